@@ -41,6 +41,68 @@ static VedgeContext vedge;
 
 
 
+//-----------------------------------------------------------------------------
+// Demonstration Bouncing Line.
+//-----------------------------------------------------------------------------
+
+// Bouncing line end points and their velocities (pixels per tick).
+typedef struct MainDemo {
+    int x1, y1, x2, y2;
+    int x1d, y1d, x2d, y2d;
+    // Ticks since the screen was last cleared.
+    int ticks;
+} MainDemo;
+
+
+static MainDemo main_demo = {
+        .x1 = 44, .y1 = 393, .x2 = 123, .y2 = 13,
+        .x1d = 5, .y1d = 6, .x2d = -4, .y2d = 8
+};
+
+
+// Move the line end points, bouncing off the screen edges, and advance the intensity wave.
+static void main_demo_update(VedgeContext * vedge, void * data, const VmathNumber tick_seconds)
+{
+    MainDemo * demo = data;
+    VdrawContext * vdraw = vedge_get_vdraw(vedge);
+    (void)tick_seconds;
+    demo->x1 += demo->x1d;
+    demo->y1 += demo->y1d;
+    demo->x2 += demo->x2d;
+    demo->y2 += demo->y2d;
+    if (demo->x1 < 5 || demo->x1 > (vdraw->width - 5)) demo->x1d = -demo->x1d;
+    if (demo->y1 < 5 || demo->y1 > (vdraw->height - 5)) demo->y1d = -demo->y1d;
+    if (demo->x2 < 5 || demo->x2 > (vdraw->width - 5)) demo->x2d = -demo->x2d;
+    if (demo->y2 < 5 || demo->y2 > (vdraw->height - 5)) demo->y2d = -demo->y2d;
+    vdraw->foreground_intensity_wave_mbr_speed = 128;
+    vdraw->foreground_intensity_wave_mbr_angle += vdraw->foreground_intensity_wave_mbr_speed;
+    demo->ticks++;
+}
+
+
+// Draw the line over the previous ones, clearing the screen every 2048 ticks.
+static void main_demo_render(VedgeContext * vedge, void * data, const VmathNumber alpha)
+{
+    MainDemo * demo = data;
+    VdrawContext * vdraw = vedge_get_vdraw(vedge);
+    (void)alpha;
+    if (demo->ticks > 2048) {
+        demo->ticks = 0;
+        vdraw_clear_screen(vdraw);
+    }
+    vdraw_set_pen_width(vdraw, 2.0);
+    vdraw_update_fg_colour_intensity_from_wave(vdraw);
+    vdraw_upd_fg_colour_from_requested_and_intensity(vdraw);
+    vdraw_line(vdraw, demo->x1, demo->y1, demo->x2, demo->y2);
+    vdraw_set_pen_width(vdraw, 1.0);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Main Application Entry Point.
+//-----------------------------------------------------------------------------
+
 int main(int argc, char * argv[])
 {
 #ifndef NDEBUG
@@ -54,6 +116,9 @@ int main(int argc, char * argv[])
     if (sdl2boot_init(&sdl2boot, &sdl2boot_config))
     {
         vedge_config_sdl2boot(&vedge_config, &sdl2boot);
+        vedge_config.update_callback = main_demo_update;
+        vedge_config.render_callback = main_demo_render;
+        vedge_config.callback_data = &main_demo;
         if (vedge_init(&vedge, &vedge_config))
         {
             vedge_run(&vedge);
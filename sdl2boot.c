@@ -65,6 +65,24 @@ void sdl2boot_config_primary_desktop(Sdl2BootConfig * boot_config,
     boot_config->window_title = window_title;
     boot_config->window_flags = window_flags;
     boot_config->renderer_flags = renderer_flags;
+    boot_config->offscreen_width = 0;
+    boot_config->offscreen_height = 0;
+}
+
+
+// Quick configure of SDL 2 boot for an offscreen software renderer without a window.
+void sdl2boot_config_offscreen(Sdl2BootConfig * boot_config,
+                               const int width,
+                               const int height)
+{
+    assert (boot_config != NULL);
+    assert (width > 0);
+    assert (height > 0);
+    memcpy(boot_config, &sdl2boot_config_default, sizeof(Sdl2BootConfig));
+    boot_config->init_subsystems = SDL2BOOT_SDL_INIT_OFFSCREEN;
+    boot_config->window_flags = 0;
+    boot_config->offscreen_width = width;
+    boot_config->offscreen_height = height;
 }
 
 
@@ -95,36 +113,60 @@ bool sdl2boot_init(Sdl2BootContext * sdl2boot, const Sdl2BootConfig * boot_confi
         return false;
     }
     sdl2boot->state.init_subsystems = sdl2boot->config.init_subsystems;
-    // Get the desktop dimensions.
-    SDL_DisplayMode desktop_display_mode = { 0 };
-    SDL_GetDesktopDisplayMode(0, &desktop_display_mode);
-    // Create the window.
-    sdl2boot->state.window = SDL_CreateWindow(
-            sdl2boot->config.window_title,
-            0,
-            0,
-            desktop_display_mode.w,
-            desktop_display_mode.h,
-            sdl2boot->config.window_flags);
-    if (sdl2boot->state.window == NULL) {
-        SDL_Log("sdl2boot_init: SDL_CreateWindow failed: %s", SDL_GetError());
-        sdl2boot_done(sdl2boot);
-        return false;
-    }
-    // Open the SDL renderer.
-    sdl2boot->state.renderer = SDL_CreateRenderer(sdl2boot->state.window,
-                                                  0,
-                                                  sdl2boot->config.renderer_flags);
-    if (sdl2boot->state.renderer == NULL) {
-        SDL_Log("sdl2boot_init: SDL_CreateRenderer failed: %s", SDL_GetError());
-        sdl2boot_done(sdl2boot);
-        return false;
-    }
-    // Get SDL display mode.
-    if (SDL_GetCurrentDisplayMode(0, &sdl2boot->state.display_mode) != 0) {
-        SDL_Log("sdl2boot_init: SDL_GetCurrentDisplayMode failed: %s", SDL_GetError());
-        sdl2boot_done(sdl2boot);
-        return false;
+    if (sdl2boot->config.offscreen_width > 0) {
+        // Create the offscreen surface and a software renderer drawing into it.
+        sdl2boot->state.surface = SDL_CreateRGBSurfaceWithFormat(0,
+                                                                 sdl2boot->config.offscreen_width,
+                                                                 sdl2boot->config.offscreen_height,
+                                                                 32,
+                                                                 SDL2BOOT_OFFSCREEN_FORMAT);
+        if (sdl2boot->state.surface == NULL) {
+            SDL_Log("sdl2boot_init: SDL_CreateRGBSurfaceWithFormat failed: %s", SDL_GetError());
+            sdl2boot_done(sdl2boot);
+            return false;
+        }
+        sdl2boot->state.renderer = SDL_CreateSoftwareRenderer(sdl2boot->state.surface);
+        if (sdl2boot->state.renderer == NULL) {
+            SDL_Log("sdl2boot_init: SDL_CreateSoftwareRenderer failed: %s", SDL_GetError());
+            sdl2boot_done(sdl2boot);
+            return false;
+        }
+        // The display mode is the surface.
+        sdl2boot->state.display_mode.format = SDL2BOOT_OFFSCREEN_FORMAT;
+        sdl2boot->state.display_mode.w = sdl2boot->config.offscreen_width;
+        sdl2boot->state.display_mode.h = sdl2boot->config.offscreen_height;
+    } else {
+        // Get the desktop dimensions.
+        SDL_DisplayMode desktop_display_mode = { 0 };
+        SDL_GetDesktopDisplayMode(0, &desktop_display_mode);
+        // Create the window.
+        sdl2boot->state.window = SDL_CreateWindow(
+                sdl2boot->config.window_title,
+                0,
+                0,
+                desktop_display_mode.w,
+                desktop_display_mode.h,
+                sdl2boot->config.window_flags);
+        if (sdl2boot->state.window == NULL) {
+            SDL_Log("sdl2boot_init: SDL_CreateWindow failed: %s", SDL_GetError());
+            sdl2boot_done(sdl2boot);
+            return false;
+        }
+        // Open the SDL renderer.
+        sdl2boot->state.renderer = SDL_CreateRenderer(sdl2boot->state.window,
+                                                      0,
+                                                      sdl2boot->config.renderer_flags);
+        if (sdl2boot->state.renderer == NULL) {
+            SDL_Log("sdl2boot_init: SDL_CreateRenderer failed: %s", SDL_GetError());
+            sdl2boot_done(sdl2boot);
+            return false;
+        }
+        // Get SDL display mode.
+        if (SDL_GetCurrentDisplayMode(0, &sdl2boot->state.display_mode) != 0) {
+            SDL_Log("sdl2boot_init: SDL_GetCurrentDisplayMode failed: %s", SDL_GetError());
+            sdl2boot_done(sdl2boot);
+            return false;
+        }
     }
     // Get renderer pixel width and height.
     if (SDL_GetRendererOutputSize(sdl2boot->state.renderer,
@@ -168,6 +210,11 @@ void sdl2boot_done(Sdl2BootContext * sdl2boot)
         SDL_DestroyWindow(sdl2boot->state.window);
         sdl2boot->state.window = NULL;
     }
+    // Free the offscreen surface.
+    if (sdl2boot->state.surface != NULL) {
+        SDL_FreeSurface(sdl2boot->state.surface);
+        sdl2boot->state.surface = NULL;
+    }
     SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "sdl2boot_done: shutting down SDL.\n");
     // Shutdown SDL and its sub-systems.
     if (sdl2boot->state.init_subsystems) {
@@ -56,6 +56,12 @@
 // Default renderer flags.
 #define SDL2BOOT_SDL_RENDERER_FLAGS (SDL_RENDERER_SOFTWARE)
 
+// Sub-systems to initialise for offscreen rendering (no window required).
+#define SDL2BOOT_SDL_INIT_OFFSCREEN (SDL_INIT_TIMER)
+
+// Offscreen surface pixel format.
+#define SDL2BOOT_OFFSCREEN_FORMAT (SDL_PIXELFORMAT_ARGB8888)
+
 
 //-----------------------------------------------------------------------------
 // Configuration, State, and Context Data Types.
@@ -71,6 +77,9 @@ typedef struct Sdl2BootConfig {
     uint32_t window_flags;
     // Renderer creation flags.
     uint32_t renderer_flags;
+    // Offscreen surface width and height, or 0 to open a window.
+    int offscreen_width;
+    int offscreen_height;
 } Sdl2BootConfig;
 
 
@@ -78,8 +87,10 @@ typedef struct Sdl2BootConfig {
 typedef struct Sdl2BootState {
     // Initial sub-systems that have been successfully initialised.
     uint32_t init_subsystems;
-    // Pointer to the window or NULL (not successfully initialised).
+    // Pointer to the window or NULL (not successfully initialised or offscreen).
     SDL_Window * window;
+    // Pointer to the offscreen surface or NULL (not successfully initialised or windowed).
+    SDL_Surface * surface;
     // SDL rendering context or NULL (not successfully initialised).
     SDL_Renderer * renderer;
     // Display mode as opened.
@@ -115,6 +126,12 @@ void sdl2boot_config_primary_desktop(Sdl2BootConfig * boot_config,
                                      const uint32_t window_flags,
                                      const uint32_t renderer_flags);
 
+// Quick configure of SDL 2 boot for an offscreen software renderer without a window.
+// Works headless, including with SDL_VIDEODRIVER=dummy.
+void sdl2boot_config_offscreen(Sdl2BootConfig * boot_config,
+                               const int width,
+                               const int height);
+
 
 //-----------------------------------------------------------------------------
 // Lifecycle Management Functions.
@@ -146,6 +163,12 @@ inline SDL_Window * sdl2boot_get_window(const Sdl2BootContext * sdl2boot)
     return sdl2boot->state.window;
 }
 
+// Get the offscreen surface for an SDL Boot context (NULL if windowed).
+inline SDL_Surface * sdl2boot_get_surface(const Sdl2BootContext * sdl2boot)
+{
+    return sdl2boot->state.surface;
+}
+
 // Get the SDL Boot renderer for an SDL Boot context.
 inline SDL_Renderer * sdl2boot_get_renderer(const Sdl2BootContext * sdl2boot)
 {
@@ -0,0 +1,245 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) vBackend Unit Tests.
+// Filename:     vbackend-tests.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 14:40
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+// API under test.
+#include "vbackend.h"
+
+
+// CTest configuration.
+#define CTEST_MAIN
+#define CTEST_SEGFAULT
+
+// CTest Extra include (implementation) file.
+#include "ctestx.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Test Fixture Lifecycle.
+//-----------------------------------------------------------------------------
+
+CTEST_DATA(vbackend)
+{
+    VdrawBackend cpu;
+    VdrawBackend null;
+    VdrawBackend record;
+    uint32_t argb[64 * 48];
+};
+
+
+CTEST_SETUP(vbackend)
+{
+    ASSERT_TRUE(vbackend_cpu_init(&data->cpu, NULL, 64, 48));
+    ASSERT_TRUE(vbackend_null_init(&data->null, 64, 48));
+    ASSERT_TRUE(vbackend_record_init(&data->record, 64, 48));
+}
+
+
+CTEST_TEARDOWN(vbackend)
+{
+    data->cpu.done(data->cpu.data);
+    data->null.done(data->null.data);
+    data->record.done(data->record.data);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Resolve the CPU backend's buffer and get a single pixel.
+static uint32_t test_vbackend_cpu_pixel(struct vbackend_data * data, const int x, const int y)
+{
+    const VrasterBuffer * raster = vbackend_cpu_get_raster(&data->cpu);
+    vraster_resolve(raster, data->argb, raster->width * (int)sizeof(uint32_t));
+    return data->argb[(y * raster->width) + x];
+}
+
+
+// Draw a test frame with each backend function.
+static void test_vbackend_frame(const VdrawBackend * backend)
+{
+    static const VdrawRGB background = { 10, 20, 30 };
+    static const VdrawRGB colour = { 200, 100, 0 };
+    static const SDL_FPoint line[3] = { { 0.0f, 5.0f }, { 40.0f, 5.0f }, { 40.0f, 30.0f } };
+    static const SDL_FPoint point = { 50.0f, 40.0f };
+    static const int indices[3] = { 0, 1, 2 };
+    const SDL_Vertex vertices[3] = {
+            { .position = { 2.0f, 10.0f }, .color = { 0, 0, 100, 255 } },
+            { .position = { 12.0f, 10.0f }, .color = { 0, 0, 100, 255 } },
+            { .position = { 2.0f, 20.0f }, .color = { 0, 0, 100, 255 } }
+    };
+    if (backend->begin != NULL) {
+        backend->begin(backend->data);
+    }
+    backend->clear(backend->data, &background);
+    backend->lines(backend->data, line, 3, &colour, VMATHNUMBER_C(1.0));
+    backend->points(backend->data, &point, 1, &colour, VMATHNUMBER_C(1.0));
+    backend->geometry(backend->data, vertices, 3, indices, 3);
+    backend->present(backend->data);
+}
+
+
+// Check the test frame drawn on the CPU backend.
+static void test_vbackend_check_cpu_frame(struct vbackend_data * data)
+{
+    ASSERT_EQUAL(0xFF0A141Eu, test_vbackend_cpu_pixel(data, 63, 0));
+    ASSERT_EQUAL(0xFFD2781Eu, test_vbackend_cpu_pixel(data, 20, 5));
+    ASSERT_EQUAL(0xFFD2781Eu, test_vbackend_cpu_pixel(data, 40, 20));
+    ASSERT_EQUAL(0xFFD2781Eu, test_vbackend_cpu_pixel(data, 50, 40));
+    ASSERT_EQUAL(0xFF0A1482u, test_vbackend_cpu_pixel(data, 3, 11));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Rasterizer Backend Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vbackend, test_vbackend_cpu_init) {
+    ASSERT_STR("cpu", data->cpu.name);
+    ASSERT_NULL(data->cpu.renderer);
+    ASSERT_EQUAL(64, data->cpu.width);
+    ASSERT_EQUAL(48, data->cpu.height);
+    ASSERT_EQUAL(64, vbackend_cpu_get_raster(&data->cpu)->width);
+}
+
+
+CTEST2(vbackend, test_vbackend_cpu_frame) {
+    test_vbackend_frame(&data->cpu);
+    test_vbackend_check_cpu_frame(data);
+}
+
+
+CTEST2(vbackend, test_vbackend_cpu_wide_point) {
+    static const VdrawRGB colour = { 0, 255, 0 };
+    static const SDL_FPoint point = { 20.0f, 20.0f };
+    data->cpu.points(data->cpu.data, &point, 1, &colour, VMATHNUMBER_C(4.0));
+    ASSERT_EQUAL(0xFF00FF00u, test_vbackend_cpu_pixel(data, 18, 18));
+    ASSERT_EQUAL(0xFF00FF00u, test_vbackend_cpu_pixel(data, 21, 21));
+    ASSERT_EQUAL(0xFF000000u, test_vbackend_cpu_pixel(data, 22, 22));
+}
+
+
+CTEST2(vbackend, test_vbackend_cpu_antialias) {
+    static const VdrawRGB colour = { 200, 100, 50 };
+    static const SDL_FPoint line[2] = { { 2.0f, 10.0f }, { 30.0f, 10.0f } };
+    ASSERT_FALSE(vbackend_cpu_set_antialias(&data->null, true));
+    ASSERT_TRUE(vbackend_cpu_set_antialias(&data->cpu, true));
+    data->cpu.lines(data->cpu.data, line, 2, &colour, VMATHNUMBER_C(1.0));
+    // Between two rows the line is split evenly over both.
+    ASSERT_EQUAL(0xFF643219u, test_vbackend_cpu_pixel(data, 20, 9));
+    ASSERT_EQUAL(0xFF643219u, test_vbackend_cpu_pixel(data, 20, 10));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Null Backend Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vbackend, test_vbackend_null_frame) {
+    test_vbackend_frame(&data->null);
+    test_vbackend_frame(&data->null);
+    const VbackendCounts * counts = vbackend_null_get_counts(&data->null);
+    ASSERT_STR("null", data->null.name);
+    ASSERT_EQUAL(2, counts->frames);
+    ASSERT_EQUAL(2, counts->clears);
+    ASSERT_EQUAL(6, counts->calls);
+    ASSERT_EQUAL(4, counts->lines);
+    ASSERT_EQUAL(2, counts->points);
+    ASSERT_EQUAL(6, counts->vertices);
+    ASSERT_EQUAL(2, counts->triangles);
+    // Lines and points share the colour and pen width.
+    ASSERT_EQUAL(1, counts->state_changes);
+    ASSERT_TRUE(counts->frame_seconds >= 0.0);
+    ASSERT_TRUE(counts->total_seconds >= counts->frame_seconds);
+}
+
+
+CTEST2(vbackend, test_vbackend_null_state_changes) {
+    static const VdrawRGB red = { 255, 0, 0 };
+    static const VdrawRGB green = { 0, 255, 0 };
+    static const SDL_FPoint point = { 1.0f, 1.0f };
+    data->null.points(data->null.data, &point, 1, &red, VMATHNUMBER_C(1.0));
+    data->null.points(data->null.data, &point, 1, &red, VMATHNUMBER_C(1.0));
+    data->null.points(data->null.data, &point, 1, &green, VMATHNUMBER_C(1.0));
+    data->null.points(data->null.data, &point, 1, &green, VMATHNUMBER_C(2.0));
+    ASSERT_EQUAL(3, vbackend_null_get_counts(&data->null)->state_changes);
+    vbackend_null_reset_counts(&data->null);
+    ASSERT_EQUAL(0, vbackend_null_get_counts(&data->null)->state_changes);
+    ASSERT_EQUAL(0, vbackend_null_get_counts(&data->null)->points);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Recording Backend Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vbackend, test_vbackend_record_frame) {
+    test_vbackend_frame(&data->record);
+    const VbackendRecording * recording = vbackend_record_get(&data->record);
+    ASSERT_EQUAL(6, recording->command_count);
+    ASSERT_EQUAL(VBACKEND_COMMAND_BEGIN, recording->commands[0].type);
+    ASSERT_EQUAL(VBACKEND_COMMAND_CLEAR, recording->commands[1].type);
+    ASSERT_EQUAL(VBACKEND_COMMAND_LINES, recording->commands[2].type);
+    ASSERT_EQUAL(3, recording->commands[2].count);
+    ASSERT_EQUAL(200, recording->commands[2].colour.red);
+    ASSERT_EQUAL(VBACKEND_COMMAND_POINTS, recording->commands[3].type);
+    ASSERT_EQUAL(3, recording->commands[3].first);
+    ASSERT_EQUAL(VBACKEND_COMMAND_GEOMETRY, recording->commands[4].type);
+    ASSERT_EQUAL(3, recording->commands[4].index_count);
+    ASSERT_EQUAL(VBACKEND_COMMAND_PRESENT, recording->commands[5].type);
+    ASSERT_EQUAL(4, recording->point_count);
+    ASSERT_EQUAL(3, recording->vertex_count);
+    ASSERT_EQUAL(3, recording->index_count);
+}
+
+
+CTEST2(vbackend, test_vbackend_record_begin_discards) {
+    test_vbackend_frame(&data->record);
+    test_vbackend_frame(&data->record);
+    const VbackendRecording * recording = vbackend_record_get(&data->record);
+    ASSERT_EQUAL(6, recording->command_count);
+    ASSERT_EQUAL(4, recording->point_count);
+}
+
+
+CTEST2(vbackend, test_vbackend_record_replay) {
+    test_vbackend_frame(&data->record);
+    vbackend_record_replay(&data->record, &data->cpu);
+    test_vbackend_check_cpu_frame(data);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Main Application Entry Point.
+//-----------------------------------------------------------------------------
+
+// Function main() implementation.
+CTESTX_MAIN
@@ -0,0 +1,832 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Drawing Backends.
+// Filename:     vbackend.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 14:05
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vbackend.h"
+
+
+
+//-----------------------------------------------------------------------------
+// SDL Renderer Backend Functions.
+//-----------------------------------------------------------------------------
+
+// Clear the frame with the colour.
+static bool vbackend_sdl_clear(void * data, const VdrawRGB * colour)
+{
+    SDL_Renderer * renderer = data;
+    SDL_SetRenderDrawColor(renderer, colour->red, colour->green, colour->blue, SDL_ALPHA_OPAQUE);
+    return !SDL_RenderClear(renderer);
+}
+
+
+// Draw lines through the points.
+static void vbackend_sdl_lines(void * data, const SDL_FPoint * points, const int count,
+                               const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    SDL_Renderer * renderer = data;
+    SDL_SetRenderDrawColor(renderer, colour->red, colour->green, colour->blue, SDL_ALPHA_OPAQUE);
+    if (pen_width == VMATHNUMBER_C(1.0)) {
+        SDL_RenderDrawLinesF(renderer, points, count);
+        return;
+    }
+    // Wider pens draw each segment as a pen wide quad, a geometry call per chunk.
+    const SDL_Color color = { colour->red, colour->green, colour->blue, SDL_ALPHA_OPAQUE };
+    SDL_Vertex vertices[VDRAW_POINTS_CHUNK * 4];
+    int indices[VDRAW_POINTS_CHUNK * 6];
+    for (int first = 1;  first < count;  first += VDRAW_POINTS_CHUNK) {
+        const int quads = SDL_min(VDRAW_POINTS_CHUNK, count - first);
+        for (int i = 0;  i < quads;  i++) {
+            const SDL_FPoint * p1 = &points[first + i - 1];
+            const SDL_FPoint * p2 = &points[first + i];
+            vdraw_line_quad(&vertices[i * 4], p1->x, p1->y, p2->x, p2->y, pen_width, color, color);
+            int * index = &indices[i * 6];
+            const int base = i * 4;
+            index[0] = base;      index[1] = base + 1;  index[2] = base + 2;
+            index[3] = base + 1;  index[4] = base + 3;  index[5] = base + 2;
+        }
+        SDL_RenderGeometry(renderer, NULL, vertices, quads * 4, indices, quads * 6);
+    }
+}
+
+
+// Draw the points.
+static void vbackend_sdl_points(void * data, const SDL_FPoint * points, const int count,
+                                const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    SDL_Renderer * renderer = data;
+    SDL_SetRenderDrawColor(renderer, colour->red, colour->green, colour->blue, SDL_ALPHA_OPAQUE);
+    if (pen_width == VMATHNUMBER_C(1.0)) {
+        SDL_RenderDrawPointsF(renderer, points, count);
+    } else {
+        SDL_FRect rects[VDRAW_POINTS_CHUNK];
+        for (int first = 0;  first < count;  first += VDRAW_POINTS_CHUNK) {
+            const int rect_count = SDL_min(VDRAW_POINTS_CHUNK, count - first);
+            for (int i = 0;  i < rect_count;  i++) {
+                rects[i].x = points[first + i].x - (pen_width/2);
+                rects[i].y = points[first + i].y - (pen_width/2);
+                rects[i].w = pen_width;
+                rects[i].h = pen_width;
+            }
+            SDL_RenderFillRectsF(renderer, rects, rect_count);
+        }
+    }
+}
+
+
+// Draw indexed triangles.
+static void vbackend_sdl_geometry(void * data, const SDL_Vertex * vertices, const int vertex_count,
+                                  const int * indices, const int index_count)
+{
+    SDL_RenderGeometry(data, NULL, vertices, vertex_count, indices, index_count);
+}
+
+
+// Show the frame.
+static void vbackend_sdl_present(void * data)
+{
+    SDL_RenderPresent(data);
+}
+
+
+// SDL renderer backend retained layer.
+typedef struct VbackendSdlLayer {
+    // Render target texture, blended over the frame.
+    SDL_Texture * texture;
+    // Render target to restore when drawing into the frame again.
+    SDL_Texture * previous;
+} VbackendSdlLayer;
+
+
+// Create a render target texture layer the size of the output.
+static void * vbackend_sdl_layer_create(void * data)
+{
+    SDL_Renderer * renderer = data;
+    int width;
+    int height;
+    if (SDL_GetRendererOutputSize(renderer, &width, &height) != 0) {
+        SDL_Log("vbackend_sdl_layer_create: SDL_GetRendererOutputSize failed: %s", SDL_GetError());
+        return NULL;
+    }
+    VbackendSdlLayer * layer = calloc(1, sizeof(VbackendSdlLayer));
+    if (layer == NULL) {
+        SDL_Log("vbackend_sdl_layer_create: calloc failed");
+        return NULL;
+    }
+    layer->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (layer->texture == NULL) {
+        SDL_Log("vbackend_sdl_layer_create: SDL_CreateTexture failed: %s", SDL_GetError());
+        free(layer);
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(layer->texture, SDL_BLENDMODE_BLEND);
+    return layer;
+}
+
+
+// Clear the layer to transparent and draw into it instead of the frame.
+static void vbackend_sdl_layer_begin(void * data, void * layer)
+{
+    SDL_Renderer * renderer = data;
+    VbackendSdlLayer * sdl_layer = layer;
+    sdl_layer->previous = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, sdl_layer->texture);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+    SDL_RenderClear(renderer);
+}
+
+
+// Draw into the frame (or the previous render target) again.
+static void vbackend_sdl_layer_end(void * data, void * layer)
+{
+    SDL_SetRenderTarget(data, ((VbackendSdlLayer *)layer)->previous);
+}
+
+
+// Copy the layer over the frame.
+static void vbackend_sdl_layer_draw(void * data, void * layer)
+{
+    SDL_RenderCopy(data, ((VbackendSdlLayer *)layer)->texture, NULL, NULL);
+}
+
+
+// Destroy the layer.
+static void vbackend_sdl_layer_destroy(void * data, void * layer)
+{
+    VbackendSdlLayer * sdl_layer = layer;
+    (void)data;
+    SDL_DestroyTexture(sdl_layer->texture);
+    free(sdl_layer);
+}
+
+
+// Initialise the backend drawing on the SDL renderer.
+bool vbackend_sdl_init(VdrawBackend * backend, SDL_Renderer * sdl_renderer)
+{
+    assert (backend != NULL);
+    assert (sdl_renderer != NULL);
+    memset(backend, 0, sizeof(VdrawBackend));
+    if (SDL_GetRendererOutputSize(sdl_renderer, &backend->width, &backend->height) != 0) {
+        SDL_Log("vbackend_sdl_init: SDL_GetRendererOutputSize failed: %s", SDL_GetError());
+        return false;
+    }
+    backend->name = "sdl";
+    backend->data = sdl_renderer;
+    backend->renderer = sdl_renderer;
+    backend->clear = vbackend_sdl_clear;
+    backend->lines = vbackend_sdl_lines;
+    backend->points = vbackend_sdl_points;
+    backend->geometry = vbackend_sdl_geometry;
+    backend->present = vbackend_sdl_present;
+    backend->layer_create = vbackend_sdl_layer_create;
+    backend->layer_begin = vbackend_sdl_layer_begin;
+    backend->layer_end = vbackend_sdl_layer_end;
+    backend->layer_draw = vbackend_sdl_layer_draw;
+    backend->layer_destroy = vbackend_sdl_layer_destroy;
+    return true;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Rasterizer Backend Functions.
+//-----------------------------------------------------------------------------
+
+// CPU rasterizer backend state.
+typedef struct VbackendCpu {
+    VrasterBuffer raster;
+    // Buffer drawn into: the raster or a retained layer.
+    VrasterBuffer * target;
+    // Renderer and streaming texture presented to, or NULL.
+    SDL_Renderer * renderer;
+    SDL_Texture * texture;
+} VbackendCpu;
+
+
+// Clear the frame with the colour.
+static bool vbackend_cpu_clear(void * data, const VdrawRGB * colour)
+{
+    VrasterBuffer * raster = &((VbackendCpu *)data)->raster;
+    vraster_clear(raster);
+    if ((colour->red | colour->green | colour->blue) != 0) {
+        vraster_rect(raster, 0, 0, raster->width, raster->height, colour->red, colour->green, colour->blue);
+    }
+    return true;
+}
+
+
+// Draw lines through the points.
+static void vbackend_cpu_lines(void * data, const SDL_FPoint * points, const int count,
+                               const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    VrasterBuffer * raster = ((VbackendCpu *)data)->target;
+    for (int i = 1;  i < count;  i++) {
+        const SDL_FPoint * p1 = &points[i - 1];
+        const SDL_FPoint * p2 = &points[i];
+        if (pen_width != VMATHNUMBER_C(1.0)) {
+            vraster_line_wide(raster, p1->x, p1->y, p2->x, p2->y, pen_width, colour->red, colour->green, colour->blue);
+        } else {
+            vraster_line(raster, p1->x, p1->y, p2->x, p2->y, colour->red, colour->green, colour->blue);
+        }
+    }
+}
+
+
+// Draw the points.
+static void vbackend_cpu_points(void * data, const SDL_FPoint * points, const int count,
+                                const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    VrasterBuffer * raster = ((VbackendCpu *)data)->target;
+    for (int i = 0;  i < count;  i++) {
+        if (pen_width != VMATHNUMBER_C(1.0)) {
+            vraster_rect(raster, points[i].x - (pen_width/2), points[i].y - (pen_width/2), pen_width, pen_width,
+                         colour->red, colour->green, colour->blue);
+        } else {
+            vraster_point(raster, points[i].x, points[i].y, colour->red, colour->green, colour->blue);
+        }
+    }
+}
+
+
+// Draw indexed triangles.
+static void vbackend_cpu_geometry(void * data, const SDL_Vertex * vertices, const int vertex_count,
+                                  const int * indices, const int index_count)
+{
+    VrasterBuffer * raster = ((VbackendCpu *)data)->target;
+    const int count = (indices != NULL) ? index_count : vertex_count;
+    for (int i = 0;  (i + 2) < count;  i += 3) {
+        VmathNumber x[3];
+        VmathNumber y[3];
+        uint8_t rgb[3][3];
+        for (int v = 0;  v < 3;  v++) {
+            const SDL_Vertex * vertex = &vertices[(indices != NULL) ? indices[i + v] : (i + v)];
+            x[v] = vertex->position.x;
+            y[v] = vertex->position.y;
+            rgb[v][0] = vertex->color.r;
+            rgb[v][1] = vertex->color.g;
+            rgb[v][2] = vertex->color.b;
+        }
+        vraster_triangle(raster, x, y, rgb);
+    }
+}
+
+
+// Show the frame.
+static void vbackend_cpu_present(void * data)
+{
+    VbackendCpu * cpu = data;
+    void * pixels;
+    int pitch;
+    if (cpu->renderer == NULL) {
+        return;
+    }
+    if (SDL_LockTexture(cpu->texture, NULL, &pixels, &pitch) == 0) {
+        vraster_resolve(&cpu->raster, pixels, pitch);
+        SDL_UnlockTexture(cpu->texture);
+    }
+    SDL_RenderCopy(cpu->renderer, cpu->texture, NULL, NULL);
+    SDL_RenderPresent(cpu->renderer);
+}
+
+
+// Create a raster buffer layer the size of the output.
+static void * vbackend_cpu_layer_create(void * data)
+{
+    const VrasterBuffer * raster = &((VbackendCpu *)data)->raster;
+    VrasterBuffer * layer = calloc(1, sizeof(VrasterBuffer));
+    if (layer == NULL) {
+        SDL_Log("vbackend_cpu_layer_create: calloc failed");
+        return NULL;
+    }
+    if (!vraster_init(layer, raster->width, raster->height)) {
+        SDL_Log("vbackend_cpu_layer_create: vraster_init failed");
+        free(layer);
+        return NULL;
+    }
+    return layer;
+}
+
+
+// Clear the layer and draw into it instead of the frame.
+static void vbackend_cpu_layer_begin(void * data, void * layer)
+{
+    VbackendCpu * cpu = data;
+    cpu->target = layer;
+    vraster_clear(cpu->target);
+    vraster_set_antialias(cpu->target, cpu->raster.antialias);
+}
+
+
+// Draw into the frame again.
+static void vbackend_cpu_layer_end(void * data, void * layer)
+{
+    VbackendCpu * cpu = data;
+    (void)layer;
+    cpu->target = &cpu->raster;
+}
+
+
+// Add the layer onto the frame.
+static void vbackend_cpu_layer_draw(void * data, void * layer)
+{
+    vraster_add_buffer(&((VbackendCpu *)data)->raster, layer);
+}
+
+
+// Destroy the layer.
+static void vbackend_cpu_layer_destroy(void * data, void * layer)
+{
+    (void)data;
+    vraster_done(layer);
+    free(layer);
+}
+
+
+// Clean-up the backend state.
+static void vbackend_cpu_done(void * data)
+{
+    VbackendCpu * cpu = data;
+    if (cpu->texture != NULL) {
+        SDL_DestroyTexture(cpu->texture);
+    }
+    vraster_done(&cpu->raster);
+    free(cpu);
+}
+
+
+// Initialise the backend rasterizing width by height pixels on the CPU.
+bool vbackend_cpu_init(VdrawBackend * backend,
+                       SDL_Renderer * sdl_renderer,
+                       const int width,
+                       const int height)
+{
+    assert (backend != NULL);
+    assert ((sdl_renderer != NULL) || ((width > 0) && (height > 0)));
+    memset(backend, 0, sizeof(VdrawBackend));
+    backend->width = width;
+    backend->height = height;
+    if (((width <= 0) || (height <= 0))
+        && (SDL_GetRendererOutputSize(sdl_renderer, &backend->width, &backend->height) != 0)) {
+        SDL_Log("vbackend_cpu_init: SDL_GetRendererOutputSize failed: %s", SDL_GetError());
+        return false;
+    }
+    VbackendCpu * cpu = calloc(1, sizeof(VbackendCpu));
+    if (cpu == NULL) {
+        SDL_Log("vbackend_cpu_init: calloc failed");
+        return false;
+    }
+    if (!vraster_init(&cpu->raster, backend->width, backend->height)) {
+        SDL_Log("vbackend_cpu_init: vraster_init failed");
+        free(cpu);
+        return false;
+    }
+    cpu->target = &cpu->raster;
+    if (sdl_renderer != NULL) {
+        cpu->renderer = sdl_renderer;
+        cpu->texture = SDL_CreateTexture(sdl_renderer,
+                                         SDL_PIXELFORMAT_ARGB8888,
+                                         SDL_TEXTUREACCESS_STREAMING,
+                                         backend->width,
+                                         backend->height);
+        if (cpu->texture == NULL) {
+            SDL_Log("vbackend_cpu_init: SDL_CreateTexture failed: %s", SDL_GetError());
+            vbackend_cpu_done(cpu);
+            return false;
+        }
+    }
+    backend->name = "cpu";
+    backend->data = cpu;
+    backend->clear = vbackend_cpu_clear;
+    backend->lines = vbackend_cpu_lines;
+    backend->points = vbackend_cpu_points;
+    backend->geometry = vbackend_cpu_geometry;
+    backend->present = vbackend_cpu_present;
+    backend->done = vbackend_cpu_done;
+    backend->layer_create = vbackend_cpu_layer_create;
+    backend->layer_begin = vbackend_cpu_layer_begin;
+    backend->layer_end = vbackend_cpu_layer_end;
+    backend->layer_draw = vbackend_cpu_layer_draw;
+    backend->layer_destroy = vbackend_cpu_layer_destroy;
+    return true;
+}
+
+
+// Get the CPU backend's raster buffer.
+const VrasterBuffer * vbackend_cpu_get_raster(const VdrawBackend * backend)
+{
+    assert (backend != NULL);
+    if (backend->done != vbackend_cpu_done) {
+        return NULL;
+    }
+    return &((const VbackendCpu *)backend->data)->raster;
+}
+
+
+// Set whether the CPU backend draws antialiased lines.
+bool vbackend_cpu_set_antialias(VdrawBackend * backend, const bool antialias)
+{
+    assert (backend != NULL);
+    if (backend->done != vbackend_cpu_done) {
+        return false;
+    }
+    vraster_set_antialias(&((VbackendCpu *)backend->data)->raster, antialias);
+    return true;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Null Backend Functions.
+//-----------------------------------------------------------------------------
+
+// Null backend state.
+typedef struct VbackendNull {
+    VbackendCounts counts;
+    // Performance counter when the frame began.
+    Uint64 frame_start;
+    // Colour and pen width of the last lines or points call.
+    VdrawRGB colour;
+    VmathNumber pen_width;
+    bool state_valid;
+} VbackendNull;
+
+
+// Count a change of colour or pen width.
+static inline void vbackend_null_state(VbackendNull * null, const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    if (!null->state_valid
+        || (null->colour.red != colour->red)
+        || (null->colour.green != colour->green)
+        || (null->colour.blue != colour->blue)
+        || (null->pen_width != pen_width)) {
+        null->counts.state_changes++;
+        null->colour = *colour;
+        null->pen_width = pen_width;
+        null->state_valid = true;
+    }
+}
+
+
+// Start timing a frame.
+static void vbackend_null_begin(void * data)
+{
+    ((VbackendNull *)data)->frame_start = SDL_GetPerformanceCounter();
+}
+
+
+// Count clearing the frame.
+static bool vbackend_null_clear(void * data, const VdrawRGB * colour)
+{
+    (void)colour;
+    ((VbackendNull *)data)->counts.clears++;
+    return true;
+}
+
+
+// Count drawing lines through the points.
+static void vbackend_null_lines(void * data, const SDL_FPoint * points, const int count,
+                                const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    (void)points;
+    VbackendNull * null = data;
+    vbackend_null_state(null, colour, pen_width);
+    null->counts.calls++;
+    null->counts.lines += (uint64_t)SDL_max(count - 1, 0);
+}
+
+
+// Count drawing the points.
+static void vbackend_null_points(void * data, const SDL_FPoint * points, const int count,
+                                 const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    (void)points;
+    VbackendNull * null = data;
+    vbackend_null_state(null, colour, pen_width);
+    null->counts.calls++;
+    null->counts.points += (uint64_t)count;
+}
+
+
+// Count drawing indexed triangles.
+static void vbackend_null_geometry(void * data, const SDL_Vertex * vertices, const int vertex_count,
+                                   const int * indices, const int index_count)
+{
+    (void)vertices;
+    VbackendNull * null = data;
+    null->counts.calls++;
+    null->counts.vertices += (uint64_t)vertex_count;
+    null->counts.triangles += (uint64_t)(((indices != NULL) ? index_count : vertex_count) / 3);
+}
+
+
+// Count presenting the frame and time it from when it began.
+static void vbackend_null_present(void * data)
+{
+    VbackendNull * null = data;
+    null->counts.frames++;
+    if (null->frame_start != 0) {
+        null->counts.frame_seconds = (double)(SDL_GetPerformanceCounter() - null->frame_start)
+                                     / (double)SDL_GetPerformanceFrequency();
+        null->counts.total_seconds += null->counts.frame_seconds;
+        null->frame_start = 0;
+    }
+}
+
+
+// Clean-up the backend state.
+static void vbackend_null_done(void * data)
+{
+    free(data);
+}
+
+
+// Initialise the backend counting the calls for a width by height pixel output.
+bool vbackend_null_init(VdrawBackend * backend, const int width, const int height)
+{
+    assert (backend != NULL);
+    memset(backend, 0, sizeof(VdrawBackend));
+    VbackendNull * null = calloc(1, sizeof(VbackendNull));
+    if (null == NULL) {
+        SDL_Log("vbackend_null_init: calloc failed");
+        return false;
+    }
+    backend->name = "null";
+    backend->data = null;
+    backend->width = width;
+    backend->height = height;
+    backend->begin = vbackend_null_begin;
+    backend->clear = vbackend_null_clear;
+    backend->lines = vbackend_null_lines;
+    backend->points = vbackend_null_points;
+    backend->geometry = vbackend_null_geometry;
+    backend->present = vbackend_null_present;
+    backend->done = vbackend_null_done;
+    return true;
+}
+
+
+// Get the null backend's counts.
+const VbackendCounts * vbackend_null_get_counts(const VdrawBackend * backend)
+{
+    assert (backend != NULL);
+    assert (backend->done == vbackend_null_done);
+    return &((const VbackendNull *)backend->data)->counts;
+}
+
+
+// Reset the null backend's counts to zero.
+void vbackend_null_reset_counts(VdrawBackend * backend)
+{
+    assert (backend != NULL);
+    assert (backend->done == vbackend_null_done);
+    VbackendNull * null = backend->data;
+    memset(&null->counts, 0, sizeof(VbackendCounts));
+    null->state_valid = false;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Recording Backend Functions.
+//-----------------------------------------------------------------------------
+
+// Make room for count more elements of size bytes, doubling the capacity.
+static bool vbackend_reserve(void ** array, int * capacity, const int used, const int count, const size_t size)
+{
+    if ((used + count) <= *capacity) {
+        return true;
+    }
+    int new_capacity = SDL_max(*capacity, 64);
+    while (new_capacity < (used + count)) {
+        new_capacity *= 2;
+    }
+    void * new_array = realloc(*array, (size_t)new_capacity * size);
+    if (new_array == NULL) {
+        SDL_Log("vbackend_reserve: realloc failed");
+        return false;
+    }
+    *array = new_array;
+    *capacity = new_capacity;
+    return true;
+}
+
+
+// Add a command to the recording. Returns NULL if out of memory.
+static VbackendCommand * vbackend_record_command(VbackendRecording * recording, const VbackendCommandType type)
+{
+    if (!vbackend_reserve((void **)&recording->commands, &recording->command_capacity,
+                          recording->command_count, 1, sizeof(VbackendCommand))) {
+        return NULL;
+    }
+    VbackendCommand * command = &recording->commands[recording->command_count++];
+    memset(command, 0, sizeof(VbackendCommand));
+    command->type = type;
+    return command;
+}
+
+
+// Start a frame, discarding the last frame's recording.
+static void vbackend_record_begin(void * data)
+{
+    VbackendRecording * recording = data;
+    recording->command_count = 0;
+    recording->point_count = 0;
+    recording->vertex_count = 0;
+    recording->index_count = 0;
+    vbackend_record_command(recording, VBACKEND_COMMAND_BEGIN);
+}
+
+
+// Record clearing the frame with the colour.
+static bool vbackend_record_clear(void * data, const VdrawRGB * colour)
+{
+    VbackendCommand * command = vbackend_record_command(data, VBACKEND_COMMAND_CLEAR);
+    if (command == NULL) {
+        return false;
+    }
+    command->colour = *colour;
+    return true;
+}
+
+
+// Record lines or points.
+static void vbackend_record_primitives(VbackendRecording * recording, const VbackendCommandType type,
+                                       const SDL_FPoint * points, const int count,
+                                       const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    if (!vbackend_reserve((void **)&recording->points, &recording->point_capacity,
+                          recording->point_count, count, sizeof(SDL_FPoint))) {
+        return;
+    }
+    VbackendCommand * command = vbackend_record_command(recording, type);
+    if (command == NULL) {
+        return;
+    }
+    command->colour = *colour;
+    command->pen_width = pen_width;
+    command->first = recording->point_count;
+    command->count = count;
+    memcpy(recording->points + recording->point_count, points, (size_t)count * sizeof(SDL_FPoint));
+    recording->point_count += count;
+}
+
+
+// Record drawing lines through the points.
+static void vbackend_record_lines(void * data, const SDL_FPoint * points, const int count,
+                                  const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    vbackend_record_primitives(data, VBACKEND_COMMAND_LINES, points, count, colour, pen_width);
+}
+
+
+// Record drawing the points.
+static void vbackend_record_points(void * data, const SDL_FPoint * points, const int count,
+                                   const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    vbackend_record_primitives(data, VBACKEND_COMMAND_POINTS, points, count, colour, pen_width);
+}
+
+
+// Record drawing indexed triangles.
+static void vbackend_record_geometry(void * data, const SDL_Vertex * vertices, const int vertex_count,
+                                     const int * indices, const int index_count)
+{
+    VbackendRecording * recording = data;
+    const int recorded_indices = (indices != NULL) ? index_count : 0;
+    if (!vbackend_reserve((void **)&recording->vertices, &recording->vertex_capacity,
+                          recording->vertex_count, vertex_count, sizeof(SDL_Vertex))
+        || !vbackend_reserve((void **)&recording->indices, &recording->index_capacity,
+                             recording->index_count, recorded_indices, sizeof(int))) {
+        return;
+    }
+    VbackendCommand * command = vbackend_record_command(recording, VBACKEND_COMMAND_GEOMETRY);
+    if (command == NULL) {
+        return;
+    }
+    command->first = recording->vertex_count;
+    command->count = vertex_count;
+    command->first_index = recording->index_count;
+    command->index_count = recorded_indices;
+    memcpy(recording->vertices + recording->vertex_count, vertices, (size_t)vertex_count * sizeof(SDL_Vertex));
+    recording->vertex_count += vertex_count;
+    if (recorded_indices > 0) {
+        memcpy(recording->indices + recording->index_count, indices, (size_t)recorded_indices * sizeof(int));
+        recording->index_count += recorded_indices;
+    }
+}
+
+
+// Record showing the frame.
+static void vbackend_record_present(void * data)
+{
+    vbackend_record_command(data, VBACKEND_COMMAND_PRESENT);
+}
+
+
+// Clean-up the backend state.
+static void vbackend_record_done(void * data)
+{
+    VbackendRecording * recording = data;
+    free(recording->commands);
+    free(recording->points);
+    free(recording->vertices);
+    free(recording->indices);
+    free(recording);
+}
+
+
+// Initialise the backend recording a width by height pixel output.
+bool vbackend_record_init(VdrawBackend * backend, const int width, const int height)
+{
+    assert (backend != NULL);
+    memset(backend, 0, sizeof(VdrawBackend));
+    VbackendRecording * recording = calloc(1, sizeof(VbackendRecording));
+    if (recording == NULL) {
+        SDL_Log("vbackend_record_init: calloc failed");
+        return false;
+    }
+    backend->name = "record";
+    backend->data = recording;
+    backend->width = width;
+    backend->height = height;
+    backend->begin = vbackend_record_begin;
+    backend->clear = vbackend_record_clear;
+    backend->lines = vbackend_record_lines;
+    backend->points = vbackend_record_points;
+    backend->geometry = vbackend_record_geometry;
+    backend->present = vbackend_record_present;
+    backend->done = vbackend_record_done;
+    return true;
+}
+
+
+// Get the recording backend's recording.
+const VbackendRecording * vbackend_record_get(const VdrawBackend * backend)
+{
+    assert (backend != NULL);
+    assert (backend->done == vbackend_record_done);
+    return backend->data;
+}
+
+
+// Replay the recording backend's calls on the target backend.
+void vbackend_record_replay(const VdrawBackend * backend, const VdrawBackend * target)
+{
+    assert (target != NULL);
+    const VbackendRecording * recording = vbackend_record_get(backend);
+    for (int i = 0;  i < recording->command_count;  i++) {
+        const VbackendCommand * command = &recording->commands[i];
+        switch (command->type) {
+            case VBACKEND_COMMAND_BEGIN:
+                if (target->begin != NULL) {
+                    target->begin(target->data);
+                }
+                break;
+            case VBACKEND_COMMAND_CLEAR:
+                target->clear(target->data, &command->colour);
+                break;
+            case VBACKEND_COMMAND_LINES:
+                target->lines(target->data, recording->points + command->first, command->count,
+                              &command->colour, command->pen_width);
+                break;
+            case VBACKEND_COMMAND_POINTS:
+                target->points(target->data, recording->points + command->first, command->count,
+                               &command->colour, command->pen_width);
+                break;
+            case VBACKEND_COMMAND_GEOMETRY:
+                if (target->geometry != NULL) {
+                    target->geometry(target->data, recording->vertices + command->first, command->count,
+                                     (command->index_count > 0) ? recording->indices + command->first_index : NULL,
+                                     command->index_count);
+                }
+                break;
+            case VBACKEND_COMMAND_PRESENT:
+                target->present(target->data);
+                break;
+        }
+    }
+}
@@ -0,0 +1,184 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Drawing Backends.
+// Filename:     vbackend.h
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 14:05
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef __VBACKEND__H__
+#define __VBACKEND__H__
+
+
+#include <SDL.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vmath.h"
+#include "vraster.h"
+#include "vdraw.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Drawing Backend Types.
+//-----------------------------------------------------------------------------
+
+// Recorded backend call types.
+typedef enum VbackendCommandType {
+    VBACKEND_COMMAND_BEGIN,
+    VBACKEND_COMMAND_CLEAR,
+    VBACKEND_COMMAND_LINES,
+    VBACKEND_COMMAND_POINTS,
+    VBACKEND_COMMAND_GEOMETRY,
+    VBACKEND_COMMAND_PRESENT
+} VbackendCommandType;
+
+
+// Recorded backend call.
+typedef struct VbackendCommand {
+    VbackendCommandType type;
+    // Clear, lines and points colour.
+    VdrawRGB colour;
+    // Lines and points pen width.
+    VmathNumber pen_width;
+    // First point or vertex and the count of them.
+    int first;
+    int count;
+    // First geometry index and the count of them.
+    int first_index;
+    int index_count;
+} VbackendCommand;
+
+
+// Null backend counts since initialised or reset.
+typedef struct VbackendCounts {
+    // Frames presented.
+    uint64_t frames;
+    // Frames cleared.
+    uint64_t clears;
+    // Lines, points and geometry calls.
+    uint64_t calls;
+    // Line segments drawn.
+    uint64_t lines;
+    // Points drawn.
+    uint64_t points;
+    // Geometry vertices submitted.
+    uint64_t vertices;
+    // Geometry triangles drawn.
+    uint64_t triangles;
+    // Lines and points calls changing the colour or pen width.
+    uint64_t state_changes;
+    // CPU time from beginning to presenting the last frame, in seconds.
+    double frame_seconds;
+    // CPU time from beginning to presenting all frames, in seconds.
+    double total_seconds;
+} VbackendCounts;
+
+
+// Recording of the backend calls since the frame began (access via API functions only).
+typedef struct VbackendRecording {
+    VbackendCommand * commands;
+    int command_count;
+    int command_capacity;
+    SDL_FPoint * points;
+    int point_count;
+    int point_capacity;
+    SDL_Vertex * vertices;
+    int vertex_count;
+    int vertex_capacity;
+    int * indices;
+    int index_count;
+    int index_capacity;
+} VbackendRecording;
+
+
+
+//-----------------------------------------------------------------------------
+// SDL Renderer Backend Functions.
+// Draws with the SDL renderer's primitives. Retained layers are render
+// target textures blended over the frame.
+//-----------------------------------------------------------------------------
+
+// Initialise the backend drawing on the SDL renderer.
+bool vbackend_sdl_init(VdrawBackend * backend, SDL_Renderer * sdl_renderer);
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Rasterizer Backend Functions.
+// Draws into a CPU raster buffer, which is resolved to a streaming texture
+// and copied to the SDL renderer when presented, if there is one. Colours
+// add onto the cleared background, saturating at full intensity. Retained
+// layers are raster buffers added onto the frame.
+//-----------------------------------------------------------------------------
+
+// Initialise the backend rasterizing width by height pixels on the CPU
+// (width or height <= 0 = the SDL renderer's output size; renderer may be NULL).
+bool vbackend_cpu_init(VdrawBackend * backend,
+                       SDL_Renderer * sdl_renderer,
+                       const int width,
+                       const int height);
+
+// Get the CPU backend's raster buffer.
+// Returns NULL if the backend is not the CPU backend.
+const VrasterBuffer * vbackend_cpu_get_raster(const VdrawBackend * backend);
+
+// Set whether the CPU backend draws antialiased lines.
+// Returns false (and does nothing) if the backend is not the CPU backend.
+bool vbackend_cpu_set_antialias(VdrawBackend * backend, const bool antialias);
+
+
+
+//-----------------------------------------------------------------------------
+// Null Backend Functions.
+// Accepts and counts every call but draws nothing, so frame timings measure
+// only the engine's own CPU work.
+//-----------------------------------------------------------------------------
+
+// Initialise the backend counting the calls for a width by height pixel output.
+bool vbackend_null_init(VdrawBackend * backend, const int width, const int height);
+
+// Get the null backend's counts.
+const VbackendCounts * vbackend_null_get_counts(const VdrawBackend * backend);
+
+// Reset the null backend's counts to zero.
+void vbackend_null_reset_counts(VdrawBackend * backend);
+
+
+
+//-----------------------------------------------------------------------------
+// Recording Backend Functions.
+// Keeps a copy of each backend call since the frame began, for inspecting
+// or replaying on another backend.
+//-----------------------------------------------------------------------------
+
+// Initialise the backend recording a width by height pixel output.
+bool vbackend_record_init(VdrawBackend * backend, const int width, const int height);
+
+// Get the recording backend's recording.
+const VbackendRecording * vbackend_record_get(const VdrawBackend * backend);
+
+// Replay the recording backend's calls on the target backend.
+void vbackend_record_replay(const VdrawBackend * backend, const VdrawBackend * target);
+
+
+
+#endif /* __VBACKEND__H__ */
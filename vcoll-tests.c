@@ -0,0 +1,182 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) vColl Unit Tests.
+// Filename:     vcoll-tests.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 17:05
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include <stdlib.h>
+
+// API under test.
+#include "vcoll.h"
+#include "vjobs.h"
+
+
+// CTest configuration.
+#define CTEST_MAIN
+#define CTEST_SEGFAULT
+
+// CTest Extra include (implementation) file.
+#include "ctestx.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Test Fixture Lifecycle.
+//-----------------------------------------------------------------------------
+
+// Broadphase with a small initial capacity so adding proxies grows it, swept by worker threads.
+CTEST_DATA(vcoll)
+{
+    VcollBroadphase broadphase;
+};
+
+
+CTEST_SETUP(vcoll)
+{
+    ASSERT_TRUE(vjobs_init(3));
+    ASSERT_TRUE(vcoll_init(&data->broadphase, 2));
+}
+
+
+CTEST_TEARDOWN(vcoll)
+{
+    vcoll_done(&data->broadphase);
+    vjobs_done();
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Is the pair in the broadphase's candidate pairs?
+static bool test_vcoll_has_pair(const VcollBroadphase * broadphase, const int a, const int b)
+{
+    int count;
+    const VcollPair * pairs = vcoll_get_pairs(broadphase, &count);
+    const int low = (a < b) ? a : b;
+    const int high = (a < b) ? b : a;
+    for (int i = 0;  i < count;  i++) {
+        if ((pairs[i].a == low) && (pairs[i].b == high)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Update Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vcoll, test_vcoll_update) {
+    VcollBroadphase * broadphase = &data->broadphase;
+    const int lander = vcoll_add(broadphase, 0, 0, 10, 10);
+    const int pad = vcoll_add(broadphase, 5, 10, 20, 12);
+    const int rock = vcoll_add(broadphase, 8, 30, 12, 40);
+    const int enemy = vcoll_add(broadphase, 100, 0, 110, 10);
+    ASSERT_EQUAL(4, broadphase->capacity);
+    // Touching boxes count; overlapping on x alone does not.
+    ASSERT_EQUAL(1, vcoll_update(broadphase));
+    ASSERT_TRUE(test_vcoll_has_pair(broadphase, lander, pad));
+    ASSERT_FALSE(test_vcoll_has_pair(broadphase, lander, rock));
+    // The enemy flies into the lander.
+    vcoll_move(broadphase, enemy, 9, 5, 19, 15);
+    ASSERT_EQUAL(3, vcoll_update(broadphase));
+    ASSERT_TRUE(test_vcoll_has_pair(broadphase, lander, enemy));
+    ASSERT_TRUE(test_vcoll_has_pair(broadphase, pad, enemy));
+    // Removed proxies no longer pair, and their IDs are reused.
+    vcoll_remove(broadphase, lander);
+    ASSERT_EQUAL(1, vcoll_update(broadphase));
+    ASSERT_TRUE(test_vcoll_has_pair(broadphase, pad, enemy));
+    ASSERT_EQUAL(lander, vcoll_add(broadphase, 200, 200, 201, 201));
+    ASSERT_EQUAL(1, vcoll_update(broadphase));
+}
+
+
+CTEST2(vcoll, test_vcoll_update_coherent) {
+    VcollBroadphase * broadphase = &data->broadphase;
+    // A row of boxes; after the first sort, moving them all together costs no swaps.
+    for (int i = 0;  i < 100;  i++) {
+        vcoll_add(broadphase, (VmathNumber)(99 - i) * 10, 0, (VmathNumber)(99 - i) * 10 + 5, 5);
+    }
+    ASSERT_EQUAL(0, vcoll_update(broadphase));
+    ASSERT_TRUE(broadphase->swaps > 0);
+    for (int i = 0;  i < 100;  i++) {
+        vcoll_move(broadphase, i, (VmathNumber)(99 - i) * 10 + 3, 0, (VmathNumber)(99 - i) * 10 + 8, 5);
+    }
+    ASSERT_EQUAL(0, vcoll_update(broadphase));
+    ASSERT_EQUAL(0, broadphase->swaps);
+}
+
+
+CTEST2(vcoll, test_vcoll_update_brute_force) {
+    VcollBroadphase * broadphase = &data->broadphase;
+    // Enough boxes for more than one sweep job.
+    enum { BOXES = 1100 };
+    VmathNumber x[BOXES];
+    VmathNumber y[BOXES];
+    srand(42);
+    for (int i = 0;  i < BOXES;  i++) {
+        x[i] = (VmathNumber)(rand() % 1000);
+        y[i] = (VmathNumber)(rand() % 1000);
+        ASSERT_EQUAL(i, vcoll_add(broadphase, x[i], y[i], x[i] + 30, y[i] + 20));
+    }
+    // As if an earlier update ran out of memory; a successful update clears it.
+    broadphase->pairs.failed = true;
+    // Random walks over several ticks, checked against testing every pair.
+    for (int tick = 0;  tick < 10;  tick++) {
+        for (int i = 0;  i < BOXES;  i++) {
+            x[i] += (VmathNumber)(rand() % 11 - 5);
+            y[i] += (VmathNumber)(rand() % 11 - 5);
+            vcoll_move(broadphase, i, x[i], y[i], x[i] + 30, y[i] + 20);
+        }
+        int expect = 0;
+        for (int a = 0;  a < BOXES;  a++) {
+            for (int b = a + 1;  b < BOXES;  b++) {
+                if ((x[a] <= x[b] + 30) && (x[a] + 30 >= x[b]) && (y[a] <= y[b] + 20) && (y[a] + 20 >= y[b])) {
+                    expect++;
+                }
+            }
+        }
+        ASSERT_EQUAL(expect, vcoll_update(broadphase));
+        ASSERT_FALSE(broadphase->pairs.failed);
+        for (int a = 0;  a < BOXES;  a++) {
+            for (int b = a + 1;  b < BOXES;  b++) {
+                if ((x[a] <= x[b] + 30) && (x[a] + 30 >= x[b]) && (y[a] <= y[b] + 20) && (y[a] + 20 >= y[b])) {
+                    ASSERT_TRUE(test_vcoll_has_pair(broadphase, a, b));
+                }
+            }
+        }
+    }
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Main Application Entry Point.
+//-----------------------------------------------------------------------------
+
+// Function main() implementation.
+CTESTX_MAIN
@@ -0,0 +1,358 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Collision Broadphase.
+// Filename:     vcoll.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 17:05
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL.h>
+
+#include "vcoll.h"
+#include "vjobs.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Collision Broadphase Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Resize an array to capacity elements of size, keeping it if out of memory.
+static bool vcoll_resize(void ** array, const int capacity, const size_t size)
+{
+    void * resized = realloc(*array, (size_t)capacity * size);
+    if (resized == NULL) {
+        return false;
+    }
+    *array = resized;
+    return true;
+}
+
+
+// Grow the per-proxy arrays to capacity proxies.
+static bool vcoll_grow(VcollBroadphase * broadphase, const int capacity)
+{
+    if (!vcoll_resize((void **)&broadphase->min_x, capacity, sizeof(VmathNumber))
+            || !vcoll_resize((void **)&broadphase->min_y, capacity, sizeof(VmathNumber))
+            || !vcoll_resize((void **)&broadphase->max_x, capacity, sizeof(VmathNumber))
+            || !vcoll_resize((void **)&broadphase->max_y, capacity, sizeof(VmathNumber))
+            || !vcoll_resize((void **)&broadphase->alive, capacity, sizeof(bool))
+            || !vcoll_resize((void **)&broadphase->free_ids, capacity, sizeof(int))
+            || !vcoll_resize((void **)&broadphase->endpoints, capacity * 2, sizeof(VcollEndpoint))
+            || !vcoll_resize((void **)&broadphase->open, capacity, sizeof(int))
+            || !vcoll_resize((void **)&broadphase->open_index, capacity, sizeof(int))) {
+        SDL_Log("vcoll_grow: out of memory for %d proxies", capacity);
+        return false;
+    }
+    broadphase->capacity = capacity;
+    return true;
+}
+
+
+// Does end point a sort before end point b (minimums first on ties)?
+static inline bool vcoll_endpoint_before(const VcollEndpoint * a, const VcollEndpoint * b)
+{
+    return (a->value < b->value) || ((a->value == b->value) && ((a->key & 1) < (b->key & 1)));
+}
+
+
+// Make room for count pairs in the list. Returns false if out of memory.
+static bool vcoll_reserve_pairs(VcollPairList * list, const int count)
+{
+    if (count <= list->capacity) {
+        return true;
+    }
+    int capacity = (list->capacity > 0) ? list->capacity : 64;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+    if (!vcoll_resize((void **)&list->pairs, capacity, sizeof(VcollPair))) {
+        SDL_Log("vcoll_update: out of memory for %d pairs", capacity);
+        return false;
+    }
+    list->capacity = capacity;
+    return true;
+}
+
+
+// Add a candidate pair to the list, growing it if needed.
+static inline void vcoll_add_pair(VcollPairList * list, const int a, const int b)
+{
+    if ((list->count == list->capacity) && !vcoll_reserve_pairs(list, list->count + 1)) {
+        list->failed = true;
+        return;
+    }
+    list->pairs[list->count++] = (a < b) ? (VcollPair){ a, b } : (VcollPair){ b, a };
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Collision Broadphase Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise an empty broadphase with room for capacity proxies (grows as needed).
+bool vcoll_init(VcollBroadphase * broadphase, const int capacity)
+{
+    assert (broadphase != NULL);
+    assert (capacity > 0);
+    memset(broadphase, 0, sizeof(VcollBroadphase));
+    if (!vcoll_grow(broadphase, capacity)) {
+        vcoll_done(broadphase);
+        return false;
+    }
+    return true;
+}
+
+
+// Clean-up the broadphase.
+void vcoll_done(VcollBroadphase * broadphase)
+{
+    assert (broadphase != NULL);
+    free(broadphase->min_x);
+    free(broadphase->min_y);
+    free(broadphase->max_x);
+    free(broadphase->max_y);
+    free(broadphase->alive);
+    free(broadphase->free_ids);
+    free(broadphase->endpoints);
+    free(broadphase->open);
+    free(broadphase->open_index);
+    for (int i = 0;  i < broadphase->job_capacity;  i++) {
+        free(broadphase->job_pairs[i].pairs);
+    }
+    free(broadphase->job_pairs);
+    free(broadphase->pairs.pairs);
+    memset(broadphase, 0, sizeof(VcollBroadphase));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Collision Broadphase Proxy Functions.
+//-----------------------------------------------------------------------------
+
+// Add a proxy for the box. Returns its ID, or VCOLL_NONE if out of memory.
+int vcoll_add(VcollBroadphase * broadphase,
+              const VmathNumber min_x, const VmathNumber min_y,
+              const VmathNumber max_x, const VmathNumber max_y)
+{
+    assert (broadphase != NULL);
+    int id;
+    if (broadphase->free_count > 0) {
+        id = broadphase->free_ids[--broadphase->free_count];
+    } else {
+        if ((broadphase->count == broadphase->capacity) && !vcoll_grow(broadphase, broadphase->capacity * 2)) {
+            return VCOLL_NONE;
+        }
+        id = broadphase->count++;
+    }
+    broadphase->alive[id] = true;
+    vcoll_move(broadphase, id, min_x, min_y, max_x, max_y);
+    // New end points go last; the next update sorts them into place.
+    broadphase->endpoints[broadphase->endpoint_count++] = (VcollEndpoint){ min_x, id * 2 };
+    broadphase->endpoints[broadphase->endpoint_count++] = (VcollEndpoint){ max_x, id * 2 + 1 };
+    return id;
+}
+
+
+// Remove the proxy.
+void vcoll_remove(VcollBroadphase * broadphase, const int id)
+{
+    assert (broadphase != NULL);
+    assert ((id >= 0) && (id < broadphase->count) && broadphase->alive[id]);
+    broadphase->alive[id] = false;
+    broadphase->free_ids[broadphase->free_count++] = id;
+    // Drop the proxy's end points, keeping the rest in order.
+    int kept = 0;
+    for (int i = 0;  i < broadphase->endpoint_count;  i++) {
+        if ((broadphase->endpoints[i].key >> 1) != id) {
+            broadphase->endpoints[kept++] = broadphase->endpoints[i];
+        }
+    }
+    broadphase->endpoint_count = kept;
+}
+
+
+// Move the proxy's box (takes effect at the next update).
+void vcoll_move(VcollBroadphase * broadphase, const int id,
+                const VmathNumber min_x, const VmathNumber min_y,
+                const VmathNumber max_x, const VmathNumber max_y)
+{
+    assert (broadphase != NULL);
+    assert ((id >= 0) && (id < broadphase->count) && broadphase->alive[id]);
+    assert ((min_x <= max_x) && (min_y <= max_y));
+    broadphase->min_x[id] = min_x;
+    broadphase->min_y[id] = min_y;
+    broadphase->max_x[id] = max_x;
+    broadphase->max_y[id] = max_y;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Collision Broadphase Update Functions.
+//-----------------------------------------------------------------------------
+
+// Sweep along x on one thread, testing each opening box against the open boxes on y.
+static void vcoll_sweep_open(VcollBroadphase * broadphase)
+{
+    const VcollEndpoint * endpoints = broadphase->endpoints;
+    const VmathNumber * min_y = broadphase->min_y;
+    const VmathNumber * max_y = broadphase->max_y;
+    int * open = broadphase->open;
+    int * open_index = broadphase->open_index;
+    int open_count = 0;
+    VcollPairList * list = &broadphase->pairs;
+    list->count = 0;
+    list->failed = false;
+    for (int i = 0;  i < broadphase->endpoint_count;  i++) {
+        const int id = endpoints[i].key >> 1;
+        if (endpoints[i].key & 1) {
+            const int last = open[--open_count];
+            open[open_index[id]] = last;
+            open_index[last] = open_index[id];
+            continue;
+        }
+        for (int j = 0;  j < open_count;  j++) {
+            const int other = open[j];
+            if ((min_y[id] <= max_y[other]) && (max_y[id] >= min_y[other])) {
+                vcoll_add_pair(list, id, other);
+            }
+        }
+        open_index[id] = open_count;
+        open[open_count++] = id;
+    }
+}
+
+
+// Sweep jobs [begin, end), each over VCOLL_ENDPOINTS_PER_JOB sorted end points:
+// each box opening there scans on to its own closing end point, and every box
+// opening in between overlaps it on x, so is tested on y.
+static void vcoll_sweep(void * data, const int begin, const int end)
+{
+    VcollBroadphase * broadphase = data;
+    const VcollEndpoint * endpoints = broadphase->endpoints;
+    const VmathNumber * min_y = broadphase->min_y;
+    const VmathNumber * max_y = broadphase->max_y;
+    for (int job = begin;  job < end;  job++) {
+        VcollPairList * list = &broadphase->job_pairs[job];
+        list->count = 0;
+        list->failed = false;
+        const int last = SDL_min((job + 1) * VCOLL_ENDPOINTS_PER_JOB, broadphase->endpoint_count);
+        for (int i = job * VCOLL_ENDPOINTS_PER_JOB;  i < last;  i++) {
+            if (endpoints[i].key & 1) {
+                continue;
+            }
+            const int id = endpoints[i].key >> 1;
+            for (int j = i + 1;  endpoints[j].key != endpoints[i].key + 1;  j++) {
+                const int other = endpoints[j].key >> 1;
+                if (!(endpoints[j].key & 1) && (min_y[id] <= max_y[other]) && (max_y[id] >= min_y[other])) {
+                    vcoll_add_pair(list, id, other);
+                }
+            }
+        }
+    }
+}
+
+
+// Re-sort the end points and find the pairs of proxies whose boxes overlap
+// (touching counts). Returns the number of pairs, or -1 if out of memory.
+int vcoll_update(VcollBroadphase * broadphase)
+{
+    assert (broadphase != NULL);
+    VcollEndpoint * endpoints = broadphase->endpoints;
+    const int count = broadphase->endpoint_count;
+    // Refresh the end point values from the boxes.
+    for (int i = 0;  i < count;  i++) {
+        const int id = endpoints[i].key >> 1;
+        endpoints[i].value = (endpoints[i].key & 1) ? broadphase->max_x[id] : broadphase->min_x[id];
+    }
+    // Insertion sort: linear in the end points plus the order changes since the last update.
+    uint64_t swaps = 0;
+    for (int i = 1;  i < count;  i++) {
+        const VcollEndpoint endpoint = endpoints[i];
+        int j = i;
+        while ((j > 0) && vcoll_endpoint_before(&endpoint, &endpoints[j - 1])) {
+            endpoints[j] = endpoints[j - 1];
+            j--;
+        }
+        endpoints[j] = endpoint;
+        swaps += (uint64_t)(i - j);
+    }
+    broadphase->swaps = swaps;
+    // Sweep along x, in parallel jobs each with its own pair list when there are
+    // workers to share them (scanning on from each opening end point costs more
+    // than keeping the open boxes, so one thread keeps them).
+    const int jobs = (count + VCOLL_ENDPOINTS_PER_JOB - 1) / VCOLL_ENDPOINTS_PER_JOB;
+    if ((jobs <= 1) || (vjobs_get_worker_count() == 0)) {
+        vcoll_sweep_open(broadphase);
+        return broadphase->pairs.failed ? -1 : broadphase->pairs.count;
+    }
+    if (jobs > broadphase->job_capacity) {
+        if (!vcoll_resize((void **)&broadphase->job_pairs, jobs, sizeof(VcollPairList))) {
+            SDL_Log("vcoll_update: out of memory for %d sweep jobs", jobs);
+            return -1;
+        }
+        memset(&broadphase->job_pairs[broadphase->job_capacity], 0,
+               (size_t)(jobs - broadphase->job_capacity) * sizeof(VcollPairList));
+        broadphase->job_capacity = jobs;
+    }
+    vjobs_parallel_for(0, jobs, 1, vcoll_sweep, broadphase);
+    // Gather the jobs' pairs in end point order.
+    VcollPairList * pairs = &broadphase->pairs;
+    pairs->count = 0;
+    pairs->failed = false;
+    int pair_count = 0;
+    for (int i = 0;  i < jobs;  i++) {
+        if (broadphase->job_pairs[i].failed) {
+            pairs->failed = true;
+            return -1;
+        }
+        pair_count += broadphase->job_pairs[i].count;
+    }
+    if (!vcoll_reserve_pairs(pairs, pair_count)) {
+        pairs->failed = true;
+        return -1;
+    }
+    for (int i = 0;  i < jobs;  i++) {
+        const VcollPairList * list = &broadphase->job_pairs[i];
+        if (list->count > 0) {
+            memcpy(&pairs->pairs[pairs->count], list->pairs, (size_t)list->count * sizeof(VcollPair));
+            pairs->count += list->count;
+        }
+    }
+    return pairs->count;
+}
+
+
+// Get the candidate pairs found by the last update.
+const VcollPair * vcoll_get_pairs(const VcollBroadphase * broadphase, int * count)
+{
+    assert (broadphase != NULL);
+    assert (count != NULL);
+    *count = broadphase->pairs.count;
+    return broadphase->pairs.pairs;
+}
@@ -0,0 +1,163 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Collision Broadphase.
+// Filename:     vcoll.h
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 17:05
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __VCOLL__H__
+#define __VCOLL__H__
+
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vmath.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Collision Broadphase Configuration.
+//-----------------------------------------------------------------------------
+
+// Sorted end points per parallel sweep job.
+#ifndef VCOLL_ENDPOINTS_PER_JOB
+#define VCOLL_ENDPOINTS_PER_JOB 2048
+#endif
+
+
+
+//-----------------------------------------------------------------------------
+// Collision Broadphase Constants.
+//-----------------------------------------------------------------------------
+
+// No proxy (a failed add).
+#define VCOLL_NONE (-1)
+
+
+
+//-----------------------------------------------------------------------------
+// Collision Broadphase Types.
+//-----------------------------------------------------------------------------
+
+// Candidate pair of proxies whose boxes overlap (a < b).
+typedef struct VcollPair {
+    int a;
+    int b;
+} VcollPair;
+
+
+// Growable list of candidate pairs.
+typedef struct VcollPairList {
+    VcollPair * pairs;
+    int count;
+    int capacity;
+    // Did adding a pair run out of memory?
+    bool failed;
+} VcollPairList;
+
+
+// Box end point on the x axis: the proxy ID times two, plus one for a maximum.
+typedef struct VcollEndpoint {
+    VmathNumber value;
+    int key;
+} VcollEndpoint;
+
+
+// Sweep-and-prune broadphase over axis aligned boxes (access via API functions only).
+// The end points stay sorted on x between updates, so objects that move a
+// little each tick cost only a few insertion sort swaps to re-sort.
+typedef struct VcollBroadphase {
+    // Proxy IDs in use are below count; capacity is the array length.
+    int count;
+    int capacity;
+    // Proxy boxes.
+    VmathNumber * min_x;
+    VmathNumber * min_y;
+    VmathNumber * max_x;
+    VmathNumber * max_y;
+    // Is the proxy ID in use?
+    bool * alive;
+    // Removed proxy IDs to reuse.
+    int * free_ids;
+    int free_count;
+    // End points of live proxies sorted on x (minimum before maximum on ties).
+    VcollEndpoint * endpoints;
+    int endpoint_count;
+    // Proxies open during the single threaded sweep, and each proxy's position in the list.
+    int * open;
+    int * open_index;
+    // Candidate pairs found by each sweep job, gathered into pairs.
+    VcollPairList * job_pairs;
+    int job_capacity;
+    // Candidate pairs found by the last update.
+    VcollPairList pairs;
+    // Insertion sort swaps made by the last update.
+    uint64_t swaps;
+} VcollBroadphase;
+
+
+
+//-----------------------------------------------------------------------------
+// Collision Broadphase Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise an empty broadphase with room for capacity proxies (grows as needed).
+bool vcoll_init(VcollBroadphase * broadphase, const int capacity);
+
+// Clean-up the broadphase.
+void vcoll_done(VcollBroadphase * broadphase);
+
+
+
+//-----------------------------------------------------------------------------
+// Collision Broadphase Proxy Functions.
+//-----------------------------------------------------------------------------
+
+// Add a proxy for the box. Returns its ID, or VCOLL_NONE if out of memory.
+int vcoll_add(VcollBroadphase * broadphase,
+              const VmathNumber min_x, const VmathNumber min_y,
+              const VmathNumber max_x, const VmathNumber max_y);
+
+// Remove the proxy.
+void vcoll_remove(VcollBroadphase * broadphase, const int id);
+
+// Move the proxy's box (takes effect at the next update).
+void vcoll_move(VcollBroadphase * broadphase, const int id,
+                const VmathNumber min_x, const VmathNumber min_y,
+                const VmathNumber max_x, const VmathNumber max_y);
+
+
+
+//-----------------------------------------------------------------------------
+// Collision Broadphase Update Functions.
+//-----------------------------------------------------------------------------
+
+// Re-sort the end points and find the pairs of proxies whose boxes overlap
+// (touching counts). Returns the number of pairs, or -1 if out of memory.
+int vcoll_update(VcollBroadphase * broadphase);
+
+// Get the candidate pairs found by the last update.
+const VcollPair * vcoll_get_pairs(const VcollBroadphase * broadphase, int * count);
+
+
+
+#endif /* __VCOLL__H__ */
@@ -0,0 +1,209 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) vDirty Unit Tests.
+// Filename:     vdirty-tests.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 11:48
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+// API under test.
+#include "vdirty.h"
+
+
+// CTest configuration.
+#define CTEST_MAIN
+#define CTEST_SEGFAULT
+
+// CTest Extra include (implementation) file.
+#include "ctestx.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Test Fixture Lifecycle.
+//-----------------------------------------------------------------------------
+
+// 10 by 8 tiles, with a partial last column and row.
+CTEST_DATA(vdirty)
+{
+    VdirtyTracker tracker;
+};
+
+
+CTEST_SETUP(vdirty)
+{
+    ASSERT_TRUE(vdirty_init(&data->tracker, (10 * VDIRTY_TILE_SIZE) - 7, (8 * VDIRTY_TILE_SIZE) - 5));
+}
+
+
+CTEST_TEARDOWN(vdirty)
+{
+    vdirty_done(&data->tracker);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Run a frame with a single primitive of one tile at the tile position.
+static int test_vdirty_frame_tile(VdirtyTracker * tracker, const int column, const int row)
+{
+    vdirty_begin_frame(tracker);
+    vdirty_add(tracker,
+               (column * VDIRTY_TILE_SIZE) + 1, (row * VDIRTY_TILE_SIZE) + 1,
+               (column * VDIRTY_TILE_SIZE) + 2, (row * VDIRTY_TILE_SIZE) + 2,
+               0x1234u);
+    return vdirty_end_frame(tracker);
+}
+
+
+// Is the rectangle the whole screen?
+static bool test_vdirty_is_full(const VdirtyTracker * tracker, const SDL_Rect * rect)
+{
+    return (rect->x == 0) && (rect->y == 0) && (rect->w == tracker->width) && (rect->h == tracker->height);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Tracking Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vdirty, test_vdirty_init) {
+    ASSERT_EQUAL(10, data->tracker.columns);
+    ASSERT_EQUAL(8, data->tracker.rows);
+    ASSERT_NOT_NULL(data->tracker.hashes);
+    ASSERT_NOT_NULL(data->tracker.previous);
+}
+
+
+CTEST2(vdirty, test_vdirty_done) {
+    vdirty_done(&data->tracker);
+    ASSERT_NULL(data->tracker.hashes);
+    ASSERT_NULL(data->tracker.previous);
+    ASSERT_EQUAL(0, data->tracker.columns);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Tracking Frame Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vdirty, test_vdirty_first_frame_full) {
+    ASSERT_EQUAL(1, test_vdirty_frame_tile(&data->tracker, 2, 3));
+    ASSERT_TRUE(test_vdirty_is_full(&data->tracker, &data->tracker.rects[0]));
+}
+
+
+CTEST2(vdirty, test_vdirty_same_frame_clean) {
+    test_vdirty_frame_tile(&data->tracker, 2, 3);
+    ASSERT_EQUAL(0, test_vdirty_frame_tile(&data->tracker, 2, 3));
+    ASSERT_EQUAL(0, test_vdirty_frame_tile(&data->tracker, 2, 3));
+}
+
+
+CTEST2(vdirty, test_vdirty_moved_primitive) {
+    test_vdirty_frame_tile(&data->tracker, 2, 3);
+    ASSERT_EQUAL(2, test_vdirty_frame_tile(&data->tracker, 6, 5));
+    // Old position is cleared.
+    ASSERT_EQUAL(2 * VDIRTY_TILE_SIZE, data->tracker.rects[0].x);
+    ASSERT_EQUAL(3 * VDIRTY_TILE_SIZE, data->tracker.rects[0].y);
+    ASSERT_EQUAL(VDIRTY_TILE_SIZE, data->tracker.rects[0].w);
+    ASSERT_EQUAL(VDIRTY_TILE_SIZE, data->tracker.rects[0].h);
+    // New position is drawn.
+    ASSERT_EQUAL(6 * VDIRTY_TILE_SIZE, data->tracker.rects[1].x);
+    ASSERT_EQUAL(5 * VDIRTY_TILE_SIZE, data->tracker.rects[1].y);
+}
+
+
+CTEST2(vdirty, test_vdirty_changed_hash) {
+    test_vdirty_frame_tile(&data->tracker, 2, 3);
+    vdirty_begin_frame(&data->tracker);
+    vdirty_add(&data->tracker,
+               (2 * VDIRTY_TILE_SIZE) + 1, (3 * VDIRTY_TILE_SIZE) + 1,
+               (2 * VDIRTY_TILE_SIZE) + 2, (3 * VDIRTY_TILE_SIZE) + 2,
+               0x4321u);
+    ASSERT_EQUAL(1, vdirty_end_frame(&data->tracker));
+    ASSERT_EQUAL(2 * VDIRTY_TILE_SIZE, data->tracker.rects[0].x);
+}
+
+
+CTEST2(vdirty, test_vdirty_merge_rows) {
+    test_vdirty_frame_tile(&data->tracker, 0, 0);
+    // A 2 by 3 tile block becomes a single rectangle.
+    vdirty_begin_frame(&data->tracker);
+    vdirty_add(&data->tracker,
+               (3 * VDIRTY_TILE_SIZE) + 4, (2 * VDIRTY_TILE_SIZE) + 4,
+               (5 * VDIRTY_TILE_SIZE) - 4, (5 * VDIRTY_TILE_SIZE) - 4,
+               0x1234u);
+    ASSERT_EQUAL(2, vdirty_end_frame(&data->tracker));
+    ASSERT_EQUAL(3 * VDIRTY_TILE_SIZE, data->tracker.rects[1].x);
+    ASSERT_EQUAL(2 * VDIRTY_TILE_SIZE, data->tracker.rects[1].y);
+    ASSERT_EQUAL(2 * VDIRTY_TILE_SIZE, data->tracker.rects[1].w);
+    ASSERT_EQUAL(3 * VDIRTY_TILE_SIZE, data->tracker.rects[1].h);
+}
+
+
+CTEST2(vdirty, test_vdirty_clipped_edge) {
+    test_vdirty_frame_tile(&data->tracker, 0, 0);
+    ASSERT_EQUAL(2, test_vdirty_frame_tile(&data->tracker, 9, 7));
+    ASSERT_EQUAL(data->tracker.width, data->tracker.rects[1].x + data->tracker.rects[1].w);
+    ASSERT_EQUAL(data->tracker.height, data->tracker.rects[1].y + data->tracker.rects[1].h);
+}
+
+
+CTEST2(vdirty, test_vdirty_off_screen) {
+    test_vdirty_frame_tile(&data->tracker, 0, 0);
+    vdirty_begin_frame(&data->tracker);
+    vdirty_add(&data->tracker, 1, 1, 2, 2, 0x1234u);
+    vdirty_add(&data->tracker, -50, -50, -10, -10, 0x5678u);
+    vdirty_add(&data->tracker, 5000, 10, 6000, 20, 0x5678u);
+    ASSERT_EQUAL(0, vdirty_end_frame(&data->tracker));
+}
+
+
+CTEST2(vdirty, test_vdirty_mostly_dirty_full) {
+    test_vdirty_frame_tile(&data->tracker, 0, 0);
+    vdirty_begin_frame(&data->tracker);
+    vdirty_add(&data->tracker, 0, 0, data->tracker.width - 1, (data->tracker.height * 3) / 4, 0x5678u);
+    ASSERT_EQUAL(1, vdirty_end_frame(&data->tracker));
+    ASSERT_TRUE(test_vdirty_is_full(&data->tracker, &data->tracker.rects[0]));
+}
+
+
+CTEST2(vdirty, test_vdirty_invalidate) {
+    test_vdirty_frame_tile(&data->tracker, 2, 3);
+    vdirty_invalidate(&data->tracker);
+    ASSERT_EQUAL(1, test_vdirty_frame_tile(&data->tracker, 2, 3));
+    ASSERT_TRUE(test_vdirty_is_full(&data->tracker, &data->tracker.rects[0]));
+    ASSERT_EQUAL(0, test_vdirty_frame_tile(&data->tracker, 2, 3));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Main Application Entry Point.
+//-----------------------------------------------------------------------------
+
+// Function main() implementation.
+CTESTX_MAIN
@@ -0,0 +1,184 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Dirty Rectangle Tracking.
+// Filename:     vdirty.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 13:20
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vdirty.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Tracking Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a tracker for a screen of width by height pixels (first frame fully dirty).
+bool vdirty_init(VdirtyTracker * tracker, const int width, const int height)
+{
+    assert (tracker != NULL);
+    assert (width > 0);
+    assert (height > 0);
+    memset(tracker, 0, sizeof(VdirtyTracker));
+    tracker->width = width;
+    tracker->height = height;
+    tracker->columns = (width + VDIRTY_TILE_SIZE - 1) / VDIRTY_TILE_SIZE;
+    tracker->rows = (height + VDIRTY_TILE_SIZE - 1) / VDIRTY_TILE_SIZE;
+    tracker->hashes = calloc((size_t)tracker->columns * tracker->rows, sizeof(uint32_t));
+    tracker->previous = calloc((size_t)tracker->columns * tracker->rows, sizeof(uint32_t));
+    if ((tracker->hashes == NULL) || (tracker->previous == NULL)) {
+        vdirty_done(tracker);
+        return false;
+    }
+    tracker->full = true;
+    return true;
+}
+
+
+// Clean-up the tracker.
+void vdirty_done(VdirtyTracker * tracker)
+{
+    assert (tracker != NULL);
+    free(tracker->hashes);
+    free(tracker->previous);
+    memset(tracker, 0, sizeof(VdirtyTracker));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Tracking Frame Functions.
+//-----------------------------------------------------------------------------
+
+// Start a new frame, keeping the last frame's tile hashes for comparison.
+void vdirty_begin_frame(VdirtyTracker * tracker)
+{
+    assert (tracker != NULL);
+    uint32_t * hashes = tracker->previous;
+    tracker->previous = tracker->hashes;
+    tracker->hashes = hashes;
+    memset(tracker->hashes, 0, (size_t)tracker->columns * tracker->rows * sizeof(uint32_t));
+}
+
+
+// Add a primitive's hash to the tiles overlapped by its inclusive pixel bounds.
+void vdirty_add(VdirtyTracker * tracker,
+                const int x1, const int y1,
+                const int x2, const int y2,
+                const uint32_t hash)
+{
+    assert (tracker != NULL);
+    if ((x2 < 0) || (y2 < 0) || (x1 >= tracker->width) || (y1 >= tracker->height) || (x2 < x1) || (y2 < y1)) {
+        return;
+    }
+    const int column1 = SDL_max(x1, 0) / VDIRTY_TILE_SIZE;
+    const int row1 = SDL_max(y1, 0) / VDIRTY_TILE_SIZE;
+    const int column2 = SDL_min(x2, tracker->width - 1) / VDIRTY_TILE_SIZE;
+    const int row2 = SDL_min(y2, tracker->height - 1) / VDIRTY_TILE_SIZE;
+    for (int row = row1;  row <= row2;  row++) {
+        uint32_t * tile = tracker->hashes + ((size_t)row * tracker->columns);
+        for (int column = column1;  column <= column2;  column++) {
+            tile[column] = vdirty_hash(tile[column], hash);
+        }
+    }
+}
+
+
+// Mark the whole screen dirty for the next vdirty_end_frame.
+void vdirty_invalidate(VdirtyTracker * tracker)
+{
+    assert (tracker != NULL);
+    tracker->full = true;
+}
+
+
+// Set the dirty rectangles to the whole screen.
+static int vdirty_full_screen(VdirtyTracker * tracker)
+{
+    tracker->full = false;
+    tracker->rects[0].x = 0;
+    tracker->rects[0].y = 0;
+    tracker->rects[0].w = tracker->width;
+    tracker->rects[0].h = tracker->height;
+    tracker->rect_count = 1;
+    return tracker->rect_count;
+}
+
+
+// Finish the frame, finding the dirty rectangles. Returns the rectangle count.
+int vdirty_end_frame(VdirtyTracker * tracker)
+{
+    assert (tracker != NULL);
+    tracker->rect_count = 0;
+    if (tracker->full) {
+        return vdirty_full_screen(tracker);
+    }
+    int dirty_tiles = 0;
+    for (int row = 0;  row < tracker->rows;  row++) {
+        const uint32_t * hashes = tracker->hashes + ((size_t)row * tracker->columns);
+        const uint32_t * previous = tracker->previous + ((size_t)row * tracker->columns);
+        int column = 0;
+        while (column < tracker->columns) {
+            if (hashes[column] == previous[column]) {
+                column++;
+                continue;
+            }
+            // A run of dirty tiles.
+            const int start = column;
+            while ((column < tracker->columns) && (hashes[column] != previous[column])) {
+                column++;
+            }
+            dirty_tiles += column - start;
+            SDL_Rect rect = {
+                    .x = start * VDIRTY_TILE_SIZE,
+                    .y = row * VDIRTY_TILE_SIZE,
+                    .w = SDL_min(column * VDIRTY_TILE_SIZE, tracker->width) - (start * VDIRTY_TILE_SIZE),
+                    .h = SDL_min((row + 1) * VDIRTY_TILE_SIZE, tracker->height) - (row * VDIRTY_TILE_SIZE)
+            };
+            // Extend a rectangle ending on the row above with the same span.
+            bool merged = false;
+            for (int i = 0;  i < tracker->rect_count;  i++) {
+                SDL_Rect * above = &tracker->rects[i];
+                if ((above->x == rect.x) && (above->w == rect.w) && ((above->y + above->h) == rect.y)) {
+                    above->h += rect.h;
+                    merged = true;
+                    break;
+                }
+            }
+            if (merged) {
+                continue;
+            }
+            if (tracker->rect_count == VDIRTY_MAX_RECTS) {
+                return vdirty_full_screen(tracker);
+            }
+            tracker->rects[tracker->rect_count++] = rect;
+        }
+    }
+    if ((dirty_tiles * 100) > (tracker->columns * tracker->rows * VDIRTY_FULL_PERCENT)) {
+        return vdirty_full_screen(tracker);
+    }
+    return tracker->rect_count;
+}
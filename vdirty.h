@@ -0,0 +1,132 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Dirty Rectangle Tracking.
+// Filename:     vdirty.h
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 13:20
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __VDIRTY__H__
+#define __VDIRTY__H__
+
+
+#include <SDL.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Tracking Configuration.
+//-----------------------------------------------------------------------------
+
+// Tile size in pixels; the granularity of the dirty rectangles.
+#ifndef VDIRTY_TILE_SIZE
+#define VDIRTY_TILE_SIZE 32
+#endif
+
+// Maximum number of dirty rectangles per frame before the whole screen is used.
+#ifndef VDIRTY_MAX_RECTS
+#define VDIRTY_MAX_RECTS 64
+#endif
+
+// Percentage of dirty tiles above which the whole screen is used.
+#ifndef VDIRTY_FULL_PERCENT
+#define VDIRTY_FULL_PERCENT 50
+#endif
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Tracking Types.
+//-----------------------------------------------------------------------------
+
+// Dirty rectangle tracker (access via API functions only).
+// Each tile holds a hash of the primitives overlapping it this frame; tiles
+// whose hash differs from the previous frame are dirty.
+typedef struct VdirtyTracker {
+    // Screen pixel width.
+    int width;
+    // Screen pixel height.
+    int height;
+    // Number of tile columns.
+    int columns;
+    // Number of tile rows.
+    int rows;
+    // Tile hashes for this frame.
+    uint32_t * hashes;
+    // Tile hashes for the previous frame.
+    uint32_t * previous;
+    // Is the whole screen dirty regardless of the hashes?
+    bool full;
+    // Dirty rectangles found by vdirty_end_frame.
+    int rect_count;
+    SDL_Rect rects[VDIRTY_MAX_RECTS];
+} VdirtyTracker;
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Tracking Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a tracker for a screen of width by height pixels (first frame fully dirty).
+bool vdirty_init(VdirtyTracker * tracker, const int width, const int height);
+
+// Clean-up the tracker.
+void vdirty_done(VdirtyTracker * tracker);
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Tracking Frame Functions.
+//-----------------------------------------------------------------------------
+
+// Start a new frame, keeping the last frame's tile hashes for comparison.
+void vdirty_begin_frame(VdirtyTracker * tracker);
+
+// Add a primitive's hash to the tiles overlapped by its inclusive pixel bounds.
+void vdirty_add(VdirtyTracker * tracker,
+                const int x1, const int y1,
+                const int x2, const int y2,
+                const uint32_t hash);
+
+// Mark the whole screen dirty for the next vdirty_end_frame.
+void vdirty_invalidate(VdirtyTracker * tracker);
+
+// Finish the frame, finding the dirty rectangles. Returns the rectangle count.
+int vdirty_end_frame(VdirtyTracker * tracker);
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Tracking Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Mix a 32 bit value into a hash (FNV-1a style).
+static inline uint32_t vdirty_hash(const uint32_t hash, const uint32_t value)
+{
+    return (hash ^ value) * 16777619u;
+}
+
+
+
+#endif /* __VDIRTY__H__ */
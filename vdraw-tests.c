@@ -25,6 +25,7 @@
 
 // API under test.
 #include "vdraw.h"
+#include "vbackend.h"
 
 
 // CTest configuration.
@@ -54,7 +55,8 @@ CTEST_DATA(vdraw_integration)
 
 CTEST_SETUP(vdraw_integration)
 {
-    sdl2boot_config_template(&data->sdl2boot_config, NULL);
+    // Offscreen, so the tests run on headless machines (SDL_VIDEODRIVER=dummy).
+    sdl2boot_config_offscreen(&data->sdl2boot_config, 640, 480);
     ASSERT_TRUE(sdl2boot_init(&data->sdl2boot, &data->sdl2boot_config));
     ASSERT_TRUE(vdraw_init(&data->vdraw, data->sdl2boot.state.renderer));
 }
@@ -217,6 +219,294 @@ CTEST2(vdraw_integration, test_vdraw_done) {
 }
 
 
+CTEST2(vdraw_integration, test_vdraw_init_backend_cpu) {
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    ASSERT_TRUE(vbackend_cpu_init(&backend, data->sdl2boot.state.renderer, 0, 0));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, data->sdl2boot.state.renderer, &backend));
+    ASSERT_STR("cpu", vdraw.backend.name);
+    ASSERT_EQUAL(data->sdl2boot.state.renderer_width, vdraw.width);
+    ASSERT_EQUAL(data->sdl2boot.state.renderer_height, vdraw.height);
+    ASSERT_FALSE(vdraw_phosphor_enable(&vdraw, VMATHNUMBER_C(0.5)));
+    ASSERT_FALSE(vdraw_dirty_enable(&vdraw));
+    vdraw_set_bg_colour(&vdraw, 12, 34, 56);
+    vdraw_set_fg_colour(&vdraw, 85, 47, 216);
+    vdraw_clear_screen(&vdraw);
+    vdraw_line(&vdraw, 0, 100, 200, 100);
+    vdraw_flip_screen(&vdraw);
+    const SDL_Rect pixelRects[2] = { { .x = 100, .y = 100, .w = 1, .h = 1 }, { .x = 100, .y = 101, .w = 1, .h = 1 } };
+    uint8_t pixels[3];
+    ASSERT_EQUAL(0, SDL_RenderReadPixels(vdraw.renderer, &pixelRects[0], SDL_PIXELFORMAT_BGR888, pixels, 1));
+    ASSERT_EQUAL(97, pixels[0]);
+    ASSERT_EQUAL(81, pixels[1]);
+    ASSERT_EQUAL(255, pixels[2]);
+    ASSERT_EQUAL(0, SDL_RenderReadPixels(vdraw.renderer, &pixelRects[1], SDL_PIXELFORMAT_BGR888, pixels, 1));
+    ASSERT_EQUAL(12, pixels[0]);
+    ASSERT_EQUAL(34, pixels[1]);
+    ASSERT_EQUAL(56, pixels[2]);
+    vdraw_done(&vdraw);
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_init_backend_hint) {
+    VdrawContext vdraw;
+    SDL_SetHint(VDRAW_HINT_BACKEND, "null");
+    const bool initialised = vdraw_init(&vdraw, data->sdl2boot.state.renderer);
+    SDL_SetHint(VDRAW_HINT_BACKEND, NULL);
+    ASSERT_TRUE(initialised);
+    ASSERT_STR("null", vdraw.backend.name);
+    ASSERT_EQUAL(data->sdl2boot.state.renderer_width, vdraw.width);
+    vdraw_clear_screen(&vdraw);
+    vdraw_line(&vdraw, 0, 100, 200, 100);
+    vdraw_point(&vdraw, 10, 10);
+    vdraw_flip_screen(&vdraw);
+    const VbackendCounts * counts = vbackend_null_get_counts(&vdraw.backend);
+    ASSERT_EQUAL(1, counts->frames);
+    ASSERT_EQUAL(1, counts->lines);
+    ASSERT_EQUAL(1, counts->points);
+    vdraw_done(&vdraw);
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_init_backend_record) {
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    ASSERT_TRUE(vbackend_record_init(&backend, 320, 200));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, NULL, &backend));
+    ASSERT_NULL(vdraw.renderer);
+    ASSERT_EQUAL(320, vdraw.width);
+    ASSERT_EQUAL(200, vdraw.height);
+    vdraw_set_pen_width(&vdraw, VMATHNUMBER_C(2.0));
+    vdraw_clear_screen(&vdraw);
+    vdraw_point(&vdraw, 10, 20);
+    vdraw_line(&vdraw, 1, 2, 3, 4);
+    vdraw_flip_screen(&vdraw);
+    const VbackendRecording * recording = vbackend_record_get(&vdraw.backend);
+    ASSERT_EQUAL(5, recording->command_count);
+    ASSERT_EQUAL(VBACKEND_COMMAND_POINTS, recording->commands[2].type);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(2.0), recording->commands[2].pen_width);
+    ASSERT_EQUAL(VBACKEND_COMMAND_LINES, recording->commands[3].type);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(3.0), recording->points[recording->commands[3].first + 1].x);
+    ASSERT_FALSE(vdraw_save_ppm(&vdraw, "vdraw-tests.ppm"));
+    vdraw_done(&vdraw);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vdraw_integration, test_vdraw_dirty_enable) {
+    ASSERT_TRUE(vdraw_dirty_enable(&data->vdraw));
+    ASSERT_NOT_NULL(data->vdraw.dirty);
+    ASSERT_NOT_NULL(data->vdraw.dirty->target);
+    vdraw_dirty_disable(&data->vdraw);
+    ASSERT_NULL(data->vdraw.dirty);
+    ASSERT_EQUAL(0, vdraw_get_dirty_rect_count(&data->vdraw));
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_dirty_point) {
+    ASSERT_TRUE(vdraw_dirty_enable(&data->vdraw));
+    vdraw_set_bg_colour(&data->vdraw, 161, 15, 188);
+    vdraw_set_fg_colour(&data->vdraw, 82, 36, 186);
+    vdraw_clear_screen(&data->vdraw);
+    vdraw_point(&data->vdraw, 100, 100);
+    vdraw_flip_screen(&data->vdraw);
+    ASSERT_EQUAL(1, vdraw_get_dirty_rect_count(&data->vdraw));
+    const SDL_Rect pixelRect = { .x = 100, .y = 100, .w = 1, .h = 1 };
+    uint8_t pixels[3];
+    ASSERT_EQUAL(0, SDL_RenderReadPixels(data->vdraw.renderer, &pixelRect, SDL_PIXELFORMAT_BGR888, pixels, 1));
+    ASSERT_EQUAL(82, pixels[0]);
+    ASSERT_EQUAL(36, pixels[1]);
+    ASSERT_EQUAL(186, pixels[2]);
+    // The same frame again changes nothing.
+    vdraw_clear_screen(&data->vdraw);
+    vdraw_point(&data->vdraw, 100, 100);
+    vdraw_flip_screen(&data->vdraw);
+    ASSERT_EQUAL(0, vdraw_get_dirty_rect_count(&data->vdraw));
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_dirty_moved_line) {
+    ASSERT_TRUE(vdraw_dirty_enable(&data->vdraw));
+    vdraw_set_bg_colour(&data->vdraw, 159, 11, 173);
+    vdraw_set_fg_colour(&data->vdraw, 85, 47, 216);
+    vdraw_clear_screen(&data->vdraw);
+    vdraw_line(&data->vdraw, 0, 100, 200, 100);
+    vdraw_flip_screen(&data->vdraw);
+    vdraw_clear_screen(&data->vdraw);
+    vdraw_line(&data->vdraw, 0, 300, 200, 300);
+    vdraw_flip_screen(&data->vdraw);
+    ASSERT_TRUE(vdraw_get_dirty_rect_count(&data->vdraw) >= 2);
+    const SDL_Rect oldRect = { .x = 100, .y = 100, .w = 1, .h = 1 };
+    const SDL_Rect newRect = { .x = 100, .y = 300, .w = 1, .h = 1 };
+    uint8_t pixels[3];
+    ASSERT_EQUAL(0, SDL_RenderReadPixels(data->vdraw.renderer, &oldRect, SDL_PIXELFORMAT_BGR888, pixels, 1));
+    ASSERT_EQUAL(159, pixels[0]);
+    ASSERT_EQUAL(11, pixels[1]);
+    ASSERT_EQUAL(173, pixels[2]);
+    ASSERT_EQUAL(0, SDL_RenderReadPixels(data->vdraw.renderer, &newRect, SDL_PIXELFORMAT_BGR888, pixels, 1));
+    ASSERT_EQUAL(85, pixels[0]);
+    ASSERT_EQUAL(47, pixels[1]);
+    ASSERT_EQUAL(216, pixels[2]);
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_dirty_invalidate) {
+    ASSERT_TRUE(vdraw_dirty_enable(&data->vdraw));
+    vdraw_clear_screen(&data->vdraw);
+    vdraw_flip_screen(&data->vdraw);
+    vdraw_clear_screen(&data->vdraw);
+    vdraw_flip_screen(&data->vdraw);
+    ASSERT_EQUAL(0, vdraw_get_dirty_rect_count(&data->vdraw));
+    vdraw_dirty_invalidate(&data->vdraw);
+    vdraw_clear_screen(&data->vdraw);
+    vdraw_flip_screen(&data->vdraw);
+    ASSERT_EQUAL(1, vdraw_get_dirty_rect_count(&data->vdraw));
+    // A new background colour redraws everything.
+    vdraw_set_bg_colour(&data->vdraw, 59, 112, 243);
+    vdraw_clear_screen(&data->vdraw);
+    vdraw_flip_screen(&data->vdraw);
+    ASSERT_EQUAL(1, vdraw_get_dirty_rect_count(&data->vdraw));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Retained Layer Functions.
+//-----------------------------------------------------------------------------
+
+// Draw a frame with a point at (100,100) in the layer; returns true if the layer was redrawn.
+static bool test_vdraw_layer_frame(VdrawContext * vdraw, VdrawLayer * layer,
+                                   const uint64_t version, const VmathMatrix3x3 view)
+{
+    vdraw_clear_screen(vdraw);
+    const bool redrawn = vdraw_layer_begin(vdraw, layer, version, view);
+    if (redrawn) {
+        vdraw_point(vdraw, 100, 100);
+    }
+    vdraw_layer_end(vdraw, layer);
+    vdraw_flip_screen(vdraw);
+    return redrawn;
+}
+
+
+// Read the renderer's pixel at (x,y) as red, green, blue and padding.
+static void test_vdraw_read_pixel(const VdrawContext * vdraw, const int x, const int y, uint8_t pixels[4])
+{
+    const SDL_Rect pixelRect = { .x = x, .y = y, .w = 1, .h = 1 };
+    ASSERT_EQUAL(0, SDL_RenderReadPixels(vdraw->renderer, &pixelRect, SDL_PIXELFORMAT_BGR888, pixels, 1));
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_layer_sdl) {
+    VdrawLayer layer;
+    vdraw_layer_init(&layer);
+    vdraw_set_bg_colour(&data->vdraw, 161, 15, 188);
+    vdraw_set_fg_colour(&data->vdraw, 82, 36, 186);
+    ASSERT_TRUE(test_vdraw_layer_frame(&data->vdraw, &layer, 1, NULL));
+    for (int i = 0;  i < 3;  i++) {
+        ASSERT_FALSE(test_vdraw_layer_frame(&data->vdraw, &layer, 1, NULL));
+        uint8_t pixels[4];
+        test_vdraw_read_pixel(&data->vdraw, 100, 100, pixels);
+        ASSERT_EQUAL(82, pixels[0]);
+        ASSERT_EQUAL(36, pixels[1]);
+        ASSERT_EQUAL(186, pixels[2]);
+        test_vdraw_read_pixel(&data->vdraw, 101, 100, pixels);
+        ASSERT_EQUAL(161, pixels[0]);
+        ASSERT_EQUAL(15, pixels[1]);
+        ASSERT_EQUAL(188, pixels[2]);
+    }
+    ASSERT_EQUAL(1, vdraw_layer_get_redraw_count(&layer));
+    ASSERT_TRUE(test_vdraw_layer_frame(&data->vdraw, &layer, 2, NULL));
+    vdraw_layer_invalidate(&layer);
+    ASSERT_TRUE(test_vdraw_layer_frame(&data->vdraw, &layer, 2, NULL));
+    ASSERT_EQUAL(3, vdraw_layer_get_redraw_count(&layer));
+    vdraw_layer_done(&data->vdraw, &layer);
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_layer_view) {
+    VdrawLayer layer;
+    vdraw_layer_init(&layer);
+    VmathMatrix3x3 view;
+    vmath_matrix3x3_set_translation(view, 10, 20);
+    ASSERT_TRUE(test_vdraw_layer_frame(&data->vdraw, &layer, 1, view));
+    ASSERT_FALSE(test_vdraw_layer_frame(&data->vdraw, &layer, 1, view));
+    // The camera moved.
+    vmath_matrix3x3_set_translation(view, 11, 20);
+    ASSERT_TRUE(test_vdraw_layer_frame(&data->vdraw, &layer, 1, view));
+    ASSERT_FALSE(test_vdraw_layer_frame(&data->vdraw, &layer, 1, view));
+    // Screen space.
+    ASSERT_TRUE(test_vdraw_layer_frame(&data->vdraw, &layer, 1, NULL));
+    ASSERT_FALSE(test_vdraw_layer_frame(&data->vdraw, &layer, 1, NULL));
+    vdraw_layer_done(&data->vdraw, &layer);
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_layer_phosphor) {
+    VdrawLayer layer;
+    vdraw_layer_init(&layer);
+    vdraw_set_bg_colour(&data->vdraw, 0, 0, 0);
+    vdraw_set_fg_colour(&data->vdraw, 82, 36, 186);
+    ASSERT_TRUE(test_vdraw_layer_frame(&data->vdraw, &layer, 1, NULL));
+    // Changing the drawing mode redraws the layer.
+    ASSERT_TRUE(vdraw_phosphor_enable(&data->vdraw, VMATHNUMBER_C(0.0)));
+    ASSERT_TRUE(test_vdraw_layer_frame(&data->vdraw, &layer, 1, NULL));
+    ASSERT_FALSE(test_vdraw_layer_frame(&data->vdraw, &layer, 1, NULL));
+    ASSERT_TRUE(data->vdraw.phosphor == &data->vdraw.private_phosphor);
+    uint8_t pixels[4];
+    test_vdraw_read_pixel(&data->vdraw, 100, 100, pixels);
+    ASSERT_EQUAL(82, pixels[0]);
+    ASSERT_EQUAL(36, pixels[1]);
+    ASSERT_EQUAL(186, pixels[2]);
+    vdraw_layer_done(&data->vdraw, &layer);
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_layer_cpu) {
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    ASSERT_TRUE(vbackend_cpu_init(&backend, NULL, 128, 128));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, NULL, &backend));
+    vdraw_set_bg_colour(&vdraw, 0, 0, 0);
+    vdraw_set_fg_colour(&vdraw, 82, 36, 186);
+    VdrawLayer layer;
+    vdraw_layer_init(&layer);
+    ASSERT_TRUE(test_vdraw_layer_frame(&vdraw, &layer, 1, NULL));
+    ASSERT_FALSE(test_vdraw_layer_frame(&vdraw, &layer, 1, NULL));
+    const VrasterBuffer * raster = vbackend_cpu_get_raster(&vdraw.backend);
+    const uint16_t * pixel = &raster->pixels[100 * raster->pitch + 100 * VRASTER_CHANNELS];
+    ASSERT_EQUAL(186 << 8, pixel[0]);
+    ASSERT_EQUAL(36 << 8, pixel[1]);
+    ASSERT_EQUAL(82 << 8, pixel[2]);
+    ASSERT_EQUAL(0, pixel[VRASTER_CHANNELS]);
+    ASSERT_EQUAL(1, vdraw_layer_get_redraw_count(&layer));
+    vdraw_layer_done(&vdraw, &layer);
+    vdraw_done(&vdraw);
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_layer_direct) {
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    ASSERT_TRUE(vbackend_null_init(&backend, 320, 200));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, NULL, &backend));
+    VdrawLayer layer;
+    vdraw_layer_init(&layer);
+    // Without layer support the content is drawn every frame.
+    for (int i = 0;  i < 3;  i++) {
+        ASSERT_TRUE(test_vdraw_layer_frame(&vdraw, &layer, 1, NULL));
+    }
+    ASSERT_EQUAL(3, vbackend_null_get_counts(&vdraw.backend)->points);
+    ASSERT_EQUAL(3, vdraw_layer_get_redraw_count(&layer));
+    vdraw_layer_done(&vdraw, &layer);
+    vdraw_done(&vdraw);
+}
+
+
 
 //-----------------------------------------------------------------------------
 // Primitive Drawing State Functions.
@@ -247,6 +537,22 @@ CTEST(vdraw, test_vdraw_set_pen_width) {
 }
 
 
+CTEST2(vdraw_integration, test_vdraw_set_antialias) {
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    ASSERT_TRUE(vbackend_cpu_init(&backend, NULL, 64, 64));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, NULL, &backend));
+    vdraw_set_antialias(&vdraw, true);
+    ASSERT_TRUE(vbackend_cpu_get_raster(&vdraw.backend)->antialias);
+    vdraw_done(&vdraw);
+    vdraw_set_antialias(&data->vdraw, true);
+    ASSERT_TRUE(vdraw_phosphor_enable(&data->vdraw, VMATHNUMBER_C(0.5)));
+    ASSERT_TRUE(data->vdraw.phosphor->antialias);
+    vdraw_set_antialias(&data->vdraw, false);
+    ASSERT_FALSE(data->vdraw.phosphor->antialias);
+}
+
+
 CTEST(vdraw, test_vdraw_set_fg_colour_requested) {
     VdrawContext vdraw = { 0 };
     vdraw_set_fg_colour_requested(&vdraw, 127, 203, 193);
@@ -319,12 +625,41 @@ CTEST(vdraw, test_vdraw_upd_fg_colour_requested_from_fade) {
     vdraw_set_fg_colour_fade_max(&vdraw, 134, 47, 222);
     vdraw_set_fg_colour_fade_val(&vdraw, VMATHNUMBER_C(0.0001));
     vdraw_upd_fg_colour_requested_from_fade(&vdraw);
+    ASSERT_DBL_EQUAL(239, vdraw.foreground_colour_requested.red);
+    ASSERT_DBL_EQUAL(73, vdraw.foreground_colour_requested.green);
+    ASSERT_DBL_EQUAL(22, vdraw.foreground_colour_requested.blue);
+    vdraw_set_fg_colour_fade_val(&vdraw, VMATHNUMBER_C(0.5));
+    vdraw_upd_fg_colour_requested_from_fade(&vdraw);
+    // Ramp index 127 of 255 from min to max.
+    ASSERT_DBL_EQUAL(187, vdraw.foreground_colour_requested.red);
+    ASSERT_DBL_EQUAL(61, vdraw.foreground_colour_requested.green);
+    ASSERT_DBL_EQUAL(121, vdraw.foreground_colour_requested.blue);
+    vdraw_set_fg_colour_fade_val(&vdraw, VMATHNUMBER_C(1.0));
+    vdraw_upd_fg_colour_requested_from_fade(&vdraw);
     ASSERT_DBL_EQUAL(134, vdraw.foreground_colour_requested.red);
     ASSERT_DBL_EQUAL(47, vdraw.foreground_colour_requested.green);
     ASSERT_DBL_EQUAL(222, vdraw.foreground_colour_requested.blue);
 }
 
 
+CTEST(vdraw, test_vdraw_fg_colour_ramps) {
+    VdrawContext vdraw = { 0 };
+    vdraw_set_fg_colour_requested(&vdraw, 100, 200, 250);
+    ASSERT_EQUAL(VDRAW_RGBA_PACK(0, 0, 0), vdraw.foreground_intensity_ramp[0]);
+    ASSERT_EQUAL(VDRAW_RGBA_PACK(100, 200, 250), vdraw.foreground_intensity_ramp[VDRAW_RAMP_SIZE - 1]);
+    ASSERT_EQUAL(100, VDRAW_RGBA_RED(vdraw.foreground_intensity_ramp[VDRAW_RAMP_SIZE - 1]));
+    ASSERT_EQUAL(200, VDRAW_RGBA_GREEN(vdraw.foreground_intensity_ramp[VDRAW_RAMP_SIZE - 1]));
+    ASSERT_EQUAL(250, VDRAW_RGBA_BLUE(vdraw.foreground_intensity_ramp[VDRAW_RAMP_SIZE - 1]));
+    // Changing the fade end points rebuilds the fade ramp.
+    vdraw_set_fg_colour_fade_max(&vdraw, 255, 128, 0);
+    ASSERT_EQUAL(VDRAW_RGBA_PACK(0, 0, 0), vdraw.foreground_fade_ramp[0]);
+    ASSERT_EQUAL(VDRAW_RGBA_PACK(255, 128, 0), vdraw.foreground_fade_ramp[VDRAW_RAMP_SIZE - 1]);
+    vdraw_set_fg_colour_fade_min(&vdraw, 0, 128, 255);
+    ASSERT_EQUAL(VDRAW_RGBA_PACK(0, 128, 255), vdraw.foreground_fade_ramp[0]);
+    ASSERT_EQUAL(VDRAW_RGBA_PACK(128, 128, 127), vdraw.foreground_fade_ramp[128]);
+}
+
+
 CTEST(vdraw, test_vdraw_set_fg_intensity_wave_size) {
     VdrawContext vdraw = { 0 };
     vdraw_set_fg_intensity_wave_size(&vdraw, VMATHNUMBER_C(2.43)); //FIXME: bounds 0 - 1?
@@ -397,6 +732,69 @@ CTEST2(vdraw_integration, test_vdraw_point) {
 }
 
 
+CTEST2(vdraw_integration, test_vdraw_points_record) {
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    ASSERT_TRUE(vbackend_record_init(&backend, 320, 200));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, NULL, &backend));
+    const int count = VDRAW_POINTS_CHUNK + 4;
+    VmathNumber x[VDRAW_POINTS_CHUNK + 4];
+    VmathNumber y[VDRAW_POINTS_CHUNK + 4];
+    for (int i = 0;  i < count;  i++) {
+        x[i] = (VmathNumber)(i % 320);
+        y[i] = (VmathNumber)(i / 320 + 7);
+    }
+    const VdrawPoints soa = { .count = count, .x = x, .y = y, .stride = 1 };
+    const VdrawRGB colours[2] = { { 255, 0, 0 }, { 0, 255, 0 } };
+    const VmathNumber sizes[2] = { VMATHNUMBER_C(1.0), VMATHNUMBER_C(4.0) };
+    const VdrawPoints coloured = { .count = 2, .x = x, .y = y, .colours = colours, .sizes = sizes };
+    vdraw_clear_screen(&vdraw);
+    vdraw_points(&vdraw, &soa);
+    vdraw_points(&vdraw, &coloured);
+    const VbackendRecording * recording = vbackend_record_get(&vdraw.backend);
+    ASSERT_EQUAL(5, recording->command_count);
+    ASSERT_EQUAL(VBACKEND_COMMAND_POINTS, recording->commands[2].type);
+    ASSERT_EQUAL(VDRAW_POINTS_CHUNK, recording->commands[2].count);
+    ASSERT_EQUAL(VBACKEND_COMMAND_POINTS, recording->commands[3].type);
+    ASSERT_EQUAL(4, recording->commands[3].count);
+    ASSERT_DBL_EQUAL(x[VDRAW_POINTS_CHUNK], recording->points[recording->commands[3].first].x);
+    ASSERT_EQUAL(VBACKEND_COMMAND_GEOMETRY, recording->commands[4].type);
+    ASSERT_EQUAL(8, recording->commands[4].count);
+    ASSERT_EQUAL(12, recording->commands[4].index_count);
+    const SDL_Vertex * vertices = &recording->vertices[recording->commands[4].first];
+    ASSERT_EQUAL(255, vertices[0].color.r);
+    ASSERT_DBL_EQUAL(0.0, vertices[0].position.x);
+    ASSERT_DBL_EQUAL(1.0, vertices[3].position.x);
+    ASSERT_EQUAL(255, vertices[4].color.g);
+    ASSERT_DBL_EQUAL(-1.0, vertices[4].position.x);
+    ASSERT_DBL_EQUAL(5.0, vertices[5].position.y);
+    vdraw_done(&vdraw);
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_points_cpu_stride) {
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    ASSERT_TRUE(vbackend_cpu_init(&backend, NULL, 64, 64));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, NULL, &backend));
+    vdraw_set_bg_colour(&vdraw, 0, 0, 0);
+    vdraw_set_fg_colour(&vdraw, 82, 36, 186);
+    // Interleaved x, y pairs, laid out like a VedgePoint array.
+    const VmathNumber pairs[6] = { 10, 11, 20, 21, 30, 31 };
+    const VdrawPoints points = { .count = 3, .x = &pairs[0], .y = &pairs[1], .stride = 2 };
+    vdraw_clear_screen(&vdraw);
+    vdraw_points(&vdraw, &points);
+    const VrasterBuffer * raster = vbackend_cpu_get_raster(&vdraw.backend);
+    for (int i = 0;  i < 3;  i++) {
+        const uint16_t * pixel = &raster->pixels[(int)pairs[i * 2 + 1] * raster->pitch + (int)pairs[i * 2] * VRASTER_CHANNELS];
+        ASSERT_NOT_EQUAL(0, pixel[0] + pixel[1] + pixel[2]);
+    }
+    const uint16_t * pixel = &raster->pixels[11 * raster->pitch + 11 * VRASTER_CHANNELS];
+    ASSERT_EQUAL(0, pixel[0] + pixel[1] + pixel[2]);
+    vdraw_done(&vdraw);
+}
+
+
 CTEST2(vdraw_integration, test_vdraw_line) {
     vdraw_set_bg_colour(&data->vdraw, 159, 11, 173);
     vdraw_set_fg_colour(&data->vdraw, 85, 47, 216);
@@ -412,6 +810,42 @@ CTEST2(vdraw_integration, test_vdraw_line) {
 }
 
 
+CTEST2(vdraw_integration, test_vdraw_line_pen_width) {
+    vdraw_set_bg_colour(&data->vdraw, 159, 11, 173);
+    vdraw_set_fg_colour(&data->vdraw, 85, 47, 216);
+    vdraw_set_pen_width(&data->vdraw, VMATHNUMBER_C(4.0));
+    vdraw_clear_screen(&data->vdraw);
+    // A diagonal line covers the pixels across it within half the pen width.
+    vdraw_line(&data->vdraw, 100, 100, 200, 200);
+    uint8_t pixels[4];
+    test_vdraw_read_pixel(&data->vdraw, 151, 149, pixels);
+    ASSERT_EQUAL(85, pixels[0]);
+    ASSERT_EQUAL(47, pixels[1]);
+    ASSERT_EQUAL(216, pixels[2]);
+    test_vdraw_read_pixel(&data->vdraw, 153, 147, pixels);
+    ASSERT_EQUAL(159, pixels[0]);
+    ASSERT_EQUAL(11, pixels[1]);
+    ASSERT_EQUAL(173, pixels[2]);
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_polyline) {
+    const SDL_FPoint points[3] = { { 0.0f, 100.25f }, { 200.5f, 100.25f }, { 200.5f, 300.75f } };
+    vdraw_set_bg_colour(&data->vdraw, 159, 11, 173);
+    vdraw_set_fg_colour(&data->vdraw, 85, 47, 216);
+    vdraw_clear_screen(&data->vdraw);
+    vdraw_polyline(&data->vdraw, points, 3);
+    const SDL_Rect pixelRects[2] = { { .x = 100, .y = 100, .w = 1, .h = 1 }, { .x = 200, .y = 200, .w = 1, .h = 1 } };
+    uint8_t pixels[3];
+    for (int i = 0;  i < 2;  i++) {
+        ASSERT_EQUAL(0, SDL_RenderReadPixels(data->vdraw.renderer, &pixelRects[i], SDL_PIXELFORMAT_BGR888, pixels, 1));
+        ASSERT_EQUAL(85, pixels[0]);
+        ASSERT_EQUAL(47, pixels[1]);
+        ASSERT_EQUAL(216, pixels[2]);
+    }
+}
+
+
 CTEST2(vdraw_integration, test_vdraw_flip_screen) {
     vdraw_set_bg_colour(&data->vdraw, 59, 112, 243);
     vdraw_clear_screen(&data->vdraw);
@@ -426,6 +860,207 @@ CTEST2(vdraw_integration, test_vdraw_flip_screen) {
 
 
 
+//-----------------------------------------------------------------------------
+// Frame Capture Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vdraw_integration, test_vdraw_save_ppm) {
+    const char * filename = "vdraw-tests.ppm";
+    vdraw_set_bg_colour(&data->vdraw, 12, 34, 56);
+    vdraw_set_fg_colour(&data->vdraw, 201, 102, 3);
+    vdraw_clear_screen(&data->vdraw);
+    vdraw_point(&data->vdraw, 1, 0);
+    vdraw_flip_screen(&data->vdraw);
+    ASSERT_TRUE(vdraw_save_ppm(&data->vdraw, filename));
+    FILE * file = fopen(filename, "rb");
+    ASSERT_NOT_NULL(file);
+    char header[16] = { 0 };
+    uint8_t pixels[6] = { 0 };
+    const size_t header_read = fread(header, 1, 15, file);
+    const size_t pixels_read = fread(pixels, 1, 6, file);
+    fclose(file);
+    remove(filename);
+    ASSERT_EQUAL(15, header_read);
+    ASSERT_STR("P6\n640 480\n255\n", header);
+    ASSERT_EQUAL(6, pixels_read);
+    ASSERT_DATA((const unsigned char *)"\x0C\x22\x38\xC9\x66\x03", 6, pixels, 6);
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_save_ppm_cpu) {
+    const char * filename = "vdraw-tests-cpu.ppm";
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    ASSERT_TRUE(vbackend_cpu_init(&backend, NULL, 64, 48));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, NULL, &backend));
+    vdraw_set_bg_colour(&vdraw, 0, 0, 0);
+    vdraw_set_fg_colour(&vdraw, 201, 102, 3);
+    vdraw_clear_screen(&vdraw);
+    vdraw_point(&vdraw, 1, 0);
+    vdraw_flip_screen(&vdraw);
+    const bool saved = vdraw_save_ppm(&vdraw, filename);
+    vdraw_done(&vdraw);
+    ASSERT_TRUE(saved);
+    FILE * file = fopen(filename, "rb");
+    ASSERT_NOT_NULL(file);
+    char header[14] = { 0 };
+    uint8_t pixels[6] = { 0 };
+    const size_t header_read = fread(header, 1, 13, file);
+    const size_t pixels_read = fread(pixels, 1, 6, file);
+    fclose(file);
+    remove(filename);
+    ASSERT_EQUAL(13, header_read);
+    ASSERT_STR("P6\n64 48\n255\n", header);
+    ASSERT_EQUAL(6, pixels_read);
+    ASSERT_DATA((const unsigned char *)"\x00\x00\x00\xC9\x66\x03", 6, pixels, 6);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Line Batch Functions.
+//-----------------------------------------------------------------------------
+
+CTEST(vdraw, test_vdraw_line_batch_add) {
+    VdrawLineBatch batch;
+    ASSERT_TRUE(vdraw_line_batch_init(&batch, 3));
+    ASSERT_TRUE(vdraw_line_batch_add(&batch, 1, 2, 3, 4));
+    ASSERT_TRUE(vdraw_line_batch_add(&batch, 5, 6, 7, 8));
+    ASSERT_TRUE(vdraw_line_batch_add(&batch, 9, 10, 11, 12));
+    ASSERT_FALSE(vdraw_line_batch_add(&batch, 13, 14, 15, 16));
+    ASSERT_EQUAL(3, batch.count);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(9.0), batch.x1[2]);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(12.0), batch.y2[2]);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(1.0), batch.intensity2[2]);
+    vdraw_line_batch_clear(&batch);
+    ASSERT_EQUAL(0, batch.count);
+    vdraw_line_batch_done(&batch);
+    ASSERT_NULL(batch.x1);
+}
+
+
+CTEST(vdraw, test_vdraw_line_batch_intensity_length) {
+    VdrawContext vdraw = { 0 };
+    VdrawLineBatch batch;
+    ASSERT_TRUE(vdraw_line_batch_init(&batch, 5));
+    vdraw_line_batch_add(&batch, 0, 0, 10, 0);
+    vdraw_line_batch_add(&batch, 0, 0, 64, 0);
+    vdraw_line_batch_add(&batch, 0, 0, 0, 128);
+    vdraw_line_batch_add(&batch, 0, 0, 32, 0);
+    vdraw_line_batch_add(&batch, 5, 5, 5, 5);
+    vdraw_line_batch_intensity(&vdraw, &batch);
+    ASSERT_DBL_NEAR_TOL(VMATHNUMBER_C(1.0), batch.intensity1[0], 1e-6);
+    ASSERT_DBL_NEAR_TOL(VMATHNUMBER_C(0.8), batch.intensity1[1], 1e-6);
+    ASSERT_DBL_NEAR_TOL(VMATHNUMBER_C(0.7), batch.intensity2[2], 1e-6);
+    ASSERT_DBL_NEAR_TOL(VMATHNUMBER_C(1.0), batch.intensity2[3], 1e-6);
+    ASSERT_DBL_NEAR_TOL(VMATHNUMBER_C(1.0), batch.intensity1[4], 1e-6);
+    vdraw_line_batch_done(&batch);
+}
+
+
+CTEST(vdraw, test_vdraw_line_batch_intensity_wave) {
+    vmath_init();
+    VdrawContext vdraw = { 0 };
+    vdraw_set_fg_intensity_wave_size(&vdraw, VMATHNUMBER_C(0.5));
+    VdrawLineBatch batch;
+    ASSERT_TRUE(vdraw_line_batch_init(&batch, 2));
+    vdraw_line_batch_add(&batch, 0, 0, 0, 0);
+    vdraw_line_batch_add(&batch, 0, 2048, 0, 2052);
+    vdraw_line_batch_intensity(&vdraw, &batch);
+    ASSERT_DBL_NEAR_TOL(VMATHNUMBER_C(1.0), batch.intensity1[0], 1e-6);
+    ASSERT_DBL_NEAR_TOL(VMATHNUMBER_C(0.5), batch.intensity1[1], 1e-6);
+    ASSERT_TRUE(batch.intensity2[1] > batch.intensity1[1]);
+    vdraw_line_batch_done(&batch);
+    vmath_done();
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_line_batch) {
+    VdrawLineBatch batch;
+    ASSERT_TRUE(vdraw_line_batch_init(&batch, 1));
+    ASSERT_TRUE(vdraw_phosphor_enable(&data->vdraw, VMATHNUMBER_C(0.0)));
+    vdraw_set_fg_colour_requested(&data->vdraw, 100, 200, 250);
+    vdraw_set_fg_intensity_wave_size(&data->vdraw, VMATHNUMBER_C(0.0));
+    vdraw_line_batch_add(&batch, 0, 100, 200, 100);
+    vdraw_line_batch_intensity(&data->vdraw, &batch);
+    vdraw_clear_screen(&data->vdraw);
+    vdraw_line_batch(&data->vdraw, &batch);
+    vdraw_flip_screen(&data->vdraw);
+    vdraw_line_batch_done(&batch);
+    const SDL_Rect pixelRect = { .x = 100, .y = 100, .w = 1, .h = 1 };
+    uint8_t pixels[3];
+    ASSERT_EQUAL(0, SDL_RenderReadPixels(data->vdraw.renderer, &pixelRect, SDL_PIXELFORMAT_BGR888, pixels, 1));
+    // Length 200: intensity 0.6 + (0.4 * 32 / 200) = 0.664, ramp index 169 of 255.
+    ASSERT_EQUAL(66, pixels[0]);
+    ASSERT_EQUAL(132, pixels[1]);
+    ASSERT_EQUAL(165, pixels[2]);
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// Retained Mesh Functions.
+//-----------------------------------------------------------------------------
+
+CTEST(vdraw, test_vdraw_mesh_init) {
+    // A triangle and a separate line; the open line becomes its own strip first.
+    const SDL_FPoint vertices[5] = { { 0, 0 }, { 4, 0 }, { 0, 4 }, { 8, 8 }, { 9, 9 } };
+    const int edges[8] = { 0, 1,  1, 2,  2, 0,  3, 4 };
+    VdrawMesh mesh;
+    ASSERT_TRUE(vdraw_mesh_init(&mesh, vertices, 5, edges, 4));
+    ASSERT_EQUAL(2, mesh.strip_count);
+    ASSERT_EQUAL(2, mesh.strip_lengths[0]);
+    ASSERT_EQUAL(4, mesh.strip_lengths[1]);
+    ASSERT_EQUAL(6, mesh.vertex_count);
+    ASSERT_DBL_EQUAL(8.0, mesh.vertices[0].x);
+    ASSERT_DBL_EQUAL(0.0, mesh.vertices[2].x);
+    ASSERT_DBL_EQUAL(0.0, mesh.vertices[5].x);
+    ASSERT_DBL_EQUAL(0.0, mesh.vertices[5].y);
+    vdraw_mesh_done(&mesh);
+    ASSERT_TRUE(vdraw_mesh_init(&mesh, NULL, 0, NULL, 0));
+    ASSERT_EQUAL(0, mesh.strip_count);
+    vdraw_mesh_done(&mesh);
+}
+
+
+CTEST2(vdraw_integration, test_vdraw_mesh_record) {
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    ASSERT_TRUE(vbackend_record_init(&backend, 320, 200));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, NULL, &backend));
+    // A square as four separate lines, laid out like a VedgeLine array, plus a separate line.
+    const VmathNumber lines[5 * 4] = { 0, 0, 1, 0,   1, 1, 1, 0,   1, 1, 0, 1,   0, 0, 0, 1,   5, 5, 6, 5 };
+    VdrawMesh mesh;
+    ASSERT_TRUE(vdraw_mesh_init_lines(&mesh, lines, 5));
+    const VmathMatrix3x3 transform = {
+            { VMATHNUMBER_C(2.0), VMATHNUMBER_C(0.0), VMATHNUMBER_C(10.0) },
+            { VMATHNUMBER_C(0.0), VMATHNUMBER_C(2.0), VMATHNUMBER_C(20.0) },
+            { VMATHNUMBER_C(0.0), VMATHNUMBER_C(0.0), VMATHNUMBER_C(1.0) } };
+    vdraw_clear_screen(&vdraw);
+    vdraw_mesh(&vdraw, &mesh, transform);
+    const VbackendRecording * recording = vbackend_record_get(&vdraw.backend);
+    ASSERT_EQUAL(4, recording->command_count);
+    ASSERT_EQUAL(VBACKEND_COMMAND_LINES, recording->commands[2].type);
+    ASSERT_EQUAL(2, recording->commands[2].count);
+    ASSERT_DBL_EQUAL(20.0, recording->points[recording->commands[2].first].x);
+    ASSERT_DBL_EQUAL(22.0, recording->points[recording->commands[2].first + 1].x);
+    ASSERT_EQUAL(VBACKEND_COMMAND_LINES, recording->commands[3].type);
+    ASSERT_EQUAL(5, recording->commands[3].count);
+    const SDL_FPoint * square = &recording->points[recording->commands[3].first];
+    ASSERT_DBL_EQUAL(10.0, square[0].x);
+    ASSERT_DBL_EQUAL(20.0, square[0].y);
+    ASSERT_DBL_EQUAL(12.0, square[1].x);
+    ASSERT_DBL_EQUAL(20.0, square[1].y);
+    ASSERT_DBL_EQUAL(12.0, square[2].x);
+    ASSERT_DBL_EQUAL(22.0, square[2].y);
+    ASSERT_DBL_EQUAL(10.0, square[4].x);
+    ASSERT_DBL_EQUAL(20.0, square[4].y);
+    vdraw_mesh_done(&mesh);
+    vdraw_done(&vdraw);
+}
+
+
 //-----------------------------------------------------------------------------
 // Main Application Entry Point.
 //-----------------------------------------------------------------------------
@@ -24,8 +24,18 @@
 
 
 #include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "vdraw.h"
+#include "vbackend.h"
+#include "vscope.h"
+
+#ifdef VDRAW_SSE
+#include <xmmintrin.h>
+#endif
 
 
 
@@ -64,27 +74,94 @@ void vdraw_order_line(const VmathNumber x1a, const VmathNumber y1a,
 
 
 
+// Fill a colour ramp from the first colour (index 0) to the second (index 255).
+static void vdraw_build_ramp(uint32_t ramp[VDRAW_RAMP_SIZE], const VdrawRGB * from, const VdrawRGB * to)
+{
+    for (int i = 0;  i < VDRAW_RAMP_SIZE;  i++) {
+        ramp[i] = VDRAW_RGBA_PACK(from->red + (((to->red - from->red) * i) / (VDRAW_RAMP_SIZE - 1)),
+                                  from->green + (((to->green - from->green) * i) / (VDRAW_RAMP_SIZE - 1)),
+                                  from->blue + (((to->blue - from->blue) * i) / (VDRAW_RAMP_SIZE - 1)));
+    }
+}
+
+
+// Get the ramp index of a value from 0.0 to 1.0 (clipped).
+static inline int vdraw_ramp_index(const VmathNumber value)
+{
+    return (int)(vmath_clip_floor_ceil(value, VMATHNUMBER_C(0.0), VMATHNUMBER_C(1.0))
+                 * (VmathNumber)(VDRAW_RAMP_SIZE - 1));
+}
+
+
+// Rebuild the intensity ramp for the requested foreground colour.
+static void vdraw_build_intensity_ramp(VdrawContext * vdraw)
+{
+    static const VdrawRGB black = { 0, 0, 0 };
+    vdraw_build_ramp(vdraw->foreground_intensity_ramp, &black, &vdraw->foreground_colour_requested);
+}
+
+
+
 //-----------------------------------------------------------------------------
 // Primitive Drawing Life-cycle Functions.
 //-----------------------------------------------------------------------------
 
+// Initialise the backend selected by the VDRAW_HINT_BACKEND hint.
+static bool vdraw_init_hint_backend(VdrawBackend * backend, SDL_Renderer * sdl_renderer)
+{
+    const char * hint = SDL_GetHint(VDRAW_HINT_BACKEND);
+    if ((hint == NULL) || (strcmp(hint, "sdl") == 0)) {
+        return vbackend_sdl_init(backend, sdl_renderer);
+    }
+    if (strcmp(hint, "cpu") == 0) {
+        return vbackend_cpu_init(backend, sdl_renderer, 0, 0);
+    }
+    if ((strcmp(hint, "null") == 0) || (strcmp(hint, "scope") == 0)) {
+        int width, height;
+        if (SDL_GetRendererOutputSize(sdl_renderer, &width, &height) != 0) {
+            SDL_Log("vdraw_init: SDL_GetRendererOutputSize failed: %s", SDL_GetError());
+            return false;
+        }
+        if (strcmp(hint, "scope") == 0) {
+            return vscope_init(backend, width, height, VSCOPE_SAMPLE_RATE, VSCOPE_FRAME_RATE, NULL);
+        }
+        return vbackend_null_init(backend, width, height);
+    }
+    SDL_Log("vdraw_init: unknown %s \"%s\", using sdl", VDRAW_HINT_BACKEND, hint);
+    return vbackend_sdl_init(backend, sdl_renderer);
+}
+
+
 // Initialise the drawing context with the SDL renderer.
 bool vdraw_init(VdrawContext * vdraw, SDL_Renderer * sdl_renderer)
 {
     assert (vdraw != NULL);
     assert (sdl_renderer != NULL);
+    VdrawBackend backend;
+    if (!vdraw_init_hint_backend(&backend, sdl_renderer)) {
+        SDL_Log("vdraw_init: backend initialisation failed");
+        memset(vdraw, 0, sizeof(struct VdrawContext));
+        return false;
+    }
+    return vdraw_init_backend(vdraw, sdl_renderer, &backend);
+}
+
+
+// Initialise the drawing context with the backend, which it takes ownership of.
+bool vdraw_init_backend(VdrawContext * vdraw,
+                        SDL_Renderer * sdl_renderer,
+                        const VdrawBackend * backend)
+{
+    assert (vdraw != NULL);
+    assert (backend != NULL);
     // Clear the context.
     memset(vdraw, 0, sizeof(struct VdrawContext));
-    // Store the renderer.
+    // Store the renderer and backend.
     vdraw->renderer = sdl_renderer;
-    // Get renderer pixel width and height.
-    if (SDL_GetRendererOutputSize(vdraw->renderer,
-                                  &vdraw->width,
-                                  &vdraw->height) != 0) {
-        SDL_Log("vdraw_init: SDL_GetRendererOutputSize failed: %s", SDL_GetError());
-        vdraw_done(vdraw);
-        return false;
-    }
+    vdraw->backend = *backend;
+    // Get the backend pixel width and height.
+    vdraw->width = backend->width;
+    vdraw->height = backend->height;
     // Initialise state with defaults.
     vdraw->background_colour.red = 0;
     vdraw->background_colour.green = 0;
@@ -107,6 +184,10 @@ bool vdraw_init(VdrawContext * vdraw, SDL_Renderer * sdl_renderer)
     vdraw->foreground_intensity_wave_size = VMATHNUMBER_C(0.2);
     vdraw->foreground_intensity_wave_mbr_angle = VMATHNUMBER_C( 0.0);
     vdraw->foreground_intensity_wave_mbr_speed = VMATHNUMBER_C(16.0);
+    vdraw_build_intensity_ramp(vdraw);
+    vdraw_build_ramp(vdraw->foreground_fade_ramp,
+                     &vdraw->foreground_colour_fade_min,
+                     &vdraw->foreground_colour_fade_max);
     return true;
 }
 
@@ -115,11 +196,487 @@ bool vdraw_init(VdrawContext * vdraw, SDL_Renderer * sdl_renderer)
 void vdraw_done(VdrawContext * vdraw)
 {
     assert (vdraw != NULL);
+    vdraw_dirty_disable(vdraw);
+    vdraw_phosphor_disable(vdraw);
+    if (vdraw->backend.done != NULL) {
+        vdraw->backend.done(vdraw->backend.data);
+    }
+    memset(&vdraw->backend, 0, sizeof(VdrawBackend));
     vdraw->renderer = NULL;
 }
 
 
 
+//-----------------------------------------------------------------------------
+// Phosphor Persistence Functions.
+//-----------------------------------------------------------------------------
+
+// Enable phosphor persistence with the decay per frame (0.0 to 1.0).
+bool vdraw_phosphor_enable(VdrawContext * vdraw, const VmathNumber decay)
+{
+    assert (vdraw != NULL);
+    if (vdraw->backend.renderer == NULL) {
+        SDL_Log("vdraw_phosphor_enable: the %s backend does not draw on the SDL renderer", vdraw->backend.name);
+        return false;
+    }
+    if (vdraw->phosphor == NULL) {
+        if (!vraster_init(&vdraw->private_phosphor, vdraw->width, vdraw->height)) {
+            SDL_Log("vdraw_phosphor_enable: vraster_init failed");
+            return false;
+        }
+        vdraw->phosphor_texture = SDL_CreateTexture(vdraw->renderer,
+                                                    SDL_PIXELFORMAT_ARGB8888,
+                                                    SDL_TEXTUREACCESS_STREAMING,
+                                                    vdraw->width,
+                                                    vdraw->height);
+        if (vdraw->phosphor_texture == NULL) {
+            SDL_Log("vdraw_phosphor_enable: SDL_CreateTexture failed: %s", SDL_GetError());
+            vraster_done(&vdraw->private_phosphor);
+            return false;
+        }
+        vraster_set_antialias(&vdraw->private_phosphor, vdraw->antialias);
+        vdraw->phosphor = &vdraw->private_phosphor;
+    }
+    vdraw_set_phosphor_decay(vdraw, decay);
+    return true;
+}
+
+
+// Disable phosphor persistence.
+void vdraw_phosphor_disable(VdrawContext * vdraw)
+{
+    assert (vdraw != NULL);
+    vdraw_glow_disable(vdraw);
+    if (vdraw->phosphor_texture != NULL) {
+        SDL_DestroyTexture(vdraw->phosphor_texture);
+        vdraw->phosphor_texture = NULL;
+    }
+    if (vdraw->phosphor != NULL) {
+        vraster_done(vdraw->phosphor);
+        vdraw->phosphor = NULL;
+    }
+}
+
+
+// Set the phosphor decay per frame (0.0 = no persistence, 1.0 = no fade).
+void vdraw_set_phosphor_decay(VdrawContext * vdraw, const VmathNumber decay)
+{
+    assert (vdraw != NULL);
+    if (vdraw->phosphor != NULL) {
+        vraster_set_decay(vdraw->phosphor, decay);
+    }
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Functions.
+//-----------------------------------------------------------------------------
+
+// Enable glow at the quality, enabling phosphor persistence (decay 0.0) if needed.
+bool vdraw_glow_enable(VdrawContext * vdraw, const VglowQuality quality)
+{
+    assert (vdraw != NULL);
+    if ((vdraw->phosphor == NULL) && !vdraw_phosphor_enable(vdraw, VMATHNUMBER_C(0.0))) {
+        return false;
+    }
+    if ((vdraw->glow != NULL) && (vdraw->glow->shift == (int)quality)) {
+        return true;
+    }
+    vdraw_glow_disable(vdraw);
+    if (!vglow_init(&vdraw->private_glow, vdraw->width, vdraw->height, quality)) {
+        SDL_Log("vdraw_glow_enable: vglow_init failed");
+        return false;
+    }
+    vdraw->glow = &vdraw->private_glow;
+    return true;
+}
+
+
+// Disable glow.
+void vdraw_glow_disable(VdrawContext * vdraw)
+{
+    assert (vdraw != NULL);
+    if (vdraw->glow != NULL) {
+        vglow_done(vdraw->glow);
+        vdraw->glow = NULL;
+    }
+}
+
+
+// Set the glow blur radius in pixels and strength (0.0 to VGLOW_MAX_STRENGTH).
+void vdraw_set_glow(VdrawContext * vdraw, const int radius, const VmathNumber strength)
+{
+    assert (vdraw != NULL);
+    if (vdraw->glow != NULL) {
+        vglow_set_radius(vdraw->glow, radius);
+        vglow_set_strength(vdraw->glow, strength);
+    }
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Functions.
+//-----------------------------------------------------------------------------
+
+// Initial number of drawing commands recorded per frame.
+#define VDRAW_DIRTY_COMMANDS 256
+
+
+// Enable dirty rectangle tracking.
+bool vdraw_dirty_enable(VdrawContext * vdraw)
+{
+    assert (vdraw != NULL);
+    if (vdraw->backend.renderer == NULL) {
+        SDL_Log("vdraw_dirty_enable: the %s backend does not draw on the SDL renderer", vdraw->backend.name);
+        return false;
+    }
+    if (vdraw->dirty != NULL) {
+        return true;
+    }
+    VdrawDirty * dirty = &vdraw->private_dirty;
+    memset(dirty, 0, sizeof(VdrawDirty));
+    if (!vdirty_init(&dirty->tracker, vdraw->width, vdraw->height)) {
+        SDL_Log("vdraw_dirty_enable: vdirty_init failed");
+        return false;
+    }
+    dirty->commands = malloc(VDRAW_DIRTY_COMMANDS * sizeof(VdrawCommand));
+    dirty->command_capacity = VDRAW_DIRTY_COMMANDS;
+    dirty->background = vdraw->background_colour;
+    dirty->target = SDL_CreateTexture(vdraw->renderer,
+                                      SDL_PIXELFORMAT_ARGB8888,
+                                      SDL_TEXTUREACCESS_TARGET,
+                                      vdraw->width,
+                                      vdraw->height);
+    if ((dirty->commands == NULL) || (dirty->target == NULL)) {
+        SDL_Log("vdraw_dirty_enable: SDL_CreateTexture failed: %s", SDL_GetError());
+        vdraw->dirty = dirty;
+        vdraw_dirty_disable(vdraw);
+        return false;
+    }
+    // Software renderers draw into a surface that keeps its pixels, so only
+    // the dirty rectangles need copying to it.
+    SDL_RendererInfo info;
+    dirty->partial_present = (SDL_GetRendererInfo(vdraw->renderer, &info) == 0)
+                             && ((info.flags & SDL_RENDERER_SOFTWARE) != 0);
+    vdraw->dirty = dirty;
+    return true;
+}
+
+
+// Disable dirty rectangle tracking.
+void vdraw_dirty_disable(VdrawContext * vdraw)
+{
+    assert (vdraw != NULL);
+    VdrawDirty * dirty = vdraw->dirty;
+    if (dirty == NULL) {
+        return;
+    }
+    if (dirty->target != NULL) {
+        SDL_DestroyTexture(dirty->target);
+    }
+    free(dirty->commands);
+    vdirty_done(&dirty->tracker);
+    memset(dirty, 0, sizeof(VdrawDirty));
+    vdraw->dirty = NULL;
+}
+
+
+// Redraw the whole screen on the next flip (e.g. after the window is exposed).
+void vdraw_dirty_invalidate(VdrawContext * vdraw)
+{
+    assert (vdraw != NULL);
+    if (vdraw->dirty != NULL) {
+        vdirty_invalidate(&vdraw->dirty->tracker);
+    }
+}
+
+
+// Get the number of rectangles redrawn by the last flip (0 = nothing presented).
+int vdraw_get_dirty_rect_count(const VdrawContext * vdraw)
+{
+    assert (vdraw != NULL);
+    return (vdraw->dirty != NULL) ? vdraw->dirty->tracker.rect_count : 0;
+}
+
+
+// Mix a number's bits into a hash.
+static inline uint32_t vdraw_hash_number(const uint32_t hash, const VmathNumber number)
+{
+    uint32_t bits;
+    memcpy(&bits, &number, sizeof(bits));
+    return vdirty_hash(hash, bits);
+}
+
+
+// Record a drawing command and add it to the dirty tiles it covers.
+static void vdraw_dirty_record(VdrawContext * vdraw,
+                               const VdrawCommandType type,
+                               const VmathNumber x1, const VmathNumber y1,
+                               const VmathNumber x2, const VmathNumber y2,
+                               const VmathNumber pen_width,
+                               const VdrawRGB * colour1, const VdrawRGB * colour2)
+{
+    VdrawDirty * dirty = vdraw->dirty;
+    if (dirty->command_count == dirty->command_capacity) {
+        VdrawCommand * commands = realloc(dirty->commands, 2 * dirty->command_capacity * sizeof(VdrawCommand));
+        if (commands == NULL) {
+            SDL_Log("vdraw_dirty_record: realloc failed");
+            return;
+        }
+        dirty->commands = commands;
+        dirty->command_capacity *= 2;
+    }
+    VdrawCommand * command = &dirty->commands[dirty->command_count++];
+    command->type = type;
+    command->x1 = x1;
+    command->y1 = y1;
+    command->x2 = x2;
+    command->y2 = y2;
+    command->pen_width = pen_width;
+    command->colour1 = *colour1;
+    command->colour2 = *colour2;
+    // Bounds grown by the pen and a pixel for rounding.
+    const int margin = (int)ceil(pen_width) + 1;
+    command->bounds.x = (int)floor(SDL_min(x1, x2)) - margin;
+    command->bounds.y = (int)floor(SDL_min(y1, y2)) - margin;
+    command->bounds.w = (int)ceil(SDL_max(x1, x2)) + margin + 1 - command->bounds.x;
+    command->bounds.h = (int)ceil(SDL_max(y1, y2)) + margin + 1 - command->bounds.y;
+    uint32_t hash = vdirty_hash(2166136261u, (uint32_t)type);
+    hash = vdraw_hash_number(hash, x1);
+    hash = vdraw_hash_number(hash, y1);
+    hash = vdraw_hash_number(hash, x2);
+    hash = vdraw_hash_number(hash, y2);
+    hash = vdraw_hash_number(hash, command->pen_width);
+    hash = vdirty_hash(hash, ((uint32_t)colour1->red << 16) | ((uint32_t)colour1->green << 8) | colour1->blue);
+    hash = vdirty_hash(hash, ((uint32_t)colour2->red << 16) | ((uint32_t)colour2->green << 8) | colour2->blue);
+    vdirty_add(&dirty->tracker,
+               command->bounds.x, command->bounds.y,
+               command->bounds.x + command->bounds.w - 1, command->bounds.y + command->bounds.h - 1,
+               hash);
+}
+
+
+// Render a recorded drawing command.
+static void vdraw_render_command(const VdrawBackend * backend, const VdrawCommand * command)
+{
+    const SDL_FPoint points[2] = { { command->x1, command->y1 }, { command->x2, command->y2 } };
+    switch (command->type) {
+        case VDRAW_COMMAND_POINT:
+            backend->points(backend->data, points, 1, &command->colour1, command->pen_width);
+            break;
+        case VDRAW_COMMAND_LINE:
+            backend->lines(backend->data, points, 2, &command->colour1, command->pen_width);
+            break;
+        case VDRAW_COMMAND_GRADIENT_LINE: {
+            static const int indices[6] = { 0, 1, 2, 1, 3, 2 };
+            if (backend->geometry == NULL) {
+                backend->lines(backend->data, points, 2, &command->colour1, command->pen_width);
+                break;
+            }
+            const SDL_Color c1 = { command->colour1.red, command->colour1.green, command->colour1.blue, SDL_ALPHA_OPAQUE };
+            const SDL_Color c2 = { command->colour2.red, command->colour2.green, command->colour2.blue, SDL_ALPHA_OPAQUE };
+            SDL_Vertex vertices[4];
+            vdraw_line_quad(vertices, command->x1, command->y1, command->x2, command->y2, command->pen_width, c1, c2);
+            backend->geometry(backend->data, vertices, 4, indices, 6);
+            break;
+        }
+    }
+}
+
+
+// Clear and redraw the dirty rectangles and copy them to the screen.
+// Returns false if nothing changed.
+static bool vdraw_dirty_redraw(VdrawContext * vdraw)
+{
+    VdrawDirty * dirty = vdraw->dirty;
+    const int rect_count = vdirty_end_frame(&dirty->tracker);
+    if (rect_count == 0) {
+        return false;
+    }
+    SDL_Renderer * renderer = vdraw->renderer;
+    SDL_SetRenderTarget(renderer, dirty->target);
+    for (int i = 0;  i < rect_count;  i++) {
+        const SDL_Rect * rect = &dirty->tracker.rects[i];
+        SDL_RenderSetClipRect(renderer, rect);
+        SDL_SetRenderDrawColor(renderer,
+                               dirty->background.red,
+                               dirty->background.green,
+                               dirty->background.blue,
+                               SDL_ALPHA_OPAQUE);
+        SDL_RenderFillRect(renderer, rect);
+        for (int c = 0;  c < dirty->command_count;  c++) {
+            if (SDL_HasIntersection(&dirty->commands[c].bounds, rect)) {
+                vdraw_render_command(&vdraw->backend, &dirty->commands[c]);
+            }
+        }
+    }
+    SDL_RenderSetClipRect(renderer, NULL);
+    SDL_SetRenderTarget(renderer, NULL);
+    if (dirty->partial_present) {
+        for (int i = 0;  i < rect_count;  i++) {
+            SDL_RenderCopy(renderer, dirty->target, &dirty->tracker.rects[i], &dirty->tracker.rects[i]);
+        }
+    } else {
+        SDL_RenderCopy(renderer, dirty->target, NULL, NULL);
+    }
+    return true;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Retained Layer Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise an empty layer.
+void vdraw_layer_init(VdrawLayer * layer)
+{
+    assert (layer != NULL);
+    memset(layer, 0, sizeof(VdrawLayer));
+}
+
+
+// Free the layer's cache.
+static void vdraw_layer_free(const VdrawContext * vdraw, VdrawLayer * layer)
+{
+    if (layer->backend_layer != NULL) {
+        vdraw->backend.layer_destroy(vdraw->backend.data, layer->backend_layer);
+        layer->backend_layer = NULL;
+    }
+    vraster_done(&layer->raster);
+    layer->valid = false;
+}
+
+
+// Clean-up the layer's cache.
+void vdraw_layer_done(VdrawContext * vdraw, VdrawLayer * layer)
+{
+    assert (vdraw != NULL);
+    assert (layer != NULL);
+    assert (!layer->drawing);
+    vdraw_layer_free(vdraw, layer);
+    vdraw_layer_init(layer);
+}
+
+
+// Redraw the layer's content the next time it is used.
+void vdraw_layer_invalidate(VdrawLayer * layer)
+{
+    assert (layer != NULL);
+    layer->valid = false;
+}
+
+
+// Get how the layer can be cached in the current drawing mode.
+static VdrawLayerCache vdraw_layer_cache(const VdrawContext * vdraw)
+{
+    if (vdraw->phosphor != NULL) {
+        return VDRAW_LAYER_PHOSPHOR;
+    }
+    if ((vdraw->dirty == NULL) && (vdraw->backend.layer_create != NULL)) {
+        return VDRAW_LAYER_BACKEND;
+    }
+    return VDRAW_LAYER_DIRECT;
+}
+
+
+// Create the layer's cache for the drawing mode, if it has none.
+static bool vdraw_layer_create(const VdrawContext * vdraw, VdrawLayer * layer, const VdrawLayerCache cache)
+{
+    if ((layer->cache != cache) || (layer->width != vdraw->width) || (layer->height != vdraw->height)) {
+        vdraw_layer_free(vdraw, layer);
+        layer->cache = cache;
+        layer->width = vdraw->width;
+        layer->height = vdraw->height;
+    }
+    if ((cache == VDRAW_LAYER_BACKEND) && (layer->backend_layer == NULL)) {
+        layer->backend_layer = vdraw->backend.layer_create(vdraw->backend.data);
+        return (layer->backend_layer != NULL);
+    }
+    if ((cache == VDRAW_LAYER_PHOSPHOR) && (layer->raster.pixels == NULL)) {
+        return vraster_init(&layer->raster, vdraw->phosphor->width, vdraw->phosphor->height);
+    }
+    return true;
+}
+
+
+// Start using the layer this frame with its content version and view transform
+// (NULL = screen space). Returns true if the content must be drawn now.
+bool vdraw_layer_begin(VdrawContext * vdraw,
+                       VdrawLayer * layer,
+                       const uint64_t version,
+                       const VmathMatrix3x3 view)
+{
+    assert (vdraw != NULL);
+    assert (layer != NULL);
+    assert (!layer->drawing);
+    VdrawLayerCache cache = vdraw_layer_cache(vdraw);
+    const bool same_view = (view == NULL) ? !layer->has_view
+                                          : (layer->has_view && (memcmp(layer->view, view, sizeof(VmathMatrix3x3)) == 0));
+    if (layer->valid && (layer->cache == cache) && (layer->version == version) && same_view
+        && (layer->width == vdraw->width) && (layer->height == vdraw->height)) {
+        return false;
+    }
+    if (!vdraw_layer_create(vdraw, layer, cache)) {
+        SDL_Log("vdraw_layer_begin: creating the layer cache failed; drawing directly");
+        vdraw_layer_free(vdraw, layer);
+        cache = VDRAW_LAYER_DIRECT;
+        layer->cache = cache;
+    }
+    layer->version = version;
+    layer->has_view = (view != NULL);
+    if (view != NULL) {
+        memcpy(layer->view, view, sizeof(VmathMatrix3x3));
+    }
+    layer->drawing = true;
+    layer->redraw_count++;
+    // Drawn directly, the content is never valid for the next frame.
+    layer->valid = (cache != VDRAW_LAYER_DIRECT);
+    if (cache == VDRAW_LAYER_BACKEND) {
+        vdraw->backend.layer_begin(vdraw->backend.data, layer->backend_layer);
+    } else if (cache == VDRAW_LAYER_PHOSPHOR) {
+        vraster_clear(&layer->raster);
+        vraster_set_antialias(&layer->raster, vdraw->phosphor->antialias);
+        layer->phosphor = vdraw->phosphor;
+        vdraw->phosphor = &layer->raster;
+    }
+    return true;
+}
+
+
+// Finish drawing the layer's content, if it was drawn, and composite the layer onto the frame.
+void vdraw_layer_end(VdrawContext * vdraw, VdrawLayer * layer)
+{
+    assert (vdraw != NULL);
+    assert (layer != NULL);
+    if (layer->drawing) {
+        layer->drawing = false;
+        if (layer->cache == VDRAW_LAYER_BACKEND) {
+            vdraw->backend.layer_end(vdraw->backend.data, layer->backend_layer);
+        } else if (layer->cache == VDRAW_LAYER_PHOSPHOR) {
+            vdraw->phosphor = layer->phosphor;
+            layer->phosphor = NULL;
+        }
+    }
+    if (layer->cache == VDRAW_LAYER_BACKEND) {
+        vdraw->backend.layer_draw(vdraw->backend.data, layer->backend_layer);
+    } else if ((layer->cache == VDRAW_LAYER_PHOSPHOR) && (vdraw->phosphor != NULL)) {
+        vraster_add_buffer(vdraw->phosphor, &layer->raster);
+    }
+}
+
+
+// Get the number of times the layer's content has been drawn.
+uint64_t vdraw_layer_get_redraw_count(const VdrawLayer * layer)
+{
+    assert (layer != NULL);
+    return layer->redraw_count;
+}
+
+
+
 //-----------------------------------------------------------------------------
 // Primitive Drawing State Functions.
 //-----------------------------------------------------------------------------
@@ -159,6 +716,19 @@ void vdraw_set_pen_width(VdrawContext * vdraw,
 }
 
 
+// Set whether lines drawn on CPU raster buffers (phosphor persistence and
+// the CPU backend) are antialiased.
+void vdraw_set_antialias(VdrawContext * vdraw, const bool antialias)
+{
+    assert (vdraw != NULL);
+    vdraw->antialias = antialias;
+    if (vdraw->phosphor != NULL) {
+        vraster_set_antialias(vdraw->phosphor, antialias);
+    }
+    vbackend_cpu_set_antialias(&vdraw->backend, antialias);
+}
+
+
 // Set the requested foreground colour.
 void vdraw_set_fg_colour_requested(VdrawContext * vdraw,
                                    const uint8_t red,
@@ -169,6 +739,7 @@ void vdraw_set_fg_colour_requested(VdrawContext * vdraw,
     vdraw->foreground_colour_requested.red = red;
     vdraw->foreground_colour_requested.green = green;
     vdraw->foreground_colour_requested.blue = blue;
+    vdraw_build_intensity_ramp(vdraw);
 }
 
 
@@ -185,9 +756,10 @@ void vdraw_set_fg_colour_intensity(VdrawContext * vdraw,
 void vdraw_upd_fg_colour_from_requested_and_intensity(VdrawContext * vdraw)
 {
     assert (vdraw != NULL);
-    vdraw->foreground_colour.red = vdraw->foreground_colour_requested.red * vdraw->foreground_colour_intensity;
-    vdraw->foreground_colour.green = vdraw->foreground_colour_requested.green * vdraw->foreground_colour_intensity;
-    vdraw->foreground_colour.blue = vdraw->foreground_colour_requested.blue * vdraw->foreground_colour_intensity;
+    const uint32_t rgba = vdraw->foreground_intensity_ramp[vdraw_ramp_index(vdraw->foreground_colour_intensity)];
+    vdraw->foreground_colour.red = VDRAW_RGBA_RED(rgba);
+    vdraw->foreground_colour.green = VDRAW_RGBA_GREEN(rgba);
+    vdraw->foreground_colour.blue = VDRAW_RGBA_BLUE(rgba);
 }
 
 
@@ -201,6 +773,9 @@ void vdraw_set_fg_colour_fade_min(VdrawContext * vdraw,
     vdraw->foreground_colour_fade_min.red = red;
     vdraw->foreground_colour_fade_min.green = green;
     vdraw->foreground_colour_fade_min.blue = blue;
+    vdraw_build_ramp(vdraw->foreground_fade_ramp,
+                     &vdraw->foreground_colour_fade_min,
+                     &vdraw->foreground_colour_fade_max);
 }
 
 
@@ -214,6 +789,9 @@ void vdraw_set_fg_colour_fade_max(VdrawContext * vdraw,
     vdraw->foreground_colour_fade_max.red = red;
     vdraw->foreground_colour_fade_max.green = green;
     vdraw->foreground_colour_fade_max.blue = blue;
+    vdraw_build_ramp(vdraw->foreground_fade_ramp,
+                     &vdraw->foreground_colour_fade_min,
+                     &vdraw->foreground_colour_fade_max);
 }
 
 
@@ -236,15 +814,12 @@ void vdraw_set_fg_colour_fade_val(VdrawContext * vdraw,
 void vdraw_upd_fg_colour_requested_from_fade(VdrawContext * vdraw)
 {
     assert (vdraw != NULL);
-    vdraw->foreground_colour_requested.red =
-            ((vdraw->foreground_colour_fade_max.red - vdraw->foreground_colour_fade_max.red)
-            * vdraw->foreground_colour_fade_val) + vdraw->foreground_colour_fade_max.red;
-    vdraw->foreground_colour_requested.green =
-            ((vdraw->foreground_colour_fade_max.green - vdraw->foreground_colour_fade_max.green)
-            * vdraw->foreground_colour_fade_val) + vdraw->foreground_colour_fade_max.green;
-    vdraw->foreground_colour_requested.blue =
-            ((vdraw->foreground_colour_fade_max.blue - vdraw->foreground_colour_fade_max.blue)
-            * vdraw->foreground_colour_fade_val) + vdraw->foreground_colour_fade_max.blue;
+    const uint32_t rgba = vdraw->foreground_fade_ramp[vdraw_ramp_index(vdraw->foreground_colour_fade_val)];
+    const VdrawRGB requested = { VDRAW_RGBA_RED(rgba), VDRAW_RGBA_GREEN(rgba), VDRAW_RGBA_BLUE(rgba) };
+    if (memcmp(&requested, &vdraw->foreground_colour_requested, sizeof(VdrawRGB)) != 0) {
+        vdraw->foreground_colour_requested = requested;
+        vdraw_build_intensity_ramp(vdraw);
+    }
 }
 
 
@@ -305,61 +880,183 @@ void vdraw_update_fg_colour_intensity_from_wave(VdrawContext * vdraw)
 //-----------------------------------------------------------------------------
 
 // Clear the screen with the current background colour.
-bool vdraw_clear_screen(const VdrawContext * context)
+// With phosphor persistence the screen fades by the decay instead.
+// With dirty rectangles a new frame of drawing commands is started instead.
+bool vdraw_clear_screen(VdrawContext * context)
 {
-    SDL_SetRenderDrawColor(context->renderer,
-                           context->background_colour.red,
-                           context->background_colour.green,
-                           context->background_colour.blue,
-                           SDL_ALPHA_OPAQUE);
-    return !SDL_RenderClear(context->renderer);
+    if (context->backend.begin != NULL) {
+        context->backend.begin(context->backend.data);
+    }
+    if (context->phosphor != NULL) {
+        vraster_decay(context->phosphor);
+        return true;
+    }
+    if (context->dirty != NULL) {
+        VdrawDirty * dirty = context->dirty;
+        if (memcmp(&dirty->background, &context->background_colour, sizeof(VdrawRGB)) != 0) {
+            dirty->background = context->background_colour;
+            vdirty_invalidate(&dirty->tracker);
+        }
+        vdirty_begin_frame(&dirty->tracker);
+        dirty->command_count = 0;
+        return true;
+    }
+    return context->backend.clear(context->backend.data, &context->background_colour);
 }
 
 
 // Draw a point with the foreground colour.
-void vdraw_point(const VdrawContext * vdraw,
+void vdraw_point(VdrawContext * vdraw,
                  const VmathNumber x,
                  const VmathNumber y)
 {
-    SDL_SetRenderDrawColor(vdraw->renderer,
-                           vdraw->foreground_colour.red,
-                           vdraw->foreground_colour.green,
-                           vdraw->foreground_colour.blue,
-                           SDL_ALPHA_OPAQUE);
     const VmathNumber pen_width = vdraw->pen_width;
-    if (pen_width != VMATHNUMBER_C(1.0)) {
-        SDL_Rect rect = { .x = x - (pen_width/2), .y = y - (pen_width/2), pen_width, pen_width};
-        SDL_RenderFillRect(vdraw->renderer, &rect);
-    } else {
-        SDL_RenderDrawPoint(vdraw->renderer, x, y);
+    if (vdraw->phosphor != NULL) {
+        const VdrawRGB * colour = &vdraw->foreground_colour;
+        if (pen_width != VMATHNUMBER_C(1.0)) {
+            vraster_rect(vdraw->phosphor, x - (pen_width/2), y - (pen_width/2), pen_width, pen_width,
+                         colour->red, colour->green, colour->blue);
+        } else {
+            vraster_point(vdraw->phosphor, x, y, colour->red, colour->green, colour->blue);
+        }
+        return;
+    }
+    if (vdraw->dirty != NULL) {
+        vdraw_dirty_record(vdraw, VDRAW_COMMAND_POINT, x, y, x, y, pen_width,
+                           &vdraw->foreground_colour, &vdraw->foreground_colour);
+        return;
     }
+    const SDL_FPoint point = { x, y };
+    vdraw->backend.points(vdraw->backend.data, &point, 1, &vdraw->foreground_colour, pen_width);
 }
 
 
 // Draw a line with the current foreground colour.
-void vdraw_line(const VdrawContext * vdraw,
+void vdraw_line(VdrawContext * vdraw,
                 const VmathNumber x1, const VmathNumber y1,
                 const VmathNumber x2, const VmathNumber y2) {
-    // Order line to always draw to the right and then down.
-    VmathNumber x1b, y1b, x2b, y2b;
-    vdraw_order_line(x1, y1, x2, y2, &x1b, &y1b, &x2b, &y2b);
-    x1b = x1;
-    y1b = y1;
-    x2b = x2;
-    y2b = y2;
-    SDL_SetRenderDrawColor(vdraw->renderer,
-                           vdraw->foreground_colour.red,
-                           vdraw->foreground_colour.green,
-                           vdraw->foreground_colour.blue,
-                           SDL_ALPHA_OPAQUE);
+    // End points keep their sub-pixel positions.
+    const VmathNumber x1b = x1;
+    const VmathNumber y1b = y1;
+    const VmathNumber x2b = x2;
+    const VmathNumber y2b = y2;
     const VmathNumber pen_width = vdraw->pen_width;
-    if (pen_width == VMATHNUMBER_C(1.0)) {
-        SDL_RenderDrawLine(vdraw->renderer, x1b, y1b, x2b, y2b);
-    } else {
-    //FIXME: !!!! pen_width
-        SDL_RenderDrawLine(vdraw->renderer, x1b-1, y1b-1, x2b-1, y2b-1);
-        SDL_RenderDrawLine(vdraw->renderer, x1b, y1b, x2b, y2b);
-        SDL_RenderDrawLine(vdraw->renderer, x1b+1, y1b+1, x2b+1, y2b+1);
+    if (vdraw->phosphor != NULL) {
+        const VdrawRGB * colour = &vdraw->foreground_colour;
+        if (pen_width != VMATHNUMBER_C(1.0)) {
+            vraster_line_wide(vdraw->phosphor, x1b, y1b, x2b, y2b, pen_width, colour->red, colour->green, colour->blue);
+        } else {
+            vraster_line(vdraw->phosphor, x1b, y1b, x2b, y2b, colour->red, colour->green, colour->blue);
+        }
+        return;
+    }
+    if (vdraw->dirty != NULL) {
+        vdraw_dirty_record(vdraw, VDRAW_COMMAND_LINE, x1b, y1b, x2b, y2b, pen_width,
+                           &vdraw->foreground_colour, &vdraw->foreground_colour);
+        return;
+    }
+    const SDL_FPoint points[2] = { { x1b, y1b }, { x2b, y2b } };
+    vdraw->backend.lines(vdraw->backend.data, points, 2, &vdraw->foreground_colour, pen_width);
+}
+
+
+// Draw connected lines through the points with the current foreground colour.
+void vdraw_polyline(VdrawContext * vdraw,
+                    const SDL_FPoint * points,
+                    const int count)
+{
+    assert (vdraw != NULL);
+    assert ((points != NULL) || (count == 0));
+    if ((vdraw->phosphor != NULL) || (vdraw->dirty != NULL)) {
+        for (int i = 1;  i < count;  i++) {
+            vdraw_line(vdraw, points[i - 1].x, points[i - 1].y, points[i].x, points[i].y);
+        }
+        return;
+    }
+    if (count > 1) {
+        vdraw->backend.lines(vdraw->backend.data, points, count, &vdraw->foreground_colour, vdraw->pen_width);
+    }
+}
+
+
+// Draw the points, each with the foreground colour and pen width unless
+// per-point colours or sizes are given.
+void vdraw_points(VdrawContext * vdraw, const VdrawPoints * points)
+{
+    assert (vdraw != NULL);
+    assert (points != NULL);
+    assert ((points->count == 0) || ((points->x != NULL) && (points->y != NULL)));
+    const int stride = (points->stride > 0) ? points->stride : 1;
+    const VmathNumber * x = points->x;
+    const VmathNumber * y = points->y;
+    const VdrawRGB * colours = points->colours;
+    const VmathNumber * sizes = points->sizes;
+    // Phosphor and dirty rectangles draw or record each point.
+    if ((vdraw->phosphor != NULL) || (vdraw->dirty != NULL)) {
+        for (int i = 0;  i < points->count;  i++) {
+            const VdrawRGB * colour = (colours != NULL) ? &colours[i] : &vdraw->foreground_colour;
+            const VmathNumber pen_width = (sizes != NULL) ? sizes[i] : vdraw->pen_width;
+            const VmathNumber px = x[i * stride];
+            const VmathNumber py = y[i * stride];
+            if (vdraw->phosphor == NULL) {
+                vdraw_dirty_record(vdraw, VDRAW_COMMAND_POINT, px, py, px, py, pen_width, colour, colour);
+            } else if (pen_width != VMATHNUMBER_C(1.0)) {
+                vraster_rect(vdraw->phosphor, px - (pen_width/2), py - (pen_width/2), pen_width, pen_width,
+                             colour->red, colour->green, colour->blue);
+            } else {
+                vraster_point(vdraw->phosphor, px, py, colour->red, colour->green, colour->blue);
+            }
+        }
+        return;
+    }
+    // One colour and size: a points call per chunk.
+    if ((colours == NULL) && (sizes == NULL)) {
+        SDL_FPoint chunk[VDRAW_POINTS_CHUNK];
+        for (int first = 0;  first < points->count;  first += VDRAW_POINTS_CHUNK) {
+            const int count = SDL_min(VDRAW_POINTS_CHUNK, points->count - first);
+            for (int i = 0;  i < count;  i++) {
+                chunk[i].x = x[(first + i) * stride];
+                chunk[i].y = y[(first + i) * stride];
+            }
+            vdraw->backend.points(vdraw->backend.data, chunk, count, &vdraw->foreground_colour, vdraw->pen_width);
+        }
+        return;
+    }
+    // Per-point colours or sizes without geometry: a points call per point.
+    if (vdraw->backend.geometry == NULL) {
+        for (int point = 0;  point < points->count;  point++) {
+            const SDL_FPoint position = { (float)x[point * stride], (float)y[point * stride] };
+            vdraw->backend.points(vdraw->backend.data, &position, 1,
+                                  (colours != NULL) ? &colours[point] : &vdraw->foreground_colour,
+                                  (sizes != NULL) ? sizes[point] : vdraw->pen_width);
+        }
+        return;
+    }
+    // Per-point colours or sizes: a geometry call of one quad per point per chunk.
+    SDL_Vertex vertices[VDRAW_POINTS_CHUNK * 4];
+    int indices[VDRAW_POINTS_CHUNK * 6];
+    for (int first = 0;  first < points->count;  first += VDRAW_POINTS_CHUNK) {
+        const int count = SDL_min(VDRAW_POINTS_CHUNK, points->count - first);
+        for (int i = 0;  i < count;  i++) {
+            const int point = first + i;
+            const VdrawRGB * colour = (colours != NULL) ? &colours[point] : &vdraw->foreground_colour;
+            const VmathNumber size = (sizes != NULL) ? sizes[point] : vdraw->pen_width;
+            // A single pixel pen covers the pixel at the point, like a point; wider pens are centred.
+            const float offset = (size == VMATHNUMBER_C(1.0)) ? 0.0f : (float)(size / 2);
+            const float left = (float)x[point * stride] - offset;
+            const float top = (float)y[point * stride] - offset;
+            const SDL_Color color = { colour->red, colour->green, colour->blue, SDL_ALPHA_OPAQUE };
+            SDL_Vertex * vertex = &vertices[i * 4];
+            vertex[0] = (SDL_Vertex){ { left, top }, color, { 0.0f, 0.0f } };
+            vertex[1] = (SDL_Vertex){ { left + size, top }, color, { 0.0f, 0.0f } };
+            vertex[2] = (SDL_Vertex){ { left, top + size }, color, { 0.0f, 0.0f } };
+            vertex[3] = (SDL_Vertex){ { left + size, top + size }, color, { 0.0f, 0.0f } };
+            int * index = &indices[i * 6];
+            const int base = i * 4;
+            index[0] = base;      index[1] = base + 1;  index[2] = base + 2;
+            index[3] = base + 1;  index[4] = base + 3;  index[5] = base + 2;
+        }
+        vdraw->backend.geometry(vdraw->backend.data, vertices, count * 4, indices, count * 6);
     }
 }
 
@@ -367,7 +1064,531 @@ void vdraw_line(const VdrawContext * vdraw,
 // Render all screen drawing since the last call to vdraw_flip().
 void vdraw_flip_screen(VdrawContext * vdraw)
 {
-    SDL_RenderPresent(vdraw->renderer);
+    if (vdraw->phosphor != NULL) {
+        void * pixels;
+        int pitch;
+        if (vdraw->glow != NULL) {
+            vglow_blur(vdraw->glow, vdraw->phosphor);
+        }
+        if (SDL_LockTexture(vdraw->phosphor_texture, NULL, &pixels, &pitch) == 0) {
+            vraster_resolve_decay(vdraw->phosphor, pixels, pitch);
+            if (vdraw->glow != NULL) {
+                vglow_composite(vdraw->glow, pixels, pitch);
+            }
+            SDL_UnlockTexture(vdraw->phosphor_texture);
+        }
+        SDL_RenderCopy(vdraw->renderer, vdraw->phosphor_texture, NULL, NULL);
+    } else if ((vdraw->dirty != NULL) && !vdraw_dirty_redraw(vdraw)) {
+        // Nothing changed; the screen still shows this frame.
+        return;
+    }
+    vdraw->backend.present(vdraw->backend.data);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Frame Capture Functions.
+//-----------------------------------------------------------------------------
+
+// Resolve the raster to packed RGB24 pixels, in a buffer big enough for its ARGB8888 pixels.
+static void vdraw_resolve_rgb24(const VrasterBuffer * raster, uint8_t * pixels)
+{
+    vraster_resolve(raster, pixels, raster->width * (int)sizeof(uint32_t));
+    // Pack in place; each RGB24 pixel ends before the next ARGB8888 pixel starts.
+    const int count = raster->width * raster->height;
+    for (int i = 0;  i < count;  i++) {
+        uint32_t argb;
+        memcpy(&argb, &pixels[i * (int)sizeof(uint32_t)], sizeof(argb));
+        pixels[(i * 3) + 0] = (uint8_t)(argb >> 16);
+        pixels[(i * 3) + 1] = (uint8_t)(argb >> 8);
+        pixels[(i * 3) + 2] = (uint8_t)argb;
+    }
+}
+
+
+// Save the renderer's pixels, or without a renderer the CPU backend's raster buffer,
+// as a binary PPM (P6) image file.
+bool vdraw_save_ppm(const VdrawContext * vdraw, const char * filename)
+{
+    assert (vdraw != NULL);
+    assert (filename != NULL);
+    const VrasterBuffer * raster = NULL;
+    if (vdraw->renderer == NULL) {
+        raster = vbackend_cpu_get_raster(&vdraw->backend);
+        if (raster == NULL) {
+            SDL_Log("vdraw_save_ppm: no SDL renderer or CPU raster buffer to capture");
+            return false;
+        }
+        assert ((raster->width == vdraw->width) && (raster->height == vdraw->height));
+    }
+    const int pitch = vdraw->width * 3;
+    uint8_t * pixels = malloc((size_t)vdraw->width * sizeof(uint32_t) * vdraw->height);
+    if (pixels == NULL) {
+        SDL_Log("vdraw_save_ppm: malloc failed");
+        return false;
+    }
+    if (raster != NULL) {
+        vdraw_resolve_rgb24(raster, pixels);
+    } else if (SDL_RenderReadPixels(vdraw->renderer, NULL, SDL_PIXELFORMAT_RGB24, pixels, pitch) != 0) {
+        SDL_Log("vdraw_save_ppm: SDL_RenderReadPixels failed: %s", SDL_GetError());
+        free(pixels);
+        return false;
+    }
+    FILE * file = fopen(filename, "wb");
+    if (file == NULL) {
+        SDL_Log("vdraw_save_ppm: fopen failed: %s", filename);
+        free(pixels);
+        return false;
+    }
+    const bool saved = (fprintf(file, "P6\n%d %d\n255\n", vdraw->width, vdraw->height) > 0)
+                       && (fwrite(pixels, (size_t)pitch, (size_t)vdraw->height, file) == (size_t)vdraw->height);
+    if (fclose(file) != 0 || !saved) {
+        SDL_Log("vdraw_save_ppm: write failed: %s", filename);
+        free(pixels);
+        return false;
+    }
+    free(pixels);
+    return true;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Line Batch Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a line batch holding up to capacity lines.
+bool vdraw_line_batch_init(VdrawLineBatch * batch, const int capacity)
+{
+    assert (batch != NULL);
+    assert (capacity > 0);
+    memset(batch, 0, sizeof(VdrawLineBatch));
+    batch->capacity = capacity;
+    const size_t padded = (size_t)(capacity + 3) & ~(size_t)3;
+    batch->x1 = calloc(padded, sizeof(VmathNumber));
+    batch->y1 = calloc(padded, sizeof(VmathNumber));
+    batch->x2 = calloc(padded, sizeof(VmathNumber));
+    batch->y2 = calloc(padded, sizeof(VmathNumber));
+    batch->intensity1 = calloc(padded, sizeof(VmathNumber));
+    batch->intensity2 = calloc(padded, sizeof(VmathNumber));
+    batch->vertices = calloc((size_t)capacity * 4, sizeof(SDL_Vertex));
+    batch->indices = calloc((size_t)capacity * 6, sizeof(int));
+    if ((batch->x1 == NULL) || (batch->y1 == NULL) || (batch->x2 == NULL) || (batch->y2 == NULL)
+            || (batch->intensity1 == NULL) || (batch->intensity2 == NULL)
+            || (batch->vertices == NULL) || (batch->indices == NULL)) {
+        vdraw_line_batch_done(batch);
+        return false;
+    }
+    // Two triangles per line quad; the pattern never changes.
+    for (int i = 0;  i < capacity;  i++) {
+        int * index = batch->indices + (i * 6);
+        const int vertex = i * 4;
+        index[0] = vertex;      index[1] = vertex + 1;  index[2] = vertex + 2;
+        index[3] = vertex + 1;  index[4] = vertex + 3;  index[5] = vertex + 2;
+    }
+    return true;
+}
+
+
+// Clean-up the line batch.
+void vdraw_line_batch_done(VdrawLineBatch * batch)
+{
+    assert (batch != NULL);
+    free(batch->x1);
+    free(batch->y1);
+    free(batch->x2);
+    free(batch->y2);
+    free(batch->intensity1);
+    free(batch->intensity2);
+    free(batch->vertices);
+    free(batch->indices);
+    memset(batch, 0, sizeof(VdrawLineBatch));
 }
 
 
+// Remove all lines from the batch.
+void vdraw_line_batch_clear(VdrawLineBatch * batch)
+{
+    assert (batch != NULL);
+    batch->count = 0;
+}
+
+
+// Add a line at full intensity to the batch. Returns false if the batch is full.
+bool vdraw_line_batch_add(VdrawLineBatch * batch,
+                          const VmathNumber x1, const VmathNumber y1,
+                          const VmathNumber x2, const VmathNumber y2)
+{
+    assert (batch != NULL);
+    if (batch->count >= batch->capacity) {
+        return false;
+    }
+    const int i = batch->count++;
+    batch->x1[i] = x1;
+    batch->y1[i] = y1;
+    batch->x2[i] = x2;
+    batch->y2[i] = y2;
+    batch->intensity1[i] = VMATHNUMBER_C(1.0);
+    batch->intensity2[i] = VMATHNUMBER_C(1.0);
+    return true;
+}
+
+
+// Adding then subtracting 1.5 * 2^23 rounds a float of magnitude below 2^22 to an integer.
+#define VDRAW_WAVE_ROUND VMATHNUMBER_C(12582912.0)
+
+// Taylor coefficients of cos(2 * PI * r) in r^2, accurate to 1e-6 for r in [0, 0.25].
+#define VDRAW_WAVE_C1 VMATHNUMBER_C(-19.7392088)
+#define VDRAW_WAVE_C2 VMATHNUMBER_C(64.9393940)
+#define VDRAW_WAVE_C3 VMATHNUMBER_C(-85.4568172)
+#define VDRAW_WAVE_C4 VMATHNUMBER_C(60.2446414)
+#define VDRAW_WAVE_C5 VMATHNUMBER_C(-26.4262568)
+
+
+// Cosine of an angle in revolutions, as 4 lanes by vdraw_wave_cos4() (this is the
+// scalar tail): reduced to [-0.5, 0.5], then folded into [0, 0.25] for the polynomial.
+static inline VmathNumber vdraw_wave_cos(const VmathNumber revs)
+{
+    const VmathNumber r = fabsf(revs - ((revs + VDRAW_WAVE_ROUND) - VDRAW_WAVE_ROUND));
+    const bool fold = (r > VMATHNUMBER_C(0.25));
+    const VmathNumber x = fold ? (VMATHNUMBER_C(0.5) - r) : r;
+    const VmathNumber x2 = x * x;
+    const VmathNumber wave = VMATHNUMBER_C(1.0) + (x2 * (VDRAW_WAVE_C1 + (x2 * (VDRAW_WAVE_C2 + (x2 * (VDRAW_WAVE_C3
+                          + (x2 * (VDRAW_WAVE_C4 + (x2 * VDRAW_WAVE_C5)))))))));
+    return fold ? -wave : wave;
+}
+
+
+#ifdef VDRAW_SSE
+// Cosines of 4 angles in revolutions, as vdraw_wave_cos().
+static inline __m128 vdraw_wave_cos4(const __m128 revs)
+{
+    const __m128 round = _mm_set1_ps(VDRAW_WAVE_ROUND);
+    const __m128 sign = _mm_set1_ps(VMATHNUMBER_C(-0.0));
+    const __m128 r = _mm_andnot_ps(sign, _mm_sub_ps(revs, _mm_sub_ps(_mm_add_ps(revs, round), round)));
+    const __m128 fold = _mm_cmpgt_ps(r, _mm_set1_ps(VMATHNUMBER_C(0.25)));
+    const __m128 x = _mm_or_ps(_mm_and_ps(fold, _mm_sub_ps(_mm_set1_ps(VMATHNUMBER_C(0.5)), r)), _mm_andnot_ps(fold, r));
+    const __m128 x2 = _mm_mul_ps(x, x);
+    __m128 wave = _mm_set1_ps(VDRAW_WAVE_C5);
+    wave = _mm_add_ps(_mm_set1_ps(VDRAW_WAVE_C4), _mm_mul_ps(x2, wave));
+    wave = _mm_add_ps(_mm_set1_ps(VDRAW_WAVE_C3), _mm_mul_ps(x2, wave));
+    wave = _mm_add_ps(_mm_set1_ps(VDRAW_WAVE_C2), _mm_mul_ps(x2, wave));
+    wave = _mm_add_ps(_mm_set1_ps(VDRAW_WAVE_C1), _mm_mul_ps(x2, wave));
+    wave = _mm_add_ps(_mm_set1_ps(VMATHNUMBER_C(1.0)), _mm_mul_ps(x2, wave));
+    // Negate the folded lanes.
+    return _mm_xor_ps(wave, _mm_and_ps(fold, sign));
+}
+#endif
+
+
+// Compute the end point intensities from the line lengths and shimmer wave.
+void vdraw_line_batch_intensity(const VdrawContext * vdraw, VdrawLineBatch * batch)
+{
+    assert (vdraw != NULL);
+    assert (batch != NULL);
+    // Length pass: base intensity = MIN + (1 - MIN) * SHORT / max(length, SHORT).
+    int i = 0;
+#ifdef VDRAW_SSE
+    const __m128 short_length = _mm_set1_ps(VDRAW_BEAM_SHORT_LENGTH);
+    const __m128 min_intensity = _mm_set1_ps(VDRAW_BEAM_MIN_INTENSITY);
+    const __m128 range = _mm_set1_ps(VMATHNUMBER_C(1.0) - VDRAW_BEAM_MIN_INTENSITY);
+    for (;  i < batch->count;  i += 4) {
+        const __m128 dx = _mm_sub_ps(_mm_loadu_ps(batch->x2 + i), _mm_loadu_ps(batch->x1 + i));
+        const __m128 dy = _mm_sub_ps(_mm_loadu_ps(batch->y2 + i), _mm_loadu_ps(batch->y1 + i));
+        const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        const __m128 speed = _mm_div_ps(short_length, _mm_max_ps(length, short_length));
+        const __m128 base = _mm_add_ps(min_intensity, _mm_mul_ps(range, speed));
+        _mm_storeu_ps(batch->intensity1 + i, base);
+        _mm_storeu_ps(batch->intensity2 + i, base);
+    }
+#endif
+    for (;  i < batch->count;  i++) {
+        const VmathNumber dx = batch->x2[i] - batch->x1[i];
+        const VmathNumber dy = batch->y2[i] - batch->y1[i];
+        const VmathNumber length = sqrtf((dx * dx) + (dy * dy));
+        const VmathNumber speed = VDRAW_BEAM_SHORT_LENGTH / SDL_max(length, VDRAW_BEAM_SHORT_LENGTH);
+        batch->intensity1[i] = VDRAW_BEAM_MIN_INTENSITY + ((VMATHNUMBER_C(1.0) - VDRAW_BEAM_MIN_INTENSITY) * speed);
+        batch->intensity2[i] = batch->intensity1[i];
+    }
+    // Wave pass: scale each end point by 1 - size * (1 - cos(angle + phase)) / 2.
+    const VmathNumber size = vdraw->foreground_intensity_wave_size / VMATHNUMBER_C(2.0);
+    if (size == VMATHNUMBER_C(0.0)) {
+        return;
+    }
+    // The angle in revolutions, kept small so that rounding it is exact.
+    const VmathNumber angle = vmath_normalise_mbr(vdraw->foreground_intensity_wave_mbr_angle) / VMATHNUMBER_C(1024.0);
+    const VmathNumber phase = VDRAW_BEAM_WAVE_PHASE / VMATHNUMBER_C(1024.0);
+    i = 0;
+#ifdef VDRAW_SSE
+    const __m128 angle4 = _mm_set1_ps(angle);
+    const __m128 phase4 = _mm_set1_ps(phase);
+    const __m128 size4 = _mm_set1_ps(size);
+    const __m128 one = _mm_set1_ps(VMATHNUMBER_C(1.0));
+    for (;  i < batch->count;  i += 4) {
+        const __m128 revs1 = _mm_add_ps(angle4, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(batch->x1 + i), _mm_loadu_ps(batch->y1 + i)), phase4));
+        const __m128 revs2 = _mm_add_ps(angle4, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(batch->x2 + i), _mm_loadu_ps(batch->y2 + i)), phase4));
+        const __m128 wave1 = vdraw_wave_cos4(revs1);
+        const __m128 wave2 = vdraw_wave_cos4(revs2);
+        _mm_storeu_ps(batch->intensity1 + i, _mm_mul_ps(_mm_loadu_ps(batch->intensity1 + i),
+                                                        _mm_sub_ps(one, _mm_mul_ps(size4, _mm_sub_ps(one, wave1)))));
+        _mm_storeu_ps(batch->intensity2 + i, _mm_mul_ps(_mm_loadu_ps(batch->intensity2 + i),
+                                                        _mm_sub_ps(one, _mm_mul_ps(size4, _mm_sub_ps(one, wave2)))));
+    }
+#endif
+    for (;  i < batch->count;  i++) {
+        const VmathNumber wave1 = vdraw_wave_cos(angle + ((batch->x1[i] + batch->y1[i]) * phase));
+        const VmathNumber wave2 = vdraw_wave_cos(angle + ((batch->x2[i] + batch->y2[i]) * phase));
+        batch->intensity1[i] *= VMATHNUMBER_C(1.0) - (size * (VMATHNUMBER_C(1.0) - wave1));
+        batch->intensity2[i] *= VMATHNUMBER_C(1.0) - (size * (VMATHNUMBER_C(1.0) - wave2));
+    }
+}
+
+
+// Get the requested foreground colour at an intensity.
+static inline SDL_Color vdraw_scale_colour(const VdrawContext * vdraw, const VmathNumber intensity)
+{
+    const uint32_t rgba = vdraw->foreground_intensity_ramp[vdraw_ramp_index(intensity)];
+    const SDL_Color scaled = {
+            .r = VDRAW_RGBA_RED(rgba),
+            .g = VDRAW_RGBA_GREEN(rgba),
+            .b = VDRAW_RGBA_BLUE(rgba),
+            .a = SDL_ALPHA_OPAQUE
+    };
+    return scaled;
+}
+
+
+// Draw the batch with the requested foreground colour scaled by the intensities.
+void vdraw_line_batch(VdrawContext * vdraw, VdrawLineBatch * batch)
+{
+    assert (vdraw != NULL);
+    assert (batch != NULL);
+    if (vdraw->phosphor != NULL) {
+        for (int i = 0;  i < batch->count;  i++) {
+            const SDL_Color c1 = vdraw_scale_colour(vdraw, batch->intensity1[i]);
+            const SDL_Color c2 = vdraw_scale_colour(vdraw, batch->intensity2[i]);
+            vraster_line_gradient(vdraw->phosphor, batch->x1[i], batch->y1[i], batch->x2[i], batch->y2[i],
+                                  c1.r, c1.g, c1.b, c2.r, c2.g, c2.b);
+        }
+        return;
+    }
+    if (vdraw->dirty != NULL) {
+        for (int i = 0;  i < batch->count;  i++) {
+            const SDL_Color c1 = vdraw_scale_colour(vdraw, batch->intensity1[i]);
+            const SDL_Color c2 = vdraw_scale_colour(vdraw, batch->intensity2[i]);
+            const VdrawRGB colour1 = { c1.r, c1.g, c1.b };
+            const VdrawRGB colour2 = { c2.r, c2.g, c2.b };
+            vdraw_dirty_record(vdraw, VDRAW_COMMAND_GRADIENT_LINE,
+                               batch->x1[i], batch->y1[i], batch->x2[i], batch->y2[i],
+                               vdraw->pen_width, &colour1, &colour2);
+        }
+        return;
+    }
+    // Without geometry, each line is a lines call in the colour of its mean intensity.
+    if (vdraw->backend.geometry == NULL) {
+        for (int i = 0;  i < batch->count;  i++) {
+            const SDL_Color c = vdraw_scale_colour(vdraw, (batch->intensity1[i] + batch->intensity2[i]) / VMATHNUMBER_C(2.0));
+            const VdrawRGB colour = { c.r, c.g, c.b };
+            const SDL_FPoint points[2] = { { (float)batch->x1[i], (float)batch->y1[i] },
+                                           { (float)batch->x2[i], (float)batch->y2[i] } };
+            vdraw->backend.lines(vdraw->backend.data, points, 2, &colour, vdraw->pen_width);
+        }
+        return;
+    }
+    // Each line is a quad pen_width wide with a colour per end point.
+    for (int i = 0;  i < batch->count;  i++) {
+        const SDL_Color c1 = vdraw_scale_colour(vdraw, batch->intensity1[i]);
+        const SDL_Color c2 = vdraw_scale_colour(vdraw, batch->intensity2[i]);
+        vdraw_line_quad(batch->vertices + (i * 4),
+                        batch->x1[i], batch->y1[i], batch->x2[i], batch->y2[i],
+                        vdraw->pen_width, c1, c2);
+    }
+    if (batch->count > 0) {
+        vdraw->backend.geometry(vdraw->backend.data, batch->vertices, batch->count * 4, batch->indices, batch->count * 6);
+    }
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Retained Mesh Functions.
+//-----------------------------------------------------------------------------
+
+// Line end point with its position in the lines, for joining equal points.
+typedef struct VdrawMeshEnd {
+    VmathNumber x;
+    VmathNumber y;
+    int index;
+} VdrawMeshEnd;
+
+
+// Order line end points by position.
+static int vdraw_mesh_end_compare(const void * a, const void * b)
+{
+    const VdrawMeshEnd * end_a = a;
+    const VdrawMeshEnd * end_b = b;
+    if (end_a->x != end_b->x) {
+        return (end_a->x < end_b->x) ? -1 : 1;
+    }
+    if (end_a->y != end_b->y) {
+        return (end_a->y < end_b->y) ? -1 : 1;
+    }
+    return end_a->index - end_b->index;
+}
+
+
+// Initialise a mesh from vertices and edges (pairs of vertex indices).
+bool vdraw_mesh_init(VdrawMesh * mesh,
+                     const SDL_FPoint * vertices, const int vertex_count,
+                     const int * edges, const int edge_count)
+{
+    assert (mesh != NULL);
+    assert ((vertices != NULL) || (vertex_count == 0));
+    assert ((edges != NULL) || (edge_count == 0));
+    memset(mesh, 0, sizeof(VdrawMesh));
+    if (edge_count == 0) {
+        return true;
+    }
+    // Each strip has one more vertex than edges, and at most one strip per edge.
+    const size_t capacity = (size_t)edge_count * 2;
+    mesh->vertices = malloc(capacity * sizeof(SDL_FPoint));
+    mesh->points = malloc(capacity * sizeof(SDL_FPoint));
+    mesh->strip_lengths = malloc((size_t)edge_count * sizeof(int));
+    // Edges around each vertex (edge index and other vertex pairs), by vertex.
+    int * first = calloc((size_t)vertex_count + 1, sizeof(int));
+    int * next = malloc((size_t)vertex_count * sizeof(int));
+    int * remaining = calloc((size_t)vertex_count, sizeof(int));
+    int * adjacent = malloc(capacity * 2 * sizeof(int));
+    bool * used = calloc((size_t)edge_count, sizeof(bool));
+    bool ok = (mesh->vertices != NULL) && (mesh->points != NULL) && (mesh->strip_lengths != NULL)
+            && (first != NULL) && (next != NULL) && (remaining != NULL) && (adjacent != NULL) && (used != NULL);
+    if (ok) {
+        for (int i = 0;  i < edge_count * 2;  i++) {
+            assert ((edges[i] >= 0) && (edges[i] < vertex_count));
+            remaining[edges[i]]++;
+        }
+        for (int v = 0;  v < vertex_count;  v++) {
+            first[v + 1] = first[v] + remaining[v];
+            next[v] = first[v];
+        }
+        // Fill each vertex's edges using next[] as the cursor, then rewind it.
+        for (int e = 0;  e < edge_count;  e++) {
+            const int a = edges[e * 2];
+            const int b = edges[e * 2 + 1];
+            adjacent[next[a] * 2] = e;  adjacent[next[a] * 2 + 1] = b;  next[a]++;
+            adjacent[next[b] * 2] = e;  adjacent[next[b] * 2 + 1] = a;  next[b]++;
+        }
+        memcpy(next, first, (size_t)vertex_count * sizeof(int));
+    }
+    if (ok) {
+        // Start strips at odd vertices first so open paths are not broken up,
+        // then walk the remaining closed loops.
+        for (int pass = 0;  pass < 2;  pass++) {
+            for (int v = 0;  v < vertex_count;  v++) {
+                while ((remaining[v] > 0) && ((pass == 1) || ((remaining[v] & 1) != 0))) {
+                    int current = v;
+                    int length = 1;
+                    mesh->vertices[mesh->vertex_count++] = vertices[current];
+                    for (;;) {
+                        while ((next[current] < first[current + 1]) && used[adjacent[next[current] * 2]]) {
+                            next[current]++;
+                        }
+                        if (next[current] == first[current + 1]) {
+                            break;
+                        }
+                        const int edge = adjacent[next[current] * 2];
+                        const int other = adjacent[next[current] * 2 + 1];
+                        used[edge] = true;
+                        remaining[current]--;
+                        remaining[other]--;
+                        current = other;
+                        mesh->vertices[mesh->vertex_count++] = vertices[current];
+                        length++;
+                    }
+                    mesh->strip_lengths[mesh->strip_count++] = length;
+                }
+            }
+        }
+    }
+    free(first);
+    free(next);
+    free(remaining);
+    free(adjacent);
+    free(used);
+    if (!ok) {
+        vdraw_mesh_done(mesh);
+    }
+    return ok;
+}
+
+
+// Initialise a mesh from lines stored as (x1, y1, x2, y2), such as
+// &VedgeLines.lines[0].x1, joining line ends at equal points.
+bool vdraw_mesh_init_lines(VdrawMesh * mesh, const VmathNumber * lines, const int line_count)
+{
+    assert (mesh != NULL);
+    assert ((lines != NULL) || (line_count == 0));
+    if (line_count == 0) {
+        return vdraw_mesh_init(mesh, NULL, 0, NULL, 0);
+    }
+    const int end_count = line_count * 2;
+    VdrawMeshEnd * ends = malloc((size_t)end_count * sizeof(VdrawMeshEnd));
+    SDL_FPoint * vertices = malloc((size_t)end_count * sizeof(SDL_FPoint));
+    int * edges = malloc((size_t)end_count * sizeof(int));
+    bool ok = (ends != NULL) && (vertices != NULL) && (edges != NULL);
+    if (ok) {
+        for (int i = 0;  i < end_count;  i++) {
+            ends[i].x = lines[i * 2];
+            ends[i].y = lines[i * 2 + 1];
+            ends[i].index = i;
+        }
+        qsort(ends, (size_t)end_count, sizeof(VdrawMeshEnd), vdraw_mesh_end_compare);
+        int vertex_count = 0;
+        for (int i = 0;  i < end_count;  i++) {
+            if ((i == 0) || (ends[i].x != ends[i - 1].x) || (ends[i].y != ends[i - 1].y)) {
+                vertices[vertex_count].x = ends[i].x;
+                vertices[vertex_count].y = ends[i].y;
+                vertex_count++;
+            }
+            edges[ends[i].index] = vertex_count - 1;
+        }
+        ok = vdraw_mesh_init(mesh, vertices, vertex_count, edges, line_count);
+    } else {
+        memset(mesh, 0, sizeof(VdrawMesh));
+    }
+    free(ends);
+    free(vertices);
+    free(edges);
+    return ok;
+}
+
+
+// Clean-up the mesh.
+void vdraw_mesh_done(VdrawMesh * mesh)
+{
+    assert (mesh != NULL);
+    free(mesh->vertices);
+    free(mesh->strip_lengths);
+    free(mesh->points);
+    memset(mesh, 0, sizeof(VdrawMesh));
+}
+
+
+// Draw the mesh transformed by the matrix with the current foreground colour.
+// The mesh's points are overwritten, so a mesh is drawn by one thread at a time.
+void vdraw_mesh(VdrawContext * vdraw, VdrawMesh * mesh, const VmathMatrix3x3 transform)
+{
+    assert (vdraw != NULL);
+    assert (mesh != NULL);
+    if (mesh->vertex_count == 0) {
+        return;
+    }
+    // SDL_FPoint is an interleaved (x, y) pair of VmathNumbers.
+    vmath_matrix3x3_multiply_points(transform, &mesh->vertices[0].x, mesh->vertex_count, &mesh->points[0].x);
+    const SDL_FPoint * strip = mesh->points;
+    for (int i = 0;  i < mesh->strip_count;  i++) {
+        vdraw_polyline(vdraw, strip, mesh->strip_lengths[i]);
+        strip += mesh->strip_lengths[i];
+    }
+}
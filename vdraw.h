@@ -28,10 +28,67 @@
 
 #include <SDL.h>
 
+#include <math.h>
 #include <stdint.h>
 #include <stdbool.h>
 
 #include "vmath.h"
+#include "vraster.h"
+#include "vglow.h"
+#include "vdirty.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Primitive Drawing Configuration.
+//-----------------------------------------------------------------------------
+
+// Use SSE kernels where the compiler targets them (define to disable).
+#if defined(__SSE__) && !defined(VDRAW_NO_SIMD)
+#define VDRAW_SSE
+#endif
+
+// Hint (or environment variable) selecting the backend used by vdraw_init():
+// "sdl" (the default), "cpu", "null" or "scope" (oscilloscope XY audio output).
+#define VDRAW_HINT_BACKEND "VDRAW_BACKEND"
+
+// Lines up to this length in pixels are drawn at full beam intensity.
+#ifndef VDRAW_BEAM_SHORT_LENGTH
+#define VDRAW_BEAM_SHORT_LENGTH VMATHNUMBER_C(32.0)
+#endif
+
+// Beam intensity approached by very long (fast) lines.
+#ifndef VDRAW_BEAM_MIN_INTENSITY
+#define VDRAW_BEAM_MIN_INTENSITY VMATHNUMBER_C(0.6)
+#endif
+
+// Shimmer wave phase change in millibit-revolutions per pixel of x + y.
+#ifndef VDRAW_BEAM_WAVE_PHASE
+#define VDRAW_BEAM_WAVE_PHASE VMATHNUMBER_C(0.25)
+#endif
+
+
+
+//-----------------------------------------------------------------------------
+// Primitive Drawing Constants.
+//-----------------------------------------------------------------------------
+
+// Maximum points submitted per backend call by vdraw_points().
+#ifndef VDRAW_POINTS_CHUNK
+#define VDRAW_POINTS_CHUNK 256
+#endif
+
+// Number of entries in a colour ramp (index = value 0.0 to 1.0 * 255).
+#define VDRAW_RAMP_SIZE 256
+
+// Pack a colour as a 32 bit 0xRRGGBBAA (SDL_PIXELFORMAT_RGBA8888) opaque value.
+#define VDRAW_RGBA_PACK(red, green, blue) \
+        (((uint32_t)(red) << 24) | ((uint32_t)(green) << 16) | ((uint32_t)(blue) << 8) | 0xFFu)
+
+// Unpack the red, green and blue components of a packed colour.
+#define VDRAW_RGBA_RED(rgba)   ((uint8_t)((rgba) >> 24))
+#define VDRAW_RGBA_GREEN(rgba) ((uint8_t)((rgba) >> 16))
+#define VDRAW_RGBA_BLUE(rgba)  ((uint8_t)((rgba) >> 8))
 
 
 
@@ -47,10 +104,191 @@ typedef struct VdrawRGB {
 } VdrawRGB;
 
 
+// Drawing backend interface; where the drawing primitives are sent.
+// Lines connect their points in order (as SDL_RenderDrawLines) and geometry
+// is indexed triangles with per vertex colours.
+typedef struct VdrawBackend {
+    // Backend name.
+    const char * name;
+    // Backend state passed to the functions.
+    void * data;
+    // The SDL renderer drawn on directly, or NULL (no renderer effects).
+    SDL_Renderer * renderer;
+    // Output pixel width.
+    int width;
+    // Output pixel height.
+    int height;
+    // Start a frame (NULL = nothing to do).
+    void (*begin)(void * data);
+    // Clear the frame with the colour.
+    bool (*clear)(void * data, const VdrawRGB * colour);
+    // Draw lines through the points.
+    void (*lines)(void * data, const SDL_FPoint * points, const int count,
+                  const VdrawRGB * colour, const VmathNumber pen_width);
+    // Draw the points.
+    void (*points)(void * data, const SDL_FPoint * points, const int count,
+                   const VdrawRGB * colour, const VmathNumber pen_width);
+    // Draw indexed triangles (NULL = not supported; vdraw draws lines
+    // with the lines function and points with the points function instead).
+    void (*geometry)(void * data, const SDL_Vertex * vertices, const int vertex_count,
+                     const int * indices, const int index_count);
+    // Show the frame.
+    void (*present)(void * data);
+    // Clean-up the backend state (NULL = nothing to do).
+    void (*done)(void * data);
+    // Create a retained layer the size of the output, or NULL if failed
+    // (NULL function = no layer support; retained layers are drawn directly).
+    void * (*layer_create)(void * data);
+    // Clear the layer and draw into it instead of the frame.
+    void (*layer_begin)(void * data, void * layer);
+    // Finish drawing into the layer and draw into the frame again.
+    void (*layer_end)(void * data, void * layer);
+    // Composite the layer onto the frame.
+    void (*layer_draw)(void * data, void * layer);
+    // Destroy the layer.
+    void (*layer_destroy)(void * data, void * layer);
+} VdrawBackend;
+
+
+// Batch of lines with per end point beam intensity (access via API functions only).
+// Stored as a structure of arrays, padded to a multiple of four lines.
+typedef struct VdrawLineBatch {
+    // Number of lines in the batch.
+    int count;
+    // Maximum number of lines.
+    int capacity;
+    // Line start and end points.
+    VmathNumber * x1;
+    VmathNumber * y1;
+    VmathNumber * x2;
+    VmathNumber * y2;
+    // Beam intensity at the start and end points (0.0 to 1.0).
+    VmathNumber * intensity1;
+    VmathNumber * intensity2;
+    // Geometry for drawing the batch in a single submission.
+    SDL_Vertex * vertices;
+    int * indices;
+} VdrawLineBatch;
+
+
+// Points for vdraw_points(). Positions are read from x[i * stride] and
+// y[i * stride]: stride 1 for separate x and y arrays, or stride 2 with
+// x = &array[0].x1 and y = &array[0].y1 for a VedgePoint array.
+typedef struct VdrawPoints {
+    // Number of points.
+    int count;
+    // Positions.
+    const VmathNumber * x;
+    const VmathNumber * y;
+    // Elements between consecutive positions (0 is treated as 1).
+    int stride;
+    // Optional per-point colours (NULL = foreground colour).
+    const VdrawRGB * colours;
+    // Optional per-point pen widths (NULL = pen width).
+    const VmathNumber * sizes;
+} VdrawPoints;
+
+
+// Retained line mesh drawn with a transform (access via API functions only).
+// The edges are stored chained into strips of connected lines so each strip
+// is a single backend lines call.
+typedef struct VdrawMesh {
+    // Strip vertices in drawing order, one strip after another.
+    SDL_FPoint * vertices;
+    int vertex_count;
+    // Number of vertices in each strip.
+    int * strip_lengths;
+    int strip_count;
+    // Transformed vertices, reused by each draw.
+    SDL_FPoint * points;
+} VdrawMesh;
+
+
+// Recorded drawing command types.
+typedef enum VdrawCommandType {
+    VDRAW_COMMAND_POINT,
+    VDRAW_COMMAND_LINE,
+    VDRAW_COMMAND_GRADIENT_LINE
+} VdrawCommandType;
+
+
+// Recorded drawing command.
+typedef struct VdrawCommand {
+    VdrawCommandType type;
+    // End points (x1 and y1 only for points).
+    VmathNumber x1;
+    VmathNumber y1;
+    VmathNumber x2;
+    VmathNumber y2;
+    VmathNumber pen_width;
+    // Start and end colours (the same unless a gradient line).
+    VdrawRGB colour1;
+    VdrawRGB colour2;
+    // Pixel bounds covered.
+    SDL_Rect bounds;
+} VdrawCommand;
+
+
+// Dirty rectangle redraw state.
+typedef struct VdrawDirty {
+    // Tile hashes and the dirty rectangles.
+    VdirtyTracker tracker;
+    // This frame's drawing commands, replayed into the dirty rectangles.
+    VdrawCommand * commands;
+    int command_count;
+    int command_capacity;
+    // Background colour this frame was cleared with.
+    VdrawRGB background;
+    // Render target keeping the last frame.
+    SDL_Texture * target;
+    // Does the screen keep its pixels between presents (software renderer)?
+    bool partial_present;
+} VdrawDirty;
+
+
+// How a retained layer is cached.
+typedef enum VdrawLayerCache {
+    // Not cached; the content is drawn every frame.
+    VDRAW_LAYER_DIRECT,
+    // Cached by the backend (render target texture or CPU raster buffer).
+    VDRAW_LAYER_BACKEND,
+    // Cached in a CPU buffer added onto the phosphor buffer.
+    VDRAW_LAYER_PHOSPHOR
+} VdrawLayerCache;
+
+
+// Retained static layer (access via API functions only).
+typedef struct VdrawLayer {
+    // How the layer is cached.
+    VdrawLayerCache cache;
+    // Is the cached content up to date?
+    bool valid;
+    // Is the content being drawn into the cache?
+    bool drawing;
+    // Content version and view transform (if any) the cache was drawn with.
+    uint64_t version;
+    bool has_view;
+    VmathMatrix3x3 view;
+    // Output pixel size the cache was drawn at.
+    int width;
+    int height;
+    // The backend's layer, or NULL.
+    void * backend_layer;
+    // Phosphor persistence layer buffer (no pixels until used).
+    VrasterBuffer raster;
+    // Phosphor buffer restored when the content has been drawn.
+    VrasterBuffer * phosphor;
+    // Number of times the content has been drawn.
+    uint64_t redraw_count;
+} VdrawLayer;
+
+
 // Primitive drawing context (access via API functions only).
 typedef struct VdrawContext {
-    // The SDL renderer;
+    // The SDL renderer (NULL for headless backends);
     SDL_Renderer * renderer;
+    // The backend drawn with.
+    VdrawBackend backend;
     // Renderer pixel width.
     int width;
     // Renderer pixel height.
@@ -60,20 +298,40 @@ typedef struct VdrawContext {
     VdrawRGB foreground_colour;
     // The width of the pen used to draw on the foreground.
     VmathNumber pen_width;
+    // Are lines drawn on CPU raster buffers antialiased?
+    bool antialias;
     // The foreground colour requested and its intensity value.
     // Used to populate foreground_colour.
     VdrawRGB    foreground_colour_requested;
     VmathNumber foreground_colour_intensity;
+    // The requested foreground colour at each intensity, rebuilt when it changes.
+    uint32_t    foreground_intensity_ramp[VDRAW_RAMP_SIZE];
     // Colour graduation fading.
     // Used to populate foreground_colour_requested or foreground_colour.
     VdrawRGB    foreground_colour_fade_min;
     VdrawRGB    foreground_colour_fade_max;
     VmathNumber foreground_colour_fade_val;
+    // The colours from fade_min to fade_max, rebuilt when either changes.
+    uint32_t    foreground_fade_ramp[VDRAW_RAMP_SIZE];
     // Vector display intensity shimmer wave enablement, size, mbr angle and speed;
     // Used to populate foreground_intensity.
     VmathNumber foreground_intensity_wave_size;
     VmathNumber foreground_intensity_wave_mbr_angle;
     VmathNumber foreground_intensity_wave_mbr_speed;
+    // The private phosphor persistence accumulation buffer.
+    VrasterBuffer private_phosphor;
+    // Pointer to the phosphor buffer or NULL (phosphor persistence disabled).
+    VrasterBuffer * phosphor;
+    // Streaming texture the phosphor buffer is resolved into for presenting.
+    SDL_Texture * phosphor_texture;
+    // The private glow (bloom) post-process buffer.
+    VglowBuffer private_glow;
+    // Pointer to the glow buffer or NULL (glow disabled).
+    VglowBuffer * glow;
+    // The private dirty rectangle redraw state.
+    VdrawDirty private_dirty;
+    // Pointer to the dirty rectangle state or NULL (full redraw every frame).
+    VdrawDirty * dirty;
 } VdrawContext;
 
 
@@ -94,15 +352,122 @@ void vdraw_order_line(const VmathNumber x1a, const VmathNumber y1a,
 // Primitive Drawing Life-cycle Functions.
 //-----------------------------------------------------------------------------
 
-// Initialise the drawing context with the SDL renderer.
+// Initialise the drawing context with the SDL renderer, using the backend
+// selected by the VDRAW_HINT_BACKEND hint.
 bool vdraw_init(VdrawContext * vdraw, SDL_Renderer * sdl_renderer);
 
+// Initialise the drawing context with the backend, which it takes ownership of.
+// The SDL renderer, used for presenting and capture, may be NULL if headless.
+bool vdraw_init_backend(VdrawContext * vdraw,
+                        SDL_Renderer * sdl_renderer,
+                        const VdrawBackend * backend);
+
 
 // Clean-up the drawing context.
 void vdraw_done(VdrawContext * vdraw);
 
 
 
+//-----------------------------------------------------------------------------
+// Phosphor Persistence Functions.
+// Lines and points accumulate into a CPU intensity buffer that fades by the
+// decay value each time the screen is cleared and is resolved when flipped.
+// Requires a backend drawing on the SDL renderer.
+//-----------------------------------------------------------------------------
+
+// Enable phosphor persistence with the decay per frame (0.0 to 1.0).
+bool vdraw_phosphor_enable(VdrawContext * vdraw, const VmathNumber decay);
+
+// Disable phosphor persistence.
+void vdraw_phosphor_disable(VdrawContext * vdraw);
+
+// Set the phosphor decay per frame (0.0 = no persistence, 1.0 = no fade).
+void vdraw_set_phosphor_decay(VdrawContext * vdraw, const VmathNumber decay);
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Functions.
+// The CPU intensity buffer is blurred at the glow quality's resolution and
+// added back onto the screen when flipped. Requires the phosphor buffer.
+//-----------------------------------------------------------------------------
+
+// Enable glow at the quality, enabling phosphor persistence (decay 0.0) if needed.
+bool vdraw_glow_enable(VdrawContext * vdraw, const VglowQuality quality);
+
+// Disable glow.
+void vdraw_glow_disable(VdrawContext * vdraw);
+
+// Set the glow blur radius in pixels and strength (0.0 to VGLOW_MAX_STRENGTH).
+void vdraw_set_glow(VdrawContext * vdraw, const int radius, const VmathNumber strength);
+
+
+
+//-----------------------------------------------------------------------------
+// Dirty Rectangle Functions.
+// Drawing is recorded between vdraw_clear_screen() and vdraw_flip_screen();
+// the flip clears and redraws only the tiles whose primitives changed, and
+// skips presenting altogether when nothing changed. Not used while phosphor
+// persistence is enabled, since the whole screen fades every frame.
+// Requires a backend drawing on the SDL renderer.
+//-----------------------------------------------------------------------------
+
+// Enable dirty rectangle tracking.
+bool vdraw_dirty_enable(VdrawContext * vdraw);
+
+// Disable dirty rectangle tracking.
+void vdraw_dirty_disable(VdrawContext * vdraw);
+
+// Redraw the whole screen on the next flip (e.g. after the window is exposed).
+void vdraw_dirty_invalidate(VdrawContext * vdraw);
+
+// Get the number of rectangles redrawn by the last flip (0 = nothing presented).
+int vdraw_get_dirty_rect_count(const VdrawContext * vdraw);
+
+
+
+//-----------------------------------------------------------------------------
+// Retained Layer Functions.
+// Static content (terrain outlines, HUD frames, starfields) is drawn once
+// into a layer cache and composited with a single copy each frame after
+// vdraw_clear_screen(), until its content version, view transform, the
+// output size or the drawing mode changes:
+//
+//     if (vdraw_layer_begin(vdraw, &layer, version, view)) {
+//         ... draw the content ...
+//     }
+//     vdraw_layer_end(vdraw, &layer);
+//
+// Backends drawing on the SDL renderer cache in a render target texture,
+// the CPU backend in a raster buffer and phosphor persistence in a buffer
+// added onto the phosphor buffer. Backends without layer support and dirty
+// rectangle tracking draw the content directly every frame.
+//-----------------------------------------------------------------------------
+
+// Initialise an empty layer.
+void vdraw_layer_init(VdrawLayer * layer);
+
+// Clean-up the layer's cache.
+void vdraw_layer_done(VdrawContext * vdraw, VdrawLayer * layer);
+
+// Redraw the layer's content the next time it is used.
+void vdraw_layer_invalidate(VdrawLayer * layer);
+
+// Start using the layer this frame with its content version and view transform
+// (NULL = screen space). Returns true if the content must be drawn now.
+bool vdraw_layer_begin(VdrawContext * vdraw,
+                       VdrawLayer * layer,
+                       const uint64_t version,
+                       const VmathMatrix3x3 view);
+
+// Finish drawing the layer's content, if it was drawn, and composite the layer onto the frame.
+void vdraw_layer_end(VdrawContext * vdraw, VdrawLayer * layer);
+
+// Get the number of times the layer's content has been drawn.
+uint64_t vdraw_layer_get_redraw_count(const VdrawLayer * layer);
+
+
+
 //-----------------------------------------------------------------------------
 // Primitive Drawing State Functions.
 //-----------------------------------------------------------------------------
@@ -124,6 +489,10 @@ void vdraw_set_fg_colour(VdrawContext * vdraw,
 void vdraw_set_pen_width(VdrawContext * vdraw,
                          const VmathNumber pen_width);
 
+// Set whether lines drawn on CPU raster buffers (phosphor persistence and
+// the CPU backend) are antialiased.
+void vdraw_set_antialias(VdrawContext * vdraw, const bool antialias);
+
 
 // Set the requested foreground colour.
 void vdraw_set_fg_colour_requested(VdrawContext * vdraw,
@@ -184,23 +553,128 @@ void vdraw_update_fg_colour_intensity_from_wave(VdrawContext * vdraw);
 //-----------------------------------------------------------------------------
 
 // Clear the screen with the current background colour.
-bool vdraw_clear_screen(const VdrawContext * vdraw);
+// With phosphor persistence the screen fades by the decay instead.
+// With dirty rectangles a new frame of drawing commands is started instead.
+bool vdraw_clear_screen(VdrawContext * vdraw);
 
 // Draw a point with the foreground colour.
-void vdraw_point(const VdrawContext * vdraw,
+void vdraw_point(VdrawContext * vdraw,
                  const VmathNumber x,
                  const VmathNumber y);
 
+// Draw the points, each with the foreground colour and pen width unless
+// per-point colours or sizes are given.
+void vdraw_points(VdrawContext * vdraw, const VdrawPoints * points);
+
 // Draw a line with the current foreground colour.
-void vdraw_line(const VdrawContext * vdraw,
+void vdraw_line(VdrawContext * vdraw,
                 const VmathNumber x1, const VmathNumber y1,
                 const VmathNumber x2, const VmathNumber y2);
 
+// Draw connected lines through the points with the current foreground colour.
+void vdraw_polyline(VdrawContext * vdraw,
+                    const SDL_FPoint * points,
+                    const int count);
+
 // Render all screen drawing since the last call to vdraw_flip().
 void vdraw_flip_screen(VdrawContext * vdraw);
 
 
 
+//-----------------------------------------------------------------------------
+// Frame Capture Functions.
+// Offscreen (software surface) renderers keep the frame after flipping;
+// windowed renderers should be captured before vdraw_flip_screen().
+//-----------------------------------------------------------------------------
+
+// Save the renderer's pixels, or without a renderer the CPU backend's raster buffer,
+// as a binary PPM (P6) image file.
+bool vdraw_save_ppm(const VdrawContext * vdraw, const char * filename);
+
+
+
+//-----------------------------------------------------------------------------
+// Line Batch Functions.
+// Short lines are brighter (a slower beam) and the shimmer wave varies
+// along the screen, so each line end point carries its own intensity.
+//-----------------------------------------------------------------------------
+
+// Initialise a line batch holding up to capacity lines.
+bool vdraw_line_batch_init(VdrawLineBatch * batch, const int capacity);
+
+// Clean-up the line batch.
+void vdraw_line_batch_done(VdrawLineBatch * batch);
+
+// Remove all lines from the batch.
+void vdraw_line_batch_clear(VdrawLineBatch * batch);
+
+// Add a line at full intensity to the batch. Returns false if the batch is full.
+bool vdraw_line_batch_add(VdrawLineBatch * batch,
+                          const VmathNumber x1, const VmathNumber y1,
+                          const VmathNumber x2, const VmathNumber y2);
+
+// Compute the end point intensities from the line lengths and shimmer wave.
+void vdraw_line_batch_intensity(const VdrawContext * vdraw, VdrawLineBatch * batch);
+
+// Draw the batch with the requested foreground colour scaled by the intensities.
+void vdraw_line_batch(VdrawContext * vdraw, VdrawLineBatch * batch);
+
+
+
+//-----------------------------------------------------------------------------
+// Retained Mesh Functions.
+// A shape's lines are chained into strips once, then each draw is a single
+// batched transform of the vertices and one lines call per strip.
+//-----------------------------------------------------------------------------
+
+// Initialise a mesh from vertices and edges (pairs of vertex indices).
+bool vdraw_mesh_init(VdrawMesh * mesh,
+                     const SDL_FPoint * vertices, const int vertex_count,
+                     const int * edges, const int edge_count);
+
+// Initialise a mesh from lines stored as (x1, y1, x2, y2), such as
+// &VedgeLines.lines[0].x1, joining line ends at equal points.
+bool vdraw_mesh_init_lines(VdrawMesh * mesh, const VmathNumber * lines, const int line_count);
+
+// Clean-up the mesh.
+void vdraw_mesh_done(VdrawMesh * mesh);
+
+// Draw the mesh transformed by the matrix with the current foreground colour.
+// The mesh's points are overwritten, so a mesh is drawn by one thread at a time.
+void vdraw_mesh(VdrawContext * vdraw, VdrawMesh * mesh, const VmathMatrix3x3 transform);
+
+
+
+//-----------------------------------------------------------------------------
+// Vector Draw Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Set the four vertices of a line quad pen_width wide, coloured per end point
+// (triangles 0, 1, 2 and 1, 3, 2).
+static inline void vdraw_line_quad(SDL_Vertex * vertex,
+                                   const VmathNumber x1, const VmathNumber y1,
+                                   const VmathNumber x2, const VmathNumber y2,
+                                   const VmathNumber pen_width,
+                                   const SDL_Color c1, const SDL_Color c2)
+{
+    const VmathNumber half_width = SDL_max(pen_width, VMATHNUMBER_C(1.0)) / VMATHNUMBER_C(2.0);
+    const VmathNumber dx = x2 - x1;
+    const VmathNumber dy = y2 - y1;
+    const VmathNumber length = sqrt((dx * dx) + (dy * dy));
+    VmathNumber nx = VMATHNUMBER_C(0.0);
+    VmathNumber ny = half_width;
+    if (length > VMATHNUMBER_C(0.0)) {
+        nx = (-dy / length) * half_width;
+        ny = (dx / length) * half_width;
+    }
+    vertex[0].position.x = x1 + nx;  vertex[0].position.y = y1 + ny;  vertex[0].color = c1;
+    vertex[1].position.x = x1 - nx;  vertex[1].position.y = y1 - ny;  vertex[1].color = c1;
+    vertex[2].position.x = x2 + nx;  vertex[2].position.y = y2 + ny;  vertex[2].color = c2;
+    vertex[3].position.x = x2 - nx;  vertex[3].position.y = y2 - ny;  vertex[3].color = c2;
+}
+
+
+
 #endif /* __VDRAW__H__ */
 
 
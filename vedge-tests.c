@@ -24,6 +24,7 @@
 
 // API under test.
 #include "vedge.h"
+#include "vstore.h"
 
 
 // CTest configuration.
@@ -78,6 +79,624 @@ CTEST(vedge, test_vedge_stuff) {
 
 
 
+//-----------------------------------------------------------------------------
+// Test Main Loop.
+//-----------------------------------------------------------------------------
+
+// Main loop callback counts.
+typedef struct TestVedgeRun {
+    int updates;
+    int renders;
+} TestVedgeRun;
+
+
+// Count the update and quit after 5 ticks.
+static void test_vedge_run_update(VedgeContext * vedge, void * data, const VmathNumber tick_seconds)
+{
+    TestVedgeRun * run = data;
+    ASSERT_DBL_NEAR_TOL(0.001, tick_seconds, 1e-6);
+    if (++run->updates == 5) {
+        vedge_quit(vedge);
+    }
+}
+
+
+// Count the render.
+static void test_vedge_run_render(VedgeContext * vedge, void * data, const VmathNumber alpha)
+{
+    TestVedgeRun * run = data;
+    ASSERT_NOT_NULL(vedge_get_vdraw(vedge));
+    ASSERT_TRUE((alpha >= VMATHNUMBER_C(0.0)) && (alpha < VMATHNUMBER_C(1.0)));
+    run->renders++;
+}
+
+
+CTEST(vedge, test_vedge_run_fixed_timestep) {
+    Sdl2BootConfig sdl2boot_config;
+    Sdl2BootContext sdl2boot = { 0 };
+    VedgeConfig vedge_config;
+    VedgeContext vedge;
+    TestVedgeRun run = { 0 };
+    sdl2boot_config_offscreen(&sdl2boot_config, 320, 240);
+    ASSERT_TRUE(sdl2boot_init(&sdl2boot, &sdl2boot_config));
+    vedge_config_sdl2boot(&vedge_config, &sdl2boot);
+    ASSERT_EQUAL(VEDGE_TICK_RATE, vedge_config.tick_rate);
+    vedge_config.tick_rate = 1000;
+    vedge_config.frame_rate = 500;
+    vedge_config.update_callback = test_vedge_run_update;
+    vedge_config.render_callback = test_vedge_run_render;
+    vedge_config.callback_data = &run;
+    ASSERT_TRUE(vedge_init(&vedge, &vedge_config));
+    ASSERT_EQUAL(0, vedge_run(&vedge));
+    // Paced at 2ms per frame, 5 ticks of 1ms take about 3 frames.
+    ASSERT_EQUAL(5, run.updates);
+    ASSERT_TRUE(run.renders >= 2);
+    ASSERT_TRUE(run.renders <= 5);
+    const VloopStats * stats = vedge_get_loop_stats(&vedge);
+    ASSERT_EQUAL(run.renders, stats->frames);
+    ASSERT_TRUE(stats->ticks >= 5);
+    vedge_done(&vedge);
+    sdl2boot_done(&sdl2boot);
+}
+
+
+// Threaded main loop state, checked on the main thread once the loop finishes.
+typedef struct TestVedgeRunThreaded {
+    int updates;
+    int renders;
+    bool main_thread_rendered;
+    int snapshot_lines;
+    VedgeGameObject object;
+    VedgeLine line;
+    SDL_threadID main_thread;
+    int keys;
+    bool main_thread_handled;
+} TestVedgeRunThreaded;
+
+
+// Count the key event, which must be handled with the updates on the simulation thread.
+static void test_vedge_run_threaded_key(VedgeContext * vedge, SDL_KeyboardEvent * key)
+{
+    TestVedgeRunThreaded * run = vedge->config.callback_data;
+    (void)key;
+    run->main_thread_handled |= (SDL_ThreadID() == run->main_thread);
+    run->keys++;
+}
+
+
+// Once the key has been handled, count the update and quit after 5 ticks.
+static void test_vedge_run_threaded_update(VedgeContext * vedge, void * data, const VmathNumber tick_seconds)
+{
+    TestVedgeRunThreaded * run = data;
+    (void)tick_seconds;
+    if (run->keys == 0) {
+        return;
+    }
+    if (++run->updates == 5) {
+        vedge_quit(vedge);
+    }
+}
+
+
+// Build a frame of the game object into the snapshot.
+static void test_vedge_run_threaded_render(VedgeContext * vedge, void * data, const VmathNumber alpha)
+{
+    TestVedgeRunThreaded * run = data;
+    (void)alpha;
+    run->main_thread_rendered |= (SDL_ThreadID() == run->main_thread);
+    vedge_frame_start(vedge);
+    vedge_frame_add_game_object(vedge, &run->object);
+    vedge_frame_finish(vedge);
+    run->snapshot_lines = vedge->state.frame.snapshot->line_count;
+    run->renders++;
+}
+
+
+CTEST(vedge, test_vedge_run_threaded) {
+    Sdl2BootConfig sdl2boot_config;
+    Sdl2BootContext sdl2boot = { 0 };
+    VedgeConfig vedge_config;
+    VedgeContext vedge;
+    TestVedgeRunThreaded run = { 0 };
+    run.line = (VedgeLine){ 10, 10, 20, 20 };
+    run.object.enable = true;
+    vmath_matrix3x3_set_identity(run.object.position);
+    vmath_matrix3x3_set_identity(run.object.rotation);
+    vmath_matrix3x3_set_identity(run.object.scaling);
+    run.object.items = malloc(sizeof(VedgeGameObjectItems) + sizeof(VedgeGameItem));
+    run.object.items->length = 1;
+    run.object.items->game_items[0] = (VedgeGameItem){ .type = LINE, .game_item.line = &run.line };
+    run.main_thread = SDL_ThreadID();
+    sdl2boot_config_offscreen(&sdl2boot_config, 320, 240);
+    ASSERT_TRUE(sdl2boot_init(&sdl2boot, &sdl2boot_config));
+    vedge_config_sdl2boot(&vedge_config, &sdl2boot);
+    ASSERT_FALSE(vedge_config.threaded);
+    vedge_config.tick_rate = 1000;
+    vedge_config.frame_rate = 500;
+    vedge_config.update_callback = test_vedge_run_threaded_update;
+    vedge_config.render_callback = test_vedge_run_threaded_render;
+    vedge_config.callback_data = &run;
+    vedge_config.threaded = true;
+    ASSERT_TRUE(vedge_init(&vedge, &vedge_config));
+    vedge.event_handlers.key_handler = test_vedge_run_threaded_key;
+    SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+    SDL_Event key = { .type = SDL_KEYDOWN };
+    ASSERT_EQUAL(1, SDL_PushEvent(&key));
+    ASSERT_EQUAL(0, vedge_run(&vedge));
+    // The callbacks ran on the simulation thread, building snapshots the main thread drew.
+    ASSERT_EQUAL(5, run.updates);
+    ASSERT_TRUE(run.renders >= 1);
+    ASSERT_TRUE(run.renders <= 5);
+    ASSERT_FALSE(run.main_thread_rendered);
+    ASSERT_EQUAL(1, run.keys);
+    ASSERT_FALSE(run.main_thread_handled);
+    ASSERT_EQUAL(1, run.snapshot_lines);
+    ASSERT_NULL(vedge.state.frame.snapshot);
+    ASSERT_TRUE(vedge_get_loop_stats(&vedge)->frames >= 1);
+    free(run.object.items);
+    vedge_done(&vedge);
+    sdl2boot_done(&sdl2boot);
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// Test Scene Traversal.
+//-----------------------------------------------------------------------------
+
+// Initialise an enabled game object translated by (tx, ty) and scaled by scale.
+static void test_vedge_game_object(VedgeGameObject * object,
+                                   const VmathNumber tx, const VmathNumber ty, const VmathNumber scale)
+{
+    memset(object, 0, sizeof(VedgeGameObject));
+    vmath_matrix3x3_set_translation(object->position, tx, ty);
+    vmath_matrix3x3_set_identity(object->rotation);
+    vmath_matrix3x3_set_scaling(object->scaling, scale, scale);
+    object->enable = true;
+}
+
+
+// Initialise vEdge on an offscreen renderer.
+static void test_vedge_open(Sdl2BootContext * sdl2boot, VedgeContext * vedge)
+{
+    Sdl2BootConfig sdl2boot_config;
+    VedgeConfig vedge_config;
+    sdl2boot_config_offscreen(&sdl2boot_config, 320, 240);
+    ASSERT_TRUE(sdl2boot_init(sdl2boot, &sdl2boot_config));
+    vedge_config_sdl2boot(&vedge_config, sdl2boot);
+    ASSERT_TRUE(vedge_init(vedge, &vedge_config));
+}
+
+
+CTEST(vedge, test_vedge_frame_add_game_object) {
+    Sdl2BootContext sdl2boot = { 0 };
+    VedgeContext vedge;
+    test_vedge_open(&sdl2boot, &vedge);
+    // Root moved to (100, 50); a child scaled by 2 with a line and two points,
+    // and a disabled child whose line must not be drawn.
+    VedgeGameObject root;
+    VedgeGameObject child;
+    VedgeGameObject hidden;
+    test_vedge_game_object(&root, VMATHNUMBER_C(100.0), VMATHNUMBER_C(50.0), VMATHNUMBER_C(1.0));
+    test_vedge_game_object(&child, VMATHNUMBER_C(0.0), VMATHNUMBER_C(0.0), VMATHNUMBER_C(2.0));
+    test_vedge_game_object(&hidden, VMATHNUMBER_C(0.0), VMATHNUMBER_C(0.0), VMATHNUMBER_C(1.0));
+    hidden.enable = false;
+    VedgeLine line = { 1, 2, 3, 4 };
+    VedgePoints * points = malloc(sizeof(VedgePoints) + 2 * sizeof(VedgePoint));
+    points->length = 2;
+    points->points[0] = (VedgePoint){ 5, 6 };
+    points->points[1] = (VedgePoint){ 7, 8 };
+    child.items = malloc(sizeof(VedgeGameObjectItems) + 2 * sizeof(VedgeGameItem));
+    child.items->length = 2;
+    child.items->game_items[0] = (VedgeGameItem){ .type = LINE, .game_item.line = &line };
+    child.items->game_items[1] = (VedgeGameItem){ .type = POINTS, .game_item.points = points };
+    hidden.items = malloc(sizeof(VedgeGameObjectItems) + sizeof(VedgeGameItem));
+    hidden.items->length = 1;
+    hidden.items->game_items[0] = (VedgeGameItem){ .type = LINE, .game_item.line = &line };
+    root.children = malloc(sizeof(VedgeGameObjectChildren) + 2 * sizeof(VedgeGameObject *));
+    root.children->length = 2;
+    root.children->game_objects[0] = &hidden;
+    root.children->game_objects[1] = &child;
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &root);
+    const VedgeFrame * frame = &vedge.state.frame;
+    ASSERT_EQUAL(1, frame->lines.count);
+    ASSERT_DBL_NEAR_TOL(102.0, frame->lines.x1[0], 1e-4);
+    ASSERT_DBL_NEAR_TOL(54.0, frame->lines.y1[0], 1e-4);
+    ASSERT_DBL_NEAR_TOL(106.0, frame->lines.x2[0], 1e-4);
+    ASSERT_DBL_NEAR_TOL(58.0, frame->lines.y2[0], 1e-4);
+    ASSERT_EQUAL(2, frame->point_count);
+    ASSERT_DBL_NEAR_TOL(114.0, frame->points[2], 1e-4);
+    ASSERT_DBL_NEAR_TOL(66.0, frame->points[3], 1e-4);
+    vedge_frame_finish(&vedge);
+    ASSERT_EQUAL(0, frame->lines.count);
+    ASSERT_EQUAL(0, frame->point_count);
+    // Disabling the root skips the whole scene.
+    root.enable = false;
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &root);
+    ASSERT_EQUAL(0, frame->lines.count);
+    free(root.children);
+    free(hidden.items);
+    free(child.items);
+    free(points);
+    vedge_done(&vedge);
+    sdl2boot_done(&sdl2boot);
+}
+
+
+CTEST(vedge, test_vedge_frame_add_game_object_path) {
+    Sdl2BootContext sdl2boot = { 0 };
+    VedgeContext vedge;
+    test_vedge_open(&sdl2boot, &vedge);
+    VedgeGameObject object;
+    test_vedge_game_object(&object, VMATHNUMBER_C(10.0), VMATHNUMBER_C(20.0), VMATHNUMBER_C(1.0));
+    VedgePath * path = malloc(sizeof(VedgePath) + 3 * sizeof(VedgePoint));
+    path->closed = true;
+    path->points.length = 3;
+    path->points.points[0] = (VedgePoint){ 0, 0 };
+    path->points.points[1] = (VedgePoint){ 4, 0 };
+    path->points.points[2] = (VedgePoint){ 0, 4 };
+    object.items = malloc(sizeof(VedgeGameObjectItems) + sizeof(VedgeGameItem));
+    object.items->length = 1;
+    object.items->game_items[0] = (VedgeGameItem){ .type = LINEPATH, .game_item.path = path };
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &object);
+    const VedgeFrame * frame = &vedge.state.frame;
+    ASSERT_EQUAL(3, frame->lines.count);
+    ASSERT_DBL_NEAR_TOL(14.0, frame->lines.x2[0], 1e-4);
+    ASSERT_DBL_NEAR_TOL(10.0, frame->lines.x2[2], 1e-4);
+    ASSERT_DBL_NEAR_TOL(20.0, frame->lines.y2[2], 1e-4);
+    path->closed = false;
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &object);
+    ASSERT_EQUAL(2, frame->lines.count);
+    free(object.items);
+    free(path);
+    vedge_done(&vedge);
+    sdl2boot_done(&sdl2boot);
+}
+
+
+CTEST(vedge, test_vedge_frame_add_game_object_deep) {
+    Sdl2BootContext sdl2boot = { 0 };
+    VedgeContext vedge;
+    test_vedge_open(&sdl2boot, &vedge);
+    // A chain far deeper than the initial stacks, each link moving a hundredth of a pixel right.
+    const int depth = 20000;
+    VedgeGameObject * chain = malloc((size_t)depth * sizeof(VedgeGameObject));
+    VedgeGameObjectChildren * links = malloc((size_t)depth * (sizeof(VedgeGameObjectChildren) + sizeof(VedgeGameObject *)));
+    for (int i = 0;  i < depth;  i++) {
+        test_vedge_game_object(&chain[i], VMATHNUMBER_C(0.01), VMATHNUMBER_C(0.0), VMATHNUMBER_C(1.0));
+        if (i + 1 < depth) {
+            VedgeGameObjectChildren * link = (VedgeGameObjectChildren *)((char *)links
+                    + (size_t)i * (sizeof(VedgeGameObjectChildren) + sizeof(VedgeGameObject *)));
+            link->length = 1;
+            link->game_objects[0] = &chain[i + 1];
+            chain[i].children = link;
+        }
+    }
+    VedgePoint point = { 0, 0 };
+    chain[depth - 1].items = malloc(sizeof(VedgeGameObjectItems) + sizeof(VedgeGameItem));
+    chain[depth - 1].items->length = 1;
+    chain[depth - 1].items->game_items[0] = (VedgeGameItem){ .type = POINT, .game_item.point = &point };
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &chain[0]);
+    ASSERT_EQUAL(1, vedge.state.frame.point_count);
+    ASSERT_DBL_NEAR_TOL(depth * 0.01, vedge.state.frame.points[0], 0.1);
+    free(chain[depth - 1].items);
+    free(links);
+    free(chain);
+    vedge_done(&vedge);
+    sdl2boot_done(&sdl2boot);
+}
+
+
+CTEST(vedge, test_vedge_frame_add_game_object_cached) {
+    Sdl2BootContext sdl2boot = { 0 };
+    VedgeContext vedge;
+    test_vedge_open(&sdl2boot, &vedge);
+    VedgeGameObject root;
+    VedgeGameObject child;
+    test_vedge_game_object(&root, VMATHNUMBER_C(10.0), VMATHNUMBER_C(0.0), VMATHNUMBER_C(1.0));
+    test_vedge_game_object(&child, VMATHNUMBER_C(1.0), VMATHNUMBER_C(0.0), VMATHNUMBER_C(1.0));
+    root.children = malloc(sizeof(VedgeGameObjectChildren) + sizeof(VedgeGameObject *));
+    root.children->length = 1;
+    root.children->game_objects[0] = &child;
+    VedgePoint point = { 0, 0 };
+    child.items = malloc(sizeof(VedgeGameObjectItems) + sizeof(VedgeGameItem));
+    child.items->length = 1;
+    child.items->game_items[0] = (VedgeGameItem){ .type = POINT, .game_item.point = &point };
+    const VedgeFrame * frame = &vedge.state.frame;
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &root);
+    ASSERT_EQUAL(2, frame->world_updates);
+    // A static scene costs no transforms.
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &root);
+    ASSERT_EQUAL(0, frame->world_updates);
+    // A child change recomputes the child only; a root change the whole tree.
+    vmath_matrix3x3_set_translation(child.position, VMATHNUMBER_C(2.0), VMATHNUMBER_C(0.0));
+    vedge_game_object_changed(&child);
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &root);
+    ASSERT_EQUAL(1, frame->world_updates);
+    ASSERT_DBL_NEAR_TOL(12.0, child.world[0][2], 1e-6);
+    vmath_matrix3x3_set_translation(root.position, VMATHNUMBER_C(20.0), VMATHNUMBER_C(0.0));
+    vedge_game_object_changed(&root);
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &root);
+    ASSERT_EQUAL(2, frame->world_updates);
+    ASSERT_DBL_NEAR_TOL(22.0, child.world[0][2], 1e-6);
+    // Moving the child to another root at the same world version recomputes it there.
+    VedgeGameObject other;
+    test_vedge_game_object(&other, VMATHNUMBER_C(50.0), VMATHNUMBER_C(0.0), VMATHNUMBER_C(1.0));
+    for (int i = 0;  i < 2;  i++) {
+        vedge_game_object_changed(&other);
+        vedge_frame_start(&vedge);
+        vedge_frame_add_game_object(&vedge, &other);
+    }
+    ASSERT_EQUAL(root.world_version, other.world_version);
+    other.children = root.children;
+    root.children = NULL;
+    vedge_game_object_bounds_changed(&other);
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &other);
+    ASSERT_EQUAL(1, frame->world_updates);
+    ASSERT_DBL_NEAR_TOL(52.0, child.world[0][2], 1e-6);
+    free(child.items);
+    free(other.children);
+    vedge_done(&vedge);
+    sdl2boot_done(&sdl2boot);
+}
+
+
+CTEST(vedge, test_vedge_frame_add_game_object_culled) {
+    Sdl2BootContext sdl2boot = { 0 };
+    VedgeContext vedge;
+    test_vedge_open(&sdl2boot, &vedge);
+    // A level with a ship on screen and a rock off screen, each a unit line.
+    VedgeGameObject level;
+    VedgeGameObject ship;
+    VedgeGameObject rock;
+    test_vedge_game_object(&level, VMATHNUMBER_C(0.0), VMATHNUMBER_C(0.0), VMATHNUMBER_C(1.0));
+    test_vedge_game_object(&ship, VMATHNUMBER_C(100.0), VMATHNUMBER_C(100.0), VMATHNUMBER_C(1.0));
+    test_vedge_game_object(&rock, VMATHNUMBER_C(1000.0), VMATHNUMBER_C(100.0), VMATHNUMBER_C(1.0));
+    VedgeLine line = { 0, 0, 1, 0 };
+    VedgeGameObjectItems * ship_items = malloc(sizeof(VedgeGameObjectItems) + sizeof(VedgeGameItem));
+    VedgeGameObjectItems * rock_items = malloc(sizeof(VedgeGameObjectItems) + sizeof(VedgeGameItem));
+    ship_items->length = 1;
+    ship_items->game_items[0] = (VedgeGameItem){ .type = LINE, .game_item.line = &line };
+    rock_items->length = 1;
+    rock_items->game_items[0] = (VedgeGameItem){ .type = LINE, .game_item.line = &line };
+    ship.items = ship_items;
+    rock.items = rock_items;
+    level.children = malloc(sizeof(VedgeGameObjectChildren) + 2 * sizeof(VedgeGameObject *));
+    level.children->length = 2;
+    level.children->game_objects[0] = &ship;
+    level.children->game_objects[1] = &rock;
+    const VedgeFrame * frame = &vedge.state.frame;
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &level);
+    ASSERT_EQUAL(1, frame->lines.count);
+    ASSERT_EQUAL(1, frame->culled);
+    ASSERT_TRUE(level.bounds_valid);
+    ASSERT_DBL_NEAR_TOL(1001.0, level.bounds.max_x, 1e-4);
+    ASSERT_TRUE(&level == rock.parent);
+    // Scrolling the whole level off screen skips it at the root.
+    vmath_matrix3x3_set_translation(level.position, VMATHNUMBER_C(-2000.0), VMATHNUMBER_C(0.0));
+    vedge_game_object_changed(&level);
+    ASSERT_TRUE(level.bounds_valid);
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &level);
+    ASSERT_EQUAL(0, frame->lines.count);
+    ASSERT_EQUAL(1, frame->culled);
+    ASSERT_EQUAL(1, frame->world_updates);
+    // Moving the rock updates the level's bounds; scrolling brings it on screen.
+    vmath_matrix3x3_set_translation(rock.position, VMATHNUMBER_C(2100.0), VMATHNUMBER_C(100.0));
+    vedge_game_object_changed(&rock);
+    ASSERT_FALSE(level.bounds_valid);
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &level);
+    ASSERT_EQUAL(1, frame->lines.count);
+    ASSERT_DBL_NEAR_TOL(100.0, frame->lines.x1[0], 1e-4);
+    // Changed item data is picked up once noted.
+    line.x2 = 2500;
+    vedge_game_object_bounds_changed(&ship);
+    vedge_frame_start(&vedge);
+    vedge_frame_add_game_object(&vedge, &level);
+    ASSERT_EQUAL(2, frame->lines.count);
+    free(level.children);
+    free(rock_items);
+    free(ship_items);
+    vedge_done(&vedge);
+    sdl2boot_done(&sdl2boot);
+}
+
+
+CTEST(vedge, test_vedge_frame_add_store) {
+    Sdl2BootContext sdl2boot = { 0 };
+    VedgeContext vedge;
+    VstoreStore store;
+    test_vedge_open(&sdl2boot, &vedge);
+    ASSERT_TRUE(vstore_init(&store, 16));
+    const int root = vstore_create(&store, VSTORE_NONE);
+    const int child = vstore_create(&store, root);
+    const int hidden = vstore_create(&store, root);
+    VmathMatrix3x3 translation;
+    vmath_matrix3x3_set_translation(translation, VMATHNUMBER_C(10.0), VMATHNUMBER_C(20.0));
+    vstore_set_local(&store, root, translation);
+    VedgeLine line = { 1, 2, 3, 4 };
+    const VedgeGameItem item = { .type = LINE, .game_item.line = &line };
+    ASSERT_TRUE(vstore_set_items(&store, child, &item, 1));
+    ASSERT_TRUE(vstore_set_items(&store, hidden, &item, 1));
+    vstore_set_enable(&store, hidden, false);
+    vstore_update_world(&store);
+    vedge_frame_start(&vedge);
+    vedge_frame_add_store(&vedge, &store);
+    ASSERT_EQUAL(1, vedge.state.frame.lines.count);
+    ASSERT_DBL_NEAR_TOL(11.0, vedge.state.frame.lines.x1[0], 1e-4);
+    ASSERT_DBL_NEAR_TOL(24.0, vedge.state.frame.lines.y2[0], 1e-4);
+    vstore_done(&store);
+    vedge_done(&vedge);
+    sdl2boot_done(&sdl2boot);
+}
+
+
+CTEST(vedge, test_vedge_frame_add_store_jobs) {
+    Sdl2BootContext sdl2boot = { 0 };
+    VedgeContext vedge;
+    VstoreStore store;
+    test_vedge_open(&sdl2boot, &vedge);
+    // A row of 1000 triangles one pixel apart, over several jobs; those right
+    // of the 320 pixel wide screen are culled.
+    ASSERT_TRUE(vstore_init(&store, 16));
+    VedgePath * path = malloc(sizeof(VedgePath) + 3 * sizeof(VedgePoint));
+    path->closed = true;
+    path->points.length = 3;
+    path->points.points[0] = (VedgePoint){ 0, 0 };
+    path->points.points[1] = (VedgePoint){ 1, 0 };
+    path->points.points[2] = (VedgePoint){ 0, 1 };
+    const VedgeGameItem item = { .type = LINEPATH, .game_item.path = path };
+    VmathMatrix3x3 translation;
+    for (int i = 0;  i < 1000;  i++) {
+        const int id = vstore_create(&store, VSTORE_NONE);
+        vmath_matrix3x3_set_translation(translation, (VmathNumber)i, VMATHNUMBER_C(10.0));
+        vstore_set_local(&store, id, translation);
+        ASSERT_TRUE(vstore_set_items(&store, id, &item, 1));
+    }
+    vstore_update_world(&store);
+    vedge_frame_start(&vedge);
+    vedge_frame_add_store(&vedge, &store);
+    const VedgeFrame * frame = &vedge.state.frame;
+    const int visible = 320 + (int)VEDGE_FRAME_CULL_MARGIN + 1;
+    ASSERT_EQUAL(1000 - visible, frame->culled);
+    ASSERT_EQUAL(visible * 3, frame->lines.count);
+    // In entity order, each path's lines joined end to end.
+    for (int i = 0;  i < visible;  i++) {
+        ASSERT_DBL_NEAR_TOL((double)i, frame->lines.x1[i * 3], 1e-4);
+        ASSERT_DBL_NEAR_TOL(10.0, frame->lines.y1[i * 3], 1e-4);
+        ASSERT_DBL_NEAR_TOL((double)i + 1.0, frame->lines.x2[i * 3], 1e-4);
+        ASSERT_DBL_NEAR_TOL((double)i + 1.0, frame->lines.x1[(i * 3) + 1], 1e-4);
+        ASSERT_DBL_NEAR_TOL(11.0, frame->lines.y2[(i * 3) + 1], 1e-4);
+        ASSERT_DBL_NEAR_TOL(11.0, frame->lines.y1[(i * 3) + 2], 1e-4);
+        ASSERT_DBL_NEAR_TOL((double)i, frame->lines.x2[(i * 3) + 2], 1e-4);
+        ASSERT_DBL_NEAR_TOL(10.0, frame->lines.y2[(i * 3) + 2], 1e-4);
+    }
+    free(path);
+    vstore_done(&store);
+    vedge_done(&vedge);
+    sdl2boot_done(&sdl2boot);
+}
+
+
+// Events seen by the test event handlers.
+typedef struct TestVedgeEvents {
+    int keys;
+    int commons;
+    int users;
+    int quits;
+    Uint32 last_user;
+} TestVedgeEvents;
+
+static TestVedgeEvents test_vedge_events;
+
+
+// Count the key event.
+static void test_vedge_key_handler(VedgeContext * vedge, SDL_KeyboardEvent * key)
+{
+    (void)vedge;
+    (void)key;
+    test_vedge_events.keys++;
+}
+
+
+// Count the common event.
+static void test_vedge_common_handler(VedgeContext * vedge, SDL_CommonEvent * common)
+{
+    (void)vedge;
+    (void)common;
+    test_vedge_events.commons++;
+}
+
+
+// Count the user event and remember its type.
+static void test_vedge_user_handler(VedgeContext * vedge, SDL_UserEvent * user)
+{
+    (void)vedge;
+    test_vedge_events.users++;
+    test_vedge_events.last_user = user->type;
+}
+
+
+// Count the quit event.
+static void test_vedge_quit_handler(VedgeContext * vedge, SDL_QuitEvent * quit)
+{
+    (void)vedge;
+    (void)quit;
+    test_vedge_events.quits++;
+}
+
+
+// Push an event of the type onto the SDL event queue.
+static void test_vedge_push_event(const Uint32 type)
+{
+    SDL_Event event;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    ASSERT_EQUAL(1, SDL_PushEvent(&event));
+}
+
+
+CTEST(vedge, test_vedge_handle_events) {
+    Sdl2BootContext sdl2boot = { 0 };
+    VedgeContext vedge;
+    VedgeEventHandlers handlers = { 0 };
+    test_vedge_open(&sdl2boot, &vedge);
+    SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+    memset(&test_vedge_events, 0, sizeof(test_vedge_events));
+    handlers.key_handler = test_vedge_key_handler;
+    handlers.common_handler = test_vedge_common_handler;
+    handlers.user_handler = test_vedge_user_handler;
+    handlers.quit_handler = test_vedge_quit_handler;
+    vedge_set_event_handlers(&vedge, &handlers);
+    // Keys, lifecycle and user events reach their handlers; unhandled types are dropped.
+    test_vedge_push_event(SDL_KEYDOWN);
+    test_vedge_push_event(SDL_KEYUP);
+    test_vedge_push_event(SDL_APP_TERMINATING);
+    test_vedge_push_event(SDL_MOUSEMOTION);
+    test_vedge_push_event(SDL_USEREVENT + 3);
+    test_vedge_push_event(SDL_QUIT);
+    vedge.state.quit = false;
+    ASSERT_EQUAL(6, vedge_handle_events(&vedge));
+    ASSERT_EQUAL(2, test_vedge_events.keys);
+    ASSERT_EQUAL(1, test_vedge_events.commons);
+    ASSERT_EQUAL(1, test_vedge_events.users);
+    ASSERT_EQUAL(SDL_USEREVENT + 3, test_vedge_events.last_user);
+    ASSERT_EQUAL(1, test_vedge_events.quits);
+    ASSERT_TRUE(vedge.state.quit);
+    // A flood is handled VEDGE_EVENTS_PER_FRAME at a time, the rest left queued.
+    const int flood = VEDGE_EVENTS_PER_FRAME + VEDGE_EVENT_BATCH / 2;
+    for (int i = 0;  i < flood;  i++) {
+        test_vedge_push_event(SDL_KEYDOWN);
+    }
+    ASSERT_EQUAL(VEDGE_EVENTS_PER_FRAME, vedge_handle_events(&vedge));
+    ASSERT_EQUAL(2 + VEDGE_EVENTS_PER_FRAME, test_vedge_events.keys);
+    ASSERT_EQUAL(flood - VEDGE_EVENTS_PER_FRAME, vedge_handle_events(&vedge));
+    ASSERT_EQUAL(2 + flood, test_vedge_events.keys);
+    ASSERT_EQUAL(0, vedge_handle_events(&vedge));
+    // Removing a handler removes its table entry.
+    handlers.key_handler = NULL;
+    vedge_set_event_handlers(&vedge, &handlers);
+    test_vedge_push_event(SDL_KEYDOWN);
+    ASSERT_EQUAL(1, vedge_handle_events(&vedge));
+    ASSERT_EQUAL(2 + flood, test_vedge_events.keys);
+    vedge_done(&vedge);
+    sdl2boot_done(&sdl2boot);
+}
+
+
 //-----------------------------------------------------------------------------
 // Main Application Entry Point./.
 //-----------------------------------------------------------------------------
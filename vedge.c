@@ -24,7 +24,10 @@
 
 
 #include <assert.h>
+#include <stdlib.h>
 #include "vedge.h"
+#include "vjobs.h"
+#include "vstore.h"
 
 
 
@@ -63,7 +66,8 @@ const char * vedge_error_messages[] = {
 
 // The default template initialisation config..
 const VedgeConfig vedge_config_default = {
-        0
+        .tick_rate = VEDGE_TICK_RATE,
+        .frame_rate = VEDGE_FRAME_RATE
 };
 
 
@@ -85,7 +89,6 @@ static void vedge_init_config_sdl(VedgeConfig * vedge_config,
                            SDL_Renderer * sdl_renderer)
 {
     assert (vedge_config != NULL);
-    assert (sdl_window != NULL);
     assert (sdl_renderer != NULL);
     vedge_config_template(vedge_config, NULL);
     vedge_config->sdl_window = sdl_window = sdl_window;
@@ -107,6 +110,40 @@ void vedge_config_sdl2boot(VedgeConfig * vedge_config,
 // Lifecycle Management Functions.
 //-----------------------------------------------------------------------------
 
+// Initialise the frame buffer and the scene traversal stacks.
+static bool vedge_frame_init(VedgeFrame * frame)
+{
+    assert (frame != NULL);
+    memset(frame, 0, sizeof(VedgeFrame));
+    frame->points = malloc(VEDGE_FRAME_POINTS * 2 * sizeof(VmathNumber));
+    frame->vertices = malloc(VEDGE_FRAME_POINTS * 2 * sizeof(VmathNumber));
+    frame->nodes = malloc(VEDGE_FRAME_STACK * sizeof(VedgeFrameNode));
+    frame->node_capacity = VEDGE_FRAME_STACK;
+    frame->bounds_nodes = malloc(VEDGE_FRAME_STACK * sizeof(VedgeFrameBoundsNode));
+    frame->bounds_capacity = VEDGE_FRAME_STACK;
+    return vdraw_line_batch_init(&frame->lines, VEDGE_FRAME_LINES)
+            && (frame->points != NULL) && (frame->vertices != NULL)
+            && (frame->nodes != NULL) && (frame->bounds_nodes != NULL);
+}
+
+
+// Clean-up the frame buffer and the scene traversal stacks.
+static void vedge_frame_done(VedgeFrame * frame)
+{
+    assert (frame != NULL);
+    vdraw_line_batch_done(&frame->lines);
+    free(frame->points);
+    free(frame->vertices);
+    free(frame->nodes);
+    free(frame->bounds_nodes);
+    for (int i = 0;  i < frame->store_job_capacity;  i++) {
+        vsnap_frame_done(&frame->store_jobs[i]);
+    }
+    free(frame->store_jobs);
+    memset(frame, 0, sizeof(VedgeFrame));
+}
+
+
 // Initialise the engine and the initial sub-systems.
 bool vedge_init(VedgeContext * vedge, const VedgeConfig * vedge_config)
 {
@@ -119,6 +156,14 @@ bool vedge_init(VedgeContext * vedge, const VedgeConfig * vedge_config)
     // Initialise vmath.
     vmath_init();
     vedge->state.vmath_initialised = 1;
+    // Initialise the worker threads (one per extra CPU core).
+    vedge->state.vjobs_initialised = vjobs_init(-1);
+    // Initialise the frame buffer.
+    if (!vedge_frame_init(&vedge->state.frame)) {
+        SDL_Log("vedge_init: frame buffer allocation failed");
+        vedge_done(vedge);
+        return false;
+    }
     // Set up initial open config.
     vdraw_init(&vedge->state.private_vdraw_context, vedge->config.sdl_renderer);//FIXME: bring in line with other code.
     vedge->state.vdraw_context = &vedge->state.private_vdraw_context;
@@ -136,11 +181,23 @@ bool vedge_init(VedgeContext * vedge, const VedgeConfig * vedge_config)
 void vedge_done(VedgeContext * vedge)
 {
     assert (vedge != NULL);
+    // Close the vdraw context.
+    if (vedge->state.vdraw_context != NULL) {
+        vdraw_done(vedge->state.vdraw_context);
+        vedge->state.vdraw_context = NULL;
+    }
     // Close the vmath.
     if (vedge->state.vmath_initialised) {
         vmath_done();
         vedge->state.vmath_initialised = 0;
     }
+    // Free the frame buffer.
+    vedge_frame_done(&vedge->state.frame);
+    // Close the worker threads.
+    if (vedge->state.vjobs_initialised) {
+        vjobs_done();
+        vedge->state.vjobs_initialised = false;
+    }
 //    // Shutdown SDL and its sub-systems.
 //    if (vedge->init_state.init_subsystems) {
 //        SDL_Quit();
@@ -156,146 +213,247 @@ void vedge_done(VedgeContext * vedge)
 
 
 
+// Define the event dispatch table entry calling the named handler with its event type.
+#define VEDGE_EVENT_DISPATCH(handler, type) \
+    static void vedge_dispatch_##handler(VedgeContext * vedge, SDL_Event * event) \
+    { \
+        vedge->event_handlers.handler(vedge, (type *)event); \
+    }
+
+VEDGE_EVENT_DISPATCH(common_handler, SDL_CommonEvent)
+VEDGE_EVENT_DISPATCH(window_handler, SDL_WindowEvent)
+VEDGE_EVENT_DISPATCH(key_handler, SDL_KeyboardEvent)
+VEDGE_EVENT_DISPATCH(edit_handler, SDL_TextEditingEvent)
+VEDGE_EVENT_DISPATCH(text_handler, SDL_TextInputEvent)
+VEDGE_EVENT_DISPATCH(motion_handler, SDL_MouseMotionEvent)
+VEDGE_EVENT_DISPATCH(button_handler, SDL_MouseButtonEvent)
+VEDGE_EVENT_DISPATCH(wheel_handler, SDL_MouseWheelEvent)
+VEDGE_EVENT_DISPATCH(jaxis_handler, SDL_JoyAxisEvent)
+VEDGE_EVENT_DISPATCH(jball_handler, SDL_JoyBallEvent)
+VEDGE_EVENT_DISPATCH(jhat_handler, SDL_JoyHatEvent)
+VEDGE_EVENT_DISPATCH(jbutton_handler, SDL_JoyButtonEvent)
+VEDGE_EVENT_DISPATCH(jdevice_handler, SDL_JoyDeviceEvent)
+VEDGE_EVENT_DISPATCH(caxis_handler, SDL_ControllerAxisEvent)
+VEDGE_EVENT_DISPATCH(cbutton_handler, SDL_ControllerButtonEvent)
+VEDGE_EVENT_DISPATCH(cdevice_handler, SDL_ControllerDeviceEvent)
+VEDGE_EVENT_DISPATCH(adevice_handler, SDL_AudioDeviceEvent)
+VEDGE_EVENT_DISPATCH(quit_handler, SDL_QuitEvent)
+VEDGE_EVENT_DISPATCH(user_handler, SDL_UserEvent)
+VEDGE_EVENT_DISPATCH(syswm_handler, SDL_SysWMEvent)
+VEDGE_EVENT_DISPATCH(tfinger_handler, SDL_TouchFingerEvent)
+VEDGE_EVENT_DISPATCH(mgesture_handler, SDL_MultiGestureEvent)
+VEDGE_EVENT_DISPATCH(dgesture_handler, SDL_DollarGestureEvent)
+VEDGE_EVENT_DISPATCH(drop_handler, SDL_DropEvent)
+
+
+// Event dispatch table slot of each SDL event type below SDL_USEREVENT
+// (VEDGE_EVENT_NONE for types without a handler or beyond the table).
+#define VEDGE_EVENT_TYPES (SDL_RENDER_DEVICE_RESET + 1)
+
+static const uint8_t vedge_event_slots[VEDGE_EVENT_TYPES] = {
+    [SDL_QUIT] = VEDGE_EVENT_QUIT,
+    [SDL_APP_TERMINATING] = VEDGE_EVENT_COMMON,
+    [SDL_APP_LOWMEMORY] = VEDGE_EVENT_COMMON,
+    [SDL_APP_WILLENTERBACKGROUND] = VEDGE_EVENT_COMMON,
+    [SDL_APP_DIDENTERBACKGROUND] = VEDGE_EVENT_COMMON,
+    [SDL_APP_WILLENTERFOREGROUND] = VEDGE_EVENT_COMMON,
+    [SDL_APP_DIDENTERFOREGROUND] = VEDGE_EVENT_COMMON,
+    [SDL_WINDOWEVENT] = VEDGE_EVENT_WINDOW,
+    [SDL_SYSWMEVENT] = VEDGE_EVENT_SYSWM,
+    [SDL_KEYDOWN] = VEDGE_EVENT_KEY,
+    [SDL_KEYUP] = VEDGE_EVENT_KEY,
+    [SDL_TEXTEDITING] = VEDGE_EVENT_EDIT,
+    [SDL_TEXTINPUT] = VEDGE_EVENT_TEXT,
+    [SDL_KEYMAPCHANGED] = VEDGE_EVENT_COMMON,
+    [SDL_MOUSEMOTION] = VEDGE_EVENT_MOTION,
+    [SDL_MOUSEBUTTONDOWN] = VEDGE_EVENT_BUTTON,
+    [SDL_MOUSEBUTTONUP] = VEDGE_EVENT_BUTTON,
+    [SDL_MOUSEWHEEL] = VEDGE_EVENT_WHEEL,
+    [SDL_JOYAXISMOTION] = VEDGE_EVENT_JAXIS,
+    [SDL_JOYBALLMOTION] = VEDGE_EVENT_JBALL,
+    [SDL_JOYHATMOTION] = VEDGE_EVENT_JHAT,
+    [SDL_JOYBUTTONDOWN] = VEDGE_EVENT_JBUTTON,
+    [SDL_JOYBUTTONUP] = VEDGE_EVENT_JBUTTON,
+    [SDL_JOYDEVICEADDED] = VEDGE_EVENT_JDEVICE,
+    [SDL_JOYDEVICEREMOVED] = VEDGE_EVENT_JDEVICE,
+    [SDL_CONTROLLERAXISMOTION] = VEDGE_EVENT_CAXIS,
+    [SDL_CONTROLLERBUTTONDOWN] = VEDGE_EVENT_CBUTTON,
+    [SDL_CONTROLLERBUTTONUP] = VEDGE_EVENT_CBUTTON,
+    [SDL_CONTROLLERDEVICEADDED] = VEDGE_EVENT_CDEVICE,
+    [SDL_CONTROLLERDEVICEREMOVED] = VEDGE_EVENT_CDEVICE,
+    [SDL_CONTROLLERDEVICEREMAPPED] = VEDGE_EVENT_CDEVICE,
+    [SDL_FINGERDOWN] = VEDGE_EVENT_TFINGER,
+    [SDL_FINGERUP] = VEDGE_EVENT_TFINGER,
+    [SDL_FINGERMOTION] = VEDGE_EVENT_TFINGER,
+    [SDL_DOLLARGESTURE] = VEDGE_EVENT_DGESTURE,
+    [SDL_DOLLARRECORD] = VEDGE_EVENT_DGESTURE,
+    [SDL_MULTIGESTURE] = VEDGE_EVENT_MGESTURE,
+    [SDL_CLIPBOARDUPDATE] = VEDGE_EVENT_COMMON,
+    [SDL_DROPFILE] = VEDGE_EVENT_DROP,
+    [SDL_DROPTEXT] = VEDGE_EVENT_DROP,
+    [SDL_DROPBEGIN] = VEDGE_EVENT_DROP,
+    [SDL_DROPCOMPLETE] = VEDGE_EVENT_DROP,
+    [SDL_AUDIODEVICEADDED] = VEDGE_EVENT_ADEVICE,
+    [SDL_AUDIODEVICEREMOVED] = VEDGE_EVENT_ADEVICE,
+    [SDL_RENDER_TARGETS_RESET] = VEDGE_EVENT_COMMON,
+    [SDL_RENDER_DEVICE_RESET] = VEDGE_EVENT_COMMON
+};
+
+
+// Rebuild the event dispatch table from the event handlers.
+static void vedge_build_event_dispatch(VedgeContext * vedge)
+{
+    const VedgeEventHandlers * handlers = &vedge->event_handlers;
+    vedge_event_dispatch * dispatch = vedge->state.event_dispatch;
+#define VEDGE_EVENT_SLOT(slot, handler) \
+    dispatch[slot] = (handlers->handler != NULL) ? vedge_dispatch_##handler : NULL
+    dispatch[VEDGE_EVENT_NONE] = NULL;
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_COMMON, common_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_WINDOW, window_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_KEY, key_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_EDIT, edit_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_TEXT, text_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_MOTION, motion_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_BUTTON, button_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_WHEEL, wheel_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_JAXIS, jaxis_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_JBALL, jball_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_JHAT, jhat_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_JBUTTON, jbutton_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_JDEVICE, jdevice_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_CAXIS, caxis_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_CBUTTON, cbutton_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_CDEVICE, cdevice_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_ADEVICE, adevice_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_QUIT, quit_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_USER, user_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_SYSWM, syswm_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_TFINGER, tfinger_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_MGESTURE, mgesture_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_DGESTURE, dgesture_handler);
+    VEDGE_EVENT_SLOT(VEDGE_EVENT_DROP, drop_handler);
+#undef VEDGE_EVENT_SLOT
+}
+
+
+// Set the event handlers and rebuild the event dispatch table from them.
+void vedge_set_event_handlers(VedgeContext * vedge, const VedgeEventHandlers * handlers)
+{
+    assert (vedge != NULL);
+    assert (handlers != NULL);
+    if (handlers != &vedge->event_handlers) {
+        memcpy(&vedge->event_handlers, handlers, sizeof(VedgeEventHandlers));
+    }
+    vedge_build_event_dispatch(vedge);
+}
+
+
+// Dispatch an event to its handler, if any.
 void vedge_handle_event(VedgeContext * vedge, SDL_Event * event)
 {
     assert (vedge != NULL);
     assert (event != NULL);
-    VedgeEventHandlers * handlers = &vedge->event_handlers;
-    switch (event->type)
-    {
-        case SDL_FIRSTEVENT:
-            break;
-        case SDL_QUIT:
-            if (handlers->quit_handler != NULL) {
-                handlers->quit_handler(vedge, (SDL_QuitEvent *)event);
-            }
-            break;
-        SDL_APP_TERMINATING:
-            break;
-        case SDL_APP_LOWMEMORY:
-//            if (handlers->handler != NULL) {
-//                handlers->quit_handler(vedge, (SDL_QuitEvent *)event);
-//            }
-            break;
-        case SDL_APP_WILLENTERBACKGROUND:
-            break;
-        case SDL_APP_DIDENTERBACKGROUND:
-            break;
-        case SDL_APP_WILLENTERFOREGROUND:
-            break;
-        case  SDL_APP_DIDENTERFOREGROUND:
-            break;
-        case   SDL_WINDOWEVENT:
-            if (handlers->window_handler != NULL) {
-                handlers->window_handler(vedge, (SDL_WindowEvent *)event);
-            }
-            break;
-        case SDL_SYSWMEVENT:
-            break;
-        case SDL_KEYDOWN:
-            if (handlers->key_handler != NULL) {
-                handlers->key_handler(vedge, (SDL_KeyboardEvent *)event);
-            }
-            break;
-        case SDL_KEYUP:
-            if (handlers->key_handler != NULL) {
-                handlers->key_handler(vedge, (SDL_KeyboardEvent *)event);
+    const Uint32 type = event->type;
+    const int slot = (type >= SDL_USEREVENT) ? VEDGE_EVENT_USER
+                   : (type < VEDGE_EVENT_TYPES) ? vedge_event_slots[type] : VEDGE_EVENT_NONE;
+    const vedge_event_dispatch dispatch = vedge->state.event_dispatch[slot];
+    if (dispatch != NULL) {
+        dispatch(vedge, event);
+    }
+}
+
+
+// Write the events to the queue (producer). The caller checks there is space.
+static void vedge_event_queue_write(VedgeEventQueue * queue, const SDL_Event * events, const int count)
+{
+    const unsigned int head = (unsigned int)SDL_AtomicGet(&queue->head);
+    for (int i = 0;  i < count;  i++) {
+        queue->events[(head + (unsigned int)i) & (VEDGE_EVENT_QUEUE - 1)] = events[i];
+    }
+    // Publish the events before the new head.
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&queue->head, (int)(head + (unsigned int)count));
+}
+
+
+// Get the number of events the queue has room for (producer).
+static int vedge_event_queue_space(VedgeEventQueue * queue)
+{
+    const unsigned int head = (unsigned int)SDL_AtomicGet(&queue->head);
+    const unsigned int tail = (unsigned int)SDL_AtomicGet(&queue->tail);
+    // The consumer has finished with the events before tail.
+    SDL_MemoryBarrierAcquire();
+    return VEDGE_EVENT_QUEUE - (int)(head - tail);
+}
+
+
+// Read up to count events from the queue (consumer). Returns the number read.
+static int vedge_event_queue_read(VedgeEventQueue * queue, SDL_Event * events, const int count)
+{
+    const unsigned int tail = (unsigned int)SDL_AtomicGet(&queue->tail);
+    const unsigned int head = (unsigned int)SDL_AtomicGet(&queue->head);
+    // The producer's events before head are visible.
+    SDL_MemoryBarrierAcquire();
+    const int read = SDL_min(count, (int)(head - tail));
+    for (int i = 0;  i < read;  i++) {
+        events[i] = queue->events[(tail + (unsigned int)i) & (VEDGE_EVENT_QUEUE - 1)];
+    }
+    // Finish with the events before releasing their slots.
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&queue->tail, (int)(tail + (unsigned int)read));
+    return read;
+}
+
+
+// Drain pending events in batches, up to VEDGE_EVENTS_PER_FRAME, and dispatch them,
+// or write them to the queue (not NULL) for the simulation thread to dispatch.
+// SDL_QUIT also asks the main loop to quit. Returns the number of events drained.
+static int vedge_drain_events(VedgeContext * vedge, VedgeEventQueue * queue)
+{
+    SDL_Event events[VEDGE_EVENT_BATCH];
+    int handled = 0;
+    SDL_PumpEvents();
+    while (handled < VEDGE_EVENTS_PER_FRAME) {
+        int wanted = SDL_min(VEDGE_EVENT_BATCH, VEDGE_EVENTS_PER_FRAME - handled);
+        if (queue != NULL) {
+            // Events the queue has no room for wait in the SDL queue.
+            wanted = SDL_min(wanted, vedge_event_queue_space(queue));
+            if (wanted == 0) {
+                break;
             }
+        }
+        const int count = SDL_PeepEvents(events, wanted, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+        if (count < 0) {
+            SDL_Log("vedge_handle_events: SDL_PeepEvents failed: %s", SDL_GetError());
             break;
-        case SDL_TEXTEDITING:
-            break;
-        case SDL_TEXTINPUT:
-            break;
-        case SDL_KEYMAPCHANGED:
-            break;
-        case SDL_MOUSEMOTION:
-            break;
-        case SDL_MOUSEBUTTONDOWN:
-            break;
-        case SDL_MOUSEBUTTONUP:
-            break;
-        case SDL_MOUSEWHEEL:
-            break;
-        case SDL_JOYAXISMOTION:
-            break;
-        case SDL_JOYBALLMOTION:
-            if (handlers->jball_handler != NULL) {
-                handlers->jball_handler(vedge, (SDL_JoyBallEvent *)event);
+        }
+        for (int i = 0;  i < count;  i++) {
+            if (events[i].type == SDL_QUIT) {
+                vedge_quit(vedge);
             }
-            break;
-        case SDL_JOYHATMOTION:
-            if (handlers->jhat_handler != NULL) {
-                handlers->jhat_handler(vedge, (SDL_JoyHatEvent *)event);
+            if (queue == NULL) {
+                vedge_handle_event(vedge, &events[i]);
             }
+        }
+        if (queue != NULL) {
+            vedge_event_queue_write(queue, events, count);
+        }
+        handled += count;
+        // A short batch means the queue is empty.
+        if (count < wanted) {
             break;
-        case SDL_JOYBUTTONDOWN:
-            break;
-        case SDL_JOYBUTTONUP:
-            break;
-        case SDL_JOYDEVICEADDED:
-            break;
-        case SDL_JOYDEVICEREMOVED:
-            break;
-        case SDL_CONTROLLERAXISMOTION:
-            break;
-        case SDL_CONTROLLERBUTTONDOWN:
-            break;
-        case SDL_CONTROLLERBUTTONUP:
-            break;
-        case SDL_CONTROLLERDEVICEADDED:
-            break;
-        case SDL_CONTROLLERDEVICEREMOVED:
-            break;
-        case SDL_CONTROLLERDEVICEREMAPPED:
-            break;
-        case SDL_FINGERDOWN:
-            break;
-        case SDL_DOLLARGESTURE:
-            break;
-        case  SDL_CLIPBOARDUPDATE:
-            break;
-        case
-            SDL_DROPFILE:
-            break;
-        case SDL_DROPTEXT:
-            break;
-        case SDL_DROPBEGIN:
-            break;
-        case SDL_DROPCOMPLETE:
-            break;
-        case SDL_AUDIODEVICEADDED :
-            break;
-        case SDL_AUDIODEVICEREMOVED:
-            break;
-        case SDL_RENDER_TARGETS_RESET:
-            break;
-        case SDL_RENDER_DEVICE_RESET:
-            break;
-        default:
-            if (event->type >= SDL_USEREVENT) {
-                //handlers->u
-            } else {
-                // unknown
-            }
+        }
     }
+    return handled;
 }
 
 
-void vedge_handle_events(VedgeEventHandlers * handlers)
+// Drain pending events in batches and dispatch them, up to VEDGE_EVENTS_PER_FRAME;
+// SDL_QUIT also asks the main loop to quit. Returns the number of events handled.
+int vedge_handle_events(VedgeContext * vedge)
 {
-    SDL_Event event;
-    while (SDL_PollEvent(&event) != 0)
-    {
-
-        //call general event handler vedge_event(&event);
-        //call specific event handlers
-        //User requests quit
-        if (event.type == SDL_QUIT) {
-            //FIXME: quit = 1;
-        }
-
-        //FIXME:vedge_handle_event(handlers, &event)
-    }
+    assert (vedge != NULL);
+    return vedge_drain_events(vedge, NULL);
 }
 
 
@@ -316,155 +474,220 @@ void vedge_handle_events(VedgeEventHandlers * handlers)
 
 #define VEDGE_VDRAW(vedge) vedge->state.vdraw_context
 
-// .
-int vedge_run(VedgeContext * vedge)
+// Log the main loop timing statistics.
+static void vedge_log_loop_stats(const VloopStats * stats)
 {
-    int x1 = 44;
-    int y1 = 393;
-    int x2 = 123;
-    int y2 = 13;
-    int x1d = 5;
-    int y1d = 6;
-    int x2d = -4;
-    int y2d = 8;
-
-    int x = 0;
-    SDL_Event event;
-    bool quit = false;
-    while (!quit)
-    {
-        while (SDL_PollEvent(&event) != 0)
-        {
-
-            //call general event handler vedge_event(&event);
-            //call specific event handlers
-            //User requests quit
-            if (event.type == SDL_QUIT) {
-                quit = 1;
-            }
-
-           //FIXME:  event.type == SDL_Q
-        }
-
-//        if (vedge->handlers.)
-
-printf("%d %d %d   %d %d %d   %f   %f %f %f\n",
-       VEDGE_VDRAW(vedge)->foreground_colour.red,
-       VEDGE_VDRAW(vedge)->foreground_colour.green,
-       VEDGE_VDRAW(vedge)->foreground_colour.blue,
-
-       VEDGE_VDRAW(vedge)->foreground_colour_requested.red,
-       VEDGE_VDRAW(vedge)->foreground_colour_requested.green,
-       VEDGE_VDRAW(vedge)->foreground_colour_requested.blue,
-
-       VEDGE_VDRAW(vedge)->foreground_colour_intensity,
-
-       VEDGE_VDRAW(vedge)->foreground_intensity_wave_size,
-       VEDGE_VDRAW(vedge)->foreground_intensity_wave_mbr_angle,
-       VEDGE_VDRAW(vedge)->foreground_intensity_wave_mbr_speed
-
-
-);
-
-vedge->state.vdraw_context->foreground_intensity_wave_mbr_speed = 128;
-       /// vdraw_clear_screen(VEDGE_VDRAW(vedge));
-vdraw_set_pen_width(VEDGE_VDRAW(vedge), 2.0);
-
-        vdraw_set_fg_colour(VEDGE_VDRAW(vedge), 255, 255, 255);
-
-
-//        vdraw_set_fg_colour_requested(VEDGE_VDRAW(vedge), 255, 0, 255);
-//        vdraw_set_fg_colour_intensity(VEDGE_VDRAW(vedge), x/64.0);
-//        vdraw_upd_fg_colour_from_requested_and_intensity(VEDGE_VDRAW(vedge));
-
-vdraw_update_fg_colour_intensity_from_wave(VEDGE_VDRAW(vedge));
-VEDGE_VDRAW(vedge)->foreground_intensity_wave_mbr_angle += VEDGE_VDRAW(vedge)->foreground_intensity_wave_mbr_speed;
-
-vdraw_upd_fg_colour_from_requested_and_intensity(VEDGE_VDRAW(vedge));
-
-        vdraw_line(VEDGE_VDRAW(vedge), x1, y1, x2 , y2);
-        x1 = x1 + x1d;
-        y1 = y1 + y1d;
-        x2 = x2 + x2d;
-        y2 = y2 + y2d;
-        if (x1 < 5 || x1 > (VEDGE_VDRAW(vedge)->width-5)) x1d = -x1d;
-        if (y1 < 5 || y1 > (VEDGE_VDRAW(vedge)->height-5)) y1d = -y1d;
-        if (x2 < 5 || x2 > (VEDGE_VDRAW(vedge)->width-5)) x2d = -x2d;
-        if (y2 < 5 || y2 > (VEDGE_VDRAW(vedge)->height-5)) y2d = -y2d;
-
-
-
-//        for (int a = 0; a < 25; a++) {
-//            vdraw_set_fg_colour(VEDGE_VDRAW(vedge), 255, 255, 255);
-//            vdraw_line(VEDGE_VDRAW(vedge), x % 2048, 200, 300, 800);
-//
-//            vdraw_set_fg_colour(VEDGE_VDRAW(vedge), 255, 0, 0);
-//            vdraw_line(VEDGE_VDRAW(vedge), x % 20458, 200, x % 1024, 800);
-//
-//            vdraw_set_fg_colour(VEDGE_VDRAW(vedge), 0, 255, 0);
-//            vdraw_line(VEDGE_VDRAW(vedge), x / 2 % 4096, 200, 300, 800);
-//
-            x++;
-//        }
-SDL_Delay(10);
-if (x > 2048) {
-    x = 0;
-    vdraw_clear_screen(VEDGE_VDRAW(vedge));
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION,
+                 "vedge_run: %.1f fps, frame %.2f ms (min %.2f, max %.2f), "
+                 "update %.2f ms, render %.2f ms, wait %.2f ms, %llu ticks, %llu dropped",
+                 (double)stats->frames / stats->total_seconds,
+                 (stats->total_seconds * 1000.0) / (double)stats->frames,
+                 stats->frame_seconds_min * 1000.0,
+                 stats->frame_seconds_max * 1000.0,
+                 stats->update_seconds * 1000.0,
+                 stats->render_seconds * 1000.0,
+                 stats->wait_seconds * 1000.0,
+                 (unsigned long long)stats->ticks,
+                 (unsigned long long)stats->dropped_ticks);
 }
-//        vdraw_char(VEDGE_VDRAW(vedge), 'J', 300, 800);
-//        vdraw_text(VEDGE_VDRAW(vedge), 300, 800, 10, 200);
-
-//for (int z = 0;  z < 1024;  z+= 16) {
-//    vdraw_set_pen_width(VEDGE_VDRAW(vedge), z / 64);
-//    vdraw_point(VEDGE_VDRAW(vedge), z+ ((x %1024) * 10), z);
-//}
-        vdraw_set_pen_width(VEDGE_VDRAW(vedge), 1.0);
-
-
-VmathMatrix3x3 cam_pos;
-VmathMatrix3x3 cam_siz;
-VmathMatrix3x3 cam_rot;
-VmathMatrix3x3 cam;
-
-VmathMatrix3x3 obj_pos;
-VmathMatrix3x3 obj_siz;
-VmathMatrix3x3 obj_rot;
-VmathMatrix3x3 obj;
 
-VmathMatrix3x3 vpt_pos;
-VmathMatrix3x3 vpt_siz;
-VmathMatrix3x3 vpt;
 
-VmathNumber cam_tx = VMATHNUMBER_C(0.0);
-VmathNumber cam_ty = VMATHNUMBER_C(0.0);
-VmathNumber cam_sx = VMATHNUMBER_C(0.0);
-VmathNumber cam_sy = VMATHNUMBER_C(0.0);
-VmathNumber cam_an = VMATHNUMBER_C(0.0);
-
-vmath_matrix3x3_set_translation(&cam_pos, cam_tx, cam_ty);
-vmath_matrix3x3_set_scaling(&cam_pos, cam_sx, cam_sy);
-vmath_matrix3x3_set_rotation_clockwise(&cam_pos, cam_an);
+// Draw a frame snapshot's lines and points, using the batch for the lines.
+static void vedge_draw_snapshot(VedgeContext * vedge, VdrawLineBatch * batch, const VsnapFrame * snapshot)
+{
+    for (int i = 0;  i < snapshot->line_count;  i++) {
+        const VmathNumber * line = &snapshot->lines[i * 4];
+        if (!vdraw_line_batch_add(batch, line[0], line[1], line[2], line[3])) {
+            vdraw_line_batch_intensity(VEDGE_VDRAW(vedge), batch);
+            vdraw_line_batch(VEDGE_VDRAW(vedge), batch);
+            vdraw_line_batch_clear(batch);
+            vdraw_line_batch_add(batch, line[0], line[1], line[2], line[3]);
+        }
+    }
+    if (batch->count > 0) {
+        vdraw_line_batch_intensity(VEDGE_VDRAW(vedge), batch);
+        vdraw_line_batch(VEDGE_VDRAW(vedge), batch);
+        vdraw_line_batch_clear(batch);
+    }
+    if (snapshot->point_count > 0) {
+        const VdrawPoints points = { .count = snapshot->point_count,
+                                     .x = &snapshot->points[0], .y = &snapshot->points[1], .stride = 2 };
+        vdraw_points(VEDGE_VDRAW(vedge), &points);
+    }
+}
 
-vmath_matrix3x3_upd_translation(&cam_pos, cam_tx, cam_ty);
-vmath_matrix3x3_upd_scaling(&cam_pos, cam_sx, cam_sy);
-vmath_matrix3x3_upd_rotation_clockwise(&cam_pos, cam_an);
 
-vmath_matrix3x3_multiply_matrix3x1_fast(cam_pos, cam_siz, cam);
-vmath_matrix3x3_multiply_matrix3x1(cam, cam_rot, cam);
+// Simulation thread of the threaded main loop: queued events, fixed-timestep updates,
+// then the render callback builds a snapshot of the new state and publishes it.
+static int vedge_simulate(void * data)
+{
+    VedgeContext * vedge = data;
+    const VedgeConfig * config = &vedge->config;
+    VloopTimer * loop = &vedge->state.simulation_loop;
+    VedgeFrame * frame = &vedge->state.frame;
+    SDL_Event events[VEDGE_EVENT_BATCH];
+    while (!SDL_AtomicGet(&vedge->state.stop))
+    {
+        // Input drained by the main thread, handled here with the game state.
+        int count;
+        while ((count = vedge_event_queue_read(&vedge->state.event_queue, events, VEDGE_EVENT_BATCH)) > 0) {
+            for (int i = 0;  i < count;  i++) {
+                vedge_handle_event(vedge, &events[i]);
+            }
+        }
+        const int ticks = vloop_begin_frame(loop);
+        if (config->update_callback != NULL) {
+            const VmathNumber tick_seconds = vloop_get_tick_seconds(loop);
+            for (int i = 0;  (i < ticks) && !SDL_AtomicGet(&vedge->state.stop);  i++) {
+                config->update_callback(vedge, config->callback_data, tick_seconds);
+            }
+        }
+        vloop_mark_update(loop);
+        // Without a tick the state, and so its snapshot, is unchanged.
+        if ((ticks > 0) && (config->render_callback != NULL)) {
+            frame->snapshot = vsnap_begin(&vedge->state.snapshots);
+            config->render_callback(vedge, config->callback_data, VMATHNUMBER_C(0.0));
+            frame->snapshot = NULL;
+            vsnap_publish(&vedge->state.snapshots);
+        }
+        vloop_mark_render(loop);
+        // Paced to the tick rate.
+        vloop_end_frame(loop);
+    }
+    // Free this thread's job deque for the next run's simulation thread.
+    vjobs_release_thread();
+    return 0;
+}
 
 
+// Run the threaded main loop until quit: drain events for the simulation thread,
+// then draw the newest snapshot from it, then pace the frame. The render callback
+// runs on the simulation thread and may draw only through the vedge_frame functions,
+// so callbacks that call vdraw directly (such as the main.c demo) must not run threaded.
+static int vedge_run_threaded(VedgeContext * vedge)
+{
+    const VedgeConfig * config = &vedge->config;
+    VloopTimer * loop = &vedge->state.loop;
+    const int tick_rate = (config->tick_rate > 0) ? config->tick_rate : VEDGE_TICK_RATE;
+    VdrawLineBatch batch;
+    if (!vloop_init(loop, tick_rate, (config->frame_rate > 0) ? config->frame_rate : 0)
+            || !vloop_init(&vedge->state.simulation_loop, tick_rate, tick_rate)
+            || !vdraw_line_batch_init(&batch, VEDGE_FRAME_LINES)) {
+        return 1;
+    }
+    vsnap_init(&vedge->state.snapshots);
+    SDL_AtomicSet(&vedge->state.event_queue.head, 0);
+    SDL_AtomicSet(&vedge->state.event_queue.tail, 0);
+    vedge->state.quit = false;
+    SDL_AtomicSet(&vedge->state.stop, 0);
+    // Pick up handlers set directly in the event handlers.
+    vedge_build_event_dispatch(vedge);
+    SDL_Thread * simulation = SDL_CreateThread(vedge_simulate, "vedge_simulate", vedge);
+    if (simulation == NULL) {
+        SDL_Log("vedge_run: SDL_CreateThread failed: %s", SDL_GetError());
+        vsnap_done(&vedge->state.snapshots);
+        vdraw_line_batch_done(&batch);
+        return 1;
+    }
+    while (!SDL_AtomicGet(&vedge->state.stop))
+    {
+        // Input, for the simulation thread.
+        vedge_drain_events(vedge, &vedge->state.event_queue);
+        // The simulation thread runs the ticks.
+        vloop_begin_frame(loop);
+        vloop_mark_update(loop);
+        // Render the newest snapshot (again, if none has been published since).
+        bool fresh;
+        const VsnapFrame * snapshot = vsnap_acquire(&vedge->state.snapshots, &fresh);
+        vdraw_clear_screen(VEDGE_VDRAW(vedge));
+        vedge_draw_snapshot(vedge, &batch, snapshot);
+        vdraw_flip_screen(VEDGE_VDRAW(vedge));
+        vloop_mark_render(loop);
+        // Frame pacing.
+        vloop_end_frame(loop);
+        if (loop->stats.total_seconds >= VEDGE_LOOP_STATS_SECONDS) {
+            vedge_log_loop_stats(&loop->stats);
+            vloop_reset_stats(loop);
+        }
+    }
+    SDL_WaitThread(simulation, NULL);
+    vsnap_done(&vedge->state.snapshots);
+    vdraw_line_batch_done(&batch);
+    return 0;
+}
 
 
+// Run the main loop until quit: events, fixed-timestep updates, render, then pace the frame.
+// When threaded, a simulation thread handles events and runs the updates and renders into
+// frame snapshots, and the main thread drains the events and draws the newest snapshot each frame.
+int vedge_run(VedgeContext * vedge)
+{
+    assert (vedge != NULL);
+    if (vedge->config.threaded) {
+        return vedge_run_threaded(vedge);
+    }
+    const VedgeConfig * config = &vedge->config;
+    VloopTimer * loop = &vedge->state.loop;
+    if (!vloop_init(loop,
+                    (config->tick_rate > 0) ? config->tick_rate : VEDGE_TICK_RATE,
+                    (config->frame_rate > 0) ? config->frame_rate : 0)) {
+        return 1;
+    }
+    vedge->state.quit = false;
+    // Pick up handlers set directly in the event handlers.
+    vedge_build_event_dispatch(vedge);
+    while (!vedge->state.quit)
+    {
+        // Input.
+        vedge_handle_events(vedge);
+        // Fixed-timestep simulation.
+        const int ticks = vloop_begin_frame(loop);
+        if (config->update_callback != NULL) {
+            const VmathNumber tick_seconds = vloop_get_tick_seconds(loop);
+            for (int i = 0;  (i < ticks) && !vedge->state.quit;  i++) {
+                config->update_callback(vedge, config->callback_data, tick_seconds);
+            }
+        }
+        vloop_mark_update(loop);
+        // Render.
+        if (config->render_callback != NULL) {
+            config->render_callback(vedge, config->callback_data, vloop_get_alpha(loop));
+        }
+        vdraw_flip_screen(VEDGE_VDRAW(vedge));
+        vloop_mark_render(loop);
+        // Frame pacing.
+        vloop_end_frame(loop);
+        if (loop->stats.total_seconds >= VEDGE_LOOP_STATS_SECONDS) {
+            vedge_log_loop_stats(&loop->stats);
+            vloop_reset_stats(loop);
+        }
+    }
+    return 0;
+}
 
 
+// Ask the main loop to quit at the end of the current frame.
+void vedge_quit(VedgeContext * vedge)
+{
+    assert (vedge != NULL);
+    vedge->state.quit = true;
+    SDL_AtomicSet(&vedge->state.stop, 1);
+}
 
 
+// Get the main loop timing statistics.
+const VloopStats * vedge_get_loop_stats(const VedgeContext * vedge)
+{
+    assert (vedge != NULL);
+    return vloop_get_stats(&vedge->state.loop);
+}
 
-        vdraw_flip_screen(VEDGE_VDRAW(vedge));
 
-        //call render loop function
-    }
-    return 0;
+// Get the vdraw context (NULL if not initialised).
+VdrawContext * vedge_get_vdraw(VedgeContext * vedge)
+{
+    assert (vedge != NULL);
+    return vedge->state.vdraw_context;
 }
 
 
@@ -544,35 +767,625 @@ int vedge_close(VedgeContext * context)
 //-----------------------------------------------------------------------------
 
 
+// Make room for needed elements of size in a growable array (doubling).
+static bool vedge_frame_reserve(void ** array, int * capacity, const int needed, const size_t size)
+{
+    if (needed <= *capacity) {
+        return true;
+    }
+    int grown = (*capacity > 0) ? *capacity : 1;
+    while (grown < needed) {
+        grown *= 2;
+    }
+    void * resized = realloc(*array, (size_t)grown * size);
+    if (resized == NULL) {
+        SDL_Log("vedge_frame_reserve: out of memory for %d entries", grown);
+        return false;
+    }
+    *array = resized;
+    *capacity = grown;
+    return true;
+}
+
+
+// Draw and remove the frame buffer's lines.
+static void vedge_frame_flush_lines(VedgeContext * context)
+{
+    VedgeFrame * frame = &context->state.frame;
+    if (frame->lines.count > 0) {
+        vdraw_line_batch_intensity(VEDGE_VDRAW(context), &frame->lines);
+        vdraw_line_batch(VEDGE_VDRAW(context), &frame->lines);
+        vdraw_line_batch_clear(&frame->lines);
+    }
+}
+
+
+// Draw and remove the frame buffer's points.
+static void vedge_frame_flush_points(VedgeContext * context)
+{
+    VedgeFrame * frame = &context->state.frame;
+    if (frame->point_count > 0) {
+        const VdrawPoints points = { .count = frame->point_count,
+                                     .x = &frame->points[0], .y = &frame->points[1], .stride = 2 };
+        vdraw_points(VEDGE_VDRAW(context), &points);
+        frame->point_count = 0;
+    }
+}
+
+
+// Add a transformed line to the frame buffer, drawing the buffer first if full.
+static void vedge_frame_emit_line(VedgeContext * context,
+                                  const VmathNumber x1, const VmathNumber y1,
+                                  const VmathNumber x2, const VmathNumber y2)
+{
+    VedgeFrame * frame = &context->state.frame;
+    if (!vdraw_line_batch_add(&frame->lines, x1, y1, x2, y2)) {
+        vedge_frame_flush_lines(context);
+        vdraw_line_batch_add(&frame->lines, x1, y1, x2, y2);
+    }
+}
+
+
+// Transform points (x, y pairs) into the frame buffer's points.
+static void vedge_frame_emit_points(VedgeContext * context, const VmathMatrix3x3 world,
+                                    const VmathNumber * points, int count)
+{
+    VedgeFrame * frame = &context->state.frame;
+    while (count > 0) {
+        if (frame->point_count == VEDGE_FRAME_POINTS) {
+            vedge_frame_flush_points(context);
+        }
+        const int chunk = SDL_min(count, VEDGE_FRAME_POINTS - frame->point_count);
+        vmath_matrix3x3_multiply_points(world, points, chunk, &frame->points[frame->point_count * 2]);
+        frame->point_count += chunk;
+        points += chunk * 2;
+        count -= chunk;
+    }
+}
+
+
+// Transform lines ((x1, y1, x2, y2) quads) into the frame buffer's lines.
+static void vedge_frame_emit_lines(VedgeContext * context, const VmathMatrix3x3 world,
+                                   const VmathNumber * lines, int count)
+{
+    VmathNumber * vertices = context->state.frame.vertices;
+    while (count > 0) {
+        const int chunk = SDL_min(count, VEDGE_FRAME_POINTS / 2);
+        vmath_matrix3x3_multiply_points(world, lines, chunk * 2, vertices);
+        for (int i = 0;  i < chunk;  i++) {
+            const VmathNumber * line = &vertices[i * 4];
+            vedge_frame_emit_line(context, line[0], line[1], line[2], line[3]);
+        }
+        lines += chunk * 4;
+        count -= chunk;
+    }
+}
+
+
+// Transform a path of points (x, y pairs) into the frame buffer's lines.
+static void vedge_frame_emit_path(VedgeContext * context, const VmathMatrix3x3 world,
+                                  const VmathNumber * points, int count, const bool closed)
+{
+    VmathNumber * vertices = context->state.frame.vertices;
+    VmathNumber first[2];
+    VmathNumber last[2];
+    bool started = false;
+    while (count > 0) {
+        const int chunk = SDL_min(count, VEDGE_FRAME_POINTS);
+        vmath_matrix3x3_multiply_points(world, points, chunk, vertices);
+        for (int i = 0;  i < chunk;  i++) {
+            const VmathNumber * vertex = &vertices[i * 2];
+            if (started) {
+                vedge_frame_emit_line(context, last[0], last[1], vertex[0], vertex[1]);
+            } else {
+                first[0] = vertex[0];
+                first[1] = vertex[1];
+                started = true;
+            }
+            last[0] = vertex[0];
+            last[1] = vertex[1];
+        }
+        points += chunk * 2;
+        count -= chunk;
+    }
+    if (closed && started) {
+        vedge_frame_emit_line(context, last[0], last[1], first[0], first[1]);
+    }
+}
+
+
+// Add transformed primitives to the frame buffer, or to the snapshot being built.
+static void vedge_frame_add_primitives(VedgeContext * context, const VsnapFrame * primitives)
+{
+    VedgeFrame * frame = &context->state.frame;
+    if (frame->snapshot != NULL) {
+        VmathNumber * lines = vsnap_add_lines(frame->snapshot, primitives->line_count);
+        if ((lines != NULL) && (primitives->line_count > 0)) {
+            memcpy(lines, primitives->lines, (size_t)primitives->line_count * 4 * sizeof(VmathNumber));
+        }
+        VmathNumber * points = vsnap_add_points(frame->snapshot, primitives->point_count);
+        if ((points != NULL) && (primitives->point_count > 0)) {
+            memcpy(points, primitives->points, (size_t)primitives->point_count * 2 * sizeof(VmathNumber));
+        }
+        return;
+    }
+    for (int i = 0;  i < primitives->line_count;  i++) {
+        const VmathNumber * line = &primitives->lines[i * 4];
+        vedge_frame_emit_line(context, line[0], line[1], line[2], line[3]);
+    }
+    for (int i = 0;  i < primitives->point_count;  ) {
+        if (frame->point_count == VEDGE_FRAME_POINTS) {
+            vedge_frame_flush_points(context);
+        }
+        const int chunk = SDL_min(primitives->point_count - i, VEDGE_FRAME_POINTS - frame->point_count);
+        memcpy(&frame->points[frame->point_count * 2], &primitives->points[i * 2], (size_t)chunk * 2 * sizeof(VmathNumber));
+        frame->point_count += chunk;
+        i += chunk;
+    }
+}
+
+
+// Transform points (x, y pairs) into the primitives' points.
+static void vedge_primitives_add_points(VsnapFrame * primitives, const VmathMatrix3x3 world,
+                                        const VmathNumber * points, const int count)
+{
+    VmathNumber * transformed = vsnap_add_points(primitives, count);
+    if ((transformed != NULL) && (count > 0)) {
+        vmath_matrix3x3_multiply_points(world, points, count, transformed);
+    }
+}
+
+
+// Transform lines ((x1, y1, x2, y2) quads) into the primitives' lines.
+static void vedge_primitives_add_lines(VsnapFrame * primitives, const VmathMatrix3x3 world,
+                                       const VmathNumber * lines, const int count)
+{
+    VmathNumber * transformed = vsnap_add_lines(primitives, count);
+    if ((transformed != NULL) && (count > 0)) {
+        vmath_matrix3x3_multiply_points(world, lines, count * 2, transformed);
+    }
+}
+
+
+// Transform a path of points (x, y pairs) into the primitives' lines.
+static void vedge_primitives_add_path(VsnapFrame * primitives, const VmathMatrix3x3 world,
+                                      const VmathNumber * points, const int count, const bool closed)
+{
+    const int segments = (count > 0) ? (count - 1 + (closed ? 1 : 0)) : 0;
+    VmathNumber * lines = vsnap_add_lines(primitives, segments);
+    if ((lines == NULL) || (segments == 0)) {
+        return;
+    }
+    // Transform the points into the start of the lines (they take no more room),
+    // then spread them out last line first: line i overwrites points 2i and
+    // 2i + 1, which only it and the lines already spread use.
+    vmath_matrix3x3_multiply_points(world, points, count, lines);
+    for (int i = segments - 1;  i >= 0;  i--) {
+        const int next = (i + 1) % count;
+        const VmathNumber x1 = lines[i * 2];
+        const VmathNumber y1 = lines[(i * 2) + 1];
+        const VmathNumber x2 = lines[next * 2];
+        const VmathNumber y2 = lines[(next * 2) + 1];
+        lines[i * 4] = x1;
+        lines[(i * 4) + 1] = y1;
+        lines[(i * 4) + 2] = x2;
+        lines[(i * 4) + 3] = y2;
+    }
+}
+
+
+// Transform a game object's items into the primitives.
+static void vedge_primitives_add_items(VsnapFrame * primitives, const VmathMatrix3x3 world,
+                                       const VedgeGameItem * items, const int length)
+{
+    for (int i = 0;  i < length;  i++) {
+        const VedgeGameItemVariant * item = &items[i].game_item;
+        switch (items[i].type) {
+            case POINT:
+                vedge_primitives_add_points(primitives, world, &item->point->x1, 1);
+                break;
+            case LINE:
+                vedge_primitives_add_lines(primitives, world, &item->line->x1, 1);
+                break;
+            case POINTS:
+                vedge_primitives_add_points(primitives, world, &item->points->points[0].x1, item->points->length);
+                break;
+            case LINES:
+                vedge_primitives_add_lines(primitives, world, &item->lines->lines[0].x1, item->lines->length);
+                break;
+            case LINEPATH:
+                vedge_primitives_add_path(primitives, world, &item->path->points.points[0].x1,
+                                          item->path->points.length, item->path->closed);
+                break;
+            default:
+                // Characters and strings have no item data yet; children are visited by the traversal.
+                break;
+        }
+    }
+}
+
+
+// Transform a game object's items into the frame buffer, or the snapshot being built.
+static void vedge_frame_add_items(VedgeContext * context, const VmathMatrix3x3 world,
+                                  const VedgeGameItem * items, const int length)
+{
+    if (context->state.frame.snapshot != NULL) {
+        vedge_primitives_add_items(context->state.frame.snapshot, world, items, length);
+        return;
+    }
+    for (int i = 0;  i < length;  i++) {
+        const VedgeGameItemVariant * item = &items[i].game_item;
+        switch (items[i].type) {
+            case POINT:
+                vedge_frame_emit_points(context, world, &item->point->x1, 1);
+                break;
+            case LINE:
+                vedge_frame_emit_lines(context, world, &item->line->x1, 1);
+                break;
+            case POINTS:
+                vedge_frame_emit_points(context, world, &item->points->points[0].x1, item->points->length);
+                break;
+            case LINEPATH:
+                vedge_frame_emit_path(context, world, &item->path->points.points[0].x1,
+                                      item->path->points.length, item->path->closed);
+                break;
+            case LINES:
+                vedge_frame_emit_lines(context, world, &item->lines->lines[0].x1, item->lines->length);
+                break;
+            default:
+                // Characters and strings have no item data yet; children are visited by the traversal.
+                break;
+        }
+    }
+}
+
+
+// Make the bounds empty.
+static inline void vedge_bounds_empty(VedgeBounds * bounds)
+{
+    bounds->min_x = bounds->min_y = FLT_MAX;
+    bounds->max_x = bounds->max_y = -FLT_MAX;
+}
+
+
+// Grow the bounds to include the points (x, y pairs).
+static void vedge_bounds_add_points(VedgeBounds * bounds, const VmathNumber * points, const int count)
+{
+    for (int i = 0;  i < count;  i++) {
+        bounds->min_x = SDL_min(bounds->min_x, points[i * 2]);
+        bounds->min_y = SDL_min(bounds->min_y, points[i * 2 + 1]);
+        bounds->max_x = SDL_max(bounds->max_x, points[i * 2]);
+        bounds->max_y = SDL_max(bounds->max_y, points[i * 2 + 1]);
+    }
+}
+
+
+// Grow the bounds to include another.
+static inline void vedge_bounds_add(VedgeBounds * bounds, const VedgeBounds * other)
+{
+    bounds->min_x = SDL_min(bounds->min_x, other->min_x);
+    bounds->min_y = SDL_min(bounds->min_y, other->min_y);
+    bounds->max_x = SDL_max(bounds->max_x, other->max_x);
+    bounds->max_y = SDL_max(bounds->max_y, other->max_y);
+}
+
+
+// Grow the bounds to include the transformed bounds of another.
+static void vedge_bounds_add_transformed(VedgeBounds * bounds, const VmathMatrix3x3 matrix, const VedgeBounds * other)
+{
+    if (other->min_x > other->max_x) {
+        return;
+    }
+    // Transform the centre and take the absolute matrix times the half size.
+    const VmathNumber cx = (other->min_x + other->max_x) / VMATHNUMBER_C(2.0);
+    const VmathNumber cy = (other->min_y + other->max_y) / VMATHNUMBER_C(2.0);
+    const VmathNumber hx = (other->max_x - other->min_x) / VMATHNUMBER_C(2.0);
+    const VmathNumber hy = (other->max_y - other->min_y) / VMATHNUMBER_C(2.0);
+    const VmathNumber tx = (matrix[0][0] * cx) + (matrix[0][1] * cy) + matrix[0][2];
+    const VmathNumber ty = (matrix[1][0] * cx) + (matrix[1][1] * cy) + matrix[1][2];
+    const VmathNumber ex = (fabsf(matrix[0][0]) * hx) + (fabsf(matrix[0][1]) * hy);
+    const VmathNumber ey = (fabsf(matrix[1][0]) * hx) + (fabsf(matrix[1][1]) * hy);
+    bounds->min_x = SDL_min(bounds->min_x, tx - ex);
+    bounds->min_y = SDL_min(bounds->min_y, ty - ey);
+    bounds->max_x = SDL_max(bounds->max_x, tx + ex);
+    bounds->max_y = SDL_max(bounds->max_y, ty + ey);
+}
+
+
+// Do the bounds overlap?
+static inline bool vedge_bounds_overlap(const VedgeBounds * a, const VedgeBounds * b)
+{
+    return (a->min_x <= b->max_x) && (a->max_x >= b->min_x)
+            && (a->min_y <= b->max_y) && (a->max_y >= b->min_y);
+}
+
+
+// Get the item's bounds, computing them if the cache is out of date.
+static const VedgeBounds * vedge_game_item_bounds(VedgeGameItem * game_item)
+{
+    if (!game_item->bounds_valid) {
+        const VedgeGameItemVariant * item = &game_item->game_item;
+        VedgeBounds * bounds = &game_item->bounds;
+        vedge_bounds_empty(bounds);
+        switch (game_item->type) {
+            case POINT:
+                vedge_bounds_add_points(bounds, &item->point->x1, 1);
+                break;
+            case LINE:
+                vedge_bounds_add_points(bounds, &item->line->x1, 2);
+                break;
+            case POINTS:
+                vedge_bounds_add_points(bounds, &item->points->points[0].x1, item->points->length);
+                break;
+            case LINEPATH:
+                vedge_bounds_add_points(bounds, &item->path->points.points[0].x1, item->path->points.length);
+                break;
+            case LINES:
+                vedge_bounds_add_points(bounds, &item->lines->lines[0].x1, item->lines->length * 2);
+                break;
+            default:
+                break;
+        }
+        game_item->bounds_valid = true;
+    }
+    return &game_item->bounds;
+}
+
+
+// Get the game object's local transform (position * rotation * scaling).
+static void vedge_game_object_local(const VedgeGameObject * object, VmathMatrix3x3 local)
+{
+    VmathMatrix3x3 position_rotation;
+    vmath_matrix3x3_multiply_matrix3x3_fast(object->position, object->rotation, position_rotation);
+    vmath_matrix3x3_multiply_matrix3x3_fast(position_rotation, object->scaling, local);
+}
+
+
+// Compute the bounds of the game object and of any descendants whose cached
+// bounds are out of date, children before parents. Returns false if out of memory.
+static bool vedge_frame_update_bounds(VedgeContext * context, VedgeGameObject * game_object)
+{
+    VedgeFrame * frame = &context->state.frame;
+    int count = 0;
+    frame->bounds_nodes[count++] = (VedgeFrameBoundsNode){ .game_object = game_object, .child = 0 };
+    while (count > 0) {
+        VedgeFrameBoundsNode * node = &frame->bounds_nodes[count - 1];
+        VedgeGameObject * object = node->game_object;
+        const VedgeGameObjectChildren * children = object->children;
+        // Visit the next child, descending if its bounds are out of date.
+        if ((children != NULL) && (node->child < children->length)) {
+            VedgeGameObject * child = children->game_objects[node->child++];
+            if ((child != NULL) && !child->bounds_valid) {
+                if (!vedge_frame_reserve((void **)&frame->bounds_nodes, &frame->bounds_capacity,
+                                         count + 1, sizeof(VedgeFrameBoundsNode))) {
+                    return false;
+                }
+                frame->bounds_nodes[count++] = (VedgeFrameBoundsNode){ .game_object = child, .child = 0 };
+            }
+            continue;
+        }
+        // All children are up to date: combine their bounds with the items'.
+        vedge_bounds_empty(&object->bounds);
+        if (object->items != NULL) {
+            for (int i = 0;  i < object->items->length;  i++) {
+                const VedgeBounds * item = vedge_game_item_bounds(&object->items->game_items[i]);
+                vedge_bounds_add(&object->bounds, item);
+            }
+        }
+        for (int i = 0;  (children != NULL) && (i < children->length);  i++) {
+            VedgeGameObject * child = children->game_objects[i];
+            if (child != NULL) {
+                VmathMatrix3x3 local;
+                vedge_game_object_local(child, local);
+                vedge_bounds_add_transformed(&object->bounds, local, &child->bounds);
+                child->parent = object;
+            }
+        }
+        object->bounds_valid = true;
+        count--;
+    }
+    return true;
+}
+
+
+// Start a frame: clear the screen (unless building a snapshot) and the frame buffer,
+// and set the viewport to the screen.
 void vedge_frame_start(VedgeContext * context)
 {
     assert (context != NULL);
-//    vdraw_clear_screen(context->init_state.vdraw_context);
+    vdraw_line_batch_clear(&context->state.frame.lines);
+    context->state.frame.point_count = 0;
+    context->state.frame.world_updates = 0;
+    context->state.frame.culled = 0;
+    const VdrawContext * vdraw = VEDGE_VDRAW(context);
+    context->state.frame.viewport = (VedgeBounds){
+            .min_x = -VEDGE_FRAME_CULL_MARGIN, .min_y = -VEDGE_FRAME_CULL_MARGIN,
+            .max_x = vdraw->width + VEDGE_FRAME_CULL_MARGIN, .max_y = vdraw->height + VEDGE_FRAME_CULL_MARGIN };
+    // Snapshots are drawn onto a cleared screen by the main thread.
+    if (context->state.frame.snapshot == NULL) {
+        vdraw_clear_screen(VEDGE_VDRAW(context));
+    }
 }
 
 
+// Finish a frame: draw what remains in the frame buffer.
 void vedge_frame_finish(VedgeContext * context)
 {
     assert (context != NULL);
- //   vdraw_flip(context->init_state.vdraw_context);
+    vedge_frame_flush_lines(context);
+    vedge_frame_flush_points(context);
 }
 
 
-void vedge_frame_add_game_object(VedgeContext * context, const VedgeGameObject * game_object)
+// Mark the cached bounds of the game object's ancestors out of date.
+static void vedge_game_object_invalidate_ancestors(VedgeGameObject * game_object)
+{
+    // Ancestors of an object with out of date bounds are already out of date.
+    for (VedgeGameObject * parent = game_object->parent;  (parent != NULL) && parent->bounds_valid;  parent = parent->parent) {
+        parent->bounds_valid = false;
+    }
+}
+
+
+// Note that the game object's position, rotation or scaling changed.
+void vedge_game_object_changed(VedgeGameObject * game_object)
+{
+    assert (game_object != NULL);
+    game_object->local_version++;
+    vedge_game_object_invalidate_ancestors(game_object);
+}
+
+
+// Note that the game object's items (or their data) or children changed.
+void vedge_game_object_bounds_changed(VedgeGameObject * game_object)
 {
-    assert (context != NULL);
     assert (game_object != NULL);
-    if (game_object->enable) {
-        for (int i = 0;  i < game_object->items->length;  i++) {
-            switch (game_object->items->game_items[i].type) {
-                case POINT:
-//FIXME:                     VedgePoint * point = game_object->items->game_items[i].game_item.point;
-break;
+    for (int i = 0;  (game_object->items != NULL) && (i < game_object->items->length);  i++) {
+        game_object->items->game_items[i].bounds_valid = false;
+    }
+    game_object->bounds_valid = false;
+    vedge_game_object_invalidate_ancestors(game_object);
+}
 
+
+// Add an enabled game object and its enabled descendants to the frame, each
+// transformed by position * rotation * scaling after its parent's transform.
+// Cached world transforms are reused unless the object or an ancestor changed.
+void vedge_frame_add_game_object(VedgeContext * context, VedgeGameObject * game_object)
+{
+    assert (context != NULL);
+    assert (game_object != NULL);
+    VedgeFrame * frame = &context->state.frame;
+    if (!game_object->enable) {
+        return;
+    }
+    // Depth first without recursion. Parents are always visited before their
+    // children, so a parent's world transform is up to date when a child checks it.
+    int count = 0;
+    frame->nodes[count++] = (VedgeFrameNode){ .game_object = game_object, .parent = NULL };
+    while (count > 0) {
+        const VedgeFrameNode node = frame->nodes[--count];
+        VedgeGameObject * object = node.game_object;
+        const uint64_t parent_version = (node.parent != NULL) ? node.parent->world_version : 0;
+        if ((object->world_version == 0)
+                || (object->world_local_version != object->local_version)
+                || (object->world_parent != node.parent)
+                || (object->world_parent_version != parent_version)) {
+            VmathMatrix3x3 local;
+            vedge_game_object_local(object, local);
+            if (node.parent == NULL) {
+                memcpy(object->world, local, sizeof(VmathMatrix3x3));
+            } else {
+                vmath_matrix3x3_multiply_matrix3x3_fast(node.parent->world, local, object->world);
+            }
+            object->world_version++;
+            object->world_local_version = object->local_version;
+            object->world_parent = node.parent;
+            object->world_parent_version = parent_version;
+            frame->world_updates++;
+        }
+        // Skip the object and its descendants if their bounds are off screen.
+        if (object->bounds_valid || vedge_frame_update_bounds(context, object)) {
+            VedgeBounds world_bounds;
+            vedge_bounds_empty(&world_bounds);
+            vedge_bounds_add_transformed(&world_bounds, object->world, &object->bounds);
+            if (!vedge_bounds_overlap(&world_bounds, &frame->viewport)) {
+                frame->culled++;
+                continue;
+            }
+        }
+        if (object->items != NULL) {
+            vedge_frame_add_items(context, object->world, object->items->game_items, object->items->length);
+        }
+        // Push the enabled children in reverse so they are visited in order.
+        const VedgeGameObjectChildren * children = object->children;
+        if ((children == NULL) || (children->length == 0)
+                || !vedge_frame_reserve((void **)&frame->nodes, &frame->node_capacity,
+                                        count + children->length, sizeof(VedgeFrameNode))) {
+            continue;
+        }
+        for (int i = children->length - 1;  i >= 0;  i--) {
+            VedgeGameObject * child = children->game_objects[i];
+            if ((child != NULL) && child->enable) {
+                child->parent = object;
+                frame->nodes[count++] = (VedgeFrameNode){ .game_object = child, .parent = object };
             }
         }
     }
 }
 
 
+// Add the game objects to the frame.
+void vedge_frame_add_game_objects(VedgeContext * context, const int length, VedgeGameObject * game_objects)
+{
+    assert (context != NULL);
+    assert ((game_objects != NULL) || (length == 0));
+    for (int i = 0;  i < length;  i++) {
+        vedge_frame_add_game_object(context, &game_objects[i]);
+    }
+}
+
+
+// A vedge_frame_add_store() pass over a store.
+typedef struct VedgeFrameStorePass {
+    VedgeFrame * frame;
+    VstoreStore * store;
+    SDL_atomic_t culled;
+} VedgeFrameStorePass;
+
+
+// Cull and transform the items of jobs [begin, end)'s entities, VEDGE_FRAME_STORE_ENTITIES
+// per job, into the jobs' primitives.
+static void vedge_frame_add_store_jobs(void * data, const int begin, const int end)
+{
+    VedgeFrameStorePass * pass = data;
+    VstoreStore * store = pass->store;
+    int culled = 0;
+    for (int job = begin;  job < end;  job++) {
+        VsnapFrame * primitives = &pass->frame->store_jobs[job];
+        vsnap_frame_clear(primitives);
+        const int last = SDL_min((job + 1) * VEDGE_FRAME_STORE_ENTITIES, store->count);
+        for (int i = job * VEDGE_FRAME_STORE_ENTITIES;  i < last;  i++) {
+            if (!store->visible[i] || (store->item_count[i] == 0)) {
+                continue;
+            }
+            VedgeGameItem * items = &store->items[store->item_first[i]];
+            VedgeBounds bounds;
+            vedge_bounds_empty(&bounds);
+            for (int k = 0;  k < store->item_count[i];  k++) {
+                vedge_bounds_add_transformed(&bounds, store->world[i], vedge_game_item_bounds(&items[k]));
+            }
+            if (!vedge_bounds_overlap(&bounds, &pass->frame->viewport)) {
+                culled++;
+                continue;
+            }
+            vedge_primitives_add_items(primitives, store->world[i], items, store->item_count[i]);
+        }
+    }
+    SDL_AtomicAdd(&pass->culled, culled);
+}
+
 
+// Add the store's visible entities to the frame using their world transforms
+// from the last vstore_update_world(), skipping those whose bounds are outside
+// the viewport. Entities are culled and transformed in parallel jobs.
+void vedge_frame_add_store(VedgeContext * context, VstoreStore * store)
+{
+    assert (context != NULL);
+    assert (store != NULL);
+    VedgeFrame * frame = &context->state.frame;
+    const int jobs = (store->count + VEDGE_FRAME_STORE_ENTITIES - 1) / VEDGE_FRAME_STORE_ENTITIES;
+    const int capacity = frame->store_job_capacity;
+    if ((jobs == 0) || !vedge_frame_reserve((void **)&frame->store_jobs, &frame->store_job_capacity, jobs, sizeof(VsnapFrame))) {
+        return;
+    }
+    memset(&frame->store_jobs[capacity], 0, (size_t)(frame->store_job_capacity - capacity) * sizeof(VsnapFrame));
+    VedgeFrameStorePass pass = { .frame = frame, .store = store };
+    SDL_AtomicSet(&pass.culled, 0);
+    vjobs_parallel_for(0, jobs, 1, vedge_frame_add_store_jobs, &pass);
+    // Gathered in job order, so in entity ID order.
+    for (int job = 0;  job < jobs;  job++) {
+        vedge_frame_add_primitives(context, &frame->store_jobs[job]);
+    }
+    frame->culled += SDL_AtomicGet(&pass.culled);
+}
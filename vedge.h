@@ -27,6 +27,7 @@
 
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <SDL.h>
 
@@ -34,6 +35,8 @@
 
 #include "vmath.h"
 #include "vdraw.h"
+#include "vloop.h"
+#include "vsnap.h"
 
 
 
@@ -61,33 +64,205 @@
 // .
 #define VEDGE_SDL_RENDERER_FLAGS (SDL_RENDERER_SOFTWARE)
 
+// Default simulation ticks per second.
+#define VEDGE_TICK_RATE 60
+
+// Default target frames per second (0 = unpaced).
+#define VEDGE_FRAME_RATE 60
+
+// Seconds between loop timing statistics debug logs (statistics reset after each).
+#define VEDGE_LOOP_STATS_SECONDS 5.0
+
+// Transformed lines held in the frame buffer before they are drawn.
+#define VEDGE_FRAME_LINES 4096
+
+// Transformed points held in the frame buffer before they are drawn.
+#define VEDGE_FRAME_POINTS 1024
+
+// Initial scene traversal stack entries (grown for deeper or wider scenes).
+#define VEDGE_FRAME_STACK 64
+
+// Pixels beyond the screen edges still treated as visible (covers the pen width).
+#define VEDGE_FRAME_CULL_MARGIN 4.0
+
+// Store entities culled and transformed per parallel job by vedge_frame_add_store().
+#define VEDGE_FRAME_STORE_ENTITIES 256
+
+// Events drained from the SDL queue per SDL_PeepEvents() call.
+#define VEDGE_EVENT_BATCH 64
+
+// Events handled per frame at most; the rest wait for later frames so a flood cannot starve rendering.
+#define VEDGE_EVENTS_PER_FRAME 256
+
+// Events queued from the main thread to the simulation thread (threaded main loop, power of two).
+#define VEDGE_EVENT_QUEUE 256
+
 
 //-----------------------------------------------------------------------------
 // Configuration, State, and Context Data Types.
 //-----------------------------------------------------------------------------
 
+typedef struct VedgeContext VedgeContext;
+
+typedef struct VedgeGameObject VedgeGameObject;
+
+struct VstoreStore;
+
+// Main loop callback run once per simulation tick of tick_seconds.
+typedef void (*vedge_update_callback)(VedgeContext * vedge, void * data, const VmathNumber tick_seconds);
+
+// Main loop callback run once per frame, alpha (0.0 to 1.0) between the last and next tick.
+// When threaded it runs on the simulation thread after each tick's updates (alpha 0.0)
+// and must draw only through the vedge_frame functions. The event handlers then run on
+// the simulation thread too, before each frame's ticks, so all three may share game state.
+typedef void (*vedge_render_callback)(VedgeContext * vedge, void * data, const VmathNumber alpha);
+
+
 // Initialisation configuration.
 typedef struct VedgeConfig {
     SDL_Window * sdl_window;
     SDL_Renderer * sdl_renderer;
+    // Simulation ticks per second.
+    int tick_rate;
+    // Target frames per second (0 = unpaced).
+    int frame_rate;
+    // Optional main loop callbacks and their data.
+    vedge_update_callback update_callback;
+    vedge_render_callback render_callback;
+    void * callback_data;
+    // Run the callbacks on a simulation thread, drawing their frames' snapshots on the main thread?
+    bool threaded;
 } VedgeConfig;
 
 
+// Axis aligned bounding box (empty when min_x > max_x).
+typedef struct VedgeBounds {
+    VmathNumber min_x;
+    VmathNumber min_y;
+    VmathNumber max_x;
+    VmathNumber max_y;
+} VedgeBounds;
+
+
+// Scene traversal stack entry: a game object still to visit and its parent (NULL for the root).
+typedef struct VedgeFrameNode {
+    VedgeGameObject * game_object;
+    const VedgeGameObject * parent;
+} VedgeFrameNode;
+
+
+// Bounds computation stack entry: a game object and the next child to visit.
+typedef struct VedgeFrameBoundsNode {
+    VedgeGameObject * game_object;
+    int child;
+} VedgeFrameBoundsNode;
+
+
+// Frame buffer of transformed primitives and the scene traversal stacks.
+typedef struct VedgeFrame {
+    // Transformed lines, drawn when full and when the frame finishes.
+    VdrawLineBatch lines;
+    // Transformed points (x, y pairs), drawn when full and when the frame finishes.
+    VmathNumber * points;
+    int point_count;
+    // Transformed item vertices (x, y pairs) for lines and line paths.
+    VmathNumber * vertices;
+    // Game objects still to visit.
+    VedgeFrameNode * nodes;
+    int node_capacity;
+    // Game objects whose bounds are being computed.
+    VedgeFrameBoundsNode * bounds_nodes;
+    int bounds_capacity;
+    // Visible area; game objects whose bounds are outside are skipped with their descendants.
+    VedgeBounds viewport;
+    // World transforms recomputed since the frame started.
+    int world_updates;
+    // Game objects skipped as outside the viewport since the frame started.
+    int culled;
+    // Snapshot the frame is built into instead of drawn (threaded main loop), or NULL.
+    VsnapFrame * snapshot;
+    // Transformed primitives of each vedge_frame_add_store() job, in job order.
+    VsnapFrame * store_jobs;
+    int store_job_capacity;
+} VedgeFrame;
+
+
+// Event dispatch table slots, one per event handler (SDL event types are mapped onto these).
+typedef enum VedgeEventSlot {
+    VEDGE_EVENT_NONE,
+    VEDGE_EVENT_COMMON,
+    VEDGE_EVENT_WINDOW,
+    VEDGE_EVENT_KEY,
+    VEDGE_EVENT_EDIT,
+    VEDGE_EVENT_TEXT,
+    VEDGE_EVENT_MOTION,
+    VEDGE_EVENT_BUTTON,
+    VEDGE_EVENT_WHEEL,
+    VEDGE_EVENT_JAXIS,
+    VEDGE_EVENT_JBALL,
+    VEDGE_EVENT_JHAT,
+    VEDGE_EVENT_JBUTTON,
+    VEDGE_EVENT_JDEVICE,
+    VEDGE_EVENT_CAXIS,
+    VEDGE_EVENT_CBUTTON,
+    VEDGE_EVENT_CDEVICE,
+    VEDGE_EVENT_ADEVICE,
+    VEDGE_EVENT_QUIT,
+    VEDGE_EVENT_USER,
+    VEDGE_EVENT_SYSWM,
+    VEDGE_EVENT_TFINGER,
+    VEDGE_EVENT_MGESTURE,
+    VEDGE_EVENT_DGESTURE,
+    VEDGE_EVENT_DROP,
+    VEDGE_EVENT_SLOTS
+} VedgeEventSlot;
+
+// Event dispatch table entry, calling the slot's handler with its event type.
+typedef void (*vedge_event_dispatch)(VedgeContext * vedge, SDL_Event * event);
+
+
+// Single producer, single consumer queue of events drained on the main thread
+// and handled on the simulation thread (threaded main loop).
+typedef struct VedgeEventQueue {
+    SDL_atomic_t head;
+    SDL_atomic_t tail;
+    SDL_Event events[VEDGE_EVENT_QUEUE];
+} VedgeEventQueue;
+
+
 // Initial state.
 typedef struct VedgeState {
     // Has vmath_init been called successfully?
     bool vmath_initialised;
+    // Has vjobs_init been called successfully?
+    bool vjobs_initialised;
     // The private vdraw context.
     VdrawContext private_vdraw_context;
     // Pointer to the vdraw context or NULL (not successfully initialised).
     VdrawContext * vdraw_context;
+    // Main loop timer.
+    VloopTimer loop;
+    // Frame buffer and scene traversal stacks.
+    VedgeFrame frame;
+    // Simulation thread loop timer (threaded main loop).
+    VloopTimer simulation_loop;
+    // Frame snapshots from the simulation thread to the main thread (threaded main loop).
+    VsnapTriple snapshots;
+    // Has the main loop been asked to quit?
+    bool quit;
+    // Non-zero once the threaded main loop has been asked to quit.
+    SDL_atomic_t stop;
+    // Event dispatch table built from the event handlers (NULL where there is no handler).
+    vedge_event_dispatch event_dispatch[VEDGE_EVENT_SLOTS];
+    // Events for the simulation thread's handlers (threaded main loop).
+    VedgeEventQueue event_queue;
     // vEdge iniitialised successfully.
     bool initialised;
 } VedgeState;
 
 
-// Event handlers function pointer types.
-typedef struct VedgeContext VedgeContext;
+// Event handlers function pointer types. Handlers run on the thread running the
+// update and render callbacks: the main thread, or when threaded the simulation thread.
 typedef void (*vedge_sdl2_common_handler)(VedgeContext * vedge, SDL_CommonEvent * common);
 typedef void (*vedge_sdl2_window_handler)(VedgeContext * vedge, SDL_WindowEvent * window);
 typedef void (*vedge_sdl2_keyboard_handler)(VedgeContext * vedge, SDL_KeyboardEvent * key);
@@ -185,9 +360,30 @@ void vedge_done(VedgeContext * vedge);
 typedef int * (dd)();
 
 
-// .
+// Run the main loop until quit: events, fixed-timestep updates, render, then pace the frame.
+// When threaded, a simulation thread handles events and runs the updates and renders into
+// frame snapshots, and the main thread drains the events and draws the newest snapshot each frame.
 int vedge_run(VedgeContext * vedge);
 
+// Ask the main loop to quit at the end of the current frame.
+void vedge_quit(VedgeContext * vedge);
+
+// Set the event handlers and rebuild the event dispatch table from them.
+void vedge_set_event_handlers(VedgeContext * vedge, const VedgeEventHandlers * handlers);
+
+// Dispatch an event to its handler, if any.
+void vedge_handle_event(VedgeContext * vedge, SDL_Event * event);
+
+// Drain pending events in batches and dispatch them, up to VEDGE_EVENTS_PER_FRAME;
+// SDL_QUIT also asks the main loop to quit. Returns the number of events handled.
+int vedge_handle_events(VedgeContext * vedge);
+
+// Get the main loop timing statistics.
+const VloopStats * vedge_get_loop_stats(const VedgeContext * vedge);
+
+// Get the vdraw context (NULL if not initialised).
+VdrawContext * vedge_get_vdraw(VedgeContext * vedge);
+
 
 //-----------------------------------------------------------------------------
 // Vector Display Graphics Engine State Update Types.
@@ -316,6 +512,9 @@ typedef union VedgeGameItemVariant {
 typedef struct VedgeGameItem {
     ItemType type;
     VedgeGameItemVariant game_item;
+    // Cached bounds of the item data, computed when needed.
+    VedgeBounds bounds;
+    bool bounds_valid;
 } VedgeGameItem;
 
 //
@@ -328,9 +527,6 @@ typedef struct VedgeGameItem {
 //};
 //
 
-typedef struct VedgeGameObject VedgeGameObject;
-
-
 typedef struct VedgeGameObjectItems {
     int length;
     VedgeGameItem game_items[];
@@ -352,6 +548,24 @@ typedef struct VedgeGameObject {
     VmathMatrix3x3 rotation;
     // The size of this object within the world.
     VmathMatrix3x3 scaling;
+    // Incremented by vedge_game_object_changed() after position, rotation or scaling change.
+    uint64_t local_version;
+    // Cached world transform (parent world * position * rotation * scaling),
+    // recomputed only when the object or an ancestor changed.
+    VmathMatrix3x3 world;
+    // Incremented each time world is recomputed (0 = never computed).
+    uint64_t world_version;
+    // Local version, parent (NULL for a root) and parent world version world was
+    // computed from; the parent is compared too as versions are per object.
+    uint64_t world_local_version;
+    const VedgeGameObject * world_parent;
+    uint64_t world_parent_version;
+    // Parent game object, set when the object is first visited (NULL for a root).
+    VedgeGameObject * parent;
+    // Cached bounds of the object's items and descendants in the object's own
+    // space (before its position, rotation and scaling), computed when needed.
+    VedgeBounds bounds;
+    bool bounds_valid;
     // Enablement.
     bool enable;
     // Optional application_data.
@@ -374,15 +588,33 @@ typedef struct VedgeGameObject {
 
 //void vedge_
 
+// Start a frame: clear the screen (unless building a snapshot) and the frame buffer,
+// and set the viewport to the screen.
 void vedge_frame_start(VedgeContext * context);
 
 
+// Finish a frame: draw what remains in the frame buffer.
 void vedge_frame_finish(VedgeContext * context);
 
+// Note that the game object's position, rotation or scaling changed.
+void vedge_game_object_changed(VedgeGameObject * game_object);
+
+// Note that the game object's items (or their data) or children changed.
+void vedge_game_object_bounds_changed(VedgeGameObject * game_object);
+
+// Add an enabled game object and its enabled descendants to the frame, each
+// transformed by position * rotation * scaling after its parent's transform.
+// Cached world transforms are reused unless the object or an ancestor changed,
+// and objects whose bounds are outside the viewport are skipped with their descendants.
+void vedge_frame_add_game_object(VedgeContext * context, VedgeGameObject * game_object);
 
-void vedge_frame_add_game_object(VedgeContext * context, const VedgeGameObject * game_object);
+// Add the game objects to the frame.
+void vedge_frame_add_game_objects(VedgeContext * context, const int length, VedgeGameObject * game_objects);
 
-void vedge_frame_add_game_objects(VedgeContext * context, const int length, const VedgeGameObject * game_objects);
+// Add the store's visible entities to the frame using their world transforms
+// from the last vstore_update_world(), skipping those whose bounds are outside
+// the viewport. Entities are culled and transformed in parallel jobs.
+void vedge_frame_add_store(VedgeContext * context, struct VstoreStore * store);
 
 
 
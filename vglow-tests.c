@@ -0,0 +1,255 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) vGlow Unit Tests.
+// Filename:     vglow-tests.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 11:48
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+// API under test.
+#include "vglow.h"
+#include "vraster.h"
+#include "vjobs.h"
+
+
+// CTest configuration.
+#define CTEST_MAIN
+#define CTEST_SEGFAULT
+
+// CTest Extra include (implementation) file.
+#include "ctestx.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Test Fixture Lifecycle.
+//-----------------------------------------------------------------------------
+
+CTEST_DATA(vglow)
+{
+    VrasterBuffer raster;
+    VglowBuffer glow;
+    uint32_t argb[61 * 37];
+};
+
+
+CTEST_SETUP(vglow)
+{
+    ASSERT_TRUE(vjobs_init(3));
+    ASSERT_TRUE(vraster_init(&data->raster, 61, 37));
+}
+
+
+CTEST_TEARDOWN(vglow)
+{
+    vglow_done(&data->glow);
+    vraster_done(&data->raster);
+    vjobs_done();
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Get a glow channel value (0 = blue, 1 = green, 2 = red).
+static int test_vglow_channel(struct vglow_data * data, const int x, const int y, const int channel)
+{
+    return data->glow.pixels[(y * data->glow.pitch) + (x * VRASTER_CHANNELS) + channel];
+}
+
+
+// Fill the screen pixels with a colour.
+static void test_vglow_fill(struct vglow_data * data, const uint32_t argb)
+{
+    for (size_t i = 0;  i < _countof(data->argb);  i++) {
+        data->argb[i] = argb;
+    }
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vglow, test_vglow_init_full) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_FULL));
+    ASSERT_EQUAL(61, data->glow.width);
+    ASSERT_EQUAL(37, data->glow.height);
+    ASSERT_EQUAL(VGLOW_DEFAULT_RADIUS, data->glow.radius);
+}
+
+
+CTEST2(vglow, test_vglow_init_half) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_HALF));
+    ASSERT_EQUAL(31, data->glow.width);
+    ASSERT_EQUAL(19, data->glow.height);
+    ASSERT_EQUAL(VGLOW_DEFAULT_RADIUS / 2, data->glow.radius);
+}
+
+
+CTEST2(vglow, test_vglow_init_quarter) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_QUARTER));
+    ASSERT_EQUAL(16, data->glow.width);
+    ASSERT_EQUAL(10, data->glow.height);
+    ASSERT_EQUAL(VGLOW_DEFAULT_RADIUS / 4, data->glow.radius);
+}
+
+
+CTEST2(vglow, test_vglow_done) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_FULL));
+    vglow_done(&data->glow);
+    ASSERT_NULL(data->glow.pixels);
+    ASSERT_NULL(data->glow.scratch);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process State Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vglow, test_vglow_set_radius) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_QUARTER));
+    vglow_set_radius(&data->glow, 1);
+    ASSERT_EQUAL(1, data->glow.radius);
+    vglow_set_radius(&data->glow, 0);
+    ASSERT_EQUAL(0, data->glow.radius);
+    vglow_set_radius(&data->glow, 1000);
+    ASSERT_EQUAL(VGLOW_MAX_RADIUS, data->glow.radius);
+}
+
+
+CTEST2(vglow, test_vglow_set_strength) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_FULL));
+    vglow_set_strength(&data->glow, VMATHNUMBER_C(0.5));
+    ASSERT_EQUAL(128, data->glow.strength);
+    vglow_set_strength(&data->glow, VMATHNUMBER_C(100.0));
+    ASSERT_EQUAL(1024, data->glow.strength);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Frame Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vglow, test_vglow_blur_no_radius) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_FULL));
+    vglow_set_radius(&data->glow, 0);
+    vraster_point(&data->raster, 10, 10, 200, 100, 50);
+    vglow_blur(&data->glow, &data->raster);
+    ASSERT_EQUAL(50, test_vglow_channel(data, 10, 10, 0));
+    ASSERT_EQUAL(100, test_vglow_channel(data, 10, 10, 1));
+    ASSERT_EQUAL(200, test_vglow_channel(data, 10, 10, 2));
+    ASSERT_EQUAL(0, test_vglow_channel(data, 11, 10, 2));
+}
+
+
+CTEST2(vglow, test_vglow_blur_strength) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_FULL));
+    vglow_set_radius(&data->glow, 0);
+    vglow_set_strength(&data->glow, VMATHNUMBER_C(2.0));
+    vraster_point(&data->raster, 10, 10, 200, 100, 50);
+    vglow_blur(&data->glow, &data->raster);
+    ASSERT_EQUAL(400, test_vglow_channel(data, 10, 10, 2));
+}
+
+
+CTEST2(vglow, test_vglow_blur_downsample) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_HALF));
+    vglow_set_radius(&data->glow, 0);
+    vraster_rect(&data->raster, 10, 10, 2, 2, 200, 200, 200);
+    vraster_point(&data->raster, 20, 20, 200, 200, 200);
+    vraster_point(&data->raster, 60, 36, 200, 200, 200);
+    vglow_blur(&data->glow, &data->raster);
+    ASSERT_EQUAL(200, test_vglow_channel(data, 5, 5, 2));
+    ASSERT_EQUAL(50, test_vglow_channel(data, 10, 10, 2));
+    // Edge blocks are partially outside the screen.
+    ASSERT_EQUAL(50, test_vglow_channel(data, 30, 18, 2));
+}
+
+
+CTEST2(vglow, test_vglow_blur_spreads) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_FULL));
+    vglow_set_radius(&data->glow, 2);
+    vraster_point(&data->raster, 30, 18, 255, 255, 255);
+    vglow_blur(&data->glow, &data->raster);
+    const int centre = test_vglow_channel(data, 30, 18, 2);
+    ASSERT_TRUE(centre > test_vglow_channel(data, 32, 18, 2));
+    ASSERT_TRUE(test_vglow_channel(data, 32, 18, 2) > test_vglow_channel(data, 34, 18, 2));
+    ASSERT_TRUE(test_vglow_channel(data, 30, 22, 2) > 0);
+    // Two passes of a 5 tap box have a 9 tap footprint.
+    ASSERT_EQUAL(0, test_vglow_channel(data, 35, 18, 2));
+    ASSERT_EQUAL(0, test_vglow_channel(data, 30, 13, 2));
+    // Symmetric.
+    ASSERT_EQUAL(test_vglow_channel(data, 34, 18, 2), test_vglow_channel(data, 26, 18, 2));
+    ASSERT_EQUAL(test_vglow_channel(data, 30, 21, 2), test_vglow_channel(data, 30, 15, 2));
+    ASSERT_EQUAL(test_vglow_channel(data, 32, 20, 2), test_vglow_channel(data, 28, 16, 2));
+}
+
+
+CTEST2(vglow, test_vglow_blur_flat) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_FULL));
+    vglow_set_radius(&data->glow, 3);
+    vraster_rect(&data->raster, 0, 0, 61, 37, 100, 100, 100);
+    vglow_blur(&data->glow, &data->raster);
+    ASSERT_EQUAL(100, test_vglow_channel(data, 30, 18, 2));
+}
+
+
+CTEST2(vglow, test_vglow_composite) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_FULL));
+    vglow_set_radius(&data->glow, 0);
+    vraster_point(&data->raster, 10, 10, 200, 100, 50);
+    vraster_point(&data->raster, 11, 10, 200, 100, 50);
+    vglow_blur(&data->glow, &data->raster);
+    test_vglow_fill(data, 0xFF808080u);
+    vglow_composite(&data->glow, data->argb, 61 * sizeof(uint32_t));
+    ASSERT_EQUAL(0xFFFFE4B2u, data->argb[(10 * 61) + 10]);
+    ASSERT_EQUAL(0xFFFFE4B2u, data->argb[(10 * 61) + 11]);
+    ASSERT_EQUAL(0xFF808080u, data->argb[(10 * 61) + 12]);
+    ASSERT_EQUAL(0xFF808080u, data->argb[(36 * 61) + 60]);
+}
+
+
+CTEST2(vglow, test_vglow_composite_half) {
+    ASSERT_TRUE(vglow_init(&data->glow, 61, 37, VGLOW_QUALITY_HALF));
+    vglow_set_radius(&data->glow, 0);
+    vraster_rect(&data->raster, 58, 34, 3, 3, 40, 40, 40);
+    vglow_blur(&data->glow, &data->raster);
+    test_vglow_fill(data, 0xFF000000u);
+    vglow_composite(&data->glow, data->argb, 61 * sizeof(uint32_t));
+    ASSERT_EQUAL(0xFF282828u, data->argb[(34 * 61) + 58]);
+    ASSERT_EQUAL(0xFF282828u, data->argb[(35 * 61) + 59]);
+    ASSERT_EQUAL(0xFF0A0A0Au, data->argb[(36 * 61) + 60]);
+    ASSERT_EQUAL(0xFF000000u, data->argb[(33 * 61) + 58]);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// CTest Main.
+//-----------------------------------------------------------------------------
+
+CTESTX_MAIN
@@ -0,0 +1,404 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Glow Post-Process.
+// Filename:     vglow.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 11:05
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <SDL.h>
+
+#include "vglow.h"
+#include "vjobs.h"
+
+#ifdef VRASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Utility Types.
+//-----------------------------------------------------------------------------
+
+// Channel values per SIMD register (one column group).
+#define VGLOW_LANES 8
+
+
+// Glow pass job data.
+typedef struct VglowPass {
+    VglowBuffer * glow;
+    const VrasterBuffer * raster;
+    // Blur pass source and destination channels.
+    const uint16_t * src;
+    uint16_t * dst;
+    // Box filter reciprocal, 0.16 fixed point.
+    uint16_t reciprocal;
+} VglowPass;
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a glow buffer for a screen of width by height pixels.
+bool vglow_init(VglowBuffer * glow, const int width, const int height, const VglowQuality quality)
+{
+    assert (glow != NULL);
+    assert (width > 0);
+    assert (height > 0);
+    SDL_zerop(glow);
+    glow->screen_width = width;
+    glow->screen_height = height;
+    glow->shift = (int)quality;
+    glow->width = (width + (1 << glow->shift) - 1) >> glow->shift;
+    glow->height = (height + (1 << glow->shift) - 1) >> glow->shift;
+    glow->pitch = ((glow->width * VRASTER_CHANNELS) + VGLOW_LANES - 1) & ~(VGLOW_LANES - 1);
+    glow->pixels = calloc((size_t)glow->pitch * glow->height, sizeof(uint16_t));
+    glow->scratch = calloc((size_t)glow->pitch * glow->height, sizeof(uint16_t));
+    if ((glow->pixels == NULL) || (glow->scratch == NULL)) {
+        vglow_done(glow);
+        return false;
+    }
+    vglow_set_radius(glow, VGLOW_DEFAULT_RADIUS);
+    vglow_set_strength(glow, VGLOW_DEFAULT_STRENGTH);
+    return true;
+}
+
+
+// Clean-up the glow buffer.
+void vglow_done(VglowBuffer * glow)
+{
+    assert (glow != NULL);
+    free(glow->scratch);
+    free(glow->pixels);
+    SDL_zerop(glow);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process State Functions.
+//-----------------------------------------------------------------------------
+
+// Set the blur radius in screen pixels.
+void vglow_set_radius(VglowBuffer * glow, const int radius)
+{
+    assert (glow != NULL);
+    int scaled = SDL_max(radius, 0) >> glow->shift;
+    if ((radius > 0) && (scaled == 0)) {
+        scaled = 1;
+    }
+    glow->radius = SDL_min(scaled, VGLOW_MAX_RADIUS);
+}
+
+
+// Set the glow strength (0.0 to VGLOW_MAX_STRENGTH).
+void vglow_set_strength(VglowBuffer * glow, const VmathNumber strength)
+{
+    assert (glow != NULL);
+    glow->strength = (uint16_t)(vmath_clip_floor_ceil(strength, VMATHNUMBER_C(0.0), VGLOW_MAX_STRENGTH)
+                                * VMATHNUMBER_C(256.0));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Passes.
+//-----------------------------------------------------------------------------
+
+// Average raster blocks into glow rows [begin, end), scaled by the strength.
+static void vglow_downsample_rows(void * data, const int begin, const int end)
+{
+    const VglowPass * pass = data;
+    const VglowBuffer * glow = pass->glow;
+    const VrasterBuffer * raster = pass->raster;
+    const int shift = glow->shift;
+#ifdef VRASTER_SSE2
+    const __m128i strength = _mm_set1_epi16((short)glow->strength);
+#endif
+    for (int gy = begin;  gy < end;  gy++) {
+        uint16_t * out = glow->pixels + ((size_t)gy * glow->pitch);
+#ifdef VRASTER_SSE2
+        // Full resolution is a straight copy of the integer part, scaled.
+        if (shift == 0) {
+            const uint16_t * in = raster->pixels + ((size_t)gy * raster->pitch);
+            const __m128i mask = _mm_set1_epi16((short)0xFF00);
+            for (int i = 0;  i < glow->pitch;  i += VGLOW_LANES) {
+                const __m128i value = _mm_and_si128(_mm_loadu_si128((const __m128i *)(in + i)), mask);
+                _mm_storeu_si128((__m128i *)(out + i), _mm_mulhi_epu16(value, strength));
+            }
+            continue;
+        }
+#endif
+        const int y1 = gy << shift;
+        const int y2 = SDL_min(y1 + (1 << shift), raster->height);
+        for (int gx = 0;  gx < glow->width;  gx++, out += VRASTER_CHANNELS) {
+            const int x1 = gx << shift;
+            const int x2 = SDL_min(x1 + (1 << shift), raster->width);
+#ifdef VRASTER_SSE2
+            __m128i sum = _mm_setzero_si128();
+            for (int y = y1;  y < y2;  y++) {
+                const uint16_t * in = raster->pixels + ((size_t)y * raster->pitch) + ((size_t)x1 * VRASTER_CHANNELS);
+                for (int x = x1;  x < x2;  x++, in += VRASTER_CHANNELS) {
+                    sum = _mm_add_epi16(sum, _mm_srli_epi16(_mm_loadl_epi64((const __m128i *)in), 8));
+                }
+            }
+            sum = _mm_slli_epi16(_mm_srli_epi16(sum, 2 * shift), 8);
+            _mm_storel_epi64((__m128i *)out, _mm_mulhi_epu16(sum, strength));
+#else
+            unsigned int sum[VRASTER_CHANNELS] = { 0 };
+            for (int y = y1;  y < y2;  y++) {
+                const uint16_t * in = raster->pixels + ((size_t)y * raster->pitch) + ((size_t)x1 * VRASTER_CHANNELS);
+                for (int x = x1;  x < x2;  x++, in += VRASTER_CHANNELS) {
+                    for (int c = 0;  c < VRASTER_CHANNELS;  c++) {
+                        sum[c] += in[c] >> 8;
+                    }
+                }
+            }
+            for (int c = 0;  c < VRASTER_CHANNELS;  c++) {
+                out[c] = (uint16_t)((((sum[c] >> (2 * shift)) << 8) * glow->strength) >> 16);
+            }
+#endif
+        }
+    }
+}
+
+
+// Box blur rows [begin, end) from the pass source to the destination.
+static void vglow_blur_rows(void * data, const int begin, const int end)
+{
+    const VglowPass * pass = data;
+    const VglowBuffer * glow = pass->glow;
+    const int radius = glow->radius;
+    const int width = glow->width;
+#ifdef VRASTER_SSE2
+    const __m128i reciprocal = _mm_set1_epi16((short)pass->reciprocal);
+#endif
+    for (int y = begin;  y < end;  y++) {
+        const uint16_t * src = pass->src + ((size_t)y * glow->pitch);
+        uint16_t * dst = pass->dst + ((size_t)y * glow->pitch);
+#ifdef VRASTER_SSE2
+        __m128i sum = _mm_setzero_si128();
+        for (int x = 0;  (x < radius) && (x < width);  x++) {
+            sum = _mm_add_epi16(sum, _mm_loadl_epi64((const __m128i *)(src + (x * VRASTER_CHANNELS))));
+        }
+        for (int x = 0;  x < width;  x++) {
+            if ((x + radius) < width) {
+                sum = _mm_add_epi16(sum, _mm_loadl_epi64((const __m128i *)(src + ((x + radius) * VRASTER_CHANNELS))));
+            }
+            _mm_storel_epi64((__m128i *)(dst + (x * VRASTER_CHANNELS)), _mm_mulhi_epu16(sum, reciprocal));
+            if (x >= radius) {
+                sum = _mm_sub_epi16(sum, _mm_loadl_epi64((const __m128i *)(src + ((x - radius) * VRASTER_CHANNELS))));
+            }
+        }
+#else
+        unsigned int sum[VRASTER_CHANNELS] = { 0 };
+        for (int x = 0;  (x < radius) && (x < width);  x++) {
+            for (int c = 0;  c < VRASTER_CHANNELS;  c++) {
+                sum[c] += src[(x * VRASTER_CHANNELS) + c];
+            }
+        }
+        for (int x = 0;  x < width;  x++) {
+            for (int c = 0;  c < VRASTER_CHANNELS;  c++) {
+                if ((x + radius) < width) {
+                    sum[c] += src[((x + radius) * VRASTER_CHANNELS) + c];
+                }
+                dst[(x * VRASTER_CHANNELS) + c] = (uint16_t)((sum[c] * pass->reciprocal) >> 16);
+                if (x >= radius) {
+                    sum[c] -= src[((x - radius) * VRASTER_CHANNELS) + c];
+                }
+            }
+        }
+#endif
+    }
+}
+
+
+// Box blur column groups [begin, end) from the pass source to the destination.
+static void vglow_blur_columns(void * data, const int begin, const int end)
+{
+    const VglowPass * pass = data;
+    const VglowBuffer * glow = pass->glow;
+    const int radius = glow->radius;
+    const int height = glow->height;
+    const size_t pitch = (size_t)glow->pitch;
+#ifdef VRASTER_SSE2
+    const __m128i reciprocal = _mm_set1_epi16((short)pass->reciprocal);
+    __m128i sums[VGLOW_GROUPS_PER_JOB];
+#else
+    unsigned int sums[VGLOW_GROUPS_PER_JOB * VGLOW_LANES];
+#endif
+    // The running sums are kept for one chunk of groups at a time.
+    for (int first = begin;  first < end;  first += VGLOW_GROUPS_PER_JOB) {
+        const int lanes = SDL_min(end - first, VGLOW_GROUPS_PER_JOB) * VGLOW_LANES;
+        const uint16_t * src = pass->src + ((size_t)first * VGLOW_LANES);
+        uint16_t * dst = pass->dst + ((size_t)first * VGLOW_LANES);
+#ifdef VRASTER_SSE2
+        for (int i = 0;  i < lanes;  i += VGLOW_LANES) {
+            sums[i / VGLOW_LANES] = _mm_setzero_si128();
+        }
+        for (int y = 0;  (y < radius) && (y < height);  y++) {
+            for (int i = 0;  i < lanes;  i += VGLOW_LANES) {
+                sums[i / VGLOW_LANES] = _mm_add_epi16(sums[i / VGLOW_LANES],
+                                                      _mm_loadu_si128((const __m128i *)(src + (y * pitch) + i)));
+            }
+        }
+        for (int y = 0;  y < height;  y++) {
+            const uint16_t * add_row = ((y + radius) < height) ? (src + ((y + radius) * pitch)) : NULL;
+            const uint16_t * sub_row = (y >= radius) ? (src + ((y - radius) * pitch)) : NULL;
+            uint16_t * out = dst + (y * pitch);
+            for (int i = 0;  i < lanes;  i += VGLOW_LANES) {
+                __m128i sum = sums[i / VGLOW_LANES];
+                if (add_row != NULL) {
+                    sum = _mm_add_epi16(sum, _mm_loadu_si128((const __m128i *)(add_row + i)));
+                }
+                _mm_storeu_si128((__m128i *)(out + i), _mm_mulhi_epu16(sum, reciprocal));
+                if (sub_row != NULL) {
+                    sum = _mm_sub_epi16(sum, _mm_loadu_si128((const __m128i *)(sub_row + i)));
+                }
+                sums[i / VGLOW_LANES] = sum;
+            }
+        }
+#else
+        for (int i = 0;  i < lanes;  i++) {
+            sums[i] = 0;
+        }
+        for (int y = 0;  (y < radius) && (y < height);  y++) {
+            for (int i = 0;  i < lanes;  i++) {
+                sums[i] += src[(y * pitch) + i];
+            }
+        }
+        for (int y = 0;  y < height;  y++) {
+            const uint16_t * add_row = ((y + radius) < height) ? (src + ((y + radius) * pitch)) : NULL;
+            const uint16_t * sub_row = (y >= radius) ? (src + ((y - radius) * pitch)) : NULL;
+            uint16_t * out = dst + (y * pitch);
+            for (int i = 0;  i < lanes;  i++) {
+                if (add_row != NULL) {
+                    sums[i] += add_row[i];
+                }
+                out[i] = (uint16_t)((sums[i] * pass->reciprocal) >> 16);
+                if (sub_row != NULL) {
+                    sums[i] -= sub_row[i];
+                }
+            }
+        }
+#endif
+    }
+}
+
+
+// Composite job data.
+typedef struct VglowComposite {
+    const VglowBuffer * glow;
+    uint8_t * argb8888;
+    int pitch;
+} VglowComposite;
+
+
+// Add the glow to screen rows [begin, end) with saturation.
+static void vglow_composite_rows(void * data, const int begin, const int end)
+{
+    const VglowComposite * composite = data;
+    const VglowBuffer * glow = composite->glow;
+    const int shift = glow->shift;
+    for (int y = begin;  y < end;  y++) {
+        const uint16_t * in = glow->pixels + ((size_t)(y >> shift) * glow->pitch);
+        uint8_t * out = composite->argb8888 + ((size_t)y * composite->pitch);
+        int x = 0;
+#ifdef VRASTER_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        if (shift == 0) {
+            for (;  (x + 4) <= glow->screen_width;  x += 4) {
+                const uint16_t * add = in + (x * VRASTER_CHANNELS);
+                __m128i * pixels = (__m128i *)(out + (x * sizeof(uint32_t)));
+                const __m128i value = _mm_loadu_si128(pixels);
+                const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(value, zero),
+                                                 _mm_loadu_si128((const __m128i *)add));
+                const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(value, zero),
+                                                 _mm_loadu_si128((const __m128i *)(add + VGLOW_LANES)));
+                _mm_storeu_si128(pixels, _mm_packus_epi16(lo, hi));
+            }
+        }
+        for (;  (x + 2) <= glow->screen_width;  x += 2) {
+            const __m128i add = _mm_unpacklo_epi64(
+                    _mm_loadl_epi64((const __m128i *)(in + ((x >> shift) * VRASTER_CHANNELS))),
+                    _mm_loadl_epi64((const __m128i *)(in + (((x + 1) >> shift) * VRASTER_CHANNELS))));
+            __m128i * pixels = (__m128i *)(out + (x * sizeof(uint32_t)));
+            const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(pixels), zero), add);
+            _mm_storel_epi64(pixels, _mm_packus_epi16(sum, sum));
+        }
+#endif
+        for (;  x < glow->screen_width;  x++) {
+            const uint16_t * add = in + ((x >> shift) * VRASTER_CHANNELS);
+            uint8_t * pixel = out + (x * sizeof(uint32_t));
+            for (int c = 0;  c < 3;  c++) {
+                const unsigned int sum = pixel[c] + add[c];
+                pixel[c] = (sum > 255) ? 255 : (uint8_t)sum;
+            }
+        }
+    }
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Frame Functions.
+//-----------------------------------------------------------------------------
+
+// Downsample the raster buffer into the glow buffer and blur it.
+void vglow_blur(VglowBuffer * glow, const VrasterBuffer * raster)
+{
+    assert (glow != NULL);
+    assert (raster != NULL);
+    assert (raster->width == glow->screen_width);
+    assert (raster->height == glow->screen_height);
+    VglowPass pass = { .glow = glow, .raster = raster };
+    vjobs_parallel_for(0, glow->height, VGLOW_ROWS_PER_JOB, vglow_downsample_rows, &pass);
+    if (glow->radius == 0) {
+        return;
+    }
+    // Rounded up so that a flat area keeps its full value.
+    const int taps = (2 * glow->radius) + 1;
+    pass.reciprocal = (uint16_t)((65536 + taps - 1) / taps);
+    for (int i = 0;  i < VGLOW_PASSES;  i++) {
+        pass.src = glow->pixels;
+        pass.dst = glow->scratch;
+        vjobs_parallel_for(0, glow->height, VGLOW_ROWS_PER_JOB, vglow_blur_rows, &pass);
+        pass.src = glow->scratch;
+        pass.dst = glow->pixels;
+        vjobs_parallel_for(0, glow->pitch / VGLOW_LANES, VGLOW_GROUPS_PER_JOB, vglow_blur_columns, &pass);
+    }
+}
+
+
+// Add the glow to resolved ARGB8888 screen pixels (pitch in bytes).
+void vglow_composite(const VglowBuffer * glow, void * argb8888, const int pitch)
+{
+    assert (glow != NULL);
+    assert (argb8888 != NULL);
+    VglowComposite composite = { .glow = glow, .argb8888 = argb8888, .pitch = pitch };
+    vjobs_parallel_for(0, glow->screen_height, VGLOW_ROWS_PER_JOB, vglow_composite_rows, &composite);
+}
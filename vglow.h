@@ -0,0 +1,155 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Glow Post-Process.
+// Filename:     vglow.h
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 11:05
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __VGLOW__H__
+#define __VGLOW__H__
+
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vmath.h"
+#include "vraster.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Configuration.
+//-----------------------------------------------------------------------------
+
+// Number of box blur passes (2 = triangle, 3 or more approaches a Gaussian).
+#ifndef VGLOW_PASSES
+#define VGLOW_PASSES 2
+#endif
+
+// Default blur radius in screen pixels.
+#ifndef VGLOW_DEFAULT_RADIUS
+#define VGLOW_DEFAULT_RADIUS 8
+#endif
+
+// Default glow strength.
+#ifndef VGLOW_DEFAULT_STRENGTH
+#define VGLOW_DEFAULT_STRENGTH VMATHNUMBER_C(1.0)
+#endif
+
+// Number of rows per parallel job chunk.
+#ifndef VGLOW_ROWS_PER_JOB
+#define VGLOW_ROWS_PER_JOB 16
+#endif
+
+// Number of 8 channel column groups per parallel job chunk.
+#ifndef VGLOW_GROUPS_PER_JOB
+#define VGLOW_GROUPS_PER_JOB 16
+#endif
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Constants.
+//-----------------------------------------------------------------------------
+
+// Maximum blur radius in glow pixels (keeps the 16 bit running sums in range).
+#define VGLOW_MAX_RADIUS 31
+
+// Maximum glow strength.
+#define VGLOW_MAX_STRENGTH VMATHNUMBER_C(4.0)
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Types.
+//-----------------------------------------------------------------------------
+
+// Glow quality; the blur runs at full, half or quarter resolution.
+typedef enum VglowQuality {
+    VGLOW_QUALITY_FULL = 0,
+    VGLOW_QUALITY_HALF = 1,
+    VGLOW_QUALITY_QUARTER = 2
+} VglowQuality;
+
+
+// Glow buffer (access via API functions only).
+typedef struct VglowBuffer {
+    // Screen pixel width.
+    int screen_width;
+    // Screen pixel height.
+    int screen_height;
+    // Downsample shift (the VglowQuality).
+    int shift;
+    // Glow pixel width.
+    int width;
+    // Glow pixel height.
+    int height;
+    // Channel values per row (width * VRASTER_CHANNELS, padded for SIMD).
+    int pitch;
+    // Glow channel values (0 to 255 * VGLOW_MAX_STRENGTH).
+    uint16_t * pixels;
+    // Intermediate channel values between the row and column passes.
+    uint16_t * scratch;
+    // Blur radius in glow pixels (0 = no blur).
+    int radius;
+    // Glow strength, 8.8 fixed point.
+    uint16_t strength;
+} VglowBuffer;
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a glow buffer for a screen of width by height pixels.
+bool vglow_init(VglowBuffer * glow, const int width, const int height, const VglowQuality quality);
+
+// Clean-up the glow buffer.
+void vglow_done(VglowBuffer * glow);
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process State Functions.
+//-----------------------------------------------------------------------------
+
+// Set the blur radius in screen pixels.
+void vglow_set_radius(VglowBuffer * glow, const int radius);
+
+// Set the glow strength (0.0 to VGLOW_MAX_STRENGTH).
+void vglow_set_strength(VglowBuffer * glow, const VmathNumber strength);
+
+
+
+//-----------------------------------------------------------------------------
+// Glow Post-Process Frame Functions.
+//-----------------------------------------------------------------------------
+
+// Downsample the raster buffer into the glow buffer and blur it.
+void vglow_blur(VglowBuffer * glow, const VrasterBuffer * raster);
+
+// Add the glow to resolved ARGB8888 screen pixels (pitch in bytes).
+void vglow_composite(const VglowBuffer * glow, void * argb8888, const int pitch);
+
+
+
+#endif /* __VGLOW__H__ */
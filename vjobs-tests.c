@@ -0,0 +1,303 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) vJobs Unit Tests.
+// Filename:     vjobs-tests.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 18:55
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include <string.h>
+
+// API under test.
+#include "vjobs.h"
+
+
+// CTest configuration.
+#define CTEST_MAIN
+#define CTEST_SEGFAULT
+
+// CTest Extra include (implementation) file.
+#include "ctestx.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Test Fixture Lifecycle.
+//-----------------------------------------------------------------------------
+
+// Number of indices the jobs visit.
+#define TEST_VJOBS_COUNT 100000
+
+
+// How many times each index was visited, and the threads that ran chunks.
+CTEST_DATA(vjobs)
+{
+    SDL_atomic_t visits[TEST_VJOBS_COUNT];
+    SDL_threadID threads[TEST_VJOBS_COUNT];
+    SDL_atomic_t chunks;
+    int grain;
+};
+
+
+CTEST_SETUP(vjobs)
+{
+    memset(data, 0, sizeof(*data));
+    ASSERT_TRUE(vjobs_init(3));
+    ASSERT_EQUAL(3, vjobs_get_worker_count());
+}
+
+
+CTEST_TEARDOWN(vjobs)
+{
+    vjobs_done();
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Range job: count visits to the indices and the chunk's thread, checking the grain.
+static void test_vjobs_visit(void * data, const int begin, const int end)
+{
+    struct vjobs_data * test = data;
+    if ((end - begin) > test->grain) {
+        return;
+    }
+    test->threads[SDL_AtomicAdd(&test->chunks, 1)] = SDL_ThreadID();
+    for (int i = begin;  i < end;  i++) {
+        SDL_AtomicAdd(&test->visits[i], 1);
+    }
+}
+
+
+// Range job: slowly count visits so that idle threads steal the rest.
+static void test_vjobs_visit_slowly(void * data, const int begin, const int end)
+{
+    SDL_Delay(1);
+    test_vjobs_visit(data, begin, end);
+}
+
+
+// Range job: each index is a row of 1000 indices, visited by a nested parallel for.
+static void test_vjobs_visit_rows(void * data, const int begin, const int end)
+{
+    for (int row = begin;  row < end;  row++) {
+        vjobs_parallel_for(row * 1000, (row + 1) * 1000, 100, test_vjobs_visit, data);
+    }
+}
+
+
+// Rows for a submitting thread to visit.
+typedef struct TestVjobsThread {
+    struct vjobs_data * test;
+    int begin;
+    int end;
+} TestVjobsThread;
+
+
+// Submitting thread: visit the rows with a parallel for.
+static int test_vjobs_thread(void * data)
+{
+    TestVjobsThread * thread = data;
+    vjobs_parallel_for(thread->begin, thread->end, 1, test_vjobs_visit_rows, thread->test);
+    vjobs_release_thread();
+    return 0;
+}
+
+
+// Two chunks that each wait (up to a second) for the other to start, and a
+// submitting thread kept alive afterwards so that its ID is not reused.
+typedef struct TestVjobsMeet {
+    SDL_atomic_t arrived;
+    SDL_atomic_t met;
+    SDL_sem * finish;
+} TestVjobsMeet;
+
+
+// Range job: wait for the other chunk to arrive on another thread.
+static void test_vjobs_meet(void * data, const int begin, const int end)
+{
+    TestVjobsMeet * meet = data;
+    (void)begin;
+    (void)end;
+    SDL_AtomicAdd(&meet->arrived, 1);
+    const Uint32 start = SDL_GetTicks();
+    while ((SDL_AtomicGet(&meet->arrived) < 2) && ((SDL_GetTicks() - start) < 1000)) {
+        SDL_Delay(1);
+    }
+    if (SDL_AtomicGet(&meet->arrived) >= 2) {
+        SDL_AtomicAdd(&meet->met, 1);
+    }
+}
+
+
+// Submitting thread: share the two chunks, release the deque, then wait to finish.
+static int test_vjobs_meet_thread(void * data)
+{
+    TestVjobsMeet * meet = data;
+    vjobs_parallel_for(0, 2, 1, test_vjobs_meet, meet);
+    vjobs_release_thread();
+    SDL_SemWait(meet->finish);
+    return 0;
+}
+
+
+// Was every index below count visited once, and no index from count up?
+static bool test_vjobs_visited_once(struct vjobs_data * test, const int count)
+{
+    for (int i = 0;  i < TEST_VJOBS_COUNT;  i++) {
+        if (SDL_AtomicGet(&test->visits[i]) != ((i < count) ? 1 : 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Number of different threads that ran chunks.
+static int test_vjobs_thread_count(struct vjobs_data * test)
+{
+    int count = 0;
+    for (int i = 0;  i < SDL_AtomicGet(&test->chunks);  i++) {
+        int j = 0;
+        while ((j < i) && (test->threads[j] != test->threads[i])) {
+            j++;
+        }
+        count += (j == i) ? 1 : 0;
+    }
+    return count;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Parallel Job Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vjobs, test_vjobs_parallel_for) {
+    data->grain = 64;
+    vjobs_parallel_for(0, TEST_VJOBS_COUNT, data->grain, test_vjobs_visit, data);
+    ASSERT_TRUE(test_vjobs_visited_once(data, TEST_VJOBS_COUNT));
+    // Halving never leaves a chunk under half the grain.
+    ASSERT_TRUE(SDL_AtomicGet(&data->chunks) <= (TEST_VJOBS_COUNT * 2) / data->grain);
+    // Empty and single chunk ranges.
+    vjobs_parallel_for(5, 5, data->grain, test_vjobs_visit, data);
+    vjobs_parallel_for(TEST_VJOBS_COUNT - 1, TEST_VJOBS_COUNT, data->grain, test_vjobs_visit, data);
+    ASSERT_EQUAL(2, SDL_AtomicGet(&data->visits[TEST_VJOBS_COUNT - 1]));
+}
+
+
+CTEST2(vjobs, test_vjobs_parallel_for_nested) {
+    data->grain = 100;
+    vjobs_parallel_for(0, TEST_VJOBS_COUNT / 1000, 1, test_vjobs_visit_rows, data);
+    ASSERT_TRUE(test_vjobs_visited_once(data, TEST_VJOBS_COUNT));
+}
+
+
+CTEST2(vjobs, test_vjobs_steal) {
+    // Chunks that take a while are stolen by the idle workers.
+    data->grain = 1;
+    vjobs_parallel_for(0, 64, data->grain, test_vjobs_visit_slowly, data);
+    ASSERT_TRUE(test_vjobs_visited_once(data, 64));
+    ASSERT_TRUE(test_vjobs_thread_count(data) > 1);
+}
+
+
+CTEST2(vjobs, test_vjobs_submit_wait) {
+    VjobsCounter first;
+    VjobsCounter second;
+    vjobs_counter_init(&first);
+    vjobs_counter_init(&second);
+    ASSERT_TRUE(vjobs_counter_done(&first));
+    // More single jobs than a deque holds; those that do not fit run here.
+    data->grain = TEST_VJOBS_COUNT;
+    for (int i = 0;  i < VJOBS_DEQUE_SIZE * 2;  i++) {
+        vjobs_submit(&first, i, i + 1, test_vjobs_visit, data);
+    }
+    vjobs_wait(&first);
+    ASSERT_TRUE(vjobs_counter_done(&first));
+    ASSERT_TRUE(test_vjobs_visited_once(data, VJOBS_DEQUE_SIZE * 2));
+    // A second stage depending on the first.
+    data->grain = 50;
+    vjobs_submit_for(&second, VJOBS_DEQUE_SIZE * 2, TEST_VJOBS_COUNT, data->grain, test_vjobs_visit, data);
+    vjobs_wait(&second);
+    ASSERT_TRUE(test_vjobs_visited_once(data, TEST_VJOBS_COUNT));
+}
+
+
+CTEST2(vjobs, test_vjobs_submitting_threads) {
+    // Other threads get deques of their own while they last, then run their jobs themselves.
+    enum { THREADS = VJOBS_MAX_SUBMITTERS + 2 };
+    TestVjobsThread jobs[THREADS];
+    SDL_Thread * threads[THREADS];
+    data->grain = 100;
+    for (int i = 0;  i < THREADS;  i++) {
+        jobs[i] = (TestVjobsThread){ .test = data,
+                                     .begin = (i * (TEST_VJOBS_COUNT / 1000)) / THREADS,
+                                     .end = ((i + 1) * (TEST_VJOBS_COUNT / 1000)) / THREADS };
+        threads[i] = SDL_CreateThread(test_vjobs_thread, "test_vjobs", &jobs[i]);
+        ASSERT_NOT_NULL(threads[i]);
+    }
+    for (int i = 0;  i < THREADS;  i++) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    ASSERT_TRUE(test_vjobs_visited_once(data, TEST_VJOBS_COUNT));
+}
+
+
+CTEST2(vjobs, test_vjobs_release_thread) {
+    // One thread after another shares its jobs, more threads in all than there are deques.
+    enum { THREADS = VJOBS_MAX_SUBMITTERS * 2 };
+    TestVjobsMeet meets[THREADS];
+    SDL_Thread * threads[THREADS];
+    SDL_sem * finish = SDL_CreateSemaphore(0);
+    ASSERT_NOT_NULL(finish);
+    (void)data;
+    for (int i = 0;  i < THREADS;  i++) {
+        memset(&meets[i], 0, sizeof(TestVjobsMeet));
+        meets[i].finish = finish;
+        threads[i] = SDL_CreateThread(test_vjobs_meet_thread, "test_vjobs", &meets[i]);
+        ASSERT_NOT_NULL(threads[i]);
+        while (SDL_AtomicGet(&meets[i].arrived) < 2) {
+            SDL_Delay(1);
+        }
+    }
+    for (int i = 0;  i < THREADS;  i++) {
+        SDL_SemPost(finish);
+    }
+    for (int i = 0;  i < THREADS;  i++) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    SDL_DestroySemaphore(finish);
+    for (int i = 0;  i < THREADS;  i++) {
+        ASSERT_EQUAL(2, SDL_AtomicGet(&meets[i].met));
+    }
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Main Application Entry Point.
+//-----------------------------------------------------------------------------
+
+// Function main() implementation.
+CTESTX_MAIN
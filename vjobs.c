@@ -0,0 +1,441 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Parallel Jobs.
+// Filename:     vjobs.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 09:12
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <SDL.h>
+
+#include "vjobs.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Parallel Jobs State.
+//-----------------------------------------------------------------------------
+
+// Bytes kept between fields written by different threads.
+#define VJOBS_CACHE_LINE 64
+
+
+// A queued job: func over [begin, end), split in halves while wider than grain.
+typedef struct VjobsJob {
+    VjobsRangeFunc func;
+    void * data;
+    VjobsCounter * counter;
+    int begin;
+    int end;
+    int grain;
+} VjobsJob;
+
+
+// Chase-Lev work-stealing deque. The owning thread pushes and pops jobs at the
+// bottom; other threads steal the oldest, and so largest, jobs from the top.
+// Indices only ever increase (wrapping), and the deque holds bottom - top jobs.
+typedef struct VjobsDeque {
+    SDL_atomic_t top;
+    char top_padding[VJOBS_CACHE_LINE - sizeof(SDL_atomic_t)];
+    SDL_atomic_t bottom;
+    char bottom_padding[VJOBS_CACHE_LINE - sizeof(SDL_atomic_t)];
+    VjobsJob jobs[VJOBS_DEQUE_SIZE];
+} VjobsDeque;
+
+
+// The worker pool.
+static struct {
+    int worker_count;
+    SDL_Thread * threads[VJOBS_MAX_WORKERS];
+    // Deques of the workers then of the submitting threads, and their owners'
+    // thread IDs (as pointers, for atomic access; NULL = unclaimed).
+    VjobsDeque * deques;
+    int deque_count;
+    void * owners[VJOBS_MAX_WORKERS + VJOBS_MAX_SUBMITTERS];
+    // First submitting thread deque.
+    int submitter_first;
+    // Posted to wake sleeping workers when jobs are queued or they are to quit.
+    SDL_sem * wake;
+    SDL_atomic_t sleeping;
+    SDL_atomic_t quit;
+    bool initialised;
+} vjobs;
+
+
+
+//-----------------------------------------------------------------------------
+// Deque Functions.
+//-----------------------------------------------------------------------------
+
+// Add to a deque index, wrapping.
+static inline int vjobs_index_add(const int index, const int n)
+{
+    return (int)((unsigned int)index + (unsigned int)n);
+}
+
+
+// Number of jobs between the top and bottom deque indices (negative if past).
+static inline int vjobs_index_distance(const int top, const int bottom)
+{
+    return (int)((unsigned int)bottom - (unsigned int)top);
+}
+
+
+// Push a job onto the bottom of the deque (owner only), counting it.
+// Returns false if the deque is full.
+static bool vjobs_push(const int slot, const VjobsJob * job)
+{
+    VjobsDeque * deque = &vjobs.deques[slot];
+    const int bottom = SDL_AtomicGet(&deque->bottom);
+    const int top = SDL_AtomicGet(&deque->top);
+    if (vjobs_index_distance(top, bottom) >= VJOBS_DEQUE_SIZE) {
+        return false;
+    }
+    SDL_AtomicIncRef(&job->counter->pending);
+    deque->jobs[(unsigned int)bottom & (VJOBS_DEQUE_SIZE - 1)] = *job;
+    SDL_AtomicSet(&deque->bottom, vjobs_index_add(bottom, 1));
+    // Wake a sleeping worker unless one is already being woken.
+    const int sleeping = SDL_AtomicGet(&vjobs.sleeping);
+    if ((sleeping > 0) && (SDL_SemValue(vjobs.wake) < (Uint32)sleeping)) {
+        SDL_SemPost(vjobs.wake);
+    }
+    return true;
+}
+
+
+// Pop the newest job from the bottom of the deque (owner only).
+static bool vjobs_pop(const int slot, VjobsJob * job)
+{
+    VjobsDeque * deque = &vjobs.deques[slot];
+    const int bottom = vjobs_index_add(SDL_AtomicGet(&deque->bottom), -1);
+    // Claim the bottom job before looking at the top (the exchange is a full barrier).
+    SDL_AtomicSet(&deque->bottom, bottom);
+    const int top = SDL_AtomicGet(&deque->top);
+    const int size = vjobs_index_distance(top, bottom);
+    if (size < 0) {
+        SDL_AtomicSet(&deque->bottom, top);
+        return false;
+    }
+    *job = deque->jobs[(unsigned int)bottom & (VJOBS_DEQUE_SIZE - 1)];
+    if (size > 0) {
+        return true;
+    }
+    // The last job: whoever moves the top first has it.
+    const bool taken = SDL_AtomicCAS(&deque->top, top, vjobs_index_add(top, 1));
+    SDL_AtomicSet(&deque->bottom, vjobs_index_add(top, 1));
+    return taken;
+}
+
+
+// Steal the oldest job from the top of another thread's deque.
+static bool vjobs_steal(const int slot, VjobsJob * job)
+{
+    VjobsDeque * deque = &vjobs.deques[slot];
+    const int top = SDL_AtomicGet(&deque->top);
+    const int bottom = SDL_AtomicGet(&deque->bottom);
+    if (vjobs_index_distance(top, bottom) <= 0) {
+        return false;
+    }
+    // The owner only reuses this entry once the top has moved past it, so the
+    // copy is only kept if the top is still where it was.
+    *job = deque->jobs[(unsigned int)top & (VJOBS_DEQUE_SIZE - 1)];
+    return SDL_AtomicCAS(&deque->top, top, vjobs_index_add(top, 1));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Worker Functions.
+//-----------------------------------------------------------------------------
+
+// Get the calling thread's deque owner value.
+static inline void * vjobs_owner(void)
+{
+    return (void *)(uintptr_t)SDL_ThreadID();
+}
+
+
+// Get the calling thread's deque, claiming an unclaimed submitting thread's
+// deque on its first use (-1 if none are left, or jobs are not running on threads).
+static int vjobs_get_slot(void)
+{
+    if (vjobs.worker_count == 0) {
+        return -1;
+    }
+    void * owner = vjobs_owner();
+    for (int i = 0;  i < vjobs.deque_count;  i++) {
+        if (SDL_AtomicGetPtr(&vjobs.owners[i]) == owner) {
+            return i;
+        }
+    }
+    for (int i = vjobs.submitter_first;  i < vjobs.deque_count;  i++) {
+        if (SDL_AtomicCASPtr(&vjobs.owners[i], NULL, owner)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+// Find a job: the newest of the thread's own, else one stolen from another thread.
+static bool vjobs_find(const int slot, VjobsJob * job)
+{
+    if (vjobs_pop(slot, job)) {
+        return true;
+    }
+    for (int i = 1;  i < vjobs.deque_count;  i++) {
+        if (vjobs_steal((slot + i) % vjobs.deque_count, job)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Run a job on the thread owning the slot (-1 = no deque), first pushing its
+// upper half while it is wider than its grain, for other threads to steal.
+static void vjobs_run(const int slot, VjobsJob * job)
+{
+    while ((slot >= 0) && ((job->end - job->begin) > job->grain)) {
+        VjobsJob upper = *job;
+        upper.begin = job->begin + ((job->end - job->begin) / 2);
+        if (!vjobs_push(slot, &upper)) {
+            break;
+        }
+        job->end = upper.begin;
+    }
+    if (slot < 0) {
+        // No deque to share chunks through; keep to the grain regardless.
+        for (int begin = job->begin;  begin < job->end;  begin += job->grain) {
+            job->func(job->data, begin, SDL_min(begin + job->grain, job->end));
+        }
+    } else {
+        job->func(job->data, job->begin, job->end);
+    }
+    SDL_AtomicAdd(&job->counter->pending, -1);
+}
+
+
+// Worker thread main loop.
+static int vjobs_worker(void * data)
+{
+    const int slot = (int)(intptr_t)data;
+    SDL_AtomicSetPtr(&vjobs.owners[slot], vjobs_owner());
+    VjobsJob job;
+    int idle = 0;
+    while (!SDL_AtomicGet(&vjobs.quit)) {
+        if (vjobs_find(slot, &job)) {
+            vjobs_run(slot, &job);
+            idle = 0;
+        } else if (++idle >= VJOBS_SPIN) {
+            // Sleep, unless a job was queued before the sleep was announced.
+            SDL_AtomicIncRef(&vjobs.sleeping);
+            if (vjobs_find(slot, &job)) {
+                SDL_AtomicAdd(&vjobs.sleeping, -1);
+                vjobs_run(slot, &job);
+            } else {
+                SDL_SemWait(vjobs.wake);
+                SDL_AtomicAdd(&vjobs.sleeping, -1);
+            }
+            idle = 0;
+        }
+    }
+    return 0;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Library Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise the worker threads (worker_count < 0 = one per extra CPU core).
+bool vjobs_init(const int worker_count)
+{
+    if (vjobs.initialised) {
+        return true;
+    }
+    SDL_zero(vjobs);
+    int count = (worker_count < 0) ? (SDL_GetCPUCount() - 1) : worker_count;
+    count = SDL_max(0, SDL_min(count, VJOBS_MAX_WORKERS));
+    vjobs.deque_count = count + VJOBS_MAX_SUBMITTERS;
+    vjobs.submitter_first = count;
+    vjobs.deques = calloc((size_t)vjobs.deque_count, sizeof(VjobsDeque));
+    vjobs.wake = SDL_CreateSemaphore(0);
+    if ((vjobs.deques == NULL) || (vjobs.wake == NULL)) {
+        SDL_Log("vjobs_init: calloc/SDL_CreateSemaphore failed: %s", SDL_GetError());
+        vjobs.initialised = true;
+        vjobs_done();
+        return false;
+    }
+    vjobs.initialised = true;
+    for (int i = 0;  i < count;  i++) {
+        vjobs.threads[i] = SDL_CreateThread(vjobs_worker, "vjobs", (void *)(intptr_t)i);
+        if (vjobs.threads[i] == NULL) {
+            SDL_Log("vjobs_init: SDL_CreateThread failed: %s", SDL_GetError());
+            break;
+        }
+        vjobs.worker_count++;
+    }
+    return true;
+}
+
+
+// Clean-up the worker threads.
+void vjobs_done(void)
+{
+    if (!vjobs.initialised) {
+        return;
+    }
+    SDL_AtomicSet(&vjobs.quit, 1);
+    for (int i = 0;  i < vjobs.worker_count;  i++) {
+        SDL_SemPost(vjobs.wake);
+    }
+    for (int i = 0;  i < vjobs.worker_count;  i++) {
+        SDL_WaitThread(vjobs.threads[i], NULL);
+    }
+    if (vjobs.wake != NULL) {
+        SDL_DestroySemaphore(vjobs.wake);
+    }
+    free(vjobs.deques);
+    SDL_zero(vjobs);
+}
+
+
+// Get the number of worker threads (excluding the calling thread).
+int vjobs_get_worker_count(void)
+{
+    return vjobs.worker_count;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Parallel Job Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a counter with no unfinished jobs.
+void vjobs_counter_init(VjobsCounter * counter)
+{
+    assert (counter != NULL);
+    SDL_AtomicSet(&counter->pending, 0);
+}
+
+
+// Have all of the counter's jobs finished?
+bool vjobs_counter_done(VjobsCounter * counter)
+{
+    assert (counter != NULL);
+    return SDL_AtomicGet(&counter->pending) == 0;
+}
+
+
+// Queue func over [begin, end) as one job on the calling thread's deque.
+void vjobs_submit(VjobsCounter * counter, const int begin, const int end,
+                  VjobsRangeFunc func, void * data)
+{
+    vjobs_submit_for(counter, begin, end, SDL_max(end - begin, 1), func, data);
+}
+
+
+// Queue func over [begin, end) as a job that halves itself down to chunks of
+// at most grain indices, the halves left for idle threads to steal.
+void vjobs_submit_for(VjobsCounter * counter, const int begin, const int end, const int grain,
+                      VjobsRangeFunc func, void * data)
+{
+    assert (counter != NULL);
+    assert (func != NULL);
+    assert (grain > 0);
+    if (end <= begin) {
+        return;
+    }
+    VjobsJob job = {
+            .func = func,
+            .data = data,
+            .counter = counter,
+            .begin = begin,
+            .end = end,
+            .grain = grain
+    };
+    // Without a deque, or with it full, run it here.
+    const int slot = vjobs_get_slot();
+    if ((slot < 0) || !vjobs_push(slot, &job)) {
+        SDL_AtomicIncRef(&counter->pending);
+        vjobs_run(-1, &job);
+    }
+}
+
+
+// Wait for the counter's jobs to finish, running queued jobs meanwhile.
+void vjobs_wait(VjobsCounter * counter)
+{
+    assert (counter != NULL);
+    const int slot = vjobs_get_slot();
+    VjobsJob job;
+    int idle = 0;
+    while (SDL_AtomicGet(&counter->pending) > 0) {
+        if ((slot >= 0) && vjobs_find(slot, &job)) {
+            vjobs_run(slot, &job);
+            idle = 0;
+        } else if (++idle >= VJOBS_SPIN) {
+            // Nothing to steal; yield to the threads running the last jobs.
+            SDL_Delay(0);
+        }
+    }
+}
+
+
+// Run func over [begin, end) split into chunks of at most grain indices.
+void vjobs_parallel_for(const int begin, const int end, const int grain,
+                        VjobsRangeFunc func, void * data)
+{
+    assert (func != NULL);
+    assert (grain > 0);
+    if (end <= begin) {
+        return;
+    }
+    // Too small to share, or no workers; run it here.
+    if ((vjobs.worker_count == 0) || ((end - begin) <= grain)) {
+        func(data, begin, end);
+        return;
+    }
+    VjobsCounter counter;
+    vjobs_counter_init(&counter);
+    vjobs_submit_for(&counter, begin, end, grain, func, data);
+    vjobs_wait(&counter);
+}
+
+
+// Release the calling thread's deque, if it has one, for other submitting threads.
+void vjobs_release_thread(void)
+{
+    if (vjobs.worker_count == 0) {
+        return;
+    }
+    void * owner = vjobs_owner();
+    for (int i = vjobs.submitter_first;  i < vjobs.deque_count;  i++) {
+        if (SDL_AtomicCASPtr(&vjobs.owners[i], owner, NULL)) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,132 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Parallel Jobs.
+// Filename:     vjobs.h
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 09:12
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef __VJOBS__H__
+#define __VJOBS__H__
+
+
+#include <stdbool.h>
+
+#include <SDL.h>
+
+
+
+//-----------------------------------------------------------------------------
+// Parallel Jobs Configuration.
+//-----------------------------------------------------------------------------
+
+// Maximum number of worker threads (excluding the calling thread).
+#ifndef VJOBS_MAX_WORKERS
+#define VJOBS_MAX_WORKERS 63
+#endif
+
+// Maximum number of other threads (such as the main and simulation threads)
+// with a job deque at once; jobs submitted by any more run on the submitting
+// thread. Threads release their deque with vjobs_release_thread().
+#ifndef VJOBS_MAX_SUBMITTERS
+#define VJOBS_MAX_SUBMITTERS 4
+#endif
+
+// Jobs each thread's deque holds (a power of two); jobs that do not fit run
+// on the submitting thread.
+#ifndef VJOBS_DEQUE_SIZE
+#define VJOBS_DEQUE_SIZE 256
+#endif
+
+// Rounds of steal attempts an idle worker makes before it sleeps.
+#ifndef VJOBS_SPIN
+#define VJOBS_SPIN 64
+#endif
+
+
+
+//-----------------------------------------------------------------------------
+// Parallel Jobs Types.
+//-----------------------------------------------------------------------------
+
+// Range job function; processes the half open index range [begin, end).
+typedef void (*VjobsRangeFunc)(void * data, const int begin, const int end);
+
+
+// Count of unfinished jobs, to wait on the jobs that something depends on
+// (access via API functions only).
+typedef struct VjobsCounter {
+    SDL_atomic_t pending;
+} VjobsCounter;
+
+
+
+//-----------------------------------------------------------------------------
+// Library Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise the worker threads (worker_count < 0 = one per extra CPU core).
+// Jobs run on the calling thread alone until this has been called.
+// Calling it again while initialised keeps the existing workers.
+bool vjobs_init(const int worker_count);
+
+// Clean-up the worker threads.
+void vjobs_done(void);
+
+// Get the number of worker threads (excluding the calling thread).
+int vjobs_get_worker_count(void);
+
+
+
+//-----------------------------------------------------------------------------
+// Parallel Job Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a counter with no unfinished jobs.
+void vjobs_counter_init(VjobsCounter * counter);
+
+// Have all of the counter's jobs finished?
+bool vjobs_counter_done(VjobsCounter * counter);
+
+// Queue func over [begin, end) as one job on the calling thread's deque,
+// counted by the counter until it finishes.
+void vjobs_submit(VjobsCounter * counter, const int begin, const int end,
+                  VjobsRangeFunc func, void * data);
+
+// Queue func over [begin, end) as a job that halves itself down to chunks of
+// at most grain indices, the halves left for idle threads to steal, counted
+// by the counter until every chunk finishes.
+void vjobs_submit_for(VjobsCounter * counter, const int begin, const int end, const int grain,
+                      VjobsRangeFunc func, void * data);
+
+// Wait for the counter's jobs to finish, running queued jobs meanwhile.
+void vjobs_wait(VjobsCounter * counter);
+
+// Run func over [begin, end) split into chunks of at most grain indices, sharing
+// the chunks between the calling thread and the workers. Returns when complete.
+void vjobs_parallel_for(const int begin, const int end, const int grain,
+                        VjobsRangeFunc func, void * data);
+
+// Release the calling thread's deque, if it has one, for other submitting threads.
+// Call before a thread that submitted jobs exits, once it has waited for them.
+void vjobs_release_thread(void);
+
+
+
+#endif /* __VJOBS__H__ */
@@ -0,0 +1,331 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) vLines Unit Tests.
+// Filename:     vlines-tests.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 11:48
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+// API under test.
+#include "vlines.h"
+#include "vfont-segs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+// CTest configuration.
+#define CTEST_MAIN
+#define CTEST_SEGFAULT
+
+// CTest Extra include (implementation) file.
+#include "ctestx.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Test Fixture Lifecycle.
+//-----------------------------------------------------------------------------
+
+CTEST_DATA(vlines)
+{
+    VlinesScratch * scratch;
+};
+
+
+CTEST_SETUP(vlines)
+{
+    data->scratch = malloc(sizeof(VlinesScratch));
+    ASSERT_NOT_NULL(data->scratch);
+    vlines_init(data->scratch);
+}
+
+
+CTEST_TEARDOWN(vlines)
+{
+    free(data->scratch);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Is the line from (x1,y1) to (x2,y2) in either direction?
+static bool test_vlines_is(const VedgeLine * line,
+                           const VmathNumber x1, const VmathNumber y1,
+                           const VmathNumber x2, const VmathNumber y2)
+{
+    return ((line->x1 == x1) && (line->y1 == y1) && (line->x2 == x2) && (line->y2 == y2))
+            || ((line->x1 == x2) && (line->y1 == y2) && (line->x2 == x1) && (line->y2 == y1));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Clean-up Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vlines, test_vlines_cleanup_empty) {
+    ASSERT_EQUAL(0, vlines_cleanup(data->scratch, NULL, 0));
+}
+
+
+CTEST2(vlines, test_vlines_cleanup_zero_length_and_duplicates) {
+    VedgeLine lines[] = {
+            VFONT_LINE(0, 0, 10, 0),
+            VFONT_LINE(5, 5, 5, 5),
+            VFONT_LINE(10, 0, 0, 0),
+            VFONT_LINE(0, 0, 10, 0),
+            VFONT_LINE(0, 0, 0, 10)
+    };
+    ASSERT_EQUAL(2, vlines_cleanup(data->scratch, lines, 5));
+    ASSERT_TRUE(test_vlines_is(&lines[0], 0, 0, 10, 0));
+    ASSERT_TRUE(test_vlines_is(&lines[1], 0, 0, 0, 10));
+    const VlinesStats * stats = vlines_get_stats(data->scratch);
+    ASSERT_EQUAL(5, stats->input);
+    ASSERT_EQUAL(2, stats->output);
+    ASSERT_EQUAL(1, stats->zero_length);
+    ASSERT_EQUAL(2, stats->duplicates);
+    ASSERT_EQUAL(0, stats->merged);
+}
+
+
+CTEST2(vlines, test_vlines_cleanup_merge_collinear) {
+    // A chain of three collinear segments, in mixed directions and order.
+    VedgeLine lines[] = {
+            VFONT_LINE(10, 10, 20, 20),
+            VFONT_LINE(30, 30, 20, 20),
+            VFONT_LINE(0, 0, 10, 10)
+    };
+    ASSERT_EQUAL(1, vlines_cleanup(data->scratch, lines, 3));
+    ASSERT_TRUE(test_vlines_is(&lines[0], 0, 0, 30, 30));
+    ASSERT_EQUAL(2, vlines_get_stats(data->scratch)->merged);
+}
+
+
+CTEST2(vlines, test_vlines_cleanup_merge_duplicate) {
+    // Two segments merge into a copy of the third line.
+    VedgeLine lines[] = {
+            VFONT_LINE(0, 0, 10, 0),
+            VFONT_LINE(10, 0, 20, 0),
+            VFONT_LINE(0, 0, 20, 0)
+    };
+    ASSERT_EQUAL(1, vlines_cleanup(data->scratch, lines, 3));
+    ASSERT_TRUE(test_vlines_is(&lines[0], 0, 0, 20, 0));
+    const VlinesStats * stats = vlines_get_stats(data->scratch);
+    ASSERT_EQUAL(1, stats->output);
+    ASSERT_EQUAL(1, stats->merged);
+    ASSERT_EQUAL(1, stats->duplicates);
+    // A merged edge is found again: two collinear chains over the same span.
+    VedgeLine chains[] = {
+            VFONT_LINE(0, 0, 10, 0),
+            VFONT_LINE(10, 0, 30, 0),
+            VFONT_LINE(0, 0, 20, 0),
+            VFONT_LINE(20, 0, 30, 0)
+    };
+    ASSERT_EQUAL(1, vlines_cleanup(data->scratch, chains, 4));
+    ASSERT_TRUE(test_vlines_is(&chains[0], 0, 0, 30, 0));
+    ASSERT_EQUAL(1, vlines_get_stats(data->scratch)->output);
+}
+
+
+CTEST2(vlines, test_vlines_cleanup_keeps_corners_and_junctions) {
+    VedgeLine lines[] = {
+            // Corner: not collinear.
+            VFONT_LINE(0, 0, 10, 0),
+            VFONT_LINE(10, 0, 10, 10),
+            // Three lines meet at (20,0): the collinear pair is kept as a junction.
+            VFONT_LINE(20, 0, 30, 0),
+            VFONT_LINE(30, 0, 40, 0),
+            VFONT_LINE(30, 0, 30, 10),
+            // Folded back on itself: collinear but overlapping.
+            VFONT_LINE(50, 0, 60, 0),
+            VFONT_LINE(60, 0, 55, 0)
+    };
+    ASSERT_EQUAL(7, vlines_cleanup(data->scratch, lines, 7));
+    ASSERT_EQUAL(0, vlines_get_stats(data->scratch)->merged);
+}
+
+
+CTEST2(vlines, test_vlines_cleanup_snaps_end_points) {
+    VedgeLine lines[] = {
+            VFONT_LINE(VMATHNUMBER_C(0.0), VMATHNUMBER_C(0.0), VMATHNUMBER_C(1.5), VMATHNUMBER_C(0.0)),
+            VFONT_LINE(VMATHNUMBER_C(1.501), VMATHNUMBER_C(0.001), VMATHNUMBER_C(3.0), VMATHNUMBER_C(0.0))
+    };
+    ASSERT_EQUAL(1, vlines_cleanup(data->scratch, lines, 2));
+    ASSERT_TRUE(test_vlines_is(&lines[0], 0, 0, 3, 0));
+}
+
+
+CTEST2(vlines, test_vlines_cleanup_too_long) {
+    const int count = VLINES_MAX_LINES + 1;
+    VedgeLine * lines = calloc((size_t)count, sizeof(VedgeLine));
+    ASSERT_NOT_NULL(lines);
+    ASSERT_EQUAL(count, vlines_cleanup(data->scratch, lines, count));
+    ASSERT_EQUAL(count, vlines_get_stats(data->scratch)->output);
+    free(lines);
+}
+
+
+CTEST2(vlines, test_vlines_cleanup_repeated) {
+    // Hash table entries from a previous call must not leak into the next.
+    for (int i = 0;  i < 3;  i++) {
+        VedgeLine lines[] = {
+                VFONT_LINE(0, 0, 10, 0),
+                VFONT_LINE(10, 0, 20, 0)
+        };
+        ASSERT_EQUAL(1, vlines_cleanup(data->scratch, lines, 2));
+    }
+}
+
+
+CTEST2(vlines, test_vlines_cleanup_batch) {
+    VdrawLineBatch batch;
+    ASSERT_TRUE(vdraw_line_batch_init(&batch, 8));
+    vdraw_line_batch_add(&batch, 0, 0, 10, 0);
+    vdraw_line_batch_add(&batch, 10, 0, 20, 0);
+    vdraw_line_batch_add(&batch, 20, 0, 10, 0);
+    vdraw_line_batch_add(&batch, 7, 7, 7, 7);
+    vdraw_line_batch_add(&batch, 0, 0, 0, 5);
+    batch.intensity1[0] = VMATHNUMBER_C(0.5);
+    vlines_cleanup_batch(data->scratch, &batch);
+    ASSERT_EQUAL(2, batch.count);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(0.0), batch.x1[0]);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(20.0), batch.x2[0]);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(1.0), batch.intensity1[0]);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(5.0), batch.y2[1]);
+    vdraw_line_batch_done(&batch);
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// Test Beam Path Ordering Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vlines, test_vlines_order_greedy_flips) {
+    // A square drawn as four lines out of order and in mixed directions.
+    VedgeLine lines[] = {
+            VFONT_LINE(0, 0, 10, 0),
+            VFONT_LINE(0, 10, 10, 10),
+            VFONT_LINE(0, 10, 0, 0),
+            VFONT_LINE(10, 10, 10, 0)
+    };
+    ASSERT_EQUAL(1, vlines_order(data->scratch, lines, 4, 0.0));
+    ASSERT_TRUE(test_vlines_is(&lines[0], 0, 0, 10, 0));
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(10.0), lines[1].x1);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(0.0), lines[1].y1);
+    for (int i = 1;  i < 4;  i++) {
+        ASSERT_DBL_EQUAL(lines[i - 1].x2, lines[i].x1);
+        ASSERT_DBL_EQUAL(lines[i - 1].y2, lines[i].y1);
+    }
+    const VlinesPathStats * stats = vlines_get_path_stats(data->scratch);
+    ASSERT_TRUE(stats->blank_before > VMATHNUMBER_C(10.0));
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(0.0), stats->blank_after);
+    ASSERT_EQUAL(1, stats->polylines);
+}
+
+
+CTEST2(vlines, test_vlines_order_two_opt) {
+    // Greedy from the first line takes the near short line then has to come back.
+    VedgeLine lines[] = {
+            VFONT_LINE(0, 0, 10, 0),
+            VFONT_LINE(12, 0, 12, 1),
+            VFONT_LINE(100, 0, 110, 0),
+            VFONT_LINE(8, 5, -90, 5)
+    };
+    VedgeLine greedy[4];
+    memcpy(greedy, lines, sizeof(lines));
+    vlines_order(data->scratch, greedy, 4, 0.0);
+    const VmathNumber greedy_blank = vlines_get_path_stats(data->scratch)->blank_after;
+    vlines_order(data->scratch, lines, 4, 0.05);
+    const VlinesPathStats * stats = vlines_get_path_stats(data->scratch);
+    ASSERT_TRUE(stats->blank_after <= greedy_blank);
+    ASSERT_TRUE(stats->blank_after < stats->blank_before);
+}
+
+
+CTEST2(vlines, test_vlines_order_random_reduces_travel) {
+    enum { COUNT = 500 };
+    static VedgeLine lines[COUNT];
+    srand(37);
+    for (int i = 0;  i < COUNT;  i++) {
+        const VmathNumber x = (VmathNumber)(rand() % 1000);
+        const VmathNumber y = (VmathNumber)(rand() % 1000);
+        lines[i] = (VedgeLine){ x, y, x + (VmathNumber)(rand() % 21 - 10), y + (VmathNumber)(rand() % 21 - 10) };
+    }
+    vlines_order(data->scratch, lines, COUNT, 0.0);
+    const VlinesPathStats * stats = vlines_get_path_stats(data->scratch);
+    // Nearest neighbour travel is a small fraction of random order travel.
+    ASSERT_TRUE(stats->blank_after < (stats->blank_before / VMATHNUMBER_C(4.0)));
+    const VmathNumber greedy_blank = stats->blank_after;
+    vlines_order(data->scratch, lines, COUNT, 0.02);
+    ASSERT_TRUE(stats->blank_after <= greedy_blank);
+}
+
+
+CTEST2(vlines, test_vlines_order_batch_intensities) {
+    VdrawLineBatch batch;
+    ASSERT_TRUE(vdraw_line_batch_init(&batch, 4));
+    vdraw_line_batch_add(&batch, 0, 0, 10, 0);
+    vdraw_line_batch_add(&batch, 20, 0, 10, 0);
+    batch.intensity1[1] = VMATHNUMBER_C(0.25);
+    batch.intensity2[1] = VMATHNUMBER_C(0.75);
+    vlines_order_batch(data->scratch, &batch, 0.0);
+    ASSERT_EQUAL(2, batch.count);
+    // The second line is reversed so its intensities swap ends.
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(10.0), batch.x1[1]);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(20.0), batch.x2[1]);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(0.75), batch.intensity1[1]);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(0.25), batch.intensity2[1]);
+    vdraw_line_batch_done(&batch);
+}
+
+
+CTEST(vlines, test_vlines_polylines) {
+    const VedgeLine lines[] = {
+            VFONT_LINE(0, 0, 10, 0),
+            VFONT_LINE(10, 0, 10, 10),
+            VFONT_LINE(20, 20, 30, 30),
+            VFONT_LINE(30, 30, 40, 20),
+            VFONT_LINE(40, 20, 50, 30)
+    };
+    SDL_FPoint points[10];
+    int lengths[5];
+    ASSERT_EQUAL(2, vlines_polylines(lines, 5, points, lengths));
+    ASSERT_EQUAL(3, lengths[0]);
+    ASSERT_EQUAL(4, lengths[1]);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(10.0), points[2].y);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(20.0), points[3].x);
+    ASSERT_DBL_EQUAL(VMATHNUMBER_C(50.0), points[6].x);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Main Application Entry Point.
+//-----------------------------------------------------------------------------
+
+// Function main() implementation.
+CTESTX_MAIN
@@ -0,0 +1,560 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Line Stream Clean-up.
+// Filename:     vlines.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 16:10
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include "vlines.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Line Stream Clean-up Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Hash a pair of 32 bit values.
+static inline uint32_t vlines_hash(const uint32_t a, const uint32_t b)
+{
+    return ((a * 73856093u) ^ (b * 19349663u)) * 2654435761u;
+}
+
+
+// Snap a co-ordinate to the vertex grid.
+static inline int32_t vlines_snap(const VmathNumber value)
+{
+    return (int32_t)lroundf(value * (VmathNumber)VLINES_SNAP);
+}
+
+
+// Find or add the shared vertex for an end point. Returns the vertex index.
+static int vlines_vertex(VlinesScratch * scratch, const VmathNumber fx, const VmathNumber fy)
+{
+    const int32_t x = vlines_snap(fx);
+    const int32_t y = vlines_snap(fy);
+    uint32_t slot = vlines_hash((uint32_t)x, (uint32_t)y) & (VLINES_VERTEX_TABLE_SIZE - 1);
+    while (scratch->vertex_stamps[slot] == scratch->generation) {
+        const VlinesVertex * vertex = &scratch->vertices[scratch->vertex_slots[slot]];
+        if ((vertex->x == x) && (vertex->y == y)) {
+            return scratch->vertex_slots[slot];
+        }
+        slot = (slot + 1) & (VLINES_VERTEX_TABLE_SIZE - 1);
+    }
+    const int index = scratch->vertex_count++;
+    VlinesVertex * vertex = &scratch->vertices[index];
+    vertex->x = x;
+    vertex->y = y;
+    vertex->fx = fx;
+    vertex->fy = fy;
+    vertex->degree = 0;
+    scratch->vertex_stamps[slot] = scratch->generation;
+    scratch->vertex_slots[slot] = index;
+    return index;
+}
+
+
+// Find the edge between two vertices (either direction). Returns its index, or -1
+// with slot set to the free hash table slot for it.
+static int vlines_edge_find(const VlinesScratch * scratch, const int start, const int end, uint32_t * slot)
+{
+    const int low = (start < end) ? start : end;
+    const int high = (start < end) ? end : start;
+    *slot = vlines_hash((uint32_t)low, (uint32_t)high) & (VLINES_EDGE_TABLE_SIZE - 1);
+    while (scratch->edge_stamps[*slot] == scratch->generation) {
+        const int other = scratch->edge_slots[*slot];
+        const int other_start = scratch->edge_start[other];
+        const int other_end = scratch->edge_end[other];
+        if (((other_start == low) && (other_end == high)) || ((other_start == high) && (other_end == low))) {
+            return other;
+        }
+        *slot = (*slot + 1) & (VLINES_EDGE_TABLE_SIZE - 1);
+    }
+    return -1;
+}
+
+
+// Add an edge unless it is already present (either direction). Returns false if a duplicate.
+static bool vlines_edge(VlinesScratch * scratch, const int start, const int end)
+{
+    uint32_t slot;
+    if (vlines_edge_find(scratch, start, end, &slot) >= 0) {
+        return false;
+    }
+    const int index = scratch->edge_count++;
+    scratch->edge_start[index] = start;
+    scratch->edge_end[index] = end;
+    scratch->edge_stamps[slot] = scratch->generation;
+    scratch->edge_slots[slot] = index;
+    // Track the incident edges of vertices with two or fewer.
+    const int ends[2] = { start, end };
+    for (int i = 0;  i < 2;  i++) {
+        VlinesVertex * vertex = &scratch->vertices[ends[i]];
+        if (vertex->degree < 2) {
+            vertex->edges[vertex->degree] = index;
+        }
+        vertex->degree++;
+    }
+    return true;
+}
+
+
+// Get the vertex at the other end of an edge.
+static inline int vlines_other_end(const VlinesScratch * scratch, const int edge, const int vertex)
+{
+    return (scratch->edge_start[edge] == vertex) ? scratch->edge_end[edge] : scratch->edge_start[edge];
+}
+
+
+// Remove an edge from a vertex's incident edges. Vertices of a higher degree keep
+// it (only two incident edges are tracked), so they are never merged.
+static void vlines_vertex_remove_edge(VlinesScratch * scratch, const int v, const int edge)
+{
+    VlinesVertex * vertex = &scratch->vertices[v];
+    if (vertex->degree > 2) {
+        return;
+    }
+    for (int i = 0;  i < vertex->degree;  i++) {
+        if (vertex->edges[i] == edge) {
+            vertex->edges[i] = vertex->edges[vertex->degree - 1];
+            vertex->degree--;
+            return;
+        }
+    }
+}
+
+
+// Merge the two edges meeting at each degree two vertex where they continue in a straight line.
+// A merged edge that is already present is dropped as a duplicate.
+static void vlines_merge_collinear(VlinesScratch * scratch)
+{
+    for (int v = 0;  v < scratch->vertex_count;  v++) {
+        VlinesVertex * vertex = &scratch->vertices[v];
+        if (vertex->degree != 2) {
+            continue;
+        }
+        const int keep = vertex->edges[0];
+        const int drop = vertex->edges[1];
+        const int p = vlines_other_end(scratch, keep, v);
+        const int q = vlines_other_end(scratch, drop, v);
+        if (p == q) {
+            continue;
+        }
+        // Exactly collinear on the snap grid and pointing away from each other.
+        const int64_t ax = scratch->vertices[p].x - vertex->x;
+        const int64_t ay = scratch->vertices[p].y - vertex->y;
+        const int64_t bx = scratch->vertices[q].x - vertex->x;
+        const int64_t by = scratch->vertices[q].y - vertex->y;
+        if (((ax * by) - (ay * bx) != 0) || (((ax * bx) + (ay * by)) >= 0)) {
+            continue;
+        }
+        scratch->stats.merged++;
+        vertex->degree = 0;
+        // Both edges go if p to q is already an edge.
+        uint32_t slot;
+        if (vlines_edge_find(scratch, p, q, &slot) >= 0) {
+            scratch->edge_start[keep] = -1;
+            scratch->edge_end[keep] = -1;
+            scratch->edge_start[drop] = -1;
+            scratch->edge_end[drop] = -1;
+            vlines_vertex_remove_edge(scratch, p, keep);
+            vlines_vertex_remove_edge(scratch, q, drop);
+            scratch->stats.duplicates++;
+            continue;
+        }
+        // The kept edge now spans p to q, in its original direction, found under that pair.
+        scratch->edge_stamps[slot] = scratch->generation;
+        scratch->edge_slots[slot] = keep;
+        if (scratch->edge_start[keep] == v) {
+            scratch->edge_start[keep] = q;
+        } else {
+            scratch->edge_end[keep] = q;
+        }
+        scratch->edge_start[drop] = -1;
+        scratch->edge_end[drop] = -1;
+        VlinesVertex * far = &scratch->vertices[q];
+        if (far->degree <= 2) {
+            for (int i = 0;  i < far->degree;  i++) {
+                if (far->edges[i] == drop) {
+                    far->edges[i] = keep;
+                }
+            }
+        }
+    }
+}
+
+
+// Distance squared between two points.
+static inline VmathNumber vlines_distance2(const VmathNumber x1, const VmathNumber y1,
+                                           const VmathNumber x2, const VmathNumber y2)
+{
+    const VmathNumber dx = x2 - x1;
+    const VmathNumber dy = y2 - y1;
+    return (dx * dx) + (dy * dy);
+}
+
+
+// Distance between two points.
+static inline VmathNumber vlines_distance(const VmathNumber x1, const VmathNumber y1,
+                                          const VmathNumber x2, const VmathNumber y2)
+{
+    return sqrtf(vlines_distance2(x1, y1, x2, y2));
+}
+
+
+// Total beam-off travel between consecutive lines.
+static VmathNumber vlines_blank_travel(const VedgeLine * lines, const int count)
+{
+    VmathNumber total = VMATHNUMBER_C(0.0);
+    for (int i = 1;  i < count;  i++) {
+        total += vlines_distance(lines[i - 1].x2, lines[i - 1].y2, lines[i].x1, lines[i].y1);
+    }
+    return total;
+}
+
+
+// Count the polylines in consecutive lines.
+static int vlines_count_polylines(const VedgeLine * lines, const int count)
+{
+    int polylines = (count > 0) ? 1 : 0;
+    for (int i = 1;  i < count;  i++) {
+        if ((lines[i].x1 != lines[i - 1].x2) || (lines[i].y1 != lines[i - 1].y2)) {
+            polylines++;
+        }
+    }
+    return polylines;
+}
+
+
+// Build the path by greedy nearest neighbour chaining from the first line.
+static void vlines_path_greedy(VlinesScratch * scratch, const VedgeLine * lines, const int count)
+{
+    memset(scratch->path_used, 0, (size_t)count * sizeof(bool));
+    scratch->path[0] = lines[0];
+    scratch->path_source[0] = 0;
+    scratch->path_reversed[0] = false;
+    scratch->path_used[0] = true;
+    for (int k = 1;  k < count;  k++) {
+        const VmathNumber x = scratch->path[k - 1].x2;
+        const VmathNumber y = scratch->path[k - 1].y2;
+        int best = -1;
+        bool best_reversed = false;
+        VmathNumber best_distance2 = VMATHNUMBER_C(0.0);
+        for (int i = 0;  i < count;  i++) {
+            if (scratch->path_used[i]) {
+                continue;
+            }
+            const VmathNumber forward = vlines_distance2(x, y, lines[i].x1, lines[i].y1);
+            const VmathNumber reverse = vlines_distance2(x, y, lines[i].x2, lines[i].y2);
+            const VmathNumber nearest = (reverse < forward) ? reverse : forward;
+            if ((best < 0) || (nearest < best_distance2)) {
+                best = i;
+                best_reversed = (reverse < forward);
+                best_distance2 = nearest;
+                if (nearest == VMATHNUMBER_C(0.0)) {
+                    break;
+                }
+            }
+        }
+        scratch->path_used[best] = true;
+        scratch->path_source[k] = best;
+        scratch->path_reversed[k] = best_reversed;
+        VedgeLine * line = &scratch->path[k];
+        if (best_reversed) {
+            line->x1 = lines[best].x2;
+            line->y1 = lines[best].y2;
+            line->x2 = lines[best].x1;
+            line->y2 = lines[best].y1;
+        } else {
+            *line = lines[best];
+        }
+    }
+}
+
+
+// Reverse the path from first to last inclusive, reversing each line too.
+static void vlines_path_reverse(VlinesScratch * scratch, int first, int last)
+{
+    for ( ;  first <= last;  first++, last--) {
+        const VedgeLine line_first = scratch->path[first];
+        const VedgeLine line_last = scratch->path[last];
+        const int source_first = scratch->path_source[first];
+        const bool reversed_first = scratch->path_reversed[first];
+        scratch->path[first] = (VedgeLine){ line_last.x2, line_last.y2, line_last.x1, line_last.y1 };
+        scratch->path[last] = (VedgeLine){ line_first.x2, line_first.y2, line_first.x1, line_first.y1 };
+        scratch->path_source[first] = scratch->path_source[last];
+        scratch->path_source[last] = source_first;
+        scratch->path_reversed[first] = !scratch->path_reversed[last];
+        scratch->path_reversed[last] = !reversed_first;
+    }
+}
+
+
+// Refine the path with 2-opt reversals (a single line reversal when first == last)
+// until no reversal shortens it or the time budget runs out.
+static void vlines_path_two_opt(VlinesScratch * scratch, const int count, const double budget_seconds)
+{
+    const uint64_t deadline = SDL_GetPerformanceCounter()
+            + (uint64_t)(budget_seconds * (double)SDL_GetPerformanceFrequency());
+    const VedgeLine * path = scratch->path;
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (int i = 0;  i < count;  i++) {
+            if (SDL_GetPerformanceCounter() >= deadline) {
+                return;
+            }
+            for (int j = i;  j < count;  j++) {
+                // Blank travel into line i and out of line j, before and after reversing i to j.
+                VmathNumber before = VMATHNUMBER_C(0.0);
+                VmathNumber after = VMATHNUMBER_C(0.0);
+                if (i > 0) {
+                    before += vlines_distance(path[i - 1].x2, path[i - 1].y2, path[i].x1, path[i].y1);
+                    after += vlines_distance(path[i - 1].x2, path[i - 1].y2, path[j].x2, path[j].y2);
+                }
+                if (j < (count - 1)) {
+                    before += vlines_distance(path[j].x2, path[j].y2, path[j + 1].x1, path[j + 1].y1);
+                    after += vlines_distance(path[i].x1, path[i].y1, path[j + 1].x1, path[j + 1].y1);
+                }
+                if (after < (before - VMATHNUMBER_C(0.0001))) {
+                    vlines_path_reverse(scratch, i, j);
+                    scratch->path_stats.reversals++;
+                    improved = true;
+                }
+            }
+        }
+    }
+}
+
+
+// Build the ordered path for a line stream. Returns false if too long to order.
+static bool vlines_path_build(VlinesScratch * scratch, const VedgeLine * lines, const int count,
+                              const double budget_seconds)
+{
+    memset(&scratch->path_stats, 0, sizeof(VlinesPathStats));
+    scratch->path_stats.blank_before = vlines_blank_travel(lines, count);
+    scratch->path_stats.blank_after = scratch->path_stats.blank_before;
+    scratch->path_stats.polylines = vlines_count_polylines(lines, count);
+    if ((count == 0) || (count > VLINES_MAX_LINES)) {
+        return false;
+    }
+    vlines_path_greedy(scratch, lines, count);
+    if (budget_seconds > 0.0) {
+        vlines_path_two_opt(scratch, count, budget_seconds);
+    }
+    scratch->path_stats.blank_after = vlines_blank_travel(scratch->path, count);
+    scratch->path_stats.polylines = vlines_count_polylines(scratch->path, count);
+    return true;
+}
+
+
+// Build the vertices and edges for a line stream. Returns false if too long.
+static bool vlines_build(VlinesScratch * scratch, const int count,
+                         const VmathNumber * x1, const VmathNumber * y1,
+                         const VmathNumber * x2, const VmathNumber * y2,
+                         const int stride)
+{
+    memset(&scratch->stats, 0, sizeof(VlinesStats));
+    scratch->stats.input = count;
+    scratch->stats.output = count;
+    if (count > VLINES_MAX_LINES) {
+        return false;
+    }
+    // A new generation invalidates all the hash table slots.
+    if (++scratch->generation == 0) {
+        memset(scratch->vertex_stamps, 0, sizeof(scratch->vertex_stamps));
+        memset(scratch->edge_stamps, 0, sizeof(scratch->edge_stamps));
+        scratch->generation = 1;
+    }
+    scratch->vertex_count = 0;
+    scratch->edge_count = 0;
+    for (int i = 0;  i < count;  i++) {
+        const int start = vlines_vertex(scratch, x1[i * stride], y1[i * stride]);
+        const int end = vlines_vertex(scratch, x2[i * stride], y2[i * stride]);
+        if (start == end) {
+            scratch->stats.zero_length++;
+        } else if (!vlines_edge(scratch, start, end)) {
+            scratch->stats.duplicates++;
+        }
+    }
+    vlines_merge_collinear(scratch);
+    scratch->stats.output = count - scratch->stats.zero_length - scratch->stats.duplicates - scratch->stats.merged;
+    return true;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Line Stream Clean-up Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise the scratch memory.
+void vlines_init(VlinesScratch * scratch)
+{
+    assert (scratch != NULL);
+    memset(scratch, 0, sizeof(VlinesScratch));
+}
+
+
+// Drop zero length and duplicate lines and merge end to end collinear lines
+// in place, keeping the first occurrence order. Returns the new line count.
+int vlines_cleanup(VlinesScratch * scratch, VedgeLine * lines, const int count)
+{
+    assert (scratch != NULL);
+    assert ((lines != NULL) || (count == 0));
+    const int stride = sizeof(VedgeLine) / sizeof(VmathNumber);
+    if ((count == 0) || !vlines_build(scratch, count, &lines->x1, &lines->y1, &lines->x2, &lines->y2, stride)) {
+        return count;
+    }
+    int output = 0;
+    for (int i = 0;  i < scratch->edge_count;  i++) {
+        if (scratch->edge_start[i] >= 0) {
+            const VlinesVertex * start = &scratch->vertices[scratch->edge_start[i]];
+            const VlinesVertex * end = &scratch->vertices[scratch->edge_end[i]];
+            lines[output].x1 = start->fx;
+            lines[output].y1 = start->fy;
+            lines[output].x2 = end->fx;
+            lines[output].y2 = end->fy;
+            output++;
+        }
+    }
+    return output;
+}
+
+
+// Clean up a line batch in place (before vdraw_line_batch_intensity; intensities are reset to full).
+void vlines_cleanup_batch(VlinesScratch * scratch, VdrawLineBatch * batch)
+{
+    assert (scratch != NULL);
+    assert (batch != NULL);
+    if ((batch->count == 0) || !vlines_build(scratch, batch->count, batch->x1, batch->y1, batch->x2, batch->y2, 1)) {
+        return;
+    }
+    int output = 0;
+    for (int i = 0;  i < scratch->edge_count;  i++) {
+        if (scratch->edge_start[i] >= 0) {
+            const VlinesVertex * start = &scratch->vertices[scratch->edge_start[i]];
+            const VlinesVertex * end = &scratch->vertices[scratch->edge_end[i]];
+            batch->x1[output] = start->fx;
+            batch->y1[output] = start->fy;
+            batch->x2[output] = end->fx;
+            batch->y2[output] = end->fy;
+            batch->intensity1[output] = VMATHNUMBER_C(1.0);
+            batch->intensity2[output] = VMATHNUMBER_C(1.0);
+            output++;
+        }
+    }
+    batch->count = output;
+}
+
+
+// Get the statistics for the last clean-up.
+const VlinesStats * vlines_get_stats(const VlinesScratch * scratch)
+{
+    assert (scratch != NULL);
+    return &scratch->stats;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Beam Path Ordering Functions.
+//-----------------------------------------------------------------------------
+
+// Reorder and reverse lines in place to minimise beam-off travel: greedy nearest
+// neighbour from the first line, then 2-opt refinement for up to budget_seconds
+// (0.0 = greedy only). Returns the number of polylines.
+int vlines_order(VlinesScratch * scratch, VedgeLine * lines, const int count, const double budget_seconds)
+{
+    assert (scratch != NULL);
+    assert ((lines != NULL) || (count == 0));
+    if (vlines_path_build(scratch, lines, count, budget_seconds)) {
+        memcpy(lines, scratch->path, (size_t)count * sizeof(VedgeLine));
+    }
+    return scratch->path_stats.polylines;
+}
+
+
+// Reorder a line batch in place (end point intensities follow their end points).
+void vlines_order_batch(VlinesScratch * scratch, VdrawLineBatch * batch, const double budget_seconds)
+{
+    assert (scratch != NULL);
+    assert (batch != NULL);
+    const int count = batch->count;
+    if (count > VLINES_MAX_LINES) {
+        memset(&scratch->path_stats, 0, sizeof(VlinesPathStats));
+        return;
+    }
+    VedgeLine * lines = scratch->batch_lines;
+    for (int i = 0;  i < count;  i++) {
+        lines[i] = (VedgeLine){ batch->x1[i], batch->y1[i], batch->x2[i], batch->y2[i] };
+    }
+    if (!vlines_path_build(scratch, lines, count, budget_seconds)) {
+        return;
+    }
+    const VmathNumber * intensity1 = scratch->batch_intensity1;
+    const VmathNumber * intensity2 = scratch->batch_intensity2;
+    memcpy(scratch->batch_intensity1, batch->intensity1, (size_t)count * sizeof(VmathNumber));
+    memcpy(scratch->batch_intensity2, batch->intensity2, (size_t)count * sizeof(VmathNumber));
+    for (int k = 0;  k < count;  k++) {
+        const int source = scratch->path_source[k];
+        const bool reversed = scratch->path_reversed[k];
+        batch->x1[k] = scratch->path[k].x1;
+        batch->y1[k] = scratch->path[k].y1;
+        batch->x2[k] = scratch->path[k].x2;
+        batch->y2[k] = scratch->path[k].y2;
+        batch->intensity1[k] = reversed ? intensity2[source] : intensity1[source];
+        batch->intensity2[k] = reversed ? intensity1[source] : intensity2[source];
+    }
+}
+
+
+// Chain ordered lines into polylines for vdraw_polyline, filling points (up to
+// 2 * count) and the point count of each polyline. Returns the number of polylines.
+int vlines_polylines(const VedgeLine * lines, const int count, SDL_FPoint * points, int * lengths)
+{
+    assert ((lines != NULL) || (count == 0));
+    assert ((points != NULL) || (count == 0));
+    assert ((lengths != NULL) || (count == 0));
+    int polylines = 0;
+    int point = 0;
+    for (int i = 0;  i < count;  i++) {
+        if ((i == 0) || (lines[i].x1 != lines[i - 1].x2) || (lines[i].y1 != lines[i - 1].y2)) {
+            points[point++] = (SDL_FPoint){ lines[i].x1, lines[i].y1 };
+            lengths[polylines++] = 1;
+        }
+        points[point++] = (SDL_FPoint){ lines[i].x2, lines[i].y2 };
+        lengths[polylines - 1]++;
+    }
+    return polylines;
+}
+
+
+// Get the beam path statistics for the last ordering.
+const VlinesPathStats * vlines_get_path_stats(const VlinesScratch * scratch)
+{
+    assert (scratch != NULL);
+    return &scratch->path_stats;
+}
@@ -0,0 +1,181 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Line Stream Clean-up.
+// Filename:     vlines.h
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 16:10
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+#ifndef __VLINES__H__
+#define __VLINES__H__
+
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vmath.h"
+#include "vedge.h"
+#include "vdraw.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Line Stream Clean-up Configuration.
+//-----------------------------------------------------------------------------
+
+// Maximum number of lines cleaned up per call (longer streams are left unchanged).
+#ifndef VLINES_MAX_LINES
+#define VLINES_MAX_LINES 4096
+#endif
+
+// End points are snapped to 1/VLINES_SNAP of a unit to find shared vertices.
+#ifndef VLINES_SNAP
+#define VLINES_SNAP 16
+#endif
+
+// Vertex and edge hash table sizes (powers of two, at least twice the entries;
+// each collinear merge adds an entry for the merged edge).
+#define VLINES_MAX_VERTICES (VLINES_MAX_LINES * 2)
+#define VLINES_VERTEX_TABLE_SIZE (VLINES_MAX_VERTICES * 2)
+#define VLINES_EDGE_TABLE_SIZE (VLINES_MAX_LINES * 4)
+
+
+
+//-----------------------------------------------------------------------------
+// Line Stream Clean-up Types.
+//-----------------------------------------------------------------------------
+
+// Clean-up statistics for the last call.
+typedef struct VlinesStats {
+    // Lines in and out.
+    int input;
+    int output;
+    // Lines dropped as zero length, duplicates, or merged into a collinear neighbour.
+    int zero_length;
+    int duplicates;
+    int merged;
+} VlinesStats;
+
+
+// Beam path ordering statistics for the last call.
+typedef struct VlinesPathStats {
+    // Total beam-off travel between lines before and after ordering.
+    VmathNumber blank_before;
+    VmathNumber blank_after;
+    // Polylines (runs of lines each starting where the last ended) after ordering.
+    int polylines;
+    // 2-opt reversals applied within the time budget.
+    int reversals;
+} VlinesPathStats;
+
+
+// Shared vertex (snapped end point).
+typedef struct VlinesVertex {
+    // Snapped co-ordinates.
+    int32_t x;
+    int32_t y;
+    // First co-ordinates seen.
+    VmathNumber fx;
+    VmathNumber fy;
+    // Incident edges (only tracked while the degree is two or less).
+    int degree;
+    int edges[2];
+} VlinesVertex;
+
+
+// Fixed size scratch memory for the clean-up (access via API functions only).
+// Large; allocate statically or on the heap. Hash table slots are valid only
+// when their stamp matches the current generation, so they are never cleared.
+typedef struct VlinesScratch {
+    // Current generation (incremented per call).
+    uint32_t generation;
+    // Shared vertices.
+    int vertex_count;
+    VlinesVertex vertices[VLINES_MAX_VERTICES];
+    // Vertex hash table (vertex index per slot).
+    uint32_t vertex_stamps[VLINES_VERTEX_TABLE_SIZE];
+    int vertex_slots[VLINES_VERTEX_TABLE_SIZE];
+    // Edges as start and end vertex indices (-1 when dropped).
+    int edge_count;
+    int edge_start[VLINES_MAX_LINES];
+    int edge_end[VLINES_MAX_LINES];
+    // Edge hash table (edge index per slot).
+    uint32_t edge_stamps[VLINES_EDGE_TABLE_SIZE];
+    int edge_slots[VLINES_EDGE_TABLE_SIZE];
+    // Statistics.
+    VlinesStats stats;
+    // Beam path: lines in drawing order, their source index and whether reversed.
+    VedgeLine path[VLINES_MAX_LINES];
+    int path_source[VLINES_MAX_LINES];
+    bool path_reversed[VLINES_MAX_LINES];
+    // Source lines already on the path.
+    bool path_used[VLINES_MAX_LINES];
+    // Source lines and end point intensities gathered from a line batch.
+    VedgeLine batch_lines[VLINES_MAX_LINES];
+    VmathNumber batch_intensity1[VLINES_MAX_LINES];
+    VmathNumber batch_intensity2[VLINES_MAX_LINES];
+    // Beam path statistics.
+    VlinesPathStats path_stats;
+} VlinesScratch;
+
+
+
+//-----------------------------------------------------------------------------
+// Line Stream Clean-up Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise the scratch memory.
+void vlines_init(VlinesScratch * scratch);
+
+// Drop zero length and duplicate lines and merge end to end collinear lines
+// in place, keeping the first occurrence order. Returns the new line count.
+int vlines_cleanup(VlinesScratch * scratch, VedgeLine * lines, const int count);
+
+// Clean up a line batch in place (before vdraw_line_batch_intensity; intensities are reset to full).
+void vlines_cleanup_batch(VlinesScratch * scratch, VdrawLineBatch * batch);
+
+// Get the statistics for the last clean-up.
+const VlinesStats * vlines_get_stats(const VlinesScratch * scratch);
+
+
+
+//-----------------------------------------------------------------------------
+// Beam Path Ordering Functions.
+//-----------------------------------------------------------------------------
+
+// Reorder and reverse lines in place to minimise beam-off travel: greedy nearest
+// neighbour from the first line, then 2-opt refinement for up to budget_seconds
+// (0.0 = greedy only). Returns the number of polylines.
+int vlines_order(VlinesScratch * scratch, VedgeLine * lines, const int count, const double budget_seconds);
+
+// Reorder a line batch in place (end point intensities follow their end points).
+void vlines_order_batch(VlinesScratch * scratch, VdrawLineBatch * batch, const double budget_seconds);
+
+// Chain ordered lines into polylines for vdraw_polyline, filling points (up to
+// 2 * count) and the point count of each polyline. Returns the number of polylines.
+int vlines_polylines(const VedgeLine * lines, const int count, SDL_FPoint * points, int * lengths);
+
+// Get the beam path statistics for the last ordering.
+const VlinesPathStats * vlines_get_path_stats(const VlinesScratch * scratch);
+
+
+
+#endif /* __VLINES__H__ */
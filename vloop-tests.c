@@ -0,0 +1,140 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) vLoop Unit Tests.
+// Filename:     vloop-tests.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 11:48
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+// API under test.
+#include "vloop.h"
+
+
+// CTest configuration.
+#define CTEST_MAIN
+#define CTEST_SEGFAULT
+
+// CTest Extra include (implementation) file.
+#include "ctestx.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Test Fixture Lifecycle.
+//-----------------------------------------------------------------------------
+
+// 100 ticks per second, unpaced.
+CTEST_DATA(vloop)
+{
+    VloopTimer loop;
+};
+
+
+CTEST_SETUP(vloop)
+{
+    ASSERT_TRUE(vloop_init(&data->loop, 100, 0));
+}
+
+
+CTEST_TEARDOWN(vloop)
+{
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Frame Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vloop, test_vloop_init) {
+    ASSERT_EQUAL(data->loop.frequency / 100, data->loop.tick_counts);
+    ASSERT_EQUAL(0, data->loop.frame_counts);
+    ASSERT_DBL_NEAR_TOL(0.01, vloop_get_tick_seconds(&data->loop), 1e-6);
+    ASSERT_DBL_NEAR_TOL(0.0, vloop_get_alpha(&data->loop), 1e-6);
+    ASSERT_EQUAL(0, vloop_get_stats(&data->loop)->frames);
+}
+
+
+CTEST2(vloop, test_vloop_advance_accumulates) {
+    const uint64_t tick = data->loop.tick_counts;
+    uint64_t now = data->loop.frame_start;
+    // Half a tick: nothing to run yet.
+    now += tick / 2;
+    ASSERT_EQUAL(0, vloop_advance(&data->loop, now));
+    ASSERT_DBL_NEAR_TOL(0.5, vloop_get_alpha(&data->loop), 1e-3);
+    // Another tick and a half: two ticks, no remainder.
+    now += tick + (tick / 2);
+    ASSERT_EQUAL(2, vloop_advance(&data->loop, now));
+    ASSERT_DBL_NEAR_TOL(0.0, vloop_get_alpha(&data->loop), 1e-3);
+    // Exactly one tick.
+    now += tick;
+    ASSERT_EQUAL(1, vloop_advance(&data->loop, now));
+    const VloopStats * stats = vloop_get_stats(&data->loop);
+    ASSERT_EQUAL(3, stats->frames);
+    ASSERT_EQUAL(3, stats->ticks);
+    ASSERT_EQUAL(0, stats->dropped_ticks);
+    ASSERT_DBL_NEAR_TOL(0.005, stats->frame_seconds_min, 1e-6);
+    ASSERT_DBL_NEAR_TOL(0.015, stats->frame_seconds_max, 1e-6);
+    ASSERT_DBL_NEAR_TOL(0.010, stats->frame_seconds, 1e-6);
+    ASSERT_DBL_NEAR_TOL(0.030, stats->total_seconds, 1e-6);
+}
+
+
+CTEST2(vloop, test_vloop_advance_drops_excess_ticks) {
+    const uint64_t tick = data->loop.tick_counts;
+    const uint64_t now = data->loop.frame_start + ((VLOOP_MAX_TICKS_PER_FRAME + 5) * tick) + (tick / 4);
+    ASSERT_EQUAL(VLOOP_MAX_TICKS_PER_FRAME, vloop_advance(&data->loop, now));
+    ASSERT_EQUAL(5, vloop_get_stats(&data->loop)->dropped_ticks);
+    // The partial tick is kept.
+    ASSERT_DBL_NEAR_TOL(0.25, vloop_get_alpha(&data->loop), 1e-3);
+    vloop_reset_stats(&data->loop);
+    ASSERT_EQUAL(0, vloop_get_stats(&data->loop)->dropped_ticks);
+}
+
+
+CTEST(vloop, test_vloop_end_frame_paces) {
+    VloopTimer loop;
+    ASSERT_TRUE(vloop_init(&loop, 100, 200));
+    for (int i = 0;  i < 10;  i++) {
+        vloop_begin_frame(&loop);
+        vloop_mark_update(&loop);
+        vloop_mark_render(&loop);
+        vloop_end_frame(&loop);
+        // Each frame ends no earlier than 5ms after it started.
+        const uint64_t now = SDL_GetPerformanceCounter();
+        ASSERT_TRUE((now - loop.frame_start) >= loop.frame_counts);
+    }
+    const VloopStats * stats = vloop_get_stats(&loop);
+    ASSERT_EQUAL(10, stats->frames);
+    // Frames after the first are paced at 5ms (allowing for a slow scheduler).
+    ASSERT_TRUE(stats->frame_seconds >= 0.005);
+    ASSERT_TRUE(stats->frame_seconds < 0.050);
+    ASSERT_TRUE(stats->wait_seconds > 0.0);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Main Application Entry Point.
+//-----------------------------------------------------------------------------
+
+// Function main() implementation.
+CTESTX_MAIN
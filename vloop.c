@@ -0,0 +1,197 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Fixed-Timestep Loop Timing.
+// Filename:     vloop.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 15:05
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+#include <assert.h>
+#include <string.h>
+
+#include "vloop.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Fixed-Timestep Loop Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Convert performance counter counts to seconds.
+static inline double vloop_seconds(const VloopTimer * loop, const uint64_t counts)
+{
+    return (double)counts / (double)loop->frequency;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Fixed-Timestep Loop Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a timer for tick_rate simulation ticks and frame_rate frames (0 = unpaced) per second.
+bool vloop_init(VloopTimer * loop, const int tick_rate, const int frame_rate)
+{
+    assert (loop != NULL);
+    assert (tick_rate > 0);
+    assert (frame_rate >= 0);
+    memset(loop, 0, sizeof(VloopTimer));
+    loop->frequency = SDL_GetPerformanceFrequency();
+    if (loop->frequency < (uint64_t)tick_rate) {
+        SDL_Log("vloop_init: performance counter frequency %llu too low",
+                (unsigned long long)loop->frequency);
+        return false;
+    }
+    loop->tick_counts = loop->frequency / (uint64_t)tick_rate;
+    loop->frame_counts = (frame_rate > 0) ? loop->frequency / (uint64_t)frame_rate : 0;
+    loop->spin_counts = (loop->frequency * VLOOP_SPIN_MICROSECONDS) / 1000000u;
+    loop->frame_start = SDL_GetPerformanceCounter();
+    loop->mark = loop->frame_start;
+    vloop_reset_stats(loop);
+    return true;
+}
+
+
+// Reset the statistics.
+void vloop_reset_stats(VloopTimer * loop)
+{
+    assert (loop != NULL);
+    memset(&loop->stats, 0, sizeof(VloopStats));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Fixed-Timestep Loop Frame Functions.
+//-----------------------------------------------------------------------------
+
+// Start a frame now. Returns the number of simulation ticks to run.
+int vloop_begin_frame(VloopTimer * loop)
+{
+    assert (loop != NULL);
+    return vloop_advance(loop, SDL_GetPerformanceCounter());
+}
+
+
+// Start a frame at the counter value now. Returns the number of simulation ticks to run.
+int vloop_advance(VloopTimer * loop, const uint64_t now)
+{
+    assert (loop != NULL);
+    const uint64_t elapsed = now - loop->frame_start;
+    loop->frame_start = now;
+    loop->mark = now;
+    // Frame time statistics.
+    VloopStats * stats = &loop->stats;
+    stats->frame_seconds = vloop_seconds(loop, elapsed);
+    if ((stats->frames == 0) || (stats->frame_seconds < stats->frame_seconds_min)) {
+        stats->frame_seconds_min = stats->frame_seconds;
+    }
+    if (stats->frame_seconds > stats->frame_seconds_max) {
+        stats->frame_seconds_max = stats->frame_seconds;
+    }
+    stats->total_seconds += stats->frame_seconds;
+    stats->frames++;
+    // Whole simulation ticks due, keeping the remainder for the next frame.
+    loop->accumulator += elapsed;
+    uint64_t ticks = loop->accumulator / loop->tick_counts;
+    loop->accumulator -= ticks * loop->tick_counts;
+    if (ticks > VLOOP_MAX_TICKS_PER_FRAME) {
+        stats->dropped_ticks += ticks - VLOOP_MAX_TICKS_PER_FRAME;
+        ticks = VLOOP_MAX_TICKS_PER_FRAME;
+    }
+    stats->ticks += ticks;
+    return (int)ticks;
+}
+
+
+// Mark the end of the frame's simulation ticks.
+void vloop_mark_update(VloopTimer * loop)
+{
+    assert (loop != NULL);
+    const uint64_t now = SDL_GetPerformanceCounter();
+    loop->stats.update_seconds = vloop_seconds(loop, now - loop->mark);
+    loop->mark = now;
+}
+
+
+// Mark the end of the frame's rendering.
+void vloop_mark_render(VloopTimer * loop)
+{
+    assert (loop != NULL);
+    const uint64_t now = SDL_GetPerformanceCounter();
+    loop->stats.render_seconds = vloop_seconds(loop, now - loop->mark);
+    loop->mark = now;
+}
+
+
+// Finish the frame, sleeping then spinning until the target frame time.
+void vloop_end_frame(VloopTimer * loop)
+{
+    assert (loop != NULL);
+    uint64_t now = SDL_GetPerformanceCounter();
+    const uint64_t start = now;
+    if (loop->frame_counts != 0) {
+        const uint64_t target = loop->frame_start + loop->frame_counts;
+        // Sleep in whole milliseconds while well short of the target.
+        while ((now < target) && ((target - now) > loop->spin_counts)) {
+            const uint64_t ms = ((target - now - loop->spin_counts) * 1000u) / loop->frequency;
+            if (ms == 0) {
+                break;
+            }
+            SDL_Delay((Uint32)ms);
+            now = SDL_GetPerformanceCounter();
+        }
+        // Spin for the remainder.
+        while (now < target) {
+            now = SDL_GetPerformanceCounter();
+        }
+    }
+    loop->stats.wait_seconds = vloop_seconds(loop, now - start);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Fixed-Timestep Loop Query Functions.
+//-----------------------------------------------------------------------------
+
+// Get the simulation tick time step in seconds.
+VmathNumber vloop_get_tick_seconds(const VloopTimer * loop)
+{
+    assert (loop != NULL);
+    return (VmathNumber)vloop_seconds(loop, loop->tick_counts);
+}
+
+
+// Get how far between the last and next simulation tick the frame is (0.0 to 1.0).
+VmathNumber vloop_get_alpha(const VloopTimer * loop)
+{
+    assert (loop != NULL);
+    return (VmathNumber)((double)loop->accumulator / (double)loop->tick_counts);
+}
+
+
+// Get the statistics.
+const VloopStats * vloop_get_stats(const VloopTimer * loop)
+{
+    assert (loop != NULL);
+    return &loop->stats;
+}
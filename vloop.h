@@ -0,0 +1,152 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Fixed-Timestep Loop Timing.
+// Filename:     vloop.h
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 15:05
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+#ifndef __VLOOP__H__
+#define __VLOOP__H__
+
+
+#include <SDL.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vmath.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Fixed-Timestep Loop Configuration.
+//-----------------------------------------------------------------------------
+
+// Maximum simulation ticks run per frame; time beyond this is dropped so a
+// long stall does not lead to ever longer catch-up frames.
+#ifndef VLOOP_MAX_TICKS_PER_FRAME
+#define VLOOP_MAX_TICKS_PER_FRAME 8
+#endif
+
+// Microseconds before the target frame time at which sleeping stops and
+// spinning starts (covers the scheduler's wake-up latency).
+#ifndef VLOOP_SPIN_MICROSECONDS
+#define VLOOP_SPIN_MICROSECONDS 2000
+#endif
+
+
+
+//-----------------------------------------------------------------------------
+// Fixed-Timestep Loop Types.
+//-----------------------------------------------------------------------------
+
+// Loop timing statistics since the last reset (seconds).
+typedef struct VloopStats {
+    // Frames and simulation ticks run.
+    uint64_t frames;
+    uint64_t ticks;
+    // Simulation ticks dropped by VLOOP_MAX_TICKS_PER_FRAME.
+    uint64_t dropped_ticks;
+    // Last, shortest, longest and total frame times (start to start).
+    double frame_seconds;
+    double frame_seconds_min;
+    double frame_seconds_max;
+    double total_seconds;
+    // Time spent in updates, rendering and waiting during the last frame.
+    double update_seconds;
+    double render_seconds;
+    double wait_seconds;
+} VloopStats;
+
+
+// Fixed-timestep loop timer (access via API functions only).
+// Times are in SDL performance counter units.
+typedef struct VloopTimer {
+    // Performance counter frequency.
+    uint64_t frequency;
+    // Counts per simulation tick.
+    uint64_t tick_counts;
+    // Target counts per frame (0 = unpaced).
+    uint64_t frame_counts;
+    // Counts before the target at which to spin rather than sleep.
+    uint64_t spin_counts;
+    // Counter at the start of the current frame.
+    uint64_t frame_start;
+    // Counter at the last timing mark within the frame.
+    uint64_t mark;
+    // Unsimulated time carried between frames.
+    uint64_t accumulator;
+    // Statistics.
+    VloopStats stats;
+} VloopTimer;
+
+
+
+//-----------------------------------------------------------------------------
+// Fixed-Timestep Loop Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a timer for tick_rate simulation ticks and frame_rate frames (0 = unpaced) per second.
+bool vloop_init(VloopTimer * loop, const int tick_rate, const int frame_rate);
+
+// Reset the statistics.
+void vloop_reset_stats(VloopTimer * loop);
+
+
+
+//-----------------------------------------------------------------------------
+// Fixed-Timestep Loop Frame Functions.
+//-----------------------------------------------------------------------------
+
+// Start a frame now. Returns the number of simulation ticks to run.
+int vloop_begin_frame(VloopTimer * loop);
+
+// Start a frame at the counter value now. Returns the number of simulation ticks to run.
+int vloop_advance(VloopTimer * loop, const uint64_t now);
+
+// Mark the end of the frame's simulation ticks.
+void vloop_mark_update(VloopTimer * loop);
+
+// Mark the end of the frame's rendering.
+void vloop_mark_render(VloopTimer * loop);
+
+// Finish the frame, sleeping then spinning until the target frame time.
+void vloop_end_frame(VloopTimer * loop);
+
+
+
+//-----------------------------------------------------------------------------
+// Fixed-Timestep Loop Query Functions.
+//-----------------------------------------------------------------------------
+
+// Get the simulation tick time step in seconds.
+VmathNumber vloop_get_tick_seconds(const VloopTimer * loop);
+
+// Get how far between the last and next simulation tick the frame is (0.0 to 1.0).
+VmathNumber vloop_get_alpha(const VloopTimer * loop);
+
+// Get the statistics.
+const VloopStats * vloop_get_stats(const VloopTimer * loop);
+
+
+
+#endif /* __VLOOP__H__ */
@@ -952,6 +952,35 @@ CTEST(vmath, test_vmath_matrix3x3_multiply_matrix3x1_result) {
 }
 
 
+CTEST(vmath, test_vmath_matrix3x3_multiply_points) {
+    VmathMatrix3x3 matrix;
+    vmath_matrix3x3_set_identity(matrix);
+    vmath_matrix3x3_upd_rotation_clockwise(matrix, VMATHNUMBER_C(100.0));
+    vmath_matrix3x3_upd_scaling(matrix, VMATHNUMBER_C(2.0), VMATHNUMBER_C(3.0));
+    vmath_matrix3x3_upd_translation(matrix, VMATHNUMBER_C(10.0), VMATHNUMBER_C(-20.0));
+    VmathNumber points[5 * 2];
+    for (int i = 0;  i < 5 * 2;  i++)
+    {
+        points[i] = (VmathNumber)(i * 3 - 7) * VMATHNUMBER_C(1.25);
+    }
+    VmathNumber result[5 * 2];
+    vmath_matrix3x3_multiply_points(matrix, points, 5, result);
+    for (int i = 0;  i < 5;  i++)
+    {
+        const VmathMatrix3x1 point = { points[i * 2], points[i * 2 + 1], VMATHNUMBER_C(1.0) };
+        VmathMatrix3x1 expect;
+        vmath_matrix3x3_multiply_matrix3x1(matrix, point, expect);
+        const VmathMatrix3x1 real = { result[i * 2], result[i * 2 + 1], VMATHNUMBER_C(1.0) };
+        ASSERT_MATRIX3X1_EQUAL_TOL(expect, real, VMATHNUMBER_C(0.0001));
+    }
+    // In place.
+    vmath_matrix3x3_multiply_points(matrix, points, 5, points);
+    for (int i = 0;  i < 5 * 2;  i++)
+    {
+        ASSERT_DBL_EQUAL(result[i], points[i]);
+    }
+}
+
 
 //-----------------------------------------------------------------------------
 // Main Application Entry Point.
@@ -28,6 +28,11 @@
 
 #include "vmath.h"
 
+#if defined(__SSE__) && !defined(VMATH_NO_SIMD)
+#define VMATH_SSE
+#include <xmmintrin.h>
+#endif
+
 
 
 //-----------------------------------------------------------------------------
@@ -517,3 +522,30 @@ void vmath_matrix3x3_multiply_matrix3x1(const VmathMatrix3x3 matrix1, const Vmat
 }
 
 
+// Multiply a 3x3 affine matrix (bottom row 0, 0, 1) by count interleaved (x, y) points
+// storing the transformed points into result (points may equal result).
+void vmath_matrix3x3_multiply_points(const VmathMatrix3x3 matrix, const VmathNumber * points, const int count, VmathNumber * result)
+{
+    assert (count == 0 || (points != NULL && result != NULL));
+    int i = 0;
+#ifdef VMATH_SSE
+    // Two points per register: (x0', y0', x1', y1') = a * (x0, x0, x1, x1) + b * (y0, y0, y1, y1) + t.
+    const __m128 a = _mm_setr_ps(matrix[0][0], matrix[1][0], matrix[0][0], matrix[1][0]);
+    const __m128 b = _mm_setr_ps(matrix[0][1], matrix[1][1], matrix[0][1], matrix[1][1]);
+    const __m128 t = _mm_setr_ps(matrix[0][2], matrix[1][2], matrix[0][2], matrix[1][2]);
+    for (;  i + 2 <= count;  i += 2)
+    {
+        const __m128 p = _mm_loadu_ps(&points[i * 2]);
+        const __m128 xx = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 yy = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        _mm_storeu_ps(&result[i * 2], _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, xx), _mm_mul_ps(b, yy)), t));
+    }
+#endif
+    for (;  i < count;  i++)
+    {
+        const VmathNumber x = points[i * 2];
+        const VmathNumber y = points[i * 2 + 1];
+        result[i * 2] = (matrix[0][0] * x) + (matrix[0][1] * y) + matrix[0][2];
+        result[i * 2 + 1] = (matrix[1][0] * x) + (matrix[1][1] * y) + matrix[1][2];
+    }
+}
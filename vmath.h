@@ -260,6 +260,11 @@ void vmath_matrix3x3_multiply_matrix3x1_fast(const VmathMatrix3x3 matrix1, const
 void vmath_matrix3x3_multiply_matrix3x1(const VmathMatrix3x3 matrix1, const VmathMatrix3x1 matrix2, VmathMatrix3x1 result);
 
 
+// Multiply a 3x3 affine matrix (bottom row 0, 0, 1) by count interleaved (x, y) points
+// storing the transformed points into result (points may equal result).
+void vmath_matrix3x3_multiply_points(const VmathMatrix3x3 matrix, const VmathNumber * points, const int count, VmathNumber * result);
+
+
 
 #endif /* __VMATH__H__ */
 
@@ -0,0 +1,394 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) vRaster Unit Tests.
+// Filename:     vraster-tests.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 10:31
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+// API under test.
+#include "vraster.h"
+#include "vjobs.h"
+
+
+// CTest configuration.
+#define CTEST_MAIN
+#define CTEST_SEGFAULT
+
+// CTest Extra include (implementation) file.
+#include "ctestx.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Test Fixture Lifecycle.
+//-----------------------------------------------------------------------------
+
+CTEST_DATA(vraster)
+{
+    VrasterBuffer raster;
+    uint32_t argb[61 * 37];
+};
+
+
+CTEST_SETUP(vraster)
+{
+    ASSERT_TRUE(vjobs_init(3));
+    ASSERT_TRUE(vraster_init(&data->raster, 61, 37));
+}
+
+
+CTEST_TEARDOWN(vraster)
+{
+    vraster_done(&data->raster);
+    vjobs_done();
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Resolve the buffer and get a single pixel.
+static uint32_t test_vraster_resolved_pixel(struct vraster_data * data, const int x, const int y)
+{
+    vraster_resolve(&data->raster, data->argb, data->raster.width * (int)sizeof(uint32_t));
+    return data->argb[(y * data->raster.width) + x];
+}
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vraster, test_vraster_init) {
+    ASSERT_EQUAL(61, data->raster.width);
+    ASSERT_EQUAL(37, data->raster.height);
+    ASSERT_EQUAL(0, data->raster.pitch % 8);
+    ASSERT_TRUE(data->raster.pitch >= 61 * VRASTER_CHANNELS);
+    ASSERT_NOT_NULL(data->raster.pixels);
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 60, 36));
+}
+
+
+CTEST2(vraster, test_vraster_done) {
+    vraster_done(&data->raster);
+    ASSERT_NULL(data->raster.pixels);
+    ASSERT_EQUAL(0, data->raster.width);
+    ASSERT_EQUAL(0, data->raster.height);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Frame Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vraster, test_vraster_resolve) {
+    for (int x = 0;  x < data->raster.width;  x++) {
+        vraster_point(&data->raster, x, 5, 12, 34, 56);
+    }
+    for (int x = 0;  x < data->raster.width;  x++) {
+        ASSERT_EQUAL(0xFF0C2238u, test_vraster_resolved_pixel(data, x, 5));
+        ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, x, 4));
+    }
+}
+
+
+CTEST2(vraster, test_vraster_point_saturates) {
+    vraster_point(&data->raster, 3, 4, 200, 100, 0);
+    vraster_point(&data->raster, 3, 4, 200, 100, 0);
+    ASSERT_EQUAL(0xFFFFC800u, test_vraster_resolved_pixel(data, 3, 4));
+}
+
+
+CTEST2(vraster, test_vraster_decay) {
+    vraster_point(&data->raster, 10, 10, 200, 100, 50);
+    vraster_set_decay(&data->raster, VMATHNUMBER_C(0.5));
+    vraster_decay(&data->raster);
+    ASSERT_EQUAL(0xFF643219u, test_vraster_resolved_pixel(data, 10, 10));
+    vraster_decay(&data->raster);
+    ASSERT_EQUAL(0xFF32190Cu, test_vraster_resolved_pixel(data, 10, 10));
+}
+
+
+CTEST2(vraster, test_vraster_decay_zero_clears) {
+    vraster_point(&data->raster, 10, 10, 200, 100, 50);
+    vraster_set_decay(&data->raster, VMATHNUMBER_C(0.0));
+    vraster_decay(&data->raster);
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 10, 10));
+}
+
+
+CTEST2(vraster, test_vraster_decay_one_holds) {
+    vraster_point(&data->raster, 10, 10, 200, 100, 50);
+    vraster_set_decay(&data->raster, VMATHNUMBER_C(1.0));
+    vraster_decay(&data->raster);
+    ASSERT_EQUAL(0xFFC86432u, test_vraster_resolved_pixel(data, 10, 10));
+}
+
+
+CTEST2(vraster, test_vraster_resolve_decay) {
+    vraster_point(&data->raster, 10, 10, 200, 100, 50);
+    // The last pixel of a row is past the last whole SIMD register.
+    vraster_point(&data->raster, 60, 10, 200, 100, 50);
+    vraster_set_decay(&data->raster, VMATHNUMBER_C(0.5));
+    vraster_resolve_decay(&data->raster, data->argb, 61 * sizeof(uint32_t));
+    ASSERT_EQUAL(0xFFC86432u, data->argb[(10 * 61) + 10]);
+    ASSERT_EQUAL(0xFFC86432u, data->argb[(10 * 61) + 60]);
+    // Already faded for this frame.
+    vraster_decay(&data->raster);
+    ASSERT_EQUAL(0xFF643219u, test_vraster_resolved_pixel(data, 10, 10));
+    ASSERT_EQUAL(0xFF643219u, test_vraster_resolved_pixel(data, 60, 10));
+    vraster_decay(&data->raster);
+    ASSERT_EQUAL(0xFF32190Cu, test_vraster_resolved_pixel(data, 10, 10));
+}
+
+
+CTEST2(vraster, test_vraster_add_buffer) {
+    VrasterBuffer layer;
+    ASSERT_TRUE(vraster_init(&layer, 61, 37));
+    vraster_point(&layer, 10, 10, 200, 100, 50);
+    vraster_point(&layer, 60, 36, 1, 2, 3);
+    vraster_point(&data->raster, 10, 10, 100, 100, 100);
+    vraster_add_buffer(&data->raster, &layer);
+    vraster_add_buffer(&data->raster, &layer);
+    vraster_done(&layer);
+    ASSERT_EQUAL(0xFFFFFFC8u, test_vraster_resolved_pixel(data, 10, 10));
+    ASSERT_EQUAL(0xFF020406u, test_vraster_resolved_pixel(data, 60, 36));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 11, 10));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Drawing Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vraster, test_vraster_line) {
+    vraster_line(&data->raster, 2, 3, 20, 21, 255, 255, 255);
+    for (int i = 0;  i <= 18;  i++) {
+        ASSERT_EQUAL(0xFFFFFFFFu, test_vraster_resolved_pixel(data, 2 + i, 3 + i));
+    }
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 21, 22));
+}
+
+
+CTEST2(vraster, test_vraster_line_clipped) {
+    vraster_line(&data->raster, -100, 7, 1000, 7, 0, 0, 255);
+    ASSERT_EQUAL(0xFF0000FFu, test_vraster_resolved_pixel(data, 0, 7));
+    ASSERT_EQUAL(0xFF0000FFu, test_vraster_resolved_pixel(data, 60, 7));
+    vraster_line(&data->raster, -100, -100, -10, 1000, 255, 0, 0);
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 0, 0));
+}
+
+
+CTEST2(vraster, test_vraster_line_subpixel) {
+    // Half a pixel lower moves the step from the end to the middle of the line.
+    vraster_line(&data->raster, 0, VMATHNUMBER_C(10.0), 40, VMATHNUMBER_C(11.0), 255, 255, 255);
+    vraster_line(&data->raster, 0, VMATHNUMBER_C(20.5), 40, VMATHNUMBER_C(21.5), 255, 255, 255);
+    ASSERT_EQUAL(0xFFFFFFFFu, test_vraster_resolved_pixel(data, 39, 10));
+    ASSERT_EQUAL(0xFFFFFFFFu, test_vraster_resolved_pixel(data, 40, 11));
+    ASSERT_EQUAL(0xFFFFFFFFu, test_vraster_resolved_pixel(data, 19, 20));
+    ASSERT_EQUAL(0xFFFFFFFFu, test_vraster_resolved_pixel(data, 20, 21));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 20, 20));
+}
+
+
+CTEST2(vraster, test_vraster_line_steep) {
+    vraster_line(&data->raster, 30, 30, 32, 2, 0, 255, 0);
+    ASSERT_EQUAL(0xFF00FF00u, test_vraster_resolved_pixel(data, 30, 30));
+    ASSERT_EQUAL(0xFF00FF00u, test_vraster_resolved_pixel(data, 31, 15));
+    ASSERT_EQUAL(0xFF00FF00u, test_vraster_resolved_pixel(data, 31, 2));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 30, 2));
+}
+
+
+CTEST2(vraster, test_vraster_line_gradient) {
+    vraster_line_gradient(&data->raster, 0, 5, 50, 5, 0, 0, 200, 200, 100, 0);
+    ASSERT_EQUAL(0xFF0000C8u, test_vraster_resolved_pixel(data, 0, 5));
+    ASSERT_EQUAL(0xFF643264u, test_vraster_resolved_pixel(data, 25, 5));
+    ASSERT_EQUAL(0xFFC86400u, test_vraster_resolved_pixel(data, 50, 5));
+}
+
+
+CTEST2(vraster, test_vraster_line_gradient_clipped) {
+    vraster_line_gradient(&data->raster, -50, 5, 50, 5, 0, 0, 0, 200, 200, 200);
+    ASSERT_EQUAL(0xFF646464u, test_vraster_resolved_pixel(data, 0, 5));
+    ASSERT_EQUAL(0xFFC8C8C8u, test_vraster_resolved_pixel(data, 50, 5));
+}
+
+
+CTEST2(vraster, test_vraster_line_antialiased_centred) {
+    // Along the pixel centres the line covers a single row.
+    vraster_line_antialiased(&data->raster, 2, 10.5f, 20, 10.5f, 255, 255, 255);
+    for (int x = 2;  x < 20;  x++) {
+        ASSERT_EQUAL(0xFFFFFFFFu, test_vraster_resolved_pixel(data, x, 10));
+        ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, x, 9));
+        ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, x, 11));
+    }
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 20, 10));
+}
+
+
+CTEST2(vraster, test_vraster_line_antialiased_between) {
+    // Between two rows the line is split evenly over both.
+    vraster_line_antialiased(&data->raster, 2, 10, 20, 10, 200, 100, 50);
+    vraster_line_antialiased(&data->raster, 30.5f, 2, 30.5f, 20, 200, 100, 50);
+    vraster_line_antialiased(&data->raster, 40, 2, 40, 20, 200, 100, 50);
+    for (int i = 3;  i < 19;  i++) {
+        ASSERT_EQUAL(0xFF643219u, test_vraster_resolved_pixel(data, i, 9));
+        ASSERT_EQUAL(0xFF643219u, test_vraster_resolved_pixel(data, i, 10));
+        ASSERT_EQUAL(0xFFC86432u, test_vraster_resolved_pixel(data, 30, i));
+        ASSERT_EQUAL(0xFF643219u, test_vraster_resolved_pixel(data, 39, i));
+        ASSERT_EQUAL(0xFF643219u, test_vraster_resolved_pixel(data, 40, i));
+    }
+}
+
+
+CTEST2(vraster, test_vraster_line_antialiased_joined) {
+    // The shared end point's column adds up to full intensity.
+    vraster_line_antialiased(&data->raster, 2, 5.5f, 10.25f, 5.5f, 200, 100, 50);
+    vraster_line_antialiased(&data->raster, 10.25f, 5.5f, 20, 5.5f, 200, 100, 50);
+    ASSERT_EQUAL(0xFFC86432u, test_vraster_resolved_pixel(data, 10, 5));
+    ASSERT_EQUAL(0xFFC86432u, test_vraster_resolved_pixel(data, 11, 5));
+    // A quarter of the end column is covered.
+    vraster_line_antialiased(&data->raster, 2, 15.5f, 10.25f, 15.5f, 200, 100, 50);
+    ASSERT_EQUAL(0xFF32190Cu, test_vraster_resolved_pixel(data, 10, 15));
+}
+
+
+CTEST2(vraster, test_vraster_line_antialiased_diagonal) {
+    // Each column's coverage is shared between the two nearest pixels.
+    vraster_line_antialiased(&data->raster, 0, 0.5f, 40, 20.5f, 255, 255, 255);
+    for (int x = 1;  x < 39;  x++) {
+        const int y = x / 2;
+        const uint32_t above = test_vraster_resolved_pixel(data, x, y) & 0xFF;
+        const uint32_t below = test_vraster_resolved_pixel(data, x, y + 1) & 0xFF;
+        ASSERT_TRUE((above + below) >= 254);
+        ASSERT_EQUAL((x & 1) ? 63 : 191, above);
+        ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, x, y + 2));
+    }
+}
+
+
+CTEST2(vraster, test_vraster_line_antialiased_clipped) {
+    vraster_line_antialiased(&data->raster, -50, 36.5f, 100, 36.5f, 255, 255, 255);
+    vraster_line_antialiased(&data->raster, 60.5f, -10, 60.5f, 100, 255, 255, 255);
+    vraster_line_antialiased(&data->raster, 0, 0, 100, 100, 255, 255, 255);
+    ASSERT_EQUAL(0xFFFFFFFFu, test_vraster_resolved_pixel(data, 0, 36));
+    ASSERT_EQUAL(0xFFFFFFFFu, test_vraster_resolved_pixel(data, 30, 36));
+    ASSERT_EQUAL(0xFFFFFFFFu, test_vraster_resolved_pixel(data, 60, 0));
+    ASSERT_EQUAL(0xFFFFFFFFu, test_vraster_resolved_pixel(data, 60, 20));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 59, 20));
+}
+
+
+CTEST2(vraster, test_vraster_line_antialiased_gradient) {
+    vraster_set_antialias(&data->raster, true);
+    vraster_line_gradient(&data->raster, 0, 5.5f, 50.5f, 5.5f, 0, 0, 200, 200, 100, 0);
+    ASSERT_EQUAL(0xFF0000C8u, test_vraster_resolved_pixel(data, 0, 5));
+    ASSERT_EQUAL(0xFF643264u, test_vraster_resolved_pixel(data, 25, 5));
+    // Half the end column is covered.
+    ASSERT_EQUAL(0xFF643200u, test_vraster_resolved_pixel(data, 50, 5));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 25, 4));
+}
+
+
+CTEST2(vraster, test_vraster_triangle) {
+    const VmathNumber x[3] = { 0, 20, 0 };
+    const VmathNumber y[3] = { 0, 0, 20 };
+    const uint8_t rgb[3][3] = { { 200, 0, 0 }, { 200, 0, 0 }, { 200, 0, 0 } };
+    vraster_triangle(&data->raster, x, y, rgb);
+    ASSERT_EQUAL(0xFFC80000u, test_vraster_resolved_pixel(data, 0, 0));
+    ASSERT_EQUAL(0xFFC80000u, test_vraster_resolved_pixel(data, 18, 0));
+    ASSERT_EQUAL(0xFFC80000u, test_vraster_resolved_pixel(data, 0, 18));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 19, 1));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 20, 0));
+}
+
+
+CTEST2(vraster, test_vraster_triangle_shared_edge) {
+    // Two triangles making a square; the diagonal is only added once.
+    const VmathNumber x1[3] = { 10, 20, 10 };
+    const VmathNumber y1[3] = { 10, 10, 20 };
+    const VmathNumber x2[3] = { 20, 20, 10 };
+    const VmathNumber y2[3] = { 10, 20, 20 };
+    const uint8_t rgb[3][3] = { { 0, 100, 0 }, { 0, 100, 0 }, { 0, 100, 0 } };
+    vraster_triangle(&data->raster, x1, y1, rgb);
+    vraster_triangle(&data->raster, x2, y2, rgb);
+    for (int py = 10;  py < 20;  py++) {
+        for (int px = 10;  px < 20;  px++) {
+            ASSERT_EQUAL(0xFF006400u, test_vraster_resolved_pixel(data, px, py));
+        }
+    }
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 20, 15));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 15, 20));
+}
+
+
+CTEST2(vraster, test_vraster_triangle_blend) {
+    const VmathNumber x[3] = { 0, 40, 0 };
+    const VmathNumber y[3] = { 0, 0, 30 };
+    const uint8_t rgb[3][3] = { { 0, 0, 0 }, { 0, 0, 200 }, { 0, 0, 0 } };
+    vraster_triangle(&data->raster, x, y, rgb);
+    // Half way along the top edge the blue is about half the vertex's.
+    const uint32_t pixel = test_vraster_resolved_pixel(data, 19, 0);
+    ASSERT_EQUAL(0xFF000000u, pixel & 0xFFFFFF00u);
+    ASSERT_INTERVAL(95, 100, (int)(pixel & 0xFFu));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 39, 29));
+}
+
+
+CTEST2(vraster, test_vraster_line_wide) {
+    vraster_line_wide(&data->raster, 10, 20, 30, 20, 4, 0, 100, 0);
+    // The pen covers two pixels either side of the line, each added once.
+    for (int py = 18;  py < 22;  py++) {
+        ASSERT_EQUAL(0xFF006400u, test_vraster_resolved_pixel(data, 10, py));
+        ASSERT_EQUAL(0xFF006400u, test_vraster_resolved_pixel(data, 29, py));
+    }
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 20, 17));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 20, 22));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 30, 20));
+    // A zero length line draws a pen sized square.
+    vraster_line_wide(&data->raster, 50, 30, 50, 30, 4, 100, 0, 0);
+    ASSERT_EQUAL(0xFF640000u, test_vraster_resolved_pixel(data, 48, 28));
+    ASSERT_EQUAL(0xFF640000u, test_vraster_resolved_pixel(data, 51, 31));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 52, 30));
+}
+
+
+CTEST2(vraster, test_vraster_rect) {
+    vraster_rect(&data->raster, 58, 34, 10, 10, 0, 255, 0);
+    ASSERT_EQUAL(0xFF00FF00u, test_vraster_resolved_pixel(data, 58, 34));
+    ASSERT_EQUAL(0xFF00FF00u, test_vraster_resolved_pixel(data, 60, 36));
+    ASSERT_EQUAL(0xFF000000u, test_vraster_resolved_pixel(data, 57, 34));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Main Application Entry Point.
+//-----------------------------------------------------------------------------
+
+// Function main() implementation.
+CTESTX_MAIN
@@ -0,0 +1,765 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) CPU Raster Buffer.
+// Filename:     vraster.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 09:40
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL.h>
+
+#include "vraster.h"
+#include "vjobs.h"
+
+#ifdef VRASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Channel values per SIMD register.
+#define VRASTER_LANES 8
+
+
+// Get a pointer to the first channel of a pixel.
+static inline uint16_t * vraster_pixel(const VrasterBuffer * raster, const int x, const int y)
+{
+    return raster->pixels + ((size_t)y * raster->pitch) + ((size_t)x * VRASTER_CHANNELS);
+}
+
+
+// Saturating add of a colour to a pixel.
+static inline void vraster_add(uint16_t * pixel,
+                               const unsigned int red,
+                               const unsigned int green,
+                               const unsigned int blue)
+{
+    const unsigned int b = pixel[0] + blue;
+    const unsigned int g = pixel[1] + green;
+    const unsigned int r = pixel[2] + red;
+    pixel[0] = (b > 0xFFFF) ? 0xFFFF : b;
+    pixel[1] = (g > 0xFFFF) ? 0xFFFF : g;
+    pixel[2] = (r > 0xFFFF) ? 0xFFFF : r;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a cleared buffer of width by height pixels.
+bool vraster_init(VrasterBuffer * raster, const int width, const int height)
+{
+    assert (raster != NULL);
+    assert (width > 0);
+    assert (height > 0);
+    memset(raster, 0, sizeof(VrasterBuffer));
+    raster->width = width;
+    raster->height = height;
+    raster->pitch = ((width * VRASTER_CHANNELS) + VRASTER_LANES - 1) & ~(VRASTER_LANES - 1);
+    raster->pixels = calloc((size_t)raster->pitch * height, sizeof(uint16_t));
+    if (raster->pixels == NULL) {
+        vraster_done(raster);
+        return false;
+    }
+    return true;
+}
+
+
+// Clean-up the buffer.
+void vraster_done(VrasterBuffer * raster)
+{
+    assert (raster != NULL);
+    free(raster->pixels);
+    raster->pixels = NULL;
+    raster->width = 0;
+    raster->height = 0;
+    raster->pitch = 0;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer State Functions.
+//-----------------------------------------------------------------------------
+
+// Set the per frame decay (0.0 = clear each frame, 1.0 = never fade).
+void vraster_set_decay(VrasterBuffer * raster, const VmathNumber decay)
+{
+    assert (raster != NULL);
+    raster->decay = (uint16_t)vmath_clip_floor_ceil(decay * VMATHNUMBER_C(65536.0),
+                                                    VMATHNUMBER_C(0.0), VMATHNUMBER_C(65535.0));
+}
+
+
+// Set whether vraster_line() and vraster_line_gradient() draw antialiased lines.
+void vraster_set_antialias(VrasterBuffer * raster, const bool antialias)
+{
+    assert (raster != NULL);
+    raster->antialias = antialias;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Frame Functions.
+//-----------------------------------------------------------------------------
+
+// Clear the whole buffer to zero intensity.
+void vraster_clear(VrasterBuffer * raster)
+{
+    assert (raster != NULL);
+    memset(raster->pixels, 0, (size_t)raster->pitch * raster->height * sizeof(uint16_t));
+}
+
+
+// Fade count channel values by the decay multiplier.
+static inline void vraster_decay_channels(uint16_t * channel, const int count, const uint16_t decay)
+{
+#ifdef VRASTER_SSE2
+    const __m128i multiplier = _mm_set1_epi16((short)decay);
+    for (int i = 0;  i < count;  i += VRASTER_LANES) {
+        __m128i * lane = (__m128i *)(channel + i);
+        _mm_storeu_si128(lane, _mm_mulhi_epu16(_mm_loadu_si128(lane), multiplier));
+    }
+#else
+    for (int i = 0;  i < count;  i++) {
+        channel[i] = (uint16_t)((channel[i] * (uint32_t)decay) >> 16);
+    }
+#endif
+}
+
+
+// Fade rows [begin, end) by the decay multiplier.
+static void vraster_decay_rows(void * data, const int begin, const int end)
+{
+    VrasterBuffer * raster = data;
+    vraster_decay_channels(raster->pixels + ((size_t)begin * raster->pitch),
+                           (end - begin) * raster->pitch,
+                           raster->decay);
+}
+
+
+// Fade the whole buffer by the decay multiplier (clears if decay is 0),
+// unless vraster_resolve_decay has already faded it since the last frame.
+void vraster_decay(VrasterBuffer * raster)
+{
+    assert (raster != NULL);
+    if (raster->decayed) {
+        raster->decayed = false;
+    } else if (raster->decay == 0) {
+        vraster_clear(raster);
+    } else if (raster->decay != 0xFFFF) {
+        vjobs_parallel_for(0, raster->height, VRASTER_ROWS_PER_JOB, vraster_decay_rows, raster);
+    }
+}
+
+
+// Resolve job data.
+typedef struct VrasterResolve {
+    VrasterBuffer * raster;
+    uint8_t * argb8888;
+    int pitch;
+    bool decay;
+} VrasterResolve;
+
+
+// Resolve a row to ARGB8888.
+static inline void vraster_resolve_row(const uint16_t * channel, uint32_t * out, const int width)
+{
+    int x = 0;
+#ifdef VRASTER_SSE2
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    for (;  x + 4 <= width;  x += 4, channel += 4 * VRASTER_CHANNELS) {
+        const __m128i lo = _mm_srli_epi16(_mm_loadu_si128((const __m128i *)channel), 8);
+        const __m128i hi = _mm_srli_epi16(_mm_loadu_si128((const __m128i *)(channel + VRASTER_LANES)), 8);
+        _mm_storeu_si128((__m128i *)(out + x), _mm_or_si128(_mm_packus_epi16(lo, hi), alpha));
+    }
+#endif
+    for (;  x < width;  x++, channel += VRASTER_CHANNELS) {
+        out[x] = 0xFF000000u
+                 | ((uint32_t)(channel[2] >> 8) << 16)
+                 | ((uint32_t)(channel[1] >> 8) << 8)
+                 | (uint32_t)(channel[0] >> 8);
+    }
+}
+
+
+// Resolve a row to ARGB8888 and fade it, each channel value loaded once.
+static inline void vraster_resolve_decay_row(uint16_t * channel, uint32_t * out, const int width,
+                                             const int pitch, const uint16_t decay)
+{
+    int x = 0;
+#ifdef VRASTER_SSE2
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i multiplier = _mm_set1_epi16((short)decay);
+    // The output is never read back, so bypass the cache when it is aligned.
+    const bool stream = (((uintptr_t)out & 15) == 0);
+    for (;  x + 4 <= width;  x += 4, channel += 4 * VRASTER_CHANNELS) {
+        __m128i * lane = (__m128i *)channel;
+        const __m128i lo = _mm_loadu_si128(lane);
+        const __m128i hi = _mm_loadu_si128(lane + 1);
+        const __m128i argb = _mm_or_si128(_mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)), alpha);
+        if (stream) {
+            _mm_stream_si128((__m128i *)(out + x), argb);
+        } else {
+            _mm_storeu_si128((__m128i *)(out + x), argb);
+        }
+        _mm_storeu_si128(lane, _mm_mulhi_epu16(lo, multiplier));
+        _mm_storeu_si128(lane + 1, _mm_mulhi_epu16(hi, multiplier));
+    }
+#endif
+    // The remaining pixels, then the padding channel values.
+    const int count = pitch - (x * VRASTER_CHANNELS);
+    vraster_resolve_row(channel, out + x, width - x);
+    vraster_decay_channels(channel, count, decay);
+}
+
+
+// Resolve rows [begin, end) to ARGB8888, fading each row in the same pass.
+static void vraster_resolve_rows(void * data, const int begin, const int end)
+{
+    const VrasterResolve * resolve = data;
+    VrasterBuffer * raster = resolve->raster;
+    const bool decay = resolve->decay && (raster->decay != 0xFFFF);
+    for (int y = begin;  y < end;  y++) {
+        uint16_t * channel = vraster_pixel(raster, 0, y);
+        uint32_t * out = (uint32_t *)(resolve->argb8888 + ((size_t)y * resolve->pitch));
+        if (decay) {
+            vraster_resolve_decay_row(channel, out, raster->width, raster->pitch, raster->decay);
+        } else {
+            vraster_resolve_row(channel, out, raster->width);
+        }
+    }
+#ifdef VRASTER_SSE2
+    // Order the streamed output before the job is counted as done.
+    _mm_sfence();
+#endif
+}
+
+
+// Resolve the buffer to opaque ARGB8888 pixels (pitch in bytes).
+void vraster_resolve(const VrasterBuffer * raster, void * argb8888, const int pitch)
+{
+    assert (raster != NULL);
+    assert (argb8888 != NULL);
+    // The rows are only read when not decaying.
+    VrasterResolve resolve = { .raster = (VrasterBuffer *)raster, .argb8888 = argb8888, .pitch = pitch, .decay = false };
+    vjobs_parallel_for(0, raster->height, VRASTER_ROWS_PER_JOB, vraster_resolve_rows, &resolve);
+}
+
+
+// Resolve the buffer and fade it for the next frame in a single pass.
+void vraster_resolve_decay(VrasterBuffer * raster, void * argb8888, const int pitch)
+{
+    assert (raster != NULL);
+    assert (argb8888 != NULL);
+    VrasterResolve resolve = { .raster = raster, .argb8888 = argb8888, .pitch = pitch, .decay = true };
+    vjobs_parallel_for(0, raster->height, VRASTER_ROWS_PER_JOB, vraster_resolve_rows, &resolve);
+    raster->decayed = true;
+}
+
+
+// Add job data.
+typedef struct VrasterAdd {
+    VrasterBuffer * raster;
+    const VrasterBuffer * source;
+} VrasterAdd;
+
+
+// Add count source channel values onto the channel values, saturating.
+static inline void vraster_add_channels(uint16_t * channel, const uint16_t * source, const int count)
+{
+#ifdef VRASTER_SSE2
+    for (int i = 0;  i < count;  i += VRASTER_LANES) {
+        __m128i * lane = (__m128i *)(channel + i);
+        _mm_storeu_si128(lane, _mm_adds_epu16(_mm_loadu_si128(lane),
+                                              _mm_loadu_si128((const __m128i *)(source + i))));
+    }
+#else
+    for (int i = 0;  i < count;  i++) {
+        const uint32_t sum = (uint32_t)channel[i] + source[i];
+        channel[i] = (uint16_t)((sum > 0xFFFF) ? 0xFFFF : sum);
+    }
+#endif
+}
+
+
+// Add source rows [begin, end) onto the buffer.
+static void vraster_add_rows(void * data, const int begin, const int end)
+{
+    const VrasterAdd * add = data;
+    const size_t first = (size_t)begin * add->raster->pitch;
+    vraster_add_channels(add->raster->pixels + first,
+                         add->source->pixels + first,
+                         (end - begin) * add->raster->pitch);
+}
+
+
+// Add the source buffer, the same size as the buffer, onto it, saturating.
+void vraster_add_buffer(VrasterBuffer * raster, const VrasterBuffer * source)
+{
+    assert (raster != NULL);
+    assert (source != NULL);
+    assert ((source->width == raster->width) && (source->height == raster->height));
+    VrasterAdd add = { .raster = raster, .source = source };
+    vjobs_parallel_for(0, raster->height, VRASTER_ROWS_PER_JOB, vraster_add_rows, &add);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Drawing Functions.
+//-----------------------------------------------------------------------------
+
+// Add a point.
+void vraster_point(VrasterBuffer * raster,
+                   const VmathNumber x, const VmathNumber y,
+                   const uint8_t red, const uint8_t green, const uint8_t blue)
+{
+    assert (raster != NULL);
+    if ((x < VMATHNUMBER_C(0.0)) || (y < VMATHNUMBER_C(0.0))) {
+        return;
+    }
+    const int px = (int)x;
+    const int py = (int)y;
+    if ((px < raster->width) && (py < raster->height)) {
+        vraster_add(vraster_pixel(raster, px, py),
+                    red * VRASTER_CHANNEL_ONE, green * VRASTER_CHANNEL_ONE, blue * VRASTER_CHANNEL_ONE);
+    }
+}
+
+
+// Add a filled rectangle.
+void vraster_rect(VrasterBuffer * raster,
+                  const VmathNumber x, const VmathNumber y,
+                  const VmathNumber w, const VmathNumber h,
+                  const uint8_t red, const uint8_t green, const uint8_t blue)
+{
+    assert (raster != NULL);
+    const int x1 = SDL_max((int)x, 0);
+    const int y1 = SDL_max((int)y, 0);
+    const int x2 = SDL_min((int)(x + w), raster->width);
+    const int y2 = SDL_min((int)(y + h), raster->height);
+    for (int py = y1;  py < y2;  py++) {
+        uint16_t * pixel = vraster_pixel(raster, x1, py);
+        for (int px = x1;  px < x2;  px++, pixel += VRASTER_CHANNELS) {
+            vraster_add(pixel, red * VRASTER_CHANNEL_ONE, green * VRASTER_CHANNEL_ONE, blue * VRASTER_CHANNEL_ONE);
+        }
+    }
+}
+
+
+// Clip a line to [0, max_x] x [0, max_y] (Liang-Barsky). Returns false if outside.
+// The clipped end points are at t1 and t2 along the original line.
+static bool vraster_clip_line(VmathNumber * x1, VmathNumber * y1,
+                              VmathNumber * x2, VmathNumber * y2,
+                              const VmathNumber max_x, const VmathNumber max_y,
+                              VmathNumber * t1, VmathNumber * t2)
+{
+    const VmathNumber dx = *x2 - *x1;
+    const VmathNumber dy = *y2 - *y1;
+    const VmathNumber p[4] = { -dx, dx, -dy, dy };
+    const VmathNumber q[4] = { *x1, max_x - *x1, *y1, max_y - *y1 };
+    *t1 = VMATHNUMBER_C(0.0);
+    *t2 = VMATHNUMBER_C(1.0);
+    for (int i = 0;  i < 4;  i++) {
+        if (p[i] == VMATHNUMBER_C(0.0)) {
+            if (q[i] < VMATHNUMBER_C(0.0)) {
+                return false;
+            }
+        } else {
+            const VmathNumber t = q[i] / p[i];
+            if (p[i] < VMATHNUMBER_C(0.0)) {
+                *t1 = (t > *t1) ? t : *t1;
+            } else {
+                *t2 = (t < *t2) ? t : *t2;
+            }
+        }
+    }
+    if (*t1 > *t2) {
+        return false;
+    }
+    *x2 = *x1 + (*t2 * dx);
+    *y2 = *y1 + (*t2 * dy);
+    *x1 = *x1 + (*t1 * dx);
+    *y1 = *y1 + (*t1 * dy);
+    return true;
+}
+
+
+// Add a line clipped to the buffer.
+void vraster_line(VrasterBuffer * raster,
+                  const VmathNumber x1, const VmathNumber y1,
+                  const VmathNumber x2, const VmathNumber y2,
+                  const uint8_t red, const uint8_t green, const uint8_t blue)
+{
+    vraster_line_gradient(raster, x1, y1, x2, y2, red, green, blue, red, green, blue);
+}
+
+
+// Add a line clipped to the buffer, blending from the first to the second colour.
+void vraster_line_gradient(VrasterBuffer * raster,
+                           const VmathNumber x1, const VmathNumber y1,
+                           const VmathNumber x2, const VmathNumber y2,
+                           const uint8_t red1, const uint8_t green1, const uint8_t blue1,
+                           const uint8_t red2, const uint8_t green2, const uint8_t blue2)
+{
+    assert (raster != NULL);
+    if (raster->antialias) {
+        vraster_line_gradient_antialiased(raster, x1, y1, x2, y2, red1, green1, blue1, red2, green2, blue2);
+        return;
+    }
+    VmathNumber cx1 = x1, cy1 = y1, cx2 = x2, cy2 = y2;
+    VmathNumber t1, t2;
+    if (!vraster_clip_line(&cx1, &cy1, &cx2, &cy2,
+                           (VmathNumber)(raster->width - 1), (VmathNumber)(raster->height - 1),
+                           &t1, &t2)) {
+        return;
+    }
+    // Step one pixel at a time along the major axis, sampling the minor axis
+    // at each pixel centre from the sub-pixel end points (16.16 fixed point).
+    const VmathNumber dx = cx2 - cx1;
+    const VmathNumber dy = cy2 - cy1;
+    const bool steep = fabsf(dy) > fabsf(dx);
+    const VmathNumber major1 = steep ? cy1 : cx1;
+    const VmathNumber major2 = steep ? cy2 : cx2;
+    const VmathNumber minor1 = steep ? cx1 : cy1;
+    const VmathNumber minor2 = steep ? cx2 : cy2;
+    const VmathNumber slope = (major2 != major1) ? ((minor2 - minor1) / (major2 - major1)) : VMATHNUMBER_C(0.0);
+    const ptrdiff_t major_stride = steep ? raster->pitch : VRASTER_CHANNELS;
+    const ptrdiff_t minor_stride = steep ? VRASTER_CHANNELS : raster->pitch;
+    int major = (int)major1;
+    const int major_end = (int)major2;
+    const int major_step = (major <= major_end) ? 1 : -1;
+    const int count = abs(major_end - major) + 1;
+    const int minor_low = (int)SDL_min(minor1, minor2);
+    const int minor_high = (int)SDL_max(minor1, minor2);
+    int32_t minor = (int32_t)((minor1 + ((((VmathNumber)major + VMATHNUMBER_C(0.5)) - major1) * slope))
+                              * VMATHNUMBER_C(65536.0));
+    const int32_t minor_step = (int32_t)(slope * major_step * VMATHNUMBER_C(65536.0));
+    // Channel values in 8.16 fixed point, stepped once per pixel.
+    const int steps = SDL_max(count - 1, 1);
+    const VmathNumber start[3] = { blue1 + ((blue2 - blue1) * t1),
+                                   green1 + ((green2 - green1) * t1),
+                                   red1 + ((red2 - red1) * t1) };
+    const VmathNumber end[3] = { blue1 + ((blue2 - blue1) * t2),
+                                 green1 + ((green2 - green1) * t2),
+                                 red1 + ((red2 - red1) * t2) };
+    int32_t channel[3];
+    int32_t step[3];
+    for (int c = 0;  c < 3;  c++) {
+        channel[c] = (int32_t)(start[c] * VMATHNUMBER_C(65536.0));
+        step[c] = (int32_t)(((end[c] - start[c]) * VMATHNUMBER_C(65536.0)) / steps);
+    }
+    for (int i = 0;  i < count;  i++) {
+        const int pixel_minor = SDL_min(SDL_max(SDL_max(minor, 0) >> 16, minor_low), minor_high);
+        vraster_add(raster->pixels + (major * major_stride) + (pixel_minor * minor_stride),
+                    (unsigned int)SDL_max(channel[2], 0) >> 8,
+                    (unsigned int)SDL_max(channel[1], 0) >> 8,
+                    (unsigned int)SDL_max(channel[0], 0) >> 8);
+        major += major_step;
+        minor += minor_step;
+        for (int c = 0;  c < 3;  c++) {
+            channel[c] += step[c];
+        }
+    }
+}
+
+
+// Add a colour (0 to 255 per channel) to a pixel, weighted by its coverage (0 to VRASTER_CHANNEL_ONE).
+static inline void vraster_add_coverage(uint16_t * pixel, const unsigned int coverage,
+                                        const unsigned int red, const unsigned int green, const unsigned int blue)
+{
+    vraster_add(pixel, red * coverage, green * coverage, blue * coverage);
+}
+
+
+#ifdef VRASTER_SSE2
+// Add the colours of two adjacent pixels (16 bit lanes, 0 to 255) weighted by
+// their coverage lanes (0 to VRASTER_CHANNEL_ONE), saturating.
+static inline void vraster_add_coverage_pair(uint16_t * pixel, const __m128i colour, const __m128i coverage)
+{
+    __m128i * lane = (__m128i *)pixel;
+    _mm_storeu_si128(lane, _mm_adds_epu16(_mm_loadu_si128(lane), _mm_mullo_epi16(colour, coverage)));
+}
+#endif
+
+
+// Add an antialiased line clipped to the buffer.
+void vraster_line_antialiased(VrasterBuffer * raster,
+                              const VmathNumber x1, const VmathNumber y1,
+                              const VmathNumber x2, const VmathNumber y2,
+                              const uint8_t red, const uint8_t green, const uint8_t blue)
+{
+    vraster_line_gradient_antialiased(raster, x1, y1, x2, y2, red, green, blue, red, green, blue);
+}
+
+
+// Add an antialiased line clipped to the buffer, blending from the first to the second colour.
+void vraster_line_gradient_antialiased(VrasterBuffer * raster,
+                                       const VmathNumber x1, const VmathNumber y1,
+                                       const VmathNumber x2, const VmathNumber y2,
+                                       const uint8_t red1, const uint8_t green1, const uint8_t blue1,
+                                       const uint8_t red2, const uint8_t green2, const uint8_t blue2)
+{
+    assert (raster != NULL);
+    // Pixel x covers [x, x + 1), so clip just inside the far edges.
+    VmathNumber cx1 = x1, cy1 = y1, cx2 = x2, cy2 = y2;
+    VmathNumber t1, t2;
+    if (!vraster_clip_line(&cx1, &cy1, &cx2, &cy2,
+                           (VmathNumber)raster->width - VMATHNUMBER_C(0.001),
+                           (VmathNumber)raster->height - VMATHNUMBER_C(0.001),
+                           &t1, &t2)) {
+        return;
+    }
+    // Step one column at a time along the major axis, in increasing order.
+    const bool steep = fabsf(cy2 - cy1) > fabsf(cx2 - cx1);
+    const bool reverse = steep ? (cy2 < cy1) : (cx2 < cx1);
+    const VmathNumber major1 = steep ? (reverse ? cy2 : cy1) : (reverse ? cx2 : cx1);
+    const VmathNumber major2 = steep ? (reverse ? cy1 : cy2) : (reverse ? cx1 : cx2);
+    const VmathNumber minor1 = steep ? (reverse ? cx2 : cx1) : (reverse ? cy2 : cy1);
+    const VmathNumber minor2 = steep ? (reverse ? cx1 : cx2) : (reverse ? cy1 : cy2);
+    const VmathNumber slope = (major2 > major1) ? ((minor2 - minor1) / (major2 - major1)) : VMATHNUMBER_C(0.0);
+    const ptrdiff_t major_stride = steep ? raster->pitch : VRASTER_CHANNELS;
+    const ptrdiff_t minor_stride = steep ? VRASTER_CHANNELS : raster->pitch;
+    const int minor_limit = steep ? raster->width : raster->height;
+    const int first = (int)major1;
+    const int last = (int)major2;
+    // Minor position at each column centre, less half a pixel so the integer
+    // part is the first of the two pixels straddling the line, plus a pixel
+    // so it is never negative (16.16 fixed point).
+    uint32_t minor = (uint32_t)((minor1 + ((((VmathNumber)first + VMATHNUMBER_C(0.5)) - major1) * slope)
+                                 + VMATHNUMBER_C(0.5)) * VMATHNUMBER_C(65536.0));
+    const int32_t minor_step = (int32_t)(slope * VMATHNUMBER_C(65536.0));
+    // Channel values in 8.16 fixed point, stepped once per column.
+    const VmathNumber ta = reverse ? t2 : t1;
+    const VmathNumber tb = reverse ? t1 : t2;
+    const int steps = SDL_max(last - first, 1);
+    const VmathNumber start[3] = { blue1 + ((blue2 - blue1) * ta),
+                                   green1 + ((green2 - green1) * ta),
+                                   red1 + ((red2 - red1) * ta) };
+    const VmathNumber end[3] = { blue1 + ((blue2 - blue1) * tb),
+                                 green1 + ((green2 - green1) * tb),
+                                 red1 + ((red2 - red1) * tb) };
+    int32_t channel[3];
+    int32_t step[3];
+    for (int c = 0;  c < 3;  c++) {
+        channel[c] = (int32_t)(start[c] * VMATHNUMBER_C(65536.0));
+        step[c] = (int32_t)(((end[c] - start[c]) * VMATHNUMBER_C(65536.0)) / steps);
+    }
+    // Coverage of the end columns by the line along the major axis.
+    const VmathNumber one = (VmathNumber)VRASTER_CHANNEL_ONE;
+    const unsigned int first_coverage = (first == last)
+                                        ? (unsigned int)(((major2 - major1) * one) + VMATHNUMBER_C(0.5))
+                                        : (unsigned int)(((((VmathNumber)first + 1) - major1) * one) + VMATHNUMBER_C(0.5));
+    const unsigned int last_coverage = (unsigned int)(((major2 - (VmathNumber)last) * one) + VMATHNUMBER_C(0.5));
+    for (int major = first;  major <= last;  major++) {
+        const unsigned int coverage = (major == first) ? first_coverage
+                                      : ((major == last) ? last_coverage : VRASTER_CHANNEL_ONE);
+        const int pixel = (int)(minor >> 16) - 1;
+        const unsigned int coverage2 = (((minor >> 8) & 0xFF) * coverage) >> 8;
+        const unsigned int coverage1 = coverage - coverage2;
+        const unsigned int blue = (unsigned int)SDL_max(channel[0], 0) >> 16;
+        const unsigned int green = (unsigned int)SDL_max(channel[1], 0) >> 16;
+        const unsigned int red = (unsigned int)SDL_max(channel[2], 0) >> 16;
+        uint16_t * pixel1 = raster->pixels + (major * major_stride) + (pixel * minor_stride);
+#ifdef VRASTER_SSE2
+        const bool inside = (pixel >= 0) && ((pixel + 1) < minor_limit);
+        if (inside && steep) {
+            // The two pixels are adjacent in the row.
+            vraster_add_coverage_pair(pixel1,
+                                      _mm_set_epi16(0, (short)red, (short)green, (short)blue,
+                                                    0, (short)red, (short)green, (short)blue),
+                                      _mm_set_epi16((short)coverage2, (short)coverage2, (short)coverage2, (short)coverage2,
+                                                    (short)coverage1, (short)coverage1, (short)coverage1, (short)coverage1));
+        } else if (inside && (major < (last - 1)) && (major != first)
+                   && ((int)((minor + (uint32_t)minor_step) >> 16) - 1 == pixel)) {
+            // The next column uses the same rows, so each row's pair of pixels is adjacent.
+            const uint32_t next_minor = minor + (uint32_t)minor_step;
+            const unsigned int next_coverage2 = ((next_minor >> 8) & 0xFF);
+            const unsigned int next_coverage1 = VRASTER_CHANNEL_ONE - next_coverage2;
+            const unsigned int next_blue = (unsigned int)SDL_max(channel[0] + step[0], 0) >> 16;
+            const unsigned int next_green = (unsigned int)SDL_max(channel[1] + step[1], 0) >> 16;
+            const unsigned int next_red = (unsigned int)SDL_max(channel[2] + step[2], 0) >> 16;
+            const __m128i colour = _mm_set_epi16(0, (short)next_red, (short)next_green, (short)next_blue,
+                                                 0, (short)red, (short)green, (short)blue);
+            vraster_add_coverage_pair(pixel1, colour,
+                                      _mm_set_epi16((short)next_coverage1, (short)next_coverage1,
+                                                    (short)next_coverage1, (short)next_coverage1,
+                                                    (short)coverage1, (short)coverage1, (short)coverage1, (short)coverage1));
+            vraster_add_coverage_pair(pixel1 + minor_stride, colour,
+                                      _mm_set_epi16((short)next_coverage2, (short)next_coverage2,
+                                                    (short)next_coverage2, (short)next_coverage2,
+                                                    (short)coverage2, (short)coverage2, (short)coverage2, (short)coverage2));
+            major++;
+            minor = next_minor + (uint32_t)minor_step;
+            for (int c = 0;  c < 3;  c++) {
+                channel[c] += 2 * step[c];
+            }
+            continue;
+        } else
+#endif
+        {
+            if (pixel >= 0) {
+                vraster_add_coverage(pixel1, coverage1, red, green, blue);
+            }
+            if ((pixel + 1) < minor_limit) {
+                vraster_add_coverage(pixel1 + minor_stride, coverage2, red, green, blue);
+            }
+        }
+        minor += (uint32_t)minor_step;
+        for (int c = 0;  c < 3;  c++) {
+            channel[c] += step[c];
+        }
+    }
+}
+
+
+// Edge function; twice the signed area of the triangle a, b, p.
+static inline VmathNumber vraster_edge(const VmathNumber ax, const VmathNumber ay,
+                                       const VmathNumber bx, const VmathNumber by,
+                                       const VmathNumber px, const VmathNumber py)
+{
+    return ((bx - ax) * (py - ay)) - ((by - ay) * (px - ax));
+}
+
+
+// Does the edge from a to b own pixels centred exactly on it (top-left rule)?
+static inline bool vraster_edge_top_left(const VmathNumber ax, const VmathNumber ay,
+                                         const VmathNumber bx, const VmathNumber by)
+{
+    return (by < ay) || ((by == ay) && (bx > ax));
+}
+
+
+// Add a triangle clipped to the buffer, blending the vertex colours across it.
+void vraster_triangle(VrasterBuffer * raster,
+                      const VmathNumber x[3], const VmathNumber y[3],
+                      const uint8_t rgb[3][3])
+{
+    assert (raster != NULL);
+    // Order the vertices so the area, and the inside of every edge, is positive.
+    int v1 = 1;
+    int v2 = 2;
+    VmathNumber area = vraster_edge(x[0], y[0], x[1], y[1], x[2], y[2]);
+    if (area < VMATHNUMBER_C(0.0)) {
+        v1 = 2;
+        v2 = 1;
+        area = -area;
+    }
+    if (area == VMATHNUMBER_C(0.0)) {
+        return;
+    }
+    const VmathNumber vx[3] = { x[0], x[v1], x[v2] };
+    const VmathNumber vy[3] = { y[0], y[v1], y[v2] };
+    const uint8_t * vc[3] = { rgb[0], rgb[v1], rgb[v2] };
+    // Pixel bounds clipped to the buffer.
+    const int x1 = SDL_max((int)floorf(SDL_min(vx[0], SDL_min(vx[1], vx[2]))), 0);
+    const int y1 = SDL_max((int)floorf(SDL_min(vy[0], SDL_min(vy[1], vy[2]))), 0);
+    const int x2 = SDL_min((int)ceilf(SDL_max(vx[0], SDL_max(vx[1], vx[2]))), raster->width - 1);
+    const int y2 = SDL_min((int)ceilf(SDL_max(vy[0], SDL_max(vy[1], vy[2]))), raster->height - 1);
+    // Edge i is opposite vertex i; its function is that vertex's weight.
+    bool top_left[3];
+    VmathNumber step_x[3];
+    for (int i = 0;  i < 3;  i++) {
+        const int a = (i + 1) % 3;
+        const int b = (i + 2) % 3;
+        top_left[i] = vraster_edge_top_left(vx[a], vy[a], vx[b], vy[b]);
+        step_x[i] = vy[a] - vy[b];
+    }
+    // Channel values per unit of weight, in 8.8 fixed point.
+    VmathNumber scale[3][3];
+    for (int i = 0;  i < 3;  i++) {
+        for (int c = 0;  c < 3;  c++) {
+            scale[i][c] = (vc[i][2 - c] * (VmathNumber)VRASTER_CHANNEL_ONE) / area;
+        }
+    }
+    for (int py = y1;  py <= y2;  py++) {
+        const VmathNumber cy = (VmathNumber)py + VMATHNUMBER_C(0.5);
+        const VmathNumber cx = (VmathNumber)x1 + VMATHNUMBER_C(0.5);
+        VmathNumber weight[3];
+        for (int i = 0;  i < 3;  i++) {
+            const int a = (i + 1) % 3;
+            const int b = (i + 2) % 3;
+            weight[i] = vraster_edge(vx[a], vy[a], vx[b], vy[b], cx, cy);
+        }
+        uint16_t * pixel = vraster_pixel(raster, x1, py);
+        for (int px = x1;  px <= x2;  px++, pixel += VRASTER_CHANNELS) {
+            bool inside = true;
+            for (int i = 0;  i < 3;  i++) {
+                inside = inside && ((weight[i] > VMATHNUMBER_C(0.0))
+                                    || ((weight[i] == VMATHNUMBER_C(0.0)) && top_left[i]));
+            }
+            if (inside) {
+                unsigned int channel[3];
+                for (int c = 0;  c < 3;  c++) {
+                    const VmathNumber value = (weight[0] * scale[0][c]) + (weight[1] * scale[1][c]) + (weight[2] * scale[2][c]);
+                    channel[c] = (unsigned int)SDL_max(value, VMATHNUMBER_C(0.0));
+                }
+                vraster_add(pixel, channel[2], channel[1], channel[0]);
+            }
+            for (int i = 0;  i < 3;  i++) {
+                weight[i] += step_x[i];
+            }
+        }
+    }
+}
+
+
+
+// Add a line pen_width wide, as a quad of two triangles, clipped to the buffer.
+void vraster_line_wide(VrasterBuffer * raster,
+                       const VmathNumber x1, const VmathNumber y1,
+                       const VmathNumber x2, const VmathNumber y2,
+                       const VmathNumber pen_width,
+                       const uint8_t red, const uint8_t green, const uint8_t blue)
+{
+    assert (raster != NULL);
+    const VmathNumber half_width = pen_width / VMATHNUMBER_C(2.0);
+    const VmathNumber dx = x2 - x1;
+    const VmathNumber dy = y2 - y1;
+    const VmathNumber length = sqrt((dx * dx) + (dy * dy));
+    if (length == VMATHNUMBER_C(0.0)) {
+        vraster_rect(raster, x1 - half_width, y1 - half_width, pen_width, pen_width, red, green, blue);
+        return;
+    }
+    // Offset the ends either side of the line by half the pen.
+    const VmathNumber nx = (-dy / length) * half_width;
+    const VmathNumber ny = (dx / length) * half_width;
+    const VmathNumber ax[3] = { x1 + nx, x1 - nx, x2 + nx };
+    const VmathNumber ay[3] = { y1 + ny, y1 - ny, y2 + ny };
+    const VmathNumber bx[3] = { x1 - nx, x2 - nx, x2 + nx };
+    const VmathNumber by[3] = { y1 - ny, y2 - ny, y2 + ny };
+    const uint8_t rgb[3][3] = { { red, green, blue }, { red, green, blue }, { red, green, blue } };
+    vraster_triangle(raster, ax, ay, rgb);
+    vraster_triangle(raster, bx, by, rgb);
+}
@@ -0,0 +1,195 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) CPU Raster Buffer.
+// Filename:     vraster.h
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 09:40
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef __VRASTER__H__
+#define __VRASTER__H__
+
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vmath.h"
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Configuration.
+//-----------------------------------------------------------------------------
+
+// Use SSE2 kernels where the compiler targets them (define to disable).
+#if defined(__SSE2__) && !defined(VRASTER_NO_SIMD)
+#define VRASTER_SSE2
+#endif
+
+// Number of rows per parallel job chunk.
+#ifndef VRASTER_ROWS_PER_JOB
+#define VRASTER_ROWS_PER_JOB 32
+#endif
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Constants.
+//-----------------------------------------------------------------------------
+
+// Channels per pixel, stored in ARGB8888 memory order (blue, green, red, pad).
+#define VRASTER_CHANNELS 4
+
+// Channel values are 8.8 fixed point; a full intensity channel is 255.0.
+#define VRASTER_CHANNEL_ONE 256
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Types.
+//-----------------------------------------------------------------------------
+
+// Intensity accumulation buffer (access via API functions only).
+typedef struct VrasterBuffer {
+    // Buffer pixel width.
+    int width;
+    // Buffer pixel height.
+    int height;
+    // Channel values per row (width * VRASTER_CHANNELS, padded for SIMD).
+    int pitch;
+    // Channel values, 8.8 fixed point, saturating at 0xFFFF.
+    uint16_t * pixels;
+    // Per frame decay multiplier, 0.16 fixed point (0 = clear each frame).
+    uint16_t decay;
+    // Has the decay for the next frame already been applied by resolving?
+    bool decayed;
+    // Are lines drawn antialiased?
+    bool antialias;
+} VrasterBuffer;
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a cleared buffer of width by height pixels.
+bool vraster_init(VrasterBuffer * raster, const int width, const int height);
+
+// Clean-up the buffer.
+void vraster_done(VrasterBuffer * raster);
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer State Functions.
+//-----------------------------------------------------------------------------
+
+// Set the per frame decay (0.0 = clear each frame, 1.0 = never fade).
+void vraster_set_decay(VrasterBuffer * raster, const VmathNumber decay);
+
+// Set whether vraster_line() and vraster_line_gradient() draw antialiased lines.
+void vraster_set_antialias(VrasterBuffer * raster, const bool antialias);
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Frame Functions.
+//-----------------------------------------------------------------------------
+
+// Clear the whole buffer to zero intensity.
+void vraster_clear(VrasterBuffer * raster);
+
+// Fade the whole buffer by the decay multiplier (clears if decay is 0),
+// unless vraster_resolve_decay has already faded it since the last frame.
+void vraster_decay(VrasterBuffer * raster);
+
+// Resolve the buffer to opaque ARGB8888 pixels (pitch in bytes).
+void vraster_resolve(const VrasterBuffer * raster, void * argb8888, const int pitch);
+
+// Resolve the buffer and fade it for the next frame in a single pass.
+void vraster_resolve_decay(VrasterBuffer * raster, void * argb8888, const int pitch);
+
+// Add the source buffer, the same size as the buffer, onto it, saturating.
+void vraster_add_buffer(VrasterBuffer * raster, const VrasterBuffer * source);
+
+
+
+//-----------------------------------------------------------------------------
+// CPU Raster Buffer Drawing Functions.
+// Colours are added to the buffer, saturating at full intensity.
+//-----------------------------------------------------------------------------
+
+// Add a point.
+void vraster_point(VrasterBuffer * raster,
+                   const VmathNumber x, const VmathNumber y,
+                   const uint8_t red, const uint8_t green, const uint8_t blue);
+
+// Add a filled rectangle.
+void vraster_rect(VrasterBuffer * raster,
+                  const VmathNumber x, const VmathNumber y,
+                  const VmathNumber w, const VmathNumber h,
+                  const uint8_t red, const uint8_t green, const uint8_t blue);
+
+// Add a line clipped to the buffer.
+void vraster_line(VrasterBuffer * raster,
+                  const VmathNumber x1, const VmathNumber y1,
+                  const VmathNumber x2, const VmathNumber y2,
+                  const uint8_t red, const uint8_t green, const uint8_t blue);
+
+// Add a line clipped to the buffer, blending from the first to the second colour.
+void vraster_line_gradient(VrasterBuffer * raster,
+                           const VmathNumber x1, const VmathNumber y1,
+                           const VmathNumber x2, const VmathNumber y2,
+                           const uint8_t red1, const uint8_t green1, const uint8_t blue1,
+                           const uint8_t red2, const uint8_t green2, const uint8_t blue2);
+
+// Add an antialiased line (Xiaolin Wu's algorithm) clipped to the buffer. Each
+// pixel column (or row, for steep lines) adds the colour to the two pixels
+// straddling the line, weighted by their distance from it and, at the ends,
+// by how much of the column the line covers; lines joined end to end add up
+// to full intensity at the join.
+void vraster_line_antialiased(VrasterBuffer * raster,
+                              const VmathNumber x1, const VmathNumber y1,
+                              const VmathNumber x2, const VmathNumber y2,
+                              const uint8_t red, const uint8_t green, const uint8_t blue);
+
+// Add an antialiased line clipped to the buffer, blending from the first to the second colour.
+void vraster_line_gradient_antialiased(VrasterBuffer * raster,
+                                       const VmathNumber x1, const VmathNumber y1,
+                                       const VmathNumber x2, const VmathNumber y2,
+                                       const uint8_t red1, const uint8_t green1, const uint8_t blue1,
+                                       const uint8_t red2, const uint8_t green2, const uint8_t blue2);
+
+// Add a triangle clipped to the buffer, blending the vertex colours (red, green, blue)
+// across it. Pixels centred on an edge shared by two triangles are added only once.
+void vraster_triangle(VrasterBuffer * raster,
+                      const VmathNumber x[3], const VmathNumber y[3],
+                      const uint8_t rgb[3][3]);
+
+// Add a line pen_width wide, as a quad of two triangles, clipped to the buffer.
+void vraster_line_wide(VrasterBuffer * raster,
+                       const VmathNumber x1, const VmathNumber y1,
+                       const VmathNumber x2, const VmathNumber y2,
+                       const VmathNumber pen_width,
+                       const uint8_t red, const uint8_t green, const uint8_t blue);
+
+
+
+#endif /* __VRASTER__H__ */
@@ -0,0 +1,260 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) vScope Unit Tests.
+// Filename:     vscope-tests.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 11:48
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+// API under test.
+#include "vscope.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+// CTest configuration.
+#define CTEST_MAIN
+#define CTEST_SEGFAULT
+
+// CTest Extra include (implementation) file.
+#include "ctestx.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Test Fixture Lifecycle.
+//-----------------------------------------------------------------------------
+
+CTEST_DATA(vscope)
+{
+    VscopeRing * ring;
+};
+
+
+CTEST_SETUP(vscope)
+{
+    data->ring = malloc(sizeof(VscopeRing));
+    ASSERT_NOT_NULL(data->ring);
+    vscope_ring_init(data->ring);
+}
+
+
+CTEST_TEARDOWN(vscope)
+{
+    free(data->ring);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Number of samples passed through the ring by the threaded test.
+#define TEST_VSCOPE_THREAD_SAMPLES 200000
+
+
+// Write an increasing sequence of samples to the ring, retrying when full.
+static int test_vscope_producer(void * data)
+{
+    VscopeRing * ring = data;
+    VscopeSample samples[37];
+    int next = 0;
+    while (next < TEST_VSCOPE_THREAD_SAMPLES) {
+        const int count = SDL_min(37, TEST_VSCOPE_THREAD_SAMPLES - next);
+        for (int i = 0;  i < count;  i++) {
+            samples[i].x = (float)(next + i);
+            samples[i].y = -(float)(next + i);
+        }
+        int written = 0;
+        while (written < count) {
+            written += vscope_ring_write(ring, samples + written, count - written);
+        }
+        next += count;
+    }
+    return 0;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Ring Buffer Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vscope, test_vscope_ring_write_read) {
+    const VscopeSample in[3] = { { 0.1f, 0.2f }, { 0.3f, 0.4f }, { 0.5f, 0.6f } };
+    VscopeSample out[4];
+    ASSERT_EQUAL(0, vscope_ring_count(data->ring));
+    ASSERT_EQUAL(0, vscope_ring_read(data->ring, out, 4));
+    ASSERT_EQUAL(3, vscope_ring_write(data->ring, in, 3));
+    ASSERT_EQUAL(3, vscope_ring_count(data->ring));
+    ASSERT_EQUAL(2, vscope_ring_read(data->ring, out, 2));
+    ASSERT_DBL_EQUAL(0.1f, out[0].x);
+    ASSERT_DBL_EQUAL(0.4f, out[1].y);
+    ASSERT_EQUAL(1, vscope_ring_read(data->ring, out, 4));
+    ASSERT_DBL_EQUAL(0.5f, out[0].x);
+    ASSERT_EQUAL(0, vscope_ring_count(data->ring));
+}
+
+
+CTEST2(vscope, test_vscope_ring_full_and_wrap) {
+    VscopeSample * samples = calloc(VSCOPE_RING_SIZE + 10, sizeof(VscopeSample));
+    ASSERT_NOT_NULL(samples);
+    for (int i = 0;  i < VSCOPE_RING_SIZE + 10;  i++) {
+        samples[i].x = (float)i;
+    }
+    // Writes never block; the excess is refused.
+    ASSERT_EQUAL(VSCOPE_RING_SIZE - 5, vscope_ring_write(data->ring, samples, VSCOPE_RING_SIZE - 5));
+    ASSERT_EQUAL(5, vscope_ring_write(data->ring, samples, 10));
+    ASSERT_EQUAL(0, vscope_ring_write(data->ring, samples, 10));
+    // Free some space and write across the end of the buffer.
+    VscopeSample out[20];
+    ASSERT_EQUAL(20, vscope_ring_read(data->ring, out, 20));
+    ASSERT_DBL_EQUAL(19.0f, out[19].x);
+    ASSERT_EQUAL(20, vscope_ring_write(data->ring, samples + 100, 20));
+    ASSERT_EQUAL(VSCOPE_RING_SIZE, vscope_ring_count(data->ring));
+    free(samples);
+}
+
+
+CTEST2(vscope, test_vscope_ring_threaded) {
+    SDL_Thread * thread = SDL_CreateThread(test_vscope_producer, "test_vscope_producer", data->ring);
+    ASSERT_NOT_NULL(thread);
+    VscopeSample samples[64];
+    int expected = 0;
+    bool in_order = true;
+    while (expected < TEST_VSCOPE_THREAD_SAMPLES) {
+        const int read = vscope_ring_read(data->ring, samples, 64);
+        for (int i = 0;  i < read;  i++) {
+            in_order = in_order && (samples[i].x == (float)expected) && (samples[i].y == -(float)expected);
+            expected++;
+        }
+    }
+    SDL_WaitThread(thread, NULL);
+    ASSERT_TRUE(in_order);
+    ASSERT_EQUAL(0, vscope_ring_count(data->ring));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Backend Functions.
+//-----------------------------------------------------------------------------
+
+CTEST(vscope, test_vscope_wav) {
+    const char * filename = "vscope-tests.wav";
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    ASSERT_TRUE(vscope_init(&backend, 640, 480, 48000, 60, filename));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, NULL, &backend));
+    const VscopeStats * stats = vscope_get_stats(&vdraw.backend);
+    // A horizontal line across the middle, left to right, for two frames.
+    for (int frame = 0;  frame < 2;  frame++) {
+        vdraw_clear_screen(&vdraw);
+        vdraw_line(&vdraw, 0, 240, 640, 240);
+        vdraw_flip_screen(&vdraw);
+    }
+    ASSERT_EQUAL(2, stats->frames);
+    ASSERT_EQUAL(1600, stats->samples);
+    ASSERT_EQUAL(0, stats->dropped_samples);
+    ASSERT_EQUAL(0, stats->decimated_lines);
+    vdraw_done(&vdraw);
+    FILE * file = fopen(filename, "rb");
+    ASSERT_NOT_NULL(file);
+    uint8_t header[44];
+    uint8_t first[4];
+    const size_t header_read = fread(header, 1, 44, file);
+    const size_t first_read = fread(first, 1, 4, file);
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fclose(file);
+    remove(filename);
+    ASSERT_EQUAL(44, header_read);
+    ASSERT_EQUAL(4, first_read);
+    ASSERT_EQUAL(44 + (1600 * 4), size);
+    ASSERT_DATA((const unsigned char *)"RIFF", 4, header, 4);
+    ASSERT_DATA((const unsigned char *)"WAVEfmt ", 8, header + 8, 8);
+    ASSERT_DATA((const unsigned char *)"data", 4, header + 36, 4);
+    ASSERT_EQUAL(1600 * 4, header[40] | (header[41] << 8) | (header[42] << 16) | (header[43] << 24));
+    // The first sample is the left middle: X -1.0, Y 0.0.
+    ASSERT_EQUAL(-32767, (int16_t)(first[0] | (first[1] << 8)));
+    ASSERT_EQUAL(0, (int16_t)(first[2] | (first[3] << 8)));
+}
+
+
+CTEST(vscope, test_vscope_decimate) {
+    const char * filename = "vscope-tests-decimate.wav";
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    // 10 samples per frame.
+    ASSERT_TRUE(vscope_init(&backend, 640, 480, 600, 60, filename));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, NULL, &backend));
+    vdraw_clear_screen(&vdraw);
+    for (int i = 0;  i < 25;  i++) {
+        vdraw_line(&vdraw, i, 0, i, 100);
+    }
+    vdraw_flip_screen(&vdraw);
+    // Every third line is kept.
+    const VscopeStats * stats = vscope_get_stats(&vdraw.backend);
+    ASSERT_EQUAL(16, stats->decimated_lines);
+    ASSERT_EQUAL(10, stats->samples);
+    ASSERT_EQUAL(0, stats->dropped_samples);
+    vdraw_done(&vdraw);
+    remove(filename);
+}
+
+
+
+CTEST(vscope, test_vscope_line_batch) {
+    const char * filename = "vscope-tests-batch.wav";
+    VdrawContext vdraw;
+    VdrawBackend backend;
+    VdrawLineBatch batch;
+    ASSERT_TRUE(vscope_init(&backend, 640, 480, 48000, 60, filename));
+    ASSERT_TRUE(vdraw_init_backend(&vdraw, NULL, &backend));
+    ASSERT_NULL(vdraw.backend.geometry);
+    ASSERT_TRUE(vdraw_line_batch_init(&batch, 8));
+    // A square as a line batch is traced like lines drawn one by one.
+    vdraw_clear_screen(&vdraw);
+    ASSERT_TRUE(vdraw_line_batch_add(&batch, 100, 100, 200, 100));
+    ASSERT_TRUE(vdraw_line_batch_add(&batch, 200, 100, 200, 200));
+    ASSERT_TRUE(vdraw_line_batch_add(&batch, 200, 200, 100, 200));
+    ASSERT_TRUE(vdraw_line_batch_add(&batch, 100, 200, 100, 100));
+    vdraw_line_batch_intensity(&vdraw, &batch);
+    vdraw_line_batch(&vdraw, &batch);
+    vdraw_flip_screen(&vdraw);
+    const VscopeStats * stats = vscope_get_stats(&vdraw.backend);
+    ASSERT_EQUAL(1, stats->frames);
+    ASSERT_EQUAL(800, stats->samples);
+    ASSERT_EQUAL(0, stats->decimated_lines);
+    vdraw_line_batch_done(&batch);
+    vdraw_done(&vdraw);
+    remove(filename);
+}
+
+
+//-----------------------------------------------------------------------------
+// Main Application Entry Point.
+//-----------------------------------------------------------------------------
+
+// Function main() implementation.
+CTESTX_MAIN
@@ -0,0 +1,407 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Oscilloscope XY Audio Output.
+// Filename:     vscope.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 17:30
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vscope.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Oscilloscope XY Ring Buffer Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise an empty ring buffer.
+void vscope_ring_init(VscopeRing * ring)
+{
+    assert (ring != NULL);
+    SDL_AtomicSet(&ring->head, 0);
+    SDL_AtomicSet(&ring->tail, 0);
+}
+
+
+// Write up to count samples without blocking (producer). Returns the number written.
+int vscope_ring_write(VscopeRing * ring, const VscopeSample * samples, const int count)
+{
+    assert (ring != NULL);
+    assert ((samples != NULL) || (count == 0));
+    const unsigned int head = (unsigned int)SDL_AtomicGet(&ring->head);
+    const unsigned int tail = (unsigned int)SDL_AtomicGet(&ring->tail);
+    // The consumer has finished with the samples before tail.
+    SDL_MemoryBarrierAcquire();
+    const int space = VSCOPE_RING_SIZE - (int)(head - tail);
+    const int written = SDL_min(count, space);
+    for (int i = 0;  i < written;  i++) {
+        ring->samples[(head + (unsigned int)i) & (VSCOPE_RING_SIZE - 1)] = samples[i];
+    }
+    // Publish the samples before the new head.
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&ring->head, (int)(head + (unsigned int)written));
+    return written;
+}
+
+
+// Read up to count samples without blocking (consumer). Returns the number read.
+int vscope_ring_read(VscopeRing * ring, VscopeSample * samples, const int count)
+{
+    assert (ring != NULL);
+    assert ((samples != NULL) || (count == 0));
+    const unsigned int tail = (unsigned int)SDL_AtomicGet(&ring->tail);
+    const unsigned int head = (unsigned int)SDL_AtomicGet(&ring->head);
+    // The producer's samples before head are visible.
+    SDL_MemoryBarrierAcquire();
+    const int read = SDL_min(count, (int)(head - tail));
+    for (int i = 0;  i < read;  i++) {
+        samples[i] = ring->samples[(tail + (unsigned int)i) & (VSCOPE_RING_SIZE - 1)];
+    }
+    // Finish with the samples before releasing them to the producer.
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&ring->tail, (int)(tail + (unsigned int)read));
+    return read;
+}
+
+
+// Get the number of samples waiting to be read.
+int vscope_ring_count(VscopeRing * ring)
+{
+    assert (ring != NULL);
+    return (int)((unsigned int)SDL_AtomicGet(&ring->head) - (unsigned int)SDL_AtomicGet(&ring->tail));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Oscilloscope XY Backend Functions.
+//-----------------------------------------------------------------------------
+
+// Line segment in pixels.
+typedef struct VscopeLine {
+    float x1;
+    float y1;
+    float x2;
+    float y2;
+} VscopeLine;
+
+
+// Oscilloscope backend state.
+typedef struct Vscope {
+    VscopeRing ring;
+    VscopeStats stats;
+    int width;
+    int height;
+    int sample_rate;
+    // Samples per frame.
+    int frame_samples;
+    // The frame's line segments.
+    int line_count;
+    VscopeLine * lines;
+    // The frame's samples.
+    VscopeSample * samples;
+    // Audio device (0 = writing a WAV file), and the last sample it played.
+    SDL_AudioDeviceID device;
+    VscopeSample last;
+    // WAV file (NULL = playing on the audio device) and sample frames written.
+    FILE * wav;
+    uint32_t wav_samples;
+} Vscope;
+
+
+// Write a little endian value to a WAV file.
+static void vscope_wav_write(FILE * wav, const uint32_t value, const int bytes)
+{
+    for (int i = 0;  i < bytes;  i++) {
+        fputc((int)((value >> (i * 8)) & 0xFFu), wav);
+    }
+}
+
+
+// Write the WAV file header for the samples written so far.
+static void vscope_wav_header(Vscope * scope)
+{
+    const uint32_t data_bytes = scope->wav_samples * 4u;
+    fseek(scope->wav, 0, SEEK_SET);
+    fputs("RIFF", scope->wav);
+    vscope_wav_write(scope->wav, 36u + data_bytes, 4);
+    fputs("WAVEfmt ", scope->wav);
+    // PCM, 2 channels, 16 bits.
+    vscope_wav_write(scope->wav, 16u, 4);
+    vscope_wav_write(scope->wav, 1u, 2);
+    vscope_wav_write(scope->wav, 2u, 2);
+    vscope_wav_write(scope->wav, (uint32_t)scope->sample_rate, 4);
+    vscope_wav_write(scope->wav, (uint32_t)scope->sample_rate * 4u, 4);
+    vscope_wav_write(scope->wav, 4u, 2);
+    vscope_wav_write(scope->wav, 16u, 2);
+    fputs("data", scope->wav);
+    vscope_wav_write(scope->wav, data_bytes, 4);
+    fseek(scope->wav, 0, SEEK_END);
+}
+
+
+// Drain the ring buffer into the WAV file.
+static void vscope_wav_drain(Vscope * scope)
+{
+    VscopeSample samples[256];
+    int read;
+    while ((read = vscope_ring_read(&scope->ring, samples, 256)) > 0) {
+        for (int i = 0;  i < read;  i++) {
+            vscope_wav_write(scope->wav, (uint32_t)(uint16_t)(int16_t)lrintf(samples[i].x * 32767.0f), 2);
+            vscope_wav_write(scope->wav, (uint32_t)(uint16_t)(int16_t)lrintf(samples[i].y * 32767.0f), 2);
+        }
+        scope->wav_samples += (uint32_t)read;
+    }
+}
+
+
+// Play the ring buffer's samples on the audio thread, holding the beam still if it runs dry.
+static void vscope_audio_callback(void * userdata, Uint8 * stream, int len)
+{
+    Vscope * scope = userdata;
+    VscopeSample * samples = (VscopeSample *)stream;
+    const int count = len / (int)sizeof(VscopeSample);
+    const int read = vscope_ring_read(&scope->ring, samples, count);
+    if (read > 0) {
+        scope->last = samples[read - 1];
+    }
+    for (int i = read;  i < count;  i++) {
+        samples[i] = scope->last;
+    }
+}
+
+
+// Convert a pixel position to a sample (-1.0 to 1.0, Y up).
+static inline VscopeSample vscope_sample(const Vscope * scope, const float x, const float y)
+{
+    const VscopeSample sample = {
+            .x = SDL_clamp(((2.0f * x) / (float)scope->width) - 1.0f, -1.0f, 1.0f),
+            .y = SDL_clamp(1.0f - ((2.0f * y) / (float)scope->height), -1.0f, 1.0f)
+    };
+    return sample;
+}
+
+
+// Add a line segment to the frame, dropping it if the frame is full.
+static inline void vscope_add_line(Vscope * scope, const float x1, const float y1, const float x2, const float y2)
+{
+    if (scope->line_count >= VSCOPE_MAX_LINES) {
+        scope->stats.dropped_lines++;
+        return;
+    }
+    VscopeLine * line = &scope->lines[scope->line_count++];
+    line->x1 = x1;
+    line->y1 = y1;
+    line->x2 = x2;
+    line->y2 = y2;
+}
+
+
+// Start a frame.
+static void vscope_begin(void * data)
+{
+    ((Vscope *)data)->line_count = 0;
+}
+
+
+// Clear the frame (nothing to do; the beam only traces lines).
+static bool vscope_clear(void * data, const VdrawRGB * colour)
+{
+    (void)data;
+    (void)colour;
+    return true;
+}
+
+
+// Add lines through the points to the frame.
+static void vscope_lines(void * data, const SDL_FPoint * points, const int count,
+                         const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    (void)colour;
+    (void)pen_width;
+    Vscope * scope = data;
+    for (int i = 1;  i < count;  i++) {
+        vscope_add_line(scope, points[i - 1].x, points[i - 1].y, points[i].x, points[i].y);
+    }
+}
+
+
+// Add the points to the frame as zero length lines.
+static void vscope_points(void * data, const SDL_FPoint * points, const int count,
+                          const VdrawRGB * colour, const VmathNumber pen_width)
+{
+    (void)colour;
+    (void)pen_width;
+    Vscope * scope = data;
+    for (int i = 0;  i < count;  i++) {
+        vscope_add_line(scope, points[i].x, points[i].y, points[i].x, points[i].y);
+    }
+}
+
+
+// Trace the frame's lines into samples, sharing the frame's sample budget by line
+// length. Lines beyond the budget are skipped evenly rather than delaying the frame.
+static void vscope_present(void * data)
+{
+    Vscope * scope = data;
+    const int line_count = scope->line_count;
+    scope->line_count = 0;
+    scope->stats.frames++;
+    if (line_count == 0) {
+        return;
+    }
+    // Keep every stride'th line so at least one sample each fits the budget.
+    const int stride = (line_count + scope->frame_samples - 1) / scope->frame_samples;
+    const int kept = (line_count + stride - 1) / stride;
+    scope->stats.decimated_lines += (uint64_t)(line_count - kept);
+    float total_length = 0.0f;
+    for (int i = 0;  i < line_count;  i += stride) {
+        const VscopeLine * line = &scope->lines[i];
+        total_length += hypotf(line->x2 - line->x1, line->y2 - line->y1);
+    }
+    // Each kept line gets one sample plus its share of the spare samples by length,
+    // rounding on the running total so the whole budget is used.
+    const float spare = (float)(scope->frame_samples - kept);
+    float length_so_far = 0.0f;
+    int count = 0;
+    for (int i = 0, k = 1;  i < line_count;  i += stride, k++) {
+        const VscopeLine * line = &scope->lines[i];
+        length_so_far += hypotf(line->x2 - line->x1, line->y2 - line->y1);
+        const int target = (k == kept) ? scope->frame_samples
+                : k + ((total_length > 0.0f) ? (int)((spare * length_so_far) / total_length) : 0);
+        const int samples = target - count;
+        for (int j = 0;  j < samples;  j++) {
+            const float t = (samples > 1) ? ((float)j / (float)(samples - 1)) : 0.0f;
+            scope->samples[count++] = vscope_sample(scope,
+                                                    line->x1 + ((line->x2 - line->x1) * t),
+                                                    line->y1 + ((line->y2 - line->y1) * t));
+        }
+    }
+    // Never wait for the consumer; drop what does not fit.
+    const int written = vscope_ring_write(&scope->ring, scope->samples, count);
+    scope->stats.samples += (uint64_t)count;
+    scope->stats.dropped_samples += (uint64_t)(count - written);
+    if (scope->wav != NULL) {
+        vscope_wav_drain(scope);
+    }
+}
+
+
+// Clean-up the backend state.
+static void vscope_done(void * data)
+{
+    Vscope * scope = data;
+    if (scope->device != 0) {
+        SDL_CloseAudioDevice(scope->device);
+    }
+    if (scope->wav != NULL) {
+        vscope_wav_header(scope);
+        fclose(scope->wav);
+    }
+    free(scope->lines);
+    free(scope->samples);
+    free(scope);
+}
+
+
+// Initialise the backend for a width by height pixel output to the default audio
+// device, or to the WAV file (16 bit stereo PCM) if wav_filename is not NULL.
+bool vscope_init(VdrawBackend * backend,
+                 const int width, const int height,
+                 const int sample_rate, const int frame_rate,
+                 const char * wav_filename)
+{
+    assert (backend != NULL);
+    assert ((width > 0) && (height > 0));
+    assert ((sample_rate > 0) && (frame_rate > 0));
+    memset(backend, 0, sizeof(VdrawBackend));
+    Vscope * scope = calloc(1, sizeof(Vscope));
+    if (scope == NULL) {
+        SDL_Log("vscope_init: calloc failed");
+        return false;
+    }
+    vscope_ring_init(&scope->ring);
+    scope->width = width;
+    scope->height = height;
+    scope->sample_rate = sample_rate;
+    scope->frame_samples = SDL_clamp(sample_rate / frame_rate, 1, VSCOPE_RING_SIZE);
+    scope->lines = malloc(VSCOPE_MAX_LINES * sizeof(VscopeLine));
+    scope->samples = malloc((size_t)scope->frame_samples * sizeof(VscopeSample));
+    if ((scope->lines == NULL) || (scope->samples == NULL)) {
+        SDL_Log("vscope_init: malloc failed");
+        vscope_done(scope);
+        return false;
+    }
+    if (wav_filename != NULL) {
+        scope->wav = fopen(wav_filename, "wb");
+        if (scope->wav == NULL) {
+            SDL_Log("vscope_init: fopen failed: %s", wav_filename);
+            vscope_done(scope);
+            return false;
+        }
+        vscope_wav_header(scope);
+    } else {
+        SDL_AudioSpec want;
+        SDL_AudioSpec have;
+        SDL_zero(want);
+        want.freq = sample_rate;
+        want.format = AUDIO_F32SYS;
+        want.channels = 2;
+        want.samples = VSCOPE_DEVICE_SAMPLES;
+        want.callback = vscope_audio_callback;
+        want.userdata = scope;
+        scope->device = SDL_OpenAudioDevice(NULL, 0, &want, &have, 0);
+        if (scope->device == 0) {
+            SDL_Log("vscope_init: SDL_OpenAudioDevice failed: %s", SDL_GetError());
+            vscope_done(scope);
+            return false;
+        }
+        SDL_PauseAudioDevice(scope->device, 0);
+    }
+    backend->name = "scope";
+    backend->data = scope;
+    backend->width = width;
+    backend->height = height;
+    backend->begin = vscope_begin;
+    backend->clear = vscope_clear;
+    backend->lines = vscope_lines;
+    backend->points = vscope_points;
+    // Filled shapes can not be traced by the beam; vdraw sends lines instead.
+    backend->geometry = NULL;
+    backend->present = vscope_present;
+    backend->done = vscope_done;
+    return true;
+}
+
+
+// Get the oscilloscope backend's statistics.
+const VscopeStats * vscope_get_stats(const VdrawBackend * backend)
+{
+    assert (backend != NULL);
+    assert (backend->done == vscope_done);
+    return &((const Vscope *)backend->data)->stats;
+}
@@ -0,0 +1,145 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Oscilloscope XY Audio Output.
+// Filename:     vscope.h
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 17:30
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+#ifndef __VSCOPE__H__
+#define __VSCOPE__H__
+
+
+#include <SDL.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vmath.h"
+#include "vdraw.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Oscilloscope XY Audio Output Configuration.
+//-----------------------------------------------------------------------------
+
+// Default audio sample rate (sample frames per second).
+#ifndef VSCOPE_SAMPLE_RATE
+#define VSCOPE_SAMPLE_RATE 48000
+#endif
+
+// Default frames per second the samples are spread over.
+#ifndef VSCOPE_FRAME_RATE
+#define VSCOPE_FRAME_RATE 60
+#endif
+
+// Ring buffer size in sample frames (a power of two).
+#ifndef VSCOPE_RING_SIZE
+#define VSCOPE_RING_SIZE 8192
+#endif
+
+// Maximum line segments kept per frame (the rest are dropped and counted).
+#ifndef VSCOPE_MAX_LINES
+#define VSCOPE_MAX_LINES 8192
+#endif
+
+// Audio device buffer size in sample frames.
+#ifndef VSCOPE_DEVICE_SAMPLES
+#define VSCOPE_DEVICE_SAMPLES 512
+#endif
+
+
+
+//-----------------------------------------------------------------------------
+// Oscilloscope XY Audio Output Types.
+//-----------------------------------------------------------------------------
+
+// Stereo sample frame: left channel X, right channel Y (-1.0 to 1.0, Y up).
+typedef struct VscopeSample {
+    float x;
+    float y;
+} VscopeSample;
+
+
+// Lock-free single producer, single consumer ring buffer of samples.
+// The producer only writes head and the consumer only writes tail; both
+// count up forever and are masked to index the samples.
+typedef struct VscopeRing {
+    SDL_atomic_t head;
+    SDL_atomic_t tail;
+    VscopeSample samples[VSCOPE_RING_SIZE];
+} VscopeRing;
+
+
+// Oscilloscope output statistics since initialised.
+typedef struct VscopeStats {
+    // Frames presented.
+    uint64_t frames;
+    // Samples generated and samples dropped because the ring buffer was full.
+    uint64_t samples;
+    uint64_t dropped_samples;
+    // Lines skipped to fit the frame's sample budget, or dropped past VSCOPE_MAX_LINES.
+    uint64_t decimated_lines;
+    uint64_t dropped_lines;
+} VscopeStats;
+
+
+
+//-----------------------------------------------------------------------------
+// Oscilloscope XY Ring Buffer Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise an empty ring buffer.
+void vscope_ring_init(VscopeRing * ring);
+
+// Write up to count samples without blocking (producer). Returns the number written.
+int vscope_ring_write(VscopeRing * ring, const VscopeSample * samples, const int count);
+
+// Read up to count samples without blocking (consumer). Returns the number read.
+int vscope_ring_read(VscopeRing * ring, VscopeSample * samples, const int count);
+
+// Get the number of samples waiting to be read.
+int vscope_ring_count(VscopeRing * ring);
+
+
+
+//-----------------------------------------------------------------------------
+// Oscilloscope XY Backend Functions.
+// Each frame's lines are traced by the beam as stereo X/Y audio, the frame's
+// sample budget (sample_rate / frame_rate) shared between the lines by length.
+// Live output plays through an SDL audio device fed from the ring buffer; WAV
+// output writes the samples to a file instead, for testing offline.
+//-----------------------------------------------------------------------------
+
+// Initialise the backend for a width by height pixel output to the default audio
+// device, or to the WAV file (16 bit stereo PCM) if wav_filename is not NULL.
+bool vscope_init(VdrawBackend * backend,
+                 const int width, const int height,
+                 const int sample_rate, const int frame_rate,
+                 const char * wav_filename);
+
+// Get the oscilloscope backend's statistics.
+const VscopeStats * vscope_get_stats(const VdrawBackend * backend);
+
+
+
+#endif /* __VSCOPE__H__ */
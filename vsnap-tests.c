@@ -0,0 +1,200 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) vSnap Unit Tests.
+// Filename:     vsnap-tests.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 18:20
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include <stdlib.h>
+
+// API under test.
+#include "vsnap.h"
+
+
+// CTest configuration.
+#define CTEST_MAIN
+#define CTEST_SEGFAULT
+
+// CTest Extra include (implementation) file.
+#include "ctestx.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Test Fixture Lifecycle.
+//-----------------------------------------------------------------------------
+
+// Triple buffer shared by a producer and a consumer.
+CTEST_DATA(vsnap)
+{
+    VsnapTriple triple;
+};
+
+
+CTEST_SETUP(vsnap)
+{
+    vsnap_init(&data->triple);
+}
+
+
+CTEST_TEARDOWN(vsnap)
+{
+    vsnap_done(&data->triple);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Frames published by the producer thread.
+#define TEST_VSNAP_FRAMES 20000
+
+
+// Build a frame of (sequence % 7 + 1) lines and one point, every value the sequence.
+static void test_vsnap_build(VsnapTriple * triple, const uint64_t sequence)
+{
+    VsnapFrame * frame = vsnap_begin(triple);
+    const VmathNumber value = (VmathNumber)sequence;
+    for (int i = 0;  i < (int)(sequence % 7) + 1;  i++) {
+        vsnap_add_line(frame, value, value, value, value);
+    }
+    VmathNumber * point = vsnap_add_points(frame, 1);
+    point[0] = value;
+    point[1] = value;
+}
+
+
+// Does the frame hold exactly what test_vsnap_build() built for its sequence?
+static bool test_vsnap_is_whole(const VsnapFrame * frame)
+{
+    const VmathNumber value = (VmathNumber)frame->sequence;
+    if ((frame->line_count != (int)(frame->sequence % 7) + 1) || (frame->point_count != 1)) {
+        return false;
+    }
+    for (int i = 0;  i < frame->line_count * 4;  i++) {
+        if (frame->lines[i] != value) {
+            return false;
+        }
+    }
+    return (frame->points[0] == value) && (frame->points[1] == value);
+}
+
+
+// Producer thread: build and publish TEST_VSNAP_FRAMES frames.
+static int test_vsnap_produce(void * data)
+{
+    VsnapTriple * triple = data;
+    for (uint64_t sequence = 1;  sequence <= TEST_VSNAP_FRAMES;  sequence++) {
+        test_vsnap_build(triple, sequence);
+        vsnap_publish(triple);
+    }
+    return 0;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Producer and Consumer Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vsnap, test_vsnap_acquire_empty) {
+    bool fresh = true;
+    const VsnapFrame * frame = vsnap_acquire(&data->triple, &fresh);
+    ASSERT_FALSE(fresh);
+    ASSERT_EQUAL(0, frame->line_count);
+    ASSERT_EQUAL(0, frame->point_count);
+    ASSERT_EQUAL(0, frame->sequence);
+}
+
+
+CTEST2(vsnap, test_vsnap_publish) {
+    VsnapTriple * triple = &data->triple;
+    bool fresh;
+    test_vsnap_build(triple, 1);
+    vsnap_publish(triple);
+    const VsnapFrame * frame = vsnap_acquire(triple, &fresh);
+    ASSERT_TRUE(fresh);
+    ASSERT_EQUAL(1, frame->sequence);
+    ASSERT_TRUE(test_vsnap_is_whole(frame));
+    // Nothing new: the same frame again.
+    ASSERT_TRUE(frame == vsnap_acquire(triple, &fresh));
+    ASSERT_FALSE(fresh);
+    // The producer never builds into the frame the consumer holds.
+    for (int i = 0;  i < 5;  i++) {
+        ASSERT_TRUE(vsnap_begin(triple) != frame);
+        vsnap_publish(triple);
+    }
+    ASSERT_TRUE(test_vsnap_is_whole(frame));
+}
+
+
+CTEST2(vsnap, test_vsnap_newest_wins) {
+    VsnapTriple * triple = &data->triple;
+    bool fresh;
+    // Frames published faster than they are acquired are skipped.
+    for (uint64_t sequence = 1;  sequence <= 3;  sequence++) {
+        test_vsnap_build(triple, sequence);
+        vsnap_publish(triple);
+    }
+    const VsnapFrame * frame = vsnap_acquire(triple, &fresh);
+    ASSERT_TRUE(fresh);
+    ASSERT_EQUAL(3, frame->sequence);
+    ASSERT_TRUE(test_vsnap_is_whole(frame));
+    test_vsnap_build(triple, 4);
+    vsnap_publish(triple);
+    frame = vsnap_acquire(triple, &fresh);
+    ASSERT_TRUE(fresh);
+    ASSERT_EQUAL(4, frame->sequence);
+    ASSERT_TRUE(test_vsnap_is_whole(frame));
+}
+
+
+CTEST2(vsnap, test_vsnap_threads) {
+    VsnapTriple * triple = &data->triple;
+    SDL_Thread * producer = SDL_CreateThread(test_vsnap_produce, "test_vsnap_produce", triple);
+    ASSERT_NOT_NULL(producer);
+    // Every frame acquired is whole and newer than the last.
+    uint64_t last = 0;
+    int acquired = 0;
+    while (last < TEST_VSNAP_FRAMES) {
+        bool fresh;
+        const VsnapFrame * frame = vsnap_acquire(triple, &fresh);
+        if (fresh) {
+            ASSERT_TRUE(frame->sequence > last);
+            ASSERT_TRUE(test_vsnap_is_whole(frame));
+            last = frame->sequence;
+            acquired++;
+        }
+    }
+    SDL_WaitThread(producer, NULL);
+    ASSERT_TRUE(acquired > 0);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Main Application Entry Point.
+//-----------------------------------------------------------------------------
+
+// Function main() implementation.
+CTESTX_MAIN
@@ -0,0 +1,197 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Frame Snapshots.
+// Filename:     vsnap.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 18:20
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsnap.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Frame Snapshot Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Make room for count more elements of size in a growable array (doubling).
+static bool vsnap_reserve(VmathNumber ** array, int * capacity, const int needed, const size_t size)
+{
+    if (needed <= *capacity) {
+        return true;
+    }
+    int grown = (*capacity > 0) ? *capacity : 256;
+    while (grown < needed) {
+        grown *= 2;
+    }
+    VmathNumber * resized = realloc(*array, (size_t)grown * size);
+    if (resized == NULL) {
+        SDL_Log("vsnap_reserve: out of memory for %d entries", grown);
+        return false;
+    }
+    *array = resized;
+    *capacity = grown;
+    return true;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Frame Snapshot Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a triple buffer of empty frames.
+void vsnap_init(VsnapTriple * triple)
+{
+    assert (triple != NULL);
+    memset(triple, 0, sizeof(VsnapTriple));
+    triple->back = 0;
+    SDL_AtomicSet(&triple->shared, 1);
+    triple->front = 2;
+}
+
+
+// Clean-up the triple buffer.
+void vsnap_done(VsnapTriple * triple)
+{
+    assert (triple != NULL);
+    for (int i = 0;  i < 3;  i++) {
+        vsnap_frame_done(&triple->frames[i]);
+    }
+    memset(triple, 0, sizeof(VsnapTriple));
+}
+
+
+// Clean-up a frame used on its own.
+void vsnap_frame_done(VsnapFrame * frame)
+{
+    assert (frame != NULL);
+    free(frame->lines);
+    free(frame->points);
+    memset(frame, 0, sizeof(VsnapFrame));
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Frame Snapshot Producer Functions.
+//-----------------------------------------------------------------------------
+
+// Get the back frame, emptied, to build the next frame into.
+VsnapFrame * vsnap_begin(VsnapTriple * triple)
+{
+    assert (triple != NULL);
+    VsnapFrame * frame = &triple->frames[triple->back];
+    vsnap_frame_clear(frame);
+    return frame;
+}
+
+
+// Publish the back frame as the newest frame.
+void vsnap_publish(VsnapTriple * triple)
+{
+    assert (triple != NULL);
+    triple->frames[triple->back].sequence = ++triple->published;
+    // The exchange publishes the frame's contents and hands back the frame the
+    // consumer is not using: the previous shared one.
+    triple->back = SDL_AtomicSet(&triple->shared, triple->back | VSNAP_FRESH) & VSNAP_INDEX;
+}
+
+
+// Empty the frame.
+void vsnap_frame_clear(VsnapFrame * frame)
+{
+    assert (frame != NULL);
+    frame->line_count = 0;
+    frame->point_count = 0;
+}
+
+
+// Add a line to the frame. Returns false if out of memory.
+bool vsnap_add_line(VsnapFrame * frame,
+                    const VmathNumber x1, const VmathNumber y1,
+                    const VmathNumber x2, const VmathNumber y2)
+{
+    assert (frame != NULL);
+    if (!vsnap_reserve(&frame->lines, &frame->line_capacity, frame->line_count + 1, 4 * sizeof(VmathNumber))) {
+        return false;
+    }
+    VmathNumber * line = &frame->lines[frame->line_count++ * 4];
+    line[0] = x1;
+    line[1] = y1;
+    line[2] = x2;
+    line[3] = y2;
+    return true;
+}
+
+
+// Make room for count more lines and return where to write them as
+// (x1, y1, x2, y2) quads, counting them as added. Returns NULL if out of memory.
+VmathNumber * vsnap_add_lines(VsnapFrame * frame, const int count)
+{
+    assert (frame != NULL);
+    assert (count >= 0);
+    if (!vsnap_reserve(&frame->lines, &frame->line_capacity, frame->line_count + count, 4 * sizeof(VmathNumber))) {
+        return NULL;
+    }
+    VmathNumber * lines = &frame->lines[frame->line_count * 4];
+    frame->line_count += count;
+    return lines;
+}
+
+
+// Make room for count more points and return where to write them as
+// (x, y) pairs, counting them as added. Returns NULL if out of memory.
+VmathNumber * vsnap_add_points(VsnapFrame * frame, const int count)
+{
+    assert (frame != NULL);
+    assert (count >= 0);
+    if (!vsnap_reserve(&frame->points, &frame->point_capacity, frame->point_count + count, 2 * sizeof(VmathNumber))) {
+        return NULL;
+    }
+    VmathNumber * points = &frame->points[frame->point_count * 2];
+    frame->point_count += count;
+    return points;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Frame Snapshot Consumer Functions.
+//-----------------------------------------------------------------------------
+
+// Get the newest published frame (an empty frame until the first is published).
+// Sets fresh to whether it was published since the last call.
+const VsnapFrame * vsnap_acquire(VsnapTriple * triple, bool * fresh)
+{
+    assert (triple != NULL);
+    assert (fresh != NULL);
+    *fresh = (SDL_AtomicGet(&triple->shared) & VSNAP_FRESH) != 0;
+    if (*fresh) {
+        // Only the producer sets the fresh bit, so the exchange always takes a fresh frame.
+        triple->front = SDL_AtomicSet(&triple->shared, triple->front) & VSNAP_INDEX;
+    }
+    return &triple->frames[triple->front];
+}
@@ -0,0 +1,139 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Frame Snapshots.
+// Filename:     vsnap.h
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 18:20
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __VSNAP__H__
+#define __VSNAP__H__
+
+
+#include <SDL.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vmath.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Frame Snapshot Constants.
+//-----------------------------------------------------------------------------
+
+// Shared frame index bits, and the bit set while the shared frame is unread.
+#define VSNAP_INDEX 3
+#define VSNAP_FRESH 4
+
+
+
+//-----------------------------------------------------------------------------
+// Frame Snapshot Types.
+//-----------------------------------------------------------------------------
+
+// Transformed primitives of one frame, in screen space (access via API functions only).
+typedef struct VsnapFrame {
+    // Lines as (x1, y1, x2, y2).
+    VmathNumber * lines;
+    int line_count;
+    int line_capacity;
+    // Points as (x, y).
+    VmathNumber * points;
+    int point_count;
+    int point_capacity;
+    // Number of the frame's publication (1 for the first).
+    uint64_t sequence;
+} VsnapFrame;
+
+
+// Lock-free triple buffer of frames between one producer thread and one
+// consumer thread. The producer fills the back frame and swaps it with the
+// shared one; the consumer swaps the shared frame with its front frame when
+// a fresh one is waiting. Neither side ever waits for the other.
+typedef struct VsnapTriple {
+    VsnapFrame frames[3];
+    // Shared frame index, plus VSNAP_FRESH if published since last acquired.
+    SDL_atomic_t shared;
+    // Producer's frame index (producer only).
+    int back;
+    // Consumer's frame index (consumer only).
+    int front;
+    // Frames published (producer only).
+    uint64_t published;
+} VsnapTriple;
+
+
+
+//-----------------------------------------------------------------------------
+// Frame Snapshot Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise a triple buffer of empty frames.
+void vsnap_init(VsnapTriple * triple);
+
+// Clean-up the triple buffer.
+void vsnap_done(VsnapTriple * triple);
+
+// Clean-up a frame used on its own (zeroed frames need no initialisation).
+void vsnap_frame_done(VsnapFrame * frame);
+
+
+
+//-----------------------------------------------------------------------------
+// Frame Snapshot Producer Functions.
+//-----------------------------------------------------------------------------
+
+// Get the back frame, emptied, to build the next frame into.
+VsnapFrame * vsnap_begin(VsnapTriple * triple);
+
+// Publish the back frame as the newest frame.
+void vsnap_publish(VsnapTriple * triple);
+
+// Empty the frame.
+void vsnap_frame_clear(VsnapFrame * frame);
+
+// Add a line to the frame. Returns false if out of memory.
+bool vsnap_add_line(VsnapFrame * frame,
+                    const VmathNumber x1, const VmathNumber y1,
+                    const VmathNumber x2, const VmathNumber y2);
+
+// Make room for count more lines and return where to write them as
+// (x1, y1, x2, y2) quads, counting them as added. Returns NULL if out of memory.
+VmathNumber * vsnap_add_lines(VsnapFrame * frame, const int count);
+
+// Make room for count more points and return where to write them as
+// (x, y) pairs, counting them as added. Returns NULL if out of memory.
+VmathNumber * vsnap_add_points(VsnapFrame * frame, const int count);
+
+
+
+//-----------------------------------------------------------------------------
+// Frame Snapshot Consumer Functions.
+//-----------------------------------------------------------------------------
+
+// Get the newest published frame (an empty frame until the first is published).
+// Sets fresh to whether it was published since the last call.
+const VsnapFrame * vsnap_acquire(VsnapTriple * triple, bool * fresh);
+
+
+
+#endif /* __VSNAP__H__ */
@@ -0,0 +1,270 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) vStore Unit Tests.
+// Filename:     vstore-tests.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 16:10
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include <stdlib.h>
+
+// API under test.
+#include "vstore.h"
+#include "vjobs.h"
+
+
+// CTest configuration.
+#define CTEST_MAIN
+#define CTEST_SEGFAULT
+
+// CTest Extra include (implementation) file.
+#include "ctestx.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Test Fixture Lifecycle.
+//-----------------------------------------------------------------------------
+
+// Store with a small initial capacity so creating entities grows it.
+CTEST_DATA(vstore)
+{
+    VstoreStore store;
+};
+
+
+CTEST_SETUP(vstore)
+{
+    vmath_init();
+    ASSERT_TRUE(vstore_init(&data->store, 2));
+}
+
+
+CTEST_TEARDOWN(vstore)
+{
+    vstore_done(&data->store);
+    vmath_done();
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Entity Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vstore, test_vstore_create) {
+    const int root = vstore_create(&data->store, VSTORE_NONE);
+    const int child = vstore_create(&data->store, root);
+    const int grandchild = vstore_create(&data->store, child);
+    ASSERT_EQUAL(0, root);
+    ASSERT_EQUAL(1, child);
+    ASSERT_EQUAL(2, grandchild);
+    ASSERT_EQUAL(4, data->store.capacity);
+    ASSERT_TRUE(vstore_is_alive(&data->store, grandchild));
+    ASSERT_FALSE(vstore_is_alive(&data->store, 3));
+    ASSERT_EQUAL(child, data->store.parent[grandchild]);
+}
+
+
+CTEST2(vstore, test_vstore_destroy) {
+    const int root = vstore_create(&data->store, VSTORE_NONE);
+    const int child = vstore_create(&data->store, root);
+    const int grandchild = vstore_create(&data->store, child);
+    const int other = vstore_create(&data->store, root);
+    vstore_destroy(&data->store, child);
+    ASSERT_TRUE(vstore_is_alive(&data->store, root));
+    ASSERT_FALSE(vstore_is_alive(&data->store, child));
+    ASSERT_FALSE(vstore_is_alive(&data->store, grandchild));
+    ASSERT_TRUE(vstore_is_alive(&data->store, other));
+    // The last destroyed ID is reused when it is above the parent...
+    ASSERT_EQUAL(grandchild, vstore_create(&data->store, root));
+    // ...but never for a child of a higher ID, which gets a new one.
+    ASSERT_EQUAL(4, vstore_create(&data->store, other));
+}
+
+
+CTEST2(vstore, test_vstore_set_items) {
+    const int a = vstore_create(&data->store, VSTORE_NONE);
+    const int b = vstore_create(&data->store, VSTORE_NONE);
+    VedgePoint point = { 1, 2 };
+    VedgeLine line = { 1, 2, 3, 4 };
+    const VedgeGameItem items[3] = {
+            { .type = POINT, .game_item.point = &point },
+            { .type = LINE, .game_item.line = &line },
+            { .type = LINE, .game_item.line = &line } };
+    ASSERT_TRUE(vstore_set_items(&data->store, a, items, 2));
+    ASSERT_TRUE(vstore_set_items(&data->store, b, items, 3));
+    ASSERT_EQUAL(0, data->store.item_first[a]);
+    ASSERT_EQUAL(2, data->store.item_first[b]);
+    ASSERT_EQUAL(5, data->store.items_count);
+    // Fewer items reuse the entity's span.
+    ASSERT_TRUE(vstore_set_items(&data->store, a, &items[1], 1));
+    ASSERT_EQUAL(0, data->store.item_first[a]);
+    ASSERT_EQUAL(1, data->store.item_count[a]);
+    ASSERT_EQUAL(LINE, data->store.items[0].type);
+    ASSERT_EQUAL(5, data->store.items_count);
+}
+
+
+CTEST2(vstore, test_vstore_set_items_churn) {
+    const int root = vstore_create(&data->store, VSTORE_NONE);
+    VedgePoint point = { 1, 2 };
+    VedgeGameItem items[8];
+    for (int i = 0;  i < 8;  i++) {
+        items[i] = (VedgeGameItem){ .type = POINT, .game_item.point = &point };
+    }
+    ASSERT_TRUE(vstore_set_items(&data->store, root, items, 1));
+    // Debris of varying sizes spawned and destroyed every frame.
+    int debris[10];
+    int peak_capacity = 0;
+    for (int frame = 0;  frame < 1000;  frame++) {
+        for (int i = 0;  i < 10;  i++) {
+            debris[i] = vstore_create(&data->store, root);
+            ASSERT_TRUE(vstore_set_items(&data->store, debris[i], items, 1 + ((frame + i) % 8)));
+        }
+        for (int i = 0;  i < 10;  i++) {
+            vstore_destroy(&data->store, debris[i]);
+        }
+        peak_capacity = SDL_max(peak_capacity, data->store.items_capacity);
+    }
+    // At most 1 + 80 items are live at once; the array stays within a few times that.
+    ASSERT_TRUE(data->store.items_count <= data->store.items_capacity);
+    ASSERT_TRUE(peak_capacity <= 4 * 81);
+    // The root's items survived the compactions.
+    ASSERT_EQUAL(1, data->store.item_count[root]);
+    ASSERT_EQUAL(POINT, data->store.items[data->store.item_first[root]].type);
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Test Pass Functions.
+//-----------------------------------------------------------------------------
+
+CTEST2(vstore, test_vstore_update_world) {
+    const int root = vstore_create(&data->store, VSTORE_NONE);
+    const int child = vstore_create(&data->store, root);
+    const int hidden = vstore_create(&data->store, root);
+    const int hidden_child = vstore_create(&data->store, hidden);
+    VmathMatrix3x3 position;
+    VmathMatrix3x3 rotation;
+    VmathMatrix3x3 scaling;
+    vmath_matrix3x3_set_translation(position, VMATHNUMBER_C(100.0), VMATHNUMBER_C(50.0));
+    vmath_matrix3x3_set_identity(rotation);
+    vmath_matrix3x3_set_scaling(scaling, VMATHNUMBER_C(2.0), VMATHNUMBER_C(2.0));
+    vstore_set_transform(&data->store, root, position, rotation, scaling);
+    vmath_matrix3x3_set_translation(position, VMATHNUMBER_C(1.0), VMATHNUMBER_C(2.0));
+    vstore_set_local(&data->store, child, position);
+    vstore_set_enable(&data->store, hidden, false);
+    vstore_update_world(&data->store);
+    ASSERT_TRUE(data->store.visible[root]);
+    ASSERT_TRUE(data->store.visible[child]);
+    ASSERT_FALSE(data->store.visible[hidden]);
+    ASSERT_FALSE(data->store.visible[hidden_child]);
+    // The child's origin is (1, 2) scaled by 2 then moved by (100, 50).
+    const VmathMatrix3x1 origin = { VMATHNUMBER_C(0.0), VMATHNUMBER_C(0.0), VMATHNUMBER_C(1.0) };
+    VmathMatrix3x1 result;
+    vmath_matrix3x3_multiply_matrix3x1(data->store.world[child], origin, result);
+    ASSERT_DBL_NEAR_TOL(102.0, result[0], 1e-4);
+    ASSERT_DBL_NEAR_TOL(54.0, result[1], 1e-4);
+}
+
+
+
+CTEST2(vstore, test_vstore_update_world_versions) {
+    const int root = vstore_create(&data->store, VSTORE_NONE);
+    const int child = vstore_create(&data->store, root);
+    const int other = vstore_create(&data->store, VSTORE_NONE);
+    VmathMatrix3x3 translation;
+    vmath_matrix3x3_set_translation(translation, VMATHNUMBER_C(5.0), VMATHNUMBER_C(0.0));
+    vstore_update_world(&data->store);
+    ASSERT_EQUAL(3, data->store.world_updates);
+    // Nothing changed: no transforms recomputed.
+    vstore_update_world(&data->store);
+    ASSERT_EQUAL(0, data->store.world_updates);
+    // A parent change recomputes its subtree only.
+    vstore_set_local(&data->store, root, translation);
+    vstore_update_world(&data->store);
+    ASSERT_EQUAL(2, data->store.world_updates);
+    ASSERT_DBL_NEAR_TOL(5.0, data->store.world[child][0][2], 1e-6);
+    // A leaf change recomputes the leaf only.
+    vstore_set_local(&data->store, other, translation);
+    vstore_update_world(&data->store);
+    ASSERT_EQUAL(1, data->store.world_updates);
+    // Re-enabling a subtree changed while hidden brings it up to date.
+    vstore_set_enable(&data->store, root, false);
+    vstore_set_local(&data->store, child, translation);
+    vstore_update_world(&data->store);
+    ASSERT_EQUAL(0, data->store.world_updates);
+    vstore_set_enable(&data->store, root, true);
+    vstore_update_world(&data->store);
+    ASSERT_EQUAL(1, data->store.world_updates);
+    ASSERT_DBL_NEAR_TOL(10.0, data->store.world[child][0][2], 1e-6);
+}
+
+
+CTEST2(vstore, test_vstore_update_world_parallel) {
+    enum { ENTITIES = 5000 };
+    static VmathNumber expect[ENTITIES];
+    VstoreStore * store = &data->store;
+    ASSERT_TRUE(vjobs_init(3));
+    // A random forest, each entity moved right by one from its parent.
+    VmathMatrix3x3 translation;
+    vmath_matrix3x3_set_translation(translation, VMATHNUMBER_C(1.0), VMATHNUMBER_C(0.0));
+    srand(7);
+    for (int i = 0;  i < ENTITIES;  i++) {
+        const int parent = ((i == 0) || ((rand() % 8) == 0)) ? VSTORE_NONE : (rand() % i);
+        ASSERT_EQUAL(i, vstore_create(store, parent));
+        vstore_set_local(store, i, translation);
+        expect[i] = ((parent == VSTORE_NONE) ? VMATHNUMBER_C(0.0) : expect[parent]) + VMATHNUMBER_C(1.0);
+    }
+    vstore_update_world(store);
+    ASSERT_EQUAL(ENTITIES, store->world_updates);
+    for (int i = 0;  i < ENTITIES;  i++) {
+        ASSERT_DBL_NEAR_TOL(expect[i], store->world[i][0][2], 1e-3);
+    }
+    // Moving the first root recomputes its subtree only.
+    int subtree = 0;
+    vmath_matrix3x3_set_translation(translation, VMATHNUMBER_C(3.0), VMATHNUMBER_C(0.0));
+    vstore_set_local(store, 0, translation);
+    vstore_update_world(store);
+    for (int i = 0;  i < ENTITIES;  i++) {
+        int root = i;
+        while (store->parent[root] != VSTORE_NONE) {
+            root = store->parent[root];
+        }
+        if (root == 0) {
+            ASSERT_DBL_NEAR_TOL(expect[i] + VMATHNUMBER_C(2.0), store->world[i][0][2], 1e-3);
+            subtree++;
+        } else {
+            ASSERT_DBL_NEAR_TOL(expect[i], store->world[i][0][2], 1e-3);
+        }
+    }
+    ASSERT_EQUAL(subtree, store->world_updates);
+    vjobs_done();
+}
+
+
+//-----------------------------------------------------------------------------
+// Main Application Entry Point.
+//-----------------------------------------------------------------------------
+
+// Function main() implementation.
+CTESTX_MAIN
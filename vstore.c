@@ -0,0 +1,380 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Game Object Store.
+// Filename:     vstore.c
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 16:10
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vjobs.h"
+#include "vstore.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Game Object Store Utility Functions.
+//-----------------------------------------------------------------------------
+
+// Resize an array to capacity elements of size, keeping it if out of memory.
+static bool vstore_resize(void ** array, const int capacity, const size_t size)
+{
+    void * resized = realloc(*array, (size_t)capacity * size);
+    if (resized == NULL) {
+        return false;
+    }
+    *array = resized;
+    return true;
+}
+
+
+// Grow the per-entity arrays to capacity entities.
+static bool vstore_grow(VstoreStore * store, const int capacity)
+{
+    if (!vstore_resize((void **)&store->parent, capacity, sizeof(int))
+            || !vstore_resize((void **)&store->depth, capacity, sizeof(int))
+            || !vstore_resize((void **)&store->alive, capacity, sizeof(bool))
+            || !vstore_resize((void **)&store->enable, capacity, sizeof(bool))
+            || !vstore_resize((void **)&store->visible, capacity, sizeof(bool))
+            || !vstore_resize((void **)&store->local, capacity, sizeof(VmathMatrix3x3))
+            || !vstore_resize((void **)&store->local_version, capacity, sizeof(uint64_t))
+            || !vstore_resize((void **)&store->world, capacity, sizeof(VmathMatrix3x3))
+            || !vstore_resize((void **)&store->world_version, capacity, sizeof(uint64_t))
+            || !vstore_resize((void **)&store->world_local_version, capacity, sizeof(uint64_t))
+            || !vstore_resize((void **)&store->world_parent_version, capacity, sizeof(uint64_t))
+            || !vstore_resize((void **)&store->item_first, capacity, sizeof(int))
+            || !vstore_resize((void **)&store->item_count, capacity, sizeof(int))
+            || !vstore_resize((void **)&store->free_ids, capacity, sizeof(int))
+            || !vstore_resize((void **)&store->order, capacity, sizeof(int))
+            || !vstore_resize((void **)&store->level_first, capacity + 2, sizeof(int))) {
+        SDL_Log("vstore_grow: out of memory for %d entities", capacity);
+        return false;
+    }
+    store->capacity = capacity;
+    return true;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Game Object Store Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise an empty store with room for capacity entities (grows as needed).
+bool vstore_init(VstoreStore * store, const int capacity)
+{
+    assert (store != NULL);
+    assert (capacity > 0);
+    memset(store, 0, sizeof(VstoreStore));
+    if (!vstore_grow(store, capacity)) {
+        vstore_done(store);
+        return false;
+    }
+    return true;
+}
+
+
+// Clean-up the store.
+void vstore_done(VstoreStore * store)
+{
+    assert (store != NULL);
+    free(store->parent);
+    free(store->depth);
+    free(store->alive);
+    free(store->enable);
+    free(store->visible);
+    free(store->local);
+    free(store->local_version);
+    free(store->world);
+    free(store->world_version);
+    free(store->world_local_version);
+    free(store->world_parent_version);
+    free(store->item_first);
+    free(store->item_count);
+    free(store->items);
+    free(store->free_ids);
+    free(store->order);
+    free(store->level_first);
+    memset(store, 0, sizeof(VstoreStore));
+}
+
+
+// Destroy all entities.
+void vstore_clear(VstoreStore * store)
+{
+    assert (store != NULL);
+    store->count = 0;
+    store->items_count = 0;
+    store->free_count = 0;
+    store->order_dirty = true;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Game Object Store Entity Functions.
+//-----------------------------------------------------------------------------
+
+// Create an enabled entity with an identity transform and no items under
+// the parent (VSTORE_NONE for a root). Returns its ID, or VSTORE_NONE.
+int vstore_create(VstoreStore * store, const int parent)
+{
+    assert (store != NULL);
+    assert ((parent == VSTORE_NONE) || vstore_is_alive(store, parent));
+    // Reuse the last destroyed ID only if it keeps the parent's ID lower.
+    int id;
+    if ((store->free_count > 0) && (store->free_ids[store->free_count - 1] > parent)) {
+        id = store->free_ids[--store->free_count];
+    } else {
+        if ((store->count == store->capacity) && !vstore_grow(store, store->capacity * 2)) {
+            return VSTORE_NONE;
+        }
+        id = store->count++;
+    }
+    store->parent[id] = parent;
+    store->depth[id] = (parent == VSTORE_NONE) ? 0 : store->depth[parent] + 1;
+    store->alive[id] = true;
+    store->enable[id] = true;
+    store->visible[id] = false;
+    vmath_matrix3x3_set_identity(store->local[id]);
+    store->local_version[id] = 0;
+    store->world_version[id] = 0;
+    store->item_first[id] = 0;
+    store->item_count[id] = 0;
+    store->order_dirty = true;
+    return id;
+}
+
+
+// Destroy the entity and its descendants.
+void vstore_destroy(VstoreStore * store, const int id)
+{
+    assert (store != NULL);
+    assert (vstore_is_alive(store, id));
+    store->alive[id] = false;
+    store->visible[id] = false;
+    store->free_ids[store->free_count++] = id;
+    store->order_dirty = true;
+    // Descendants have higher IDs and their parents are seen first.
+    for (int i = id + 1;  i < store->count;  i++) {
+        if (store->alive[i] && (store->parent[i] != VSTORE_NONE) && !store->alive[store->parent[i]]) {
+            store->alive[i] = false;
+            store->visible[i] = false;
+            store->free_ids[store->free_count++] = i;
+        }
+    }
+}
+
+
+// Is the ID a live entity?
+bool vstore_is_alive(const VstoreStore * store, const int id)
+{
+    assert (store != NULL);
+    return (id >= 0) && (id < store->count) && store->alive[id];
+}
+
+
+// Set whether the entity, and so its descendants, are visited.
+void vstore_set_enable(VstoreStore * store, const int id, const bool enable)
+{
+    assert (vstore_is_alive(store, id));
+    store->enable[id] = enable;
+}
+
+
+// Set the entity's local transform from its position, rotation and scaling.
+void vstore_set_transform(VstoreStore * store, const int id,
+                          const VmathMatrix3x3 position,
+                          const VmathMatrix3x3 rotation,
+                          const VmathMatrix3x3 scaling)
+{
+    assert (vstore_is_alive(store, id));
+    VmathMatrix3x3 position_rotation;
+    vmath_matrix3x3_multiply_matrix3x3_fast(position, rotation, position_rotation);
+    vmath_matrix3x3_multiply_matrix3x3_fast(position_rotation, scaling, store->local[id]);
+    store->local_version[id]++;
+}
+
+
+// Set the entity's local transform.
+void vstore_set_local(VstoreStore * store, const int id, const VmathMatrix3x3 local)
+{
+    assert (vstore_is_alive(store, id));
+    memcpy(store->local[id], local, sizeof(VmathMatrix3x3));
+    store->local_version[id]++;
+}
+
+
+// Copy the other live entities' spans to a new items array with room for count more
+// items, dropping the spans of destroyed entities, replaced spans and the entity's own.
+// The new array is at least twice the items kept, so compacting is amortised over
+// as many appends. Returns false if out of memory.
+static bool vstore_compact_items(VstoreStore * store, const int id, const int count)
+{
+    int live = count;
+    for (int i = 0;  i < store->count;  i++) {
+        if (store->alive[i] && (i != id)) {
+            live += store->item_count[i];
+        }
+    }
+    int capacity = (store->items_capacity > 0) ? store->items_capacity : store->capacity;
+    while (capacity < live * 2) {
+        capacity *= 2;
+    }
+    VedgeGameItem * items = malloc((size_t)capacity * sizeof(VedgeGameItem));
+    if (items == NULL) {
+        SDL_Log("vstore_set_items: out of memory for %d items", capacity);
+        return false;
+    }
+    int next = 0;
+    for (int i = 0;  i < store->count;  i++) {
+        if (store->alive[i] && (i != id) && (store->item_count[i] > 0)) {
+            memcpy(&items[next], &store->items[store->item_first[i]], (size_t)store->item_count[i] * sizeof(VedgeGameItem));
+            store->item_first[i] = next;
+            next += store->item_count[i];
+        }
+    }
+    free(store->items);
+    store->items = items;
+    store->items_count = next;
+    store->items_capacity = capacity;
+    return true;
+}
+
+
+// Set the entity's items (copied). Returns false if out of memory.
+bool vstore_set_items(VstoreStore * store, const int id, const VedgeGameItem * items, const int count)
+{
+    assert (vstore_is_alive(store, id));
+    assert ((items != NULL) || (count == 0));
+    // Overwrite the entity's span if the items fit, otherwise append a new span,
+    // first compacting away unused spans when the items array is full.
+    if (count > store->item_count[id]) {
+        if ((store->items_count + count > store->items_capacity) && !vstore_compact_items(store, id, count)) {
+            return false;
+        }
+        store->item_first[id] = store->items_count;
+        store->items_count += count;
+    }
+    if (count > 0) {
+        memcpy(&store->items[store->item_first[id]], items, (size_t)count * sizeof(VedgeGameItem));
+    }
+    store->item_count[id] = count;
+    return true;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Game Object Store Pass Functions.
+//-----------------------------------------------------------------------------
+
+// Group the live entity IDs by depth (a counting sort, keeping ID order within a depth).
+static void vstore_order(VstoreStore * store)
+{
+    int * level_first = store->level_first;
+    int levels = 0;
+    for (int i = 0;  i < store->count;  i++) {
+        if (store->alive[i]) {
+            levels = SDL_max(levels, store->depth[i] + 1);
+        }
+    }
+    // Count each depth's entities two entries on, sum them into the start of the
+    // next depth, then place the IDs advancing those starts to the depth's own.
+    memset(level_first, 0, (size_t)(levels + 2) * sizeof(int));
+    for (int i = 0;  i < store->count;  i++) {
+        if (store->alive[i]) {
+            level_first[store->depth[i] + 2]++;
+        }
+    }
+    for (int d = 2;  d <= levels;  d++) {
+        level_first[d] += level_first[d - 1];
+    }
+    for (int i = 0;  i < store->count;  i++) {
+        if (store->alive[i]) {
+            store->order[level_first[store->depth[i] + 1]++] = i;
+        }
+    }
+    store->level_count = levels;
+    store->order_dirty = false;
+}
+
+
+// A world transform pass over one depth.
+typedef struct VstoreWorldPass {
+    VstoreStore * store;
+    SDL_atomic_t updates;
+} VstoreWorldPass;
+
+
+// Update the visibility and world transforms of the entities in [begin, end) of the order.
+static void vstore_update_world_range(void * data, const int begin, const int end)
+{
+    VstoreWorldPass * pass = data;
+    VstoreStore * store = pass->store;
+    int updates = 0;
+    for (int k = begin;  k < end;  k++) {
+        const int i = store->order[k];
+        const int parent = store->parent[i];
+        store->visible[i] = store->enable[i] && ((parent == VSTORE_NONE) || store->visible[parent]);
+        if (!store->visible[i]) {
+            continue;
+        }
+        const uint64_t parent_version = (parent == VSTORE_NONE) ? 0 : store->world_version[parent];
+        if ((store->world_version[i] != 0)
+                && (store->world_local_version[i] == store->local_version[i])
+                && (store->world_parent_version[i] == parent_version)) {
+            continue;
+        }
+        if (parent == VSTORE_NONE) {
+            memcpy(store->world[i], store->local[i], sizeof(VmathMatrix3x3));
+        } else {
+            vmath_matrix3x3_multiply_matrix3x3_fast(store->world[parent], store->local[i], store->world[i]);
+        }
+        store->world_version[i]++;
+        store->world_local_version[i] = store->local_version[i];
+        store->world_parent_version[i] = parent_version;
+        updates++;
+    }
+    SDL_AtomicAdd(&pass->updates, updates);
+}
+
+
+// Update every entity's visibility, and the world transforms of visible entities
+// whose local transform or parent's world transform changed, one depth at a time.
+void vstore_update_world(VstoreStore * store)
+{
+    assert (store != NULL);
+    if (store->order_dirty) {
+        vstore_order(store);
+    }
+    // Each depth only reads the depth above, which is complete.
+    VstoreWorldPass pass = { .store = store };
+    SDL_AtomicSet(&pass.updates, 0);
+    for (int d = 0;  d < store->level_count;  d++) {
+        vjobs_parallel_for(store->level_first[d], store->level_first[d + 1], VSTORE_ENTITIES_PER_JOB,
+                           vstore_update_world_range, &pass);
+    }
+    store->world_updates = SDL_AtomicGet(&pass.updates);
+}
@@ -0,0 +1,172 @@
+//=============================================================================
+// Title:        VEctor Display Graphics Engine (vEdge) Game Object Store.
+// Filename:     vstore.h
+// Platform:     Any supported by SDL version 2.
+// Language:     ANSI C99
+// Author:       Justin Lane (vedge@jigglesoft.co.uk)
+// Date:         2026-10-19 16:10
+// Version:      1.0.0-alpha-1
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021 Justin Lane
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __VSTORE__H__
+#define __VSTORE__H__
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "vmath.h"
+#include "vedge.h"
+
+
+
+//-----------------------------------------------------------------------------
+// Game Object Store Configuration.
+//-----------------------------------------------------------------------------
+
+// Entities of one depth per parallel job chunk in vstore_update_world.
+#ifndef VSTORE_ENTITIES_PER_JOB
+#define VSTORE_ENTITIES_PER_JOB 256
+#endif
+
+
+
+//-----------------------------------------------------------------------------
+// Game Object Store Constants.
+//-----------------------------------------------------------------------------
+
+// No entity (a root entity's parent, or a failed create).
+#define VSTORE_NONE (-1)
+
+
+
+//-----------------------------------------------------------------------------
+// Game Object Store Types.
+//-----------------------------------------------------------------------------
+
+// Game objects stored as a structure of arrays indexed by entity ID, so the
+// per-frame passes stream through contiguous memory (access via API functions
+// only). A parent's ID is always lower than its children's, so one pass in ID
+// order sees every parent before its children.
+typedef struct VstoreStore {
+    // Entity IDs in use are below count; capacity is the array length.
+    int count;
+    int capacity;
+    // Parent entity ID (VSTORE_NONE for a root).
+    int * parent;
+    // Number of ancestors.
+    int * depth;
+    // Is the ID in use?
+    bool * alive;
+    // Is the entity enabled?
+    bool * enable;
+    // Is the entity alive and enabled along with all of its ancestors (updated by vstore_update_world)?
+    bool * visible;
+    // Local transform (position * rotation * scaling).
+    VmathMatrix3x3 * local;
+    // Incremented each time the local transform is set.
+    uint64_t * local_version;
+    // World transform of visible entities (parent world * local, updated by
+    // vstore_update_world only when the entity or an ancestor changed).
+    VmathMatrix3x3 * world;
+    // Incremented each time world is recomputed (0 = never computed).
+    uint64_t * world_version;
+    // Local version and parent world version world was computed from.
+    uint64_t * world_local_version;
+    uint64_t * world_parent_version;
+    // World transforms recomputed by the last vstore_update_world.
+    int world_updates;
+    // Span of the entity's items in items.
+    int * item_first;
+    int * item_count;
+    // Items of all entities, including unused spans until compacted when full.
+    VedgeGameItem * items;
+    int items_count;
+    int items_capacity;
+    // Destroyed IDs to reuse, most recent last.
+    int * free_ids;
+    int free_count;
+    // Live entity IDs grouped by depth, in ID order within a depth: depth d's
+    // are order[level_first[d]] up to order[level_first[d + 1]].
+    int * order;
+    int * level_first;
+    int level_count;
+    // Do order and level_first need regrouping (entities created or destroyed)?
+    bool order_dirty;
+} VstoreStore;
+
+
+
+//-----------------------------------------------------------------------------
+// Game Object Store Life-cycle Functions.
+//-----------------------------------------------------------------------------
+
+// Initialise an empty store with room for capacity entities (grows as needed).
+bool vstore_init(VstoreStore * store, const int capacity);
+
+// Clean-up the store.
+void vstore_done(VstoreStore * store);
+
+// Destroy all entities.
+void vstore_clear(VstoreStore * store);
+
+
+
+//-----------------------------------------------------------------------------
+// Game Object Store Entity Functions.
+//-----------------------------------------------------------------------------
+
+// Create an enabled entity with an identity transform and no items under
+// the parent (VSTORE_NONE for a root). Returns its ID, or VSTORE_NONE.
+int vstore_create(VstoreStore * store, const int parent);
+
+// Destroy the entity and its descendants.
+void vstore_destroy(VstoreStore * store, const int id);
+
+// Is the ID a live entity?
+bool vstore_is_alive(const VstoreStore * store, const int id);
+
+// Set whether the entity, and so its descendants, are visited.
+void vstore_set_enable(VstoreStore * store, const int id, const bool enable);
+
+// Set the entity's local transform from its position, rotation and scaling.
+void vstore_set_transform(VstoreStore * store, const int id,
+                          const VmathMatrix3x3 position,
+                          const VmathMatrix3x3 rotation,
+                          const VmathMatrix3x3 scaling);
+
+// Set the entity's local transform.
+void vstore_set_local(VstoreStore * store, const int id, const VmathMatrix3x3 local);
+
+// Set the entity's items (copied). Returns false if out of memory.
+bool vstore_set_items(VstoreStore * store, const int id, const VedgeGameItem * items, const int count);
+
+
+
+//-----------------------------------------------------------------------------
+// Game Object Store Pass Functions.
+//-----------------------------------------------------------------------------
+
+// Update every entity's visibility, and the world transforms of visible entities
+// whose local transform or parent's world transform changed, one depth at a time
+// with each depth's entities shared between the vjobs threads.
+void vstore_update_world(VstoreStore * store);
+
+
+
+#endif /* __VSTORE__H__ */